@@ -6,16 +6,27 @@
 
 #include <cassert>
 #include <cmath>
+#include <vector>
 #include <algorithm>  // for min/max
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/VertexBufferModel.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "PerlinNoiseField3.h"
 #include "Entity.h"
+#include "RadiusCubemap.h"
+#ifndef HEADLESS_SIMULATION
+#include "AsteroidMesh.h"
+#include "RenderQueue.h"
+#endif
 
 using namespace ObjLibrary;
 namespace
@@ -37,10 +48,107 @@ namespace
 		return rand() / (RAND_MAX + 1.0);
 	}
 
+//
+//  calculateNoise
+//
+//  Purpose: To evaluate the noise that defines the shape of an
+//           asteroid for many directions at once.
+//  Parameter(s):
+//    <1> count: The number of directions
+//    <2> pa_directions: The directions in local coordinates
+//    <3> random_noise_offset: The offset for the Perlin noise
+//    <4> pa_noise: An array to fill with the noise values
+//  Preconditions:
+//    <1> count == 0 || pa_directions != nullptr
+//    <2> count == 0 || pa_noise != nullptr
+//  Returns: N/A
+//  Side Effect: pa_noise[i] is set to the noise value in
+//               [-1, 1] for direction pa_directions[i], for
+//               each i < count.
+//
+	void calculateNoise (unsigned int count,
+	                     const Vector3* pa_directions,
+	                     const Vector3& random_noise_offset,
+	                     float* pa_noise)
+	{
+		assert(count == 0 || pa_directions != nullptr);
+		assert(count == 0 || pa_noise != nullptr);
+
+		if(count == 0)
+			return;
+
+		std::vector<float> v_x(count);
+		std::vector<float> v_y(count);
+		std::vector<float> v_z(count);
+		Vector3 minimum = random_noise_offset;
+		Vector3 maximum = random_noise_offset;
+		for(unsigned int i = 0; i < count; i++)
+		{
+			Vector3 offset_vertex = pa_directions[i] + random_noise_offset;
+			v_x[i] = (float)(offset_vertex.x);
+			v_y[i] = (float)(offset_vertex.y);
+			v_z[i] = (float)(offset_vertex.z);
+			minimum = Vector3(std::min<double>(minimum.x, v_x[i]),
+			                  std::min<double>(minimum.y, v_y[i]),
+			                  std::min<double>(minimum.z, v_z[i]));
+			maximum = Vector3(std::max<double>(maximum.x, v_x[i]),
+			                  std::max<double>(maximum.y, v_y[i]),
+			                  std::max<double>(maximum.z, v_z[i]));
+		}
+
+		// the points are all near each other, so calculate each
+		//   lattice gradient only once
+		PerlinNoiseField3 noise_with_table(NOISE, minimum, maximum);
+		noise_with_table.perlinNoiseBatch(count, v_x.data(), v_y.data(), v_z.data(), pa_noise);
+	}
+
+//
+//  calculateRadii
+//
+//  Purpose: To determine the surface radius of an asteroid for
+//           many directions at once.
+//  Parameter(s):
+//    <1> count: The number of directions
+//    <2> pa_directions: The directions in local coordinates
+//    <3> random_noise_offset: The offset for the Perlin noise
+//    <4> radius_average: The average of the inner and outer
+//                        radii
+//    <5> radius_half_range: Half the difference between the
+//                           inner and outer radii
+//    <6> pa_radii: An array to fill with the radii
+//  Preconditions:
+//    <1> count == 0 || pa_directions != nullptr
+//    <2> count == 0 || pa_radii != nullptr
+//  Returns: N/A
+//  Side Effect: pa_radii[i] is set to the surface radius for
+//               direction pa_directions[i], for each
+//               i < count.
+//
+	void calculateRadii (unsigned int count,
+	                     const Vector3* pa_directions,
+	                     const Vector3& random_noise_offset,
+	                     double radius_average,
+	                     double radius_half_range,
+	                     float* pa_radii)
+	{
+		assert(count == 0 || pa_directions != nullptr);
+		assert(count == 0 || pa_radii != nullptr);
+
+		calculateNoise(count, pa_directions, random_noise_offset, pa_radii);
+		for(unsigned int i = 0; i < count; i++)
+		{
+			double noise = pa_radii[i];
+			assert(noise >= -1.0);
+			assert(noise <=  1.0);
+			pa_radii[i] = (float)(radius_average + noise * radius_half_range);
+		}
+	}
+
 }  // end of anonymous namespace
 
 
 
+#ifndef HEADLESS_SIMULATION
 bool Asteroid :: isUnitSphere (const ObjLibrary::ObjModel& base_model)
 {
 	static const double TOLERANCE = 1.0e-3;
@@ -55,6 +163,12 @@ bool Asteroid :: isUnitSphere (const ObjLibrary::ObjModel& base_model)
 	}
 	return true;
 }
+#endif
+
+const PerlinNoiseField3& Asteroid :: getNoiseField ()
+{
+	return NOISE;
+}
 
 double Asteroid :: calculateMass (double inner_radius,
                                   double outer_radius)
@@ -65,10 +179,11 @@ double Asteroid :: calculateMass (double inner_radius,
 	return PI * outer_radius * outer_radius * inner_radius * DENSITY / 6.0;
 }
 
-ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjModel& base_model,
-                                                       double inner_radius,
-                                                       double outer_radius,
-                                                       ObjLibrary::Vector3 random_noise_offset)
+#ifndef HEADLESS_SIMULATION
+ObjLibrary::ObjModel Asteroid :: createModel (const ObjLibrary::ObjModel& base_model,
+                                              double inner_radius,
+                                              double outer_radius,
+                                              const ObjLibrary::Vector3& random_noise_offset)
 {
 	assert(isUnitSphere(base_model));
 
@@ -76,16 +191,20 @@ ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjMode
 	double radius_average    = (outer_radius + inner_radius) * 0.5;
 	double radius_half_range = (outer_radius - inner_radius) * 0.5;
 
-	for(unsigned int v = 0; v < model.getVertexCount(); v++)
+	unsigned int vertex_count = model.getVertexCount();
+	std::vector<Vector3> v_old_vertexes(vertex_count);
+	for(unsigned int v = 0; v < vertex_count; v++)
+		v_old_vertexes[v] = model.getVertexPosition(v);
+	std::vector<float> v_noise(vertex_count);
+	calculateNoise(vertex_count, v_old_vertexes.data(), random_noise_offset, v_noise.data());
+
+	for(unsigned int v = 0; v < vertex_count; v++)
 	{
-		const Vector3& old_vertex = model.getVertexPosition(v);
+		const Vector3& old_vertex = v_old_vertexes[v];
 		assert(!old_vertex.isZero());
 		//assert(old_vertex.isUnit());  // tolerances are too tight, so skip
 
-		Vector3 offset_vertex = old_vertex + random_noise_offset;
-		double noise = NOISE.perlinNoise((float)(offset_vertex.x),
-		                                 (float)(offset_vertex.y),
-		                                 (float)(offset_vertex.z));
+		double noise = v_noise[v];
 		assert(noise >= -1.0);
 		assert(noise <=  1.0);
 
@@ -94,9 +213,20 @@ ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjMode
 		model.setVertexPosition(v, new_vertex);
 	}
 
+	return model;
+}
+
+ObjLibrary::DisplayList Asteroid :: createDisplayList (const ObjLibrary::ObjModel& base_model,
+                                                       double inner_radius,
+                                                       double outer_radius,
+                                                       ObjLibrary::Vector3 random_noise_offset)
+{
+	assert(isUnitSphere(base_model));
+
 	// don't check invariant in helper function
-	return model.getDisplayList();
+	return createModel(base_model, inner_radius, outer_radius, random_noise_offset).getDisplayList();
 }
+#endif
 
 Asteroid :: Asteroid ()
 		: Entity()
@@ -105,11 +235,16 @@ Asteroid :: Asteroid ()
 		, m_rotation_axis(Vector3(1.0, 0.0, 0.0))
 		, m_rotation_rate(0.0)
 		, m_is_crystals(false)
+		, m_radius_cubemap()
+#ifndef HEADLESS_SIMULATION
+		, mv_vertex_buffer_models()
+#endif
 {
 	assert(!isInitialized());
 	assert(invariant());
 }
 
+#ifndef HEADLESS_SIMULATION
 static Vector3 g_noise_offset;  // to copy value out of parameter into member field initialized after
 Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
                       const ObjLibrary::Vector3& velocity,
@@ -130,6 +265,8 @@ Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
 		, m_rotation_axis(Vector3::getRandomUnitVector())
 		, m_rotation_rate(std::min(random01(), random01()) * ROTATION_RATE_MAX)  // mostly rotate slowly
 		, m_is_crystals(true)
+		, m_radius_cubemap()
+		, mv_vertex_buffer_models()
 {
 	assert(inner_radius >= 0.0);
 	assert(inner_radius <= outer_radius);
@@ -146,28 +283,64 @@ Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
 	assert(isInitialized());
 	assert(invariant());
 }
+#endif
+
+Asteroid :: Asteroid (const ObjLibrary::Vector3& position,
+                      const ObjLibrary::Vector3& velocity,
+                      double inner_radius,
+                      double outer_radius)
+		: Entity(position,
+		         velocity,
+		         calculateMass(inner_radius, outer_radius),
+		         outer_radius)
+		, m_inner_radius(inner_radius)
+		, m_random_noise_offset(Vector3::getRandomSphereVector() * NOISE_OFFSET_MAX)  // same order as above
+		, m_rotation_axis(Vector3::getRandomUnitVector())
+		, m_rotation_rate(std::min(random01(), random01()) * ROTATION_RATE_MAX)  // mostly rotate slowly
+		, m_is_crystals(true)
+		, m_radius_cubemap()
+#ifndef HEADLESS_SIMULATION
+		, mv_vertex_buffer_models()
+#endif
+{
+	assert(inner_radius >= 0.0);
+	assert(inner_radius <= outer_radius);
+
+	// rotate randomly
+	m_coords.rotateAroundForward(random01() * TWO_PI);
+	m_coords.rotateAroundUp     (random01() * TWO_PI);
+	m_coords.rotateAroundRight  (random01() * TWO_PI);
+	m_coords.rotateAroundForward(random01() * TWO_PI);
+	m_coords.rotateAroundUp     (random01() * TWO_PI);
+	m_coords.rotateAroundRight  (random01() * TWO_PI);
+
+	assert(isInitialized());
+	assert(invariant());
+}
 
 
 
 double Asteroid :: getRadiusForDirection (const ObjLibrary::Vector3& direction) const
 {
+	assert(isInitialized());
+	assert(isRadiusCubemap());
 	assert(direction.isUnit());
 
-	double radius_average    = (getRadius() + m_inner_radius) * 0.5;
-	double radius_half_range = (getRadius() - m_inner_radius) * 0.5;
+	Vector3 in_local = m_coords.worldToLocal(direction);
+	return m_radius_cubemap.getRadius(in_local);
+}
+
+double Asteroid :: getRadiusForDirectionExact (const ObjLibrary::Vector3& direction) const
+{
+	assert(isInitialized());
+	assert(direction.isUnit());
 
 	Vector3 in_local = m_coords.worldToLocal(direction);
 	assert(in_local.isUnit());
-	Vector3 offset_vertex = in_local + m_random_noise_offset;
-	double noise = NOISE.perlinNoise((float)(offset_vertex.x),
-	                                 (float)(offset_vertex.y),
-	                                 (float)(offset_vertex.z));
-	assert(noise >= -1.0);
-	assert(noise <=  1.0);
-
-	return radius_average + noise * radius_half_range;
+	return calculateLocalRadius(in_local);
 }
 
+#ifndef HEADLESS_SIMULATION
 void Asteroid::drawShield(Vector3 location)
 {
 	glPushMatrix();
@@ -237,6 +410,81 @@ void Asteroid :: drawSurfaceEquators () const
 
 
 
+std::vector<float> Asteroid :: calculateVertexRadii (const AsteroidMesh& mesh) const
+{
+	assert(isInitialized());
+	assert(!mesh.isEmpty());
+
+	double radius_average    = (getRadius() + m_inner_radius) * 0.5;
+	double radius_half_range = (getRadius() - m_inner_radius) * 0.5;
+
+	std::vector<float> v_radii(mesh.getVertexCount());
+	calculateRadii(mesh.getVertexCount(), mesh.getVertexDirections(), m_random_noise_offset,
+	               radius_average, radius_half_range, v_radii.data());
+	return v_radii;
+}
+
+unsigned int Asteroid :: getLevelOfDetailCount () const
+{
+	assert(isInitialized());
+
+	return (unsigned int)(mv_vertex_buffer_models.size());
+}
+
+void Asteroid :: drawLevelOfDetail (unsigned int level) const
+{
+	assert(isInitialized());
+	assert(level < getLevelOfDetailCount());
+
+	if(level == 0)
+	{
+		draw();
+		return;
+	}
+
+	// asteroid models are not scaled
+	glPushMatrix();
+		m_coords.applyDrawTransformations();
+		mv_vertex_buffer_models[level].draw();
+	glPopMatrix();
+}
+
+void Asteroid :: addLevelOfDetailToRenderQueue (RenderQueue& r_queue,
+                                                unsigned int pass,
+                                                unsigned int level) const
+{
+	assert(isInitialized());
+	assert(pass < RenderQueue::PASS_COUNT);
+	assert(level < getLevelOfDetailCount());
+
+	if(level == 0)
+	{
+		addToRenderQueue(r_queue, pass);
+		return;
+	}
+
+	// asteroid models are not scaled
+	double a_matrix[16];
+	m_coords.calculateDrawMatrix(a_matrix);
+	r_queue.addModel(pass, mv_vertex_buffer_models[level], a_matrix);
+}
+
+void Asteroid :: setVertexBufferModels (const std::vector<ObjLibrary::VertexBufferModel>& v_vertex_buffer_models)
+{
+	assert(isInitialized());
+	assert(!v_vertex_buffer_models.empty());
+
+	for(unsigned int i = 0; i < v_vertex_buffer_models.size(); i++)
+		assert(v_vertex_buffer_models[i].isReady());
+	mv_vertex_buffer_models = v_vertex_buffer_models;
+	Entity::setVertexBufferModel(mv_vertex_buffer_models[0], 1.0);
+
+	assert(isDrawable());
+	assert(getLevelOfDetailCount() == v_vertex_buffer_models.size());
+	assert(invariant());
+}
+#endif
+
 void Asteroid :: removeCrystals ()
 {
 	assert(isInitialized());
@@ -253,6 +501,27 @@ void Asteroid :: updatePhysics (double delta_time,
 	assert(delta_time > 0.0);
 
 	Entity::updatePhysics(delta_time, black_hole);
+	updateRotation(delta_time);
+
+	assert(invariant());
+}
+
+void Asteroid :: updatePhysicsOnRails (double delta_time,
+                                       const Entity& black_hole)
+{
+	assert(isInitialized());
+	assert(delta_time > 0.0);
+
+	Entity::updatePhysicsOnRails(delta_time, black_hole);
+	updateRotation(delta_time);
+
+	assert(invariant());
+}
+
+void Asteroid :: updateRotation (double delta_time)
+{
+	assert(isInitialized());
+	assert(delta_time > 0.0);
 
 	double rotation_radians = m_rotation_rate * delta_time;
 	m_coords.rotateAroundArbitrary(m_rotation_axis, rotation_radians);
@@ -262,6 +531,42 @@ void Asteroid :: updatePhysics (double delta_time,
 
 
 
+double Asteroid :: calculateLocalRadius (const ObjLibrary::Vector3& local_direction) const
+{
+	double radius_average    = (getRadius() + m_inner_radius) * 0.5;
+	double radius_half_range = (getRadius() - m_inner_radius) * 0.5;
+
+	Vector3 offset_vertex = local_direction + m_random_noise_offset;
+	double noise = NOISE.perlinNoise((float)(offset_vertex.x),
+	                                 (float)(offset_vertex.y),
+	                                 (float)(offset_vertex.z));
+	assert(noise >= -1.0);
+	assert(noise <=  1.0);
+
+	return radius_average + noise * radius_half_range;
+}
+
+void Asteroid :: initRadiusCubemap ()
+{
+	assert(isInitialized());
+
+	double radius_average    = (getRadius() + m_inner_radius) * 0.5;
+	double radius_half_range = (getRadius() - m_inner_radius) * 0.5;
+
+	// same formula as calculateLocalRadius, but in bulk
+	m_radius_cubemap = RadiusCubemap([this, radius_average, radius_half_range]
+	                                 (unsigned int count,
+	                                  const Vector3* pa_directions,
+	                                  float* pa_radii)
+	                                 {
+	                                     calculateRadii(count, pa_directions, m_random_noise_offset,
+	                                                    radius_average, radius_half_range, pa_radii);
+	                                 });
+
+	assert(!m_radius_cubemap.isEmpty());
+}
+
+#ifndef HEADLESS_SIMULATION
 void Asteroid :: drawSurfaceMarker (const ObjLibrary::Vector3& direction,
                                     const ObjLibrary::Vector3& colour) const
 {
@@ -279,6 +584,7 @@ void Asteroid :: drawSurfaceMarker (const ObjLibrary::Vector3& direction,
 		glutSolidOctahedron();
 	glPopMatrix();
 }
+#endif
 
 bool Asteroid :: invariant () const
 {
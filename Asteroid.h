@@ -7,13 +7,22 @@
 #pragma once
 
 #include <cassert>
+#include <vector>
 
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/ObjModel.h"
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/VertexBufferModel.h"
+#endif
 
 #include "CoordinateSystem.h"
+#include "PerlinNoiseField3.h"
 #include "Entity.h"
+#include "RadiusCubemap.h"
+#ifndef HEADLESS_SIMULATION
+#include "AsteroidMesh.h"
+#endif
 
 
 
@@ -27,6 +36,13 @@
 //    between these two values.  Note that it is normal for no
 //    part of the surface to ever reach either radii.
 //
+//  The surface radius in each direction is defined by Perlin
+//    noise.  Evaluating the noise is slow, so each Asteroid
+//    samples it into a RadiusCubemap, and the collision checks
+//    use the (approximate) cubemap.  The cubemap is not made
+//    by the constructors, so that the World can make the
+//    cubemaps for all its Asteroids on several threads.
+//
 //  A base ObjModel is used to produce the asteroid model.  The
 //    base model must be a unit sphere and should have materials
 //    set.  The vertexes of the model will be moved, but the
@@ -34,6 +50,17 @@
 //    a higher-polygon sphere for the base model will produce a
 //    higher-polygon asteroid.
 //
+//  Asteroids made from the same base model only differ in
+//    their vertex radii, so the World shares one AsteroidMesh
+//    for each base model.  An Asteroid does not store its
+//    radii, because they can be recalculated from the noise
+//    offset whenever its model is needed.
+//
+//  An Asteroid can have several levels of detail, each
+//    displayed with a VertexBufferModel made from a different
+//    AsteroidMesh.  Level 0 is the most detailed and is the
+//    one displayed by draw.
+//
 //  Class Invariant:
 //    <1> m_inner_radius >= 0.0
 //    <2> m_inner_radius <= getRadius()
@@ -43,6 +70,7 @@
 class Asteroid : public Entity
 {
 public:
+#ifndef HEADLESS_SIMULATION
 //
 //  Class Function: isUnitSphere
 //
@@ -57,6 +85,7 @@ public:
 //  Side Effect: N/A
 //
 	static bool isUnitSphere (const ObjLibrary::ObjModel& base_model);
+#endif
 
 //
 //  Class Function: calculateMass
@@ -75,6 +104,45 @@ public:
 	static double calculateMass (double inner_radius,
 	                             double outer_radius);
 
+//
+//  Class Function: getNoiseField
+//
+//  Purpose: To retrieve the Perlin noise field that defines the
+//           shape of every Asteroid.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The noise field.  The noise for an Asteroid is
+//           evaluated at its noise offset plus the direction
+//           from its center.
+//  Side Effect: N/A
+//
+	static const PerlinNoiseField3& getNoiseField ();
+
+#ifndef HEADLESS_SIMULATION
+//
+//  Class Function: createModel
+//
+//  Purpose: To create the model for an Asteroid.  This does not
+//           use OpenGL, so it can be run on any thread.
+//  Parameter(s):
+//    <1> base_model: The base ObjModel that wil be modified to
+//                    produce the asteroid
+//    <2> inner_radius: The inner asteroid radius
+//    <3> outer_radius: The outer asteroid radius
+//    <4> random_noise_offset: The offset for the Perlin noise
+//  Preconditions:
+//    <1> isUnitSphere(base_model)
+//  Returns: A copy of base_model with the vertexes positioned
+//           based on Perlin noise and the inner and outer
+//           radii.
+//  Side Effect: N/A
+//
+	static ObjLibrary::ObjModel createModel (
+	                   const ObjLibrary::ObjModel& base_model,
+	                   double inner_radius,
+	                   double outer_radius,
+	                   const ObjLibrary::Vector3& random_noise_offset);
+
 //
 //  Class Function: createDisplayList
 //
@@ -97,6 +165,7 @@ public:
 	                   double inner_radius,
 	                   double outer_radius,
 	                   ObjLibrary::Vector3 random_noise_offset);
+#endif
 
 public:
 //
@@ -111,6 +180,7 @@ public:
 //
 	Asteroid ();
 
+#ifndef HEADLESS_SIMULATION
 //
 //  Constructor
 //
@@ -134,13 +204,48 @@ public:
 //               radius always in the interval
 //               [inner_radius, outer_radius].  The new Asteroid
 //               has a random orientation and rotational
-//               velocity.
+//               velocity.  It does not have a radius cubemap
+//               until initRadiusCubemap is called.
 //
 	Asteroid (const ObjLibrary::Vector3& position,
 	          const ObjLibrary::Vector3& velocity,
 	          double inner_radius,
 	          double outer_radius,
 	          const ObjLibrary::ObjModel& base_model);
+#endif
+
+//
+//  Constructor
+//
+//  Purpose: To create a random asteroid with the specified
+//           position and inner and out radii that cannot be
+//           displayed.
+//  Parameter(s):
+//    <1> position: The position of the asteroid origin
+//    <2> velocity: The velocity of the asteroid
+//    <3> inner_radius: The inner asteroid radius
+//    <4> outer_radius: The outer asteroid radius
+//  Preconditions: N/A
+//    <1> inner_radius >= 0.0
+//    <2> inner_radius <= outer_radius
+//  Returns: N/A
+//  Side Effect: A new Asteroid is created at position position
+//               with velocity velocity.  Its surface radius is
+//               always in the interval
+//               [inner_radius, outer_radius].  The new Asteroid
+//               has a random orientation and rotational
+//               velocity.  No DisplayList is created, so this
+//               constructor does not require an OpenGL context.
+//               The same random numbers are used as by the
+//               constructor that takes a base model, so the
+//               Asteroid has the same shape and motion.  It
+//               does not have a radius cubemap until
+//               initRadiusCubemap is called.
+//
+	Asteroid (const ObjLibrary::Vector3& position,
+	          const ObjLibrary::Vector3& velocity,
+	          double inner_radius,
+	          double outer_radius);
 
 	Asteroid (const Asteroid& to_copy) = default;
 	~Asteroid () = default;
@@ -157,14 +262,90 @@ public:
 //    <1> direction: The direction to measure the surface in
 //  Preconditions:
 //    <1> isInitialized()
+//    <2> isRadiusCubemap()
+//    <3> direction.isUnit()
+//  Returns: The distance from the Asteroid origin to its
+//           surface in direction direction.  The value is
+//           interpolated from the radius cubemap, and differs
+//           from getRadiusForDirectionExact by at most about
+//           3% of the difference between the inner and outer
+//           radii (average error about 0.3%).
+//  Side Effect: N/A
+//
+	double getRadiusForDirection (
+	                const ObjLibrary::Vector3& direction) const;
+
+//
+//  getRadiusForDirectionExact
+//
+//  Purpose: To determine the surface radius of this Asteroid in
+//           the specified direction by evaluating the Perlin
+//           noise that defines its shape.  This is much slower
+//           than getRadiusForDirection.
+//  Parameter(s):
+//    <1> direction: The direction to measure the surface in
+//  Preconditions:
+//    <1> isInitialized()
 //    <2> direction.isUnit()
 //  Returns: The distance from the Asteroid origin to its
 //           surface in direction direction.
 //  Side Effect: N/A
 //
-	double getRadiusForDirection (
+	double getRadiusForDirectionExact (
 	                const ObjLibrary::Vector3& direction) const;
 
+//
+//  getInnerRadius
+//
+//  Purpose: To determine the inner radius of this Asteroid.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The inner radius.  The outer radius is the
+//           collision radius returned by getRadius.
+//  Side Effect: N/A
+//
+	double getInnerRadius () const
+	{
+		assert(isInitialized());
+
+		return m_inner_radius;
+	}
+
+//
+//  getNoiseOffset
+//
+//  Purpose: To determine where the noise defining the shape of
+//           this Asteroid is sampled.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The offset added to each direction before
+//           evaluating the noise field.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getNoiseOffset () const
+	{
+		assert(isInitialized());
+
+		return m_random_noise_offset;
+	}
+
+//
+//  isRadiusCubemap
+//
+//  Purpose: To determine if the surface radius of this
+//           Asteroid has been sampled into its radius cubemap.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether initRadiusCubemap has been called.
+//  Side Effect: N/A
+//
+	bool isRadiusCubemap () const
+	{
+		return !m_radius_cubemap.isEmpty();
+	}
+
 //
 //  isCrystals
 //
@@ -184,6 +365,7 @@ public:
 		return m_is_crystals;
 	}
 
+#ifndef HEADLESS_SIMULATION
 //
 //  drawAxes
 //
@@ -218,6 +400,123 @@ public:
 
 	void drawSurfaceEquators () const;
 
+//
+//  calculateVertexRadii
+//
+//  Purpose: To determine the radius of this Asteroid at each
+//           vertex of the specified AsteroidMesh.  This does
+//           not use OpenGL, so it can be run on any thread, and
+//           several Asteroids can calculate their radii at the
+//           same time.
+//  Parameter(s):
+//    <1> mesh: The AsteroidMesh
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> !mesh.isEmpty()
+//  Returns: The radius for each vertex direction of mesh, for
+//           use with mesh.createVertexBufferModel.  The
+//           vertexes are positioned as they would be by the
+//           constructor that takes a base model.
+//  Side Effect: N/A
+//
+	std::vector<float> calculateVertexRadii (
+	                          const AsteroidMesh& mesh) const;
+
+//
+//  getLevelOfDetailCount
+//
+//  Purpose: To determine how many levels of detail this
+//           Asteroid can be displayed at.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: The number of VertexBufferModels set by
+//           setVertexBufferModels, or 0 if it has not been
+//           called.
+//  Side Effect: N/A
+//
+	unsigned int getLevelOfDetailCount () const;
+
+//
+//  drawLevelOfDetail
+//
+//  Purpose: To display this Asteroid at the specified level of
+//           detail.
+//  Parameter(s):
+//    <1> level: The level of detail
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> level < getLevelOfDetailCount()
+//  Returns: N/A
+//  Side Effect: This Asteroid is displayed with the
+//               VertexBufferModel for level of detail level.
+//               Level 0 is the same as calling draw.
+//
+	void drawLevelOfDetail (unsigned int level) const;
+
+//
+//  addLevelOfDetailToRenderQueue
+//
+//  Purpose: To add the commands to display this Asteroid at the
+//           specified level of detail to the specified
+//           RenderQueue.
+//  Parameter(s):
+//    <1> r_queue: The RenderQueue
+//    <2> pass: The pass to display this Asteroid in
+//    <3> level: The level of detail
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> pass < RenderQueue::PASS_COUNT
+//    <3> level < getLevelOfDetailCount()
+//  Returns: N/A
+//  Side Effect: Commands to display this Asteroid as
+//               drawLevelOfDetail would are added to r_queue.
+//               This Asteroid must exist until r_queue is
+//               executed.
+//
+	void addLevelOfDetailToRenderQueue (RenderQueue& r_queue,
+	                                    unsigned int pass,
+	                                    unsigned int level) const;
+
+//
+//  setVertexBufferModels
+//
+//  Purpose: To set the VertexBufferModels used to display this
+//           Asteroid at each level of detail.
+//  Parameter(s):
+//    <1> v_vertex_buffer_models: The VertexBufferModels, from
+//                                most to least detailed,
+//                                normally created with the
+//                                radii returned by
+//                                calculateVertexRadii
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> !v_vertex_buffer_models.empty()
+//    <3> v_vertex_buffer_models[i].isReady()
+//        WHERE 0 <= i < v_vertex_buffer_models.size()
+//  Returns: N/A
+//  Side Effect: This Asteroid is set to be displayed with
+//               v_vertex_buffer_models[0], and with
+//               v_vertex_buffer_models[i] at level of detail i.
+//
+	void setVertexBufferModels (
+	        const std::vector<ObjLibrary::VertexBufferModel>& v_vertex_buffer_models);
+#endif
+
+//
+//  initRadiusCubemap
+//
+//  Purpose: To sample the surface radius of this Asteroid into
+//           its radius cubemap.  This does not use OpenGL or
+//           random numbers, so it can be run on any thread.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: The radius cubemap is filled.
+//
+	void initRadiusCubemap ();
+
 //
 //  removeCrystals
 //
@@ -249,8 +548,61 @@ public:
 	virtual void updatePhysics (double delta_time,
 	                            const Entity& black_hole);
 
+//
+//  updatePhysicsOnRails
+//
+//  Purpose: To perform the physics updates for this Entity
+//           for one time step by following its exact orbit
+//           around the black hole.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//    <2> black_hole: The black hole
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: This Entity is updated for one time step.  This
+//               includes rotation.
+//
+	virtual void updatePhysicsOnRails (double delta_time,
+	                                   const Entity& black_hole);
+
+//
+//  updateRotation
+//
+//  Purpose: To perform only the rotation part of the physics
+//           update for one time step.  This is used when the
+//           motion has been calculated somewhere else (e.g. in
+//           a BodyStore).
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: This Asteroid is rotated for one time step.
+//
+	void updateRotation (double delta_time);
+
 private:
 //
+//  Helper Function: calculateLocalRadius
+//
+//  Purpose: To evaluate the surface radius of this Asteroid in
+//           the specified direction in local coordinates.
+//  Parameter(s):
+//    <1> local_direction: The direction in local coordinates
+//  Preconditions:
+//    <1> local_direction.isUnit()
+//  Returns: The distance from the Asteroid origin to its
+//           surface in direction local_direction.
+//  Side Effect: N/A
+//
+	double calculateLocalRadius (
+	             const ObjLibrary::Vector3& local_direction) const;
+
+#ifndef HEADLESS_SIMULATION
+//
 //  drawSurfaceMarker
 //
 //  Purpose: To display a markers showing the distance to the
@@ -271,6 +623,7 @@ private:
 	void drawSurfaceMarker (
 	                   const ObjLibrary::Vector3& direction,
 	                   const ObjLibrary::Vector3& colour) const;
+#endif
 
 //
 //  invariant
@@ -289,6 +642,10 @@ private:
 	ObjLibrary::Vector3 m_rotation_axis;
 	double m_rotation_rate;
 	bool m_is_crystals;
+	RadiusCubemap m_radius_cubemap;
+#ifndef HEADLESS_SIMULATION
+	std::vector<ObjLibrary::VertexBufferModel> mv_vertex_buffer_models;
+#endif
 };
 
 
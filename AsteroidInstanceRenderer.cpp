@@ -0,0 +1,711 @@
+//
+//  AsteroidInstanceRenderer.cpp
+//
+//  This file is only used for display, so it is empty if
+//    HEADLESS_SIMULATION is defined.
+//
+
+#ifndef HEADLESS_SIMULATION
+
+#include "AsteroidInstanceRenderer.h"
+
+#include <cassert>
+#include <cstddef>  // for NULL, ptrdiff_t
+#include <cmath>
+#include <iostream>
+#include <sstream>
+#include <iomanip>
+#include <string>
+#include <vector>
+
+// ask for the OpenGL 2.0+ function declarations on Linux
+#ifndef GL_GLEXT_PROTOTYPES
+	#define GL_GLEXT_PROTOTYPES
+#endif
+#include "GetGlut.h"
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/VertexBufferModel.h"
+
+#include "PerlinNoiseField3.h"
+#include "Asteroid.h"
+#include "AsteroidMesh.h"
+#include "World.h"
+
+// the Windows headers only go up to OpenGL 1.1
+#ifndef GL_ARRAY_BUFFER
+	#define GL_ARRAY_BUFFER     0x8892
+#endif
+#ifndef GL_STREAM_DRAW
+	#define GL_STREAM_DRAW      0x88E0
+#endif
+#ifndef GL_FRAGMENT_SHADER
+	#define GL_FRAGMENT_SHADER  0x8B30
+#endif
+#ifndef GL_VERTEX_SHADER
+	#define GL_VERTEX_SHADER    0x8B31
+#endif
+#ifndef GL_COMPILE_STATUS
+	#define GL_COMPILE_STATUS   0x8B81
+#endif
+#ifndef GL_LINK_STATUS
+	#define GL_LINK_STATUS      0x8B82
+#endif
+#ifndef GL_INFO_LOG_LENGTH
+	#define GL_INFO_LOG_LENGTH  0x8B84
+#endif
+
+// instancing is never available on Mac computers, see
+//   VertexBufferModel::isInstancingAvailable
+#ifdef __APPLE__
+	#define glVertexAttribDivisor(index, divisor)
+#endif
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int SUPPORT_UNKNOWN = 0;
+	const unsigned int SUPPORT_YES     = 1;
+	const unsigned int SUPPORT_NO      = 2;
+	unsigned int g_support = SUPPORT_UNKNOWN;
+
+	// the rows of the local-to-world matrix, then the noise
+	//   cell and fraction
+	const unsigned int INSTANCE_ATTRIBUTE_COUNT = 5;
+	const unsigned int FLOATS_PER_ATTRIBUTE     = 4;
+
+	// some graphics cards alias the fixed-function attributes to
+	//   generic ones, so avoid gl_Vertex (0), gl_Normal (2),
+	//   gl_Color (3), and gl_MultiTexCoord0 (8)
+	const unsigned int INSTANCE_ATTRIBUTE_FIRST = 10;
+
+	const char* A_INSTANCE_ATTRIBUTE_NAMES[INSTANCE_ATTRIBUTE_COUNT] =
+	{
+		"a_instance_row0",
+		"a_instance_row1",
+		"a_instance_row2",
+		"a_instance_noise_cell",
+		"a_instance_noise_fraction",
+	};
+
+#ifdef _WIN32
+	//
+	//  Windows only exports the OpenGL 1.1 functions, so the
+	//    shader and buffer functions are found at run time by
+	//    isAvailable.  These have the same names as the real
+	//    functions so the code using them is the same on every
+	//    platform.
+	//
+
+	typedef GLuint (APIENTRY *CreateShaderFunction)      (GLenum type);
+	typedef void   (APIENTRY *ShaderSourceFunction)      (GLuint shader, GLsizei count, const char* const* a_strings, const GLint* a_lengths);
+	typedef void   (APIENTRY *CompileShaderFunction)     (GLuint shader);
+	typedef void   (APIENTRY *GetShaderivFunction)       (GLuint shader, GLenum name, GLint* p_value);
+	typedef void   (APIENTRY *GetShaderInfoLogFunction)  (GLuint shader, GLsizei max_length, GLsizei* p_length, char* a_log);
+	typedef void   (APIENTRY *DeleteShaderFunction)      (GLuint shader);
+	typedef GLuint (APIENTRY *CreateProgramFunction)     ();
+	typedef void   (APIENTRY *AttachShaderFunction)      (GLuint program, GLuint shader);
+	typedef void   (APIENTRY *BindAttribLocationFunction)(GLuint program, GLuint index, const char* a_name);
+	typedef void   (APIENTRY *LinkProgramFunction)       (GLuint program);
+	typedef void   (APIENTRY *GetProgramivFunction)      (GLuint program, GLenum name, GLint* p_value);
+	typedef void   (APIENTRY *GetProgramInfoLogFunction) (GLuint program, GLsizei max_length, GLsizei* p_length, char* a_log);
+	typedef void   (APIENTRY *DeleteProgramFunction)     (GLuint program);
+	typedef void   (APIENTRY *UseProgramFunction)        (GLuint program);
+	typedef GLint  (APIENTRY *GetUniformLocationFunction)(GLuint program, const char* a_name);
+	typedef void   (APIENTRY *Uniform1iFunction)         (GLint location, GLint value);
+	typedef void   (APIENTRY *EnableVertexAttribArrayFunction)  (GLuint index);
+	typedef void   (APIENTRY *DisableVertexAttribArrayFunction) (GLuint index);
+	typedef void   (APIENTRY *VertexAttribPointerFunction)      (GLuint index, GLint size, GLenum type, GLboolean is_normalized, GLsizei stride, const void* p_pointer);
+	typedef void   (APIENTRY *VertexAttribDivisorFunction)      (GLuint index, GLuint divisor);
+	typedef void   (APIENTRY *GenBuffersFunction)    (GLsizei n, GLuint* a_buffers);
+	typedef void   (APIENTRY *DeleteBuffersFunction) (GLsizei n, const GLuint* a_buffers);
+	typedef void   (APIENTRY *BindBufferFunction)    (GLenum target, GLuint buffer);
+	typedef void   (APIENTRY *BufferDataFunction)    (GLenum target, ptrdiff_t size, const void* p_data, GLenum usage);
+
+	CreateShaderFunction       glCreateShader       = NULL;
+	ShaderSourceFunction       glShaderSource       = NULL;
+	CompileShaderFunction      glCompileShader      = NULL;
+	GetShaderivFunction        glGetShaderiv        = NULL;
+	GetShaderInfoLogFunction   glGetShaderInfoLog   = NULL;
+	DeleteShaderFunction       glDeleteShader       = NULL;
+	CreateProgramFunction      glCreateProgram      = NULL;
+	AttachShaderFunction       glAttachShader       = NULL;
+	BindAttribLocationFunction glBindAttribLocation = NULL;
+	LinkProgramFunction        glLinkProgram        = NULL;
+	GetProgramivFunction       glGetProgramiv       = NULL;
+	GetProgramInfoLogFunction  glGetProgramInfoLog  = NULL;
+	DeleteProgramFunction      glDeleteProgram      = NULL;
+	UseProgramFunction         glUseProgram         = NULL;
+	GetUniformLocationFunction glGetUniformLocation = NULL;
+	Uniform1iFunction          glUniform1i          = NULL;
+	EnableVertexAttribArrayFunction  glEnableVertexAttribArray  = NULL;
+	DisableVertexAttribArrayFunction glDisableVertexAttribArray = NULL;
+	VertexAttribPointerFunction      glVertexAttribPointer      = NULL;
+	VertexAttribDivisorFunction      glVertexAttribDivisor      = NULL;
+	GenBuffersFunction    glGenBuffers    = NULL;
+	DeleteBuffersFunction glDeleteBuffers = NULL;
+	BindBufferFunction    glBindBuffer    = NULL;
+	BufferDataFunction    glBufferData    = NULL;
+
+//
+//  loadFunction
+//
+//  Purpose: To find an OpenGL function by name.
+//  Parameter(s):
+//    <1> r_function: A reference to the function pointer to set
+//    <2> a_name: The name of the function
+//  Preconditions:
+//    <1> a_name != NULL
+//  Returns: Whether the function was found.
+//  Side Effect: r_function is set to the function, or to NULL
+//               if it is not available.
+//
+	template <typename FunctionType>
+	bool loadFunction (FunctionType& r_function, const char* a_name)
+	{
+		assert(a_name != NULL);
+
+		r_function = (FunctionType)(glutGetProcAddress(a_name));
+		return r_function != NULL;
+	}
+
+//
+//  loadFunctions
+//
+//  Purpose: To find the OpenGL functions needed for instanced
+//           asteroid drawing.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether all the functions were found.
+//  Side Effect: The function pointers are set.
+//
+	bool loadFunctions ()
+	{
+		bool is_loaded = true;
+		is_loaded &= loadFunction(glCreateShader,       "glCreateShader");
+		is_loaded &= loadFunction(glShaderSource,       "glShaderSource");
+		is_loaded &= loadFunction(glCompileShader,      "glCompileShader");
+		is_loaded &= loadFunction(glGetShaderiv,        "glGetShaderiv");
+		is_loaded &= loadFunction(glGetShaderInfoLog,   "glGetShaderInfoLog");
+		is_loaded &= loadFunction(glDeleteShader,       "glDeleteShader");
+		is_loaded &= loadFunction(glCreateProgram,      "glCreateProgram");
+		is_loaded &= loadFunction(glAttachShader,       "glAttachShader");
+		is_loaded &= loadFunction(glBindAttribLocation, "glBindAttribLocation");
+		is_loaded &= loadFunction(glLinkProgram,        "glLinkProgram");
+		is_loaded &= loadFunction(glGetProgramiv,       "glGetProgramiv");
+		is_loaded &= loadFunction(glGetProgramInfoLog,  "glGetProgramInfoLog");
+		is_loaded &= loadFunction(glDeleteProgram,      "glDeleteProgram");
+		is_loaded &= loadFunction(glUseProgram,         "glUseProgram");
+		is_loaded &= loadFunction(glGetUniformLocation, "glGetUniformLocation");
+		is_loaded &= loadFunction(glUniform1i,          "glUniform1i");
+		is_loaded &= loadFunction(glEnableVertexAttribArray,  "glEnableVertexAttribArray");
+		is_loaded &= loadFunction(glDisableVertexAttribArray, "glDisableVertexAttribArray");
+		is_loaded &= loadFunction(glVertexAttribPointer,      "glVertexAttribPointer");
+		is_loaded &= loadFunction(glVertexAttribDivisor,      "glVertexAttribDivisor");
+		is_loaded &= loadFunction(glGenBuffers,    "glGenBuffers");
+		is_loaded &= loadFunction(glDeleteBuffers, "glDeleteBuffers");
+		is_loaded &= loadFunction(glBindBuffer,    "glBindBuffer");
+		is_loaded &= loadFunction(glBufferData,    "glBufferData");
+		return is_loaded;
+	}
+#endif
+
+//
+//  createVertexShaderSource
+//
+//  Purpose: To create the source code for the vertex shader.
+//  Parameter(s):
+//    <1> noise: The noise field used to shape the asteroids
+//  Preconditions: N/A
+//  Returns: The source code for a vertex shader that evaluates
+//           noise with the same seeds, grid size, and
+//           amplitude.
+//  Side Effect: N/A
+//
+	string createVertexShaderSource (const PerlinNoiseField3& noise)
+	{
+		unsigned int a_seeds[PerlinNoiseField3::SEED_COUNT];
+		noise.getSeeds(a_seeds);
+
+		stringstream ss;
+		ss << setprecision(9);
+		ss << "#version 130\n";
+		ss << "\n";
+		ss << "const uint SEED_X1 = " << a_seeds[0] << "u;\n";
+		ss << "const uint SEED_X2 = " << a_seeds[1] << "u;\n";
+		ss << "const uint SEED_Y1 = " << a_seeds[2] << "u;\n";
+		ss << "const uint SEED_Y2 = " << a_seeds[3] << "u;\n";
+		ss << "const uint SEED_Z1 = " << a_seeds[4] << "u;\n";
+		ss << "const uint SEED_Z2 = " << a_seeds[5] << "u;\n";
+		ss << "const uint SEED_Q0 = " << a_seeds[6] << "u;\n";
+		ss << "const uint SEED_Q1 = " << a_seeds[7] << "u;\n";
+		ss << "const uint SEED_Q2 = " << a_seeds[8] << "u;\n";
+		ss << "const float GRID_SIZE = " << fixed << noise.getGridSize() << ";\n";
+		ss << "const float AMPLITUDE = " << fixed << noise.getAmplitude() << ";\n";
+		ss << "const float PI = 3.14159265;\n";
+		ss << "\n";
+		ss << "in vec4 a_instance_row0;\n";
+		ss << "in vec4 a_instance_row1;\n";
+		ss << "in vec4 a_instance_row2;\n";
+		ss << "in vec4 a_instance_noise_cell;      // w is average radius\n";
+		ss << "in vec4 a_instance_noise_fraction;  // w is half radius range\n";
+		ss << "\n";
+		ss << "uniform bool u_is_lighting;\n";
+		ss << "\n";
+		// same as PerlinNoiseField3::pseudorandom, with wrapping
+		//   unsigned arithmetic
+		ss << "uint pseudorandom (ivec3 cell)\n";
+		ss << "{\n";
+		ss << "	uvec3 u = uvec3(cell);\n";
+		ss << "	uint n = SEED_X1 * u.x + SEED_Y1 * u.y + SEED_Z1 * u.z;\n";
+		ss << "	uint quad_term = SEED_Q2 * n * n + SEED_Q1 * n + SEED_Q0;\n";
+		ss << "	return quad_term + SEED_X2 * u.x + SEED_Y2 * u.y + SEED_Z2 * u.z;\n";
+		ss << "}\n";
+		ss << "\n";
+		// same as PerlinNoiseField3::calculateLattice
+		ss << "vec3 lattice (ivec3 cell)\n";
+		ss << "{\n";
+		ss << "	float seed1 = float(pseudorandom(cell))              / 4294967295.0;\n";
+		ss << "	float seed2 = float(pseudorandom(cell + ivec3(1))) / 4294967295.0;\n";
+		ss << "	float xy_angle = seed1 * 2.0 * PI;\n";
+		ss << "	float z = seed2 * 2.0 - 1.0;\n";
+		ss << "	float radius_xy = sqrt(max(1.0 - z * z, 0.0));\n";
+		ss << "	return vec3(radius_xy * cos(xy_angle), radius_xy * sin(xy_angle), z);\n";
+		ss << "}\n";
+		ss << "\n";
+		ss << "vec3 fade (vec3 n)\n";
+		ss << "{\n";
+		ss << "	return (1.0 - cos(n * PI)) * 0.5;\n";
+		ss << "}\n";
+		ss << "\n";
+		// same as PerlinNoiseField3::perlinNoiseInCell
+		ss << "float perlinNoise (ivec3 cell, vec3 fraction)\n";
+		ss << "{\n";
+		ss << "	float value000 = dot(lattice(cell + ivec3(0, 0, 0)), vec3(0.0, 0.0, 0.0) - fraction);\n";
+		ss << "	float value001 = dot(lattice(cell + ivec3(0, 0, 1)), vec3(0.0, 0.0, 1.0) - fraction);\n";
+		ss << "	float value010 = dot(lattice(cell + ivec3(0, 1, 0)), vec3(0.0, 1.0, 0.0) - fraction);\n";
+		ss << "	float value011 = dot(lattice(cell + ivec3(0, 1, 1)), vec3(0.0, 1.0, 1.0) - fraction);\n";
+		ss << "	float value100 = dot(lattice(cell + ivec3(1, 0, 0)), vec3(1.0, 0.0, 0.0) - fraction);\n";
+		ss << "	float value101 = dot(lattice(cell + ivec3(1, 0, 1)), vec3(1.0, 0.0, 1.0) - fraction);\n";
+		ss << "	float value110 = dot(lattice(cell + ivec3(1, 1, 0)), vec3(1.0, 1.0, 0.0) - fraction);\n";
+		ss << "	float value111 = dot(lattice(cell + ivec3(1, 1, 1)), vec3(1.0, 1.0, 1.0) - fraction);\n";
+		ss << "\n";
+		ss << "	vec3 faded = fade(fraction);\n";
+		ss << "	float value00 = mix(value000, value001, faded.z);\n";
+		ss << "	float value01 = mix(value010, value011, faded.z);\n";
+		ss << "	float value10 = mix(value100, value101, faded.z);\n";
+		ss << "	float value11 = mix(value110, value111, faded.z);\n";
+		ss << "	float value0  = mix(value00,  value01,  faded.y);\n";
+		ss << "	float value1  = mix(value10,  value11,  faded.y);\n";
+		ss << "	return mix(value0, value1, faded.x) * AMPLITUDE;\n";
+		ss << "}\n";
+		ss << "\n";
+		ss << "void main ()\n";
+		ss << "{\n";
+		ss << "	vec3 direction = normalize(gl_Vertex.xyz);\n";
+		ss << "\n";
+		ss << "	// whole cells are kept as integers to avoid rounding errors\n";
+		ss << "	vec3 in_cells = direction / GRID_SIZE + a_instance_noise_fraction.xyz;\n";
+		ss << "	vec3 floor_in_cells = floor(in_cells);\n";
+		ss << "	ivec3 cell = ivec3(a_instance_noise_cell.xyz) + ivec3(floor_in_cells);\n";
+		ss << "	float noise = perlinNoise(cell, in_cells - floor_in_cells);\n";
+		ss << "	float radius = a_instance_noise_cell.w + noise * a_instance_noise_fraction.w;\n";
+		ss << "\n";
+		ss << "	vec4 local = vec4(direction * radius, 1.0);\n";
+		ss << "	vec4 world = vec4(dot(a_instance_row0, local),\n";
+		ss << "	                  dot(a_instance_row1, local),\n";
+		ss << "	                  dot(a_instance_row2, local),\n";
+		ss << "	                  1.0);\n";
+		ss << "	gl_Position = gl_ModelViewProjectionMatrix * world;\n";
+		ss << "	gl_TexCoord[0] = gl_TextureMatrix[0] * gl_MultiTexCoord0;\n";
+		ss << "\n";
+		ss << "	if(u_is_lighting)\n";
+		ss << "	{\n";
+		ss << "		vec3 world_normal = vec3(dot(a_instance_row0.xyz, gl_Normal),\n";
+		ss << "		                         dot(a_instance_row1.xyz, gl_Normal),\n";
+		ss << "		                         dot(a_instance_row2.xyz, gl_Normal));\n";
+		ss << "		vec3 normal = normalize(gl_NormalMatrix * world_normal);\n";
+		ss << "		vec4 eye = gl_ModelViewMatrix * world;\n";
+		ss << "		vec4 light_position = gl_LightSource[0].position;\n";
+		ss << "		vec3 to_light = normalize(light_position.xyz - eye.xyz * light_position.w);\n";
+		ss << "		float diffuse = max(dot(normal, to_light), 0.0);\n";
+		ss << "		gl_FrontColor = gl_FrontLightModelProduct.sceneColor +\n";
+		ss << "		                gl_FrontLightProduct[0].ambient +\n";
+		ss << "		                gl_FrontLightProduct[0].diffuse * diffuse;\n";
+		ss << "		gl_FrontColor.a = gl_FrontMaterial.diffuse.a;\n";
+		ss << "	}\n";
+		ss << "	else\n";
+		ss << "		gl_FrontColor = gl_Color;\n";
+		ss << "}\n";
+		return ss.str();
+	}
+
+	const char* FRAGMENT_SHADER_SOURCE =
+		"#version 130\n"
+		"\n"
+		"uniform bool u_is_texture;\n"
+		"uniform sampler2D u_texture;\n"
+		"\n"
+		"void main ()\n"
+		"{\n"
+		"	gl_FragColor = gl_Color;\n"
+		"	if(u_is_texture)\n"
+		"		gl_FragColor *= texture(u_texture, gl_TexCoord[0].st);\n"
+		"}\n";
+
+//
+//  compileShader
+//
+//  Purpose: To compile a shader.
+//  Parameter(s):
+//    <1> type: The type of shader
+//    <2> source: The source code
+//  Preconditions: N/A
+//  Returns: The shader, or 0 if it could not be compiled.
+//  Side Effect: If the shader could not be compiled, the errors
+//               are written to the standard error stream.
+//
+	unsigned int compileShader (GLenum type, const string& source)
+	{
+		GLuint shader = glCreateShader(type);
+		if(shader == 0)
+			return 0;
+
+		const char* a_source = source.c_str();
+		glShaderSource(shader, 1, &a_source, NULL);
+		glCompileShader(shader);
+
+		GLint is_compiled = GL_FALSE;
+		glGetShaderiv(shader, GL_COMPILE_STATUS, &is_compiled);
+		if(is_compiled == GL_FALSE)
+		{
+			GLint log_length = 0;
+			glGetShaderiv(shader, GL_INFO_LOG_LENGTH, &log_length);
+			vector<char> v_log(log_length + 1, '\0');
+			glGetShaderInfoLog(shader, log_length, NULL, v_log.data());
+			cerr << "Could not compile asteroid "
+			     << ((type == GL_VERTEX_SHADER) ? "vertex" : "fragment")
+			     << " shader:" << endl;
+			cerr << v_log.data() << endl;
+
+			glDeleteShader(shader);
+			return 0;
+		}
+		return shader;
+	}
+
+//
+//  linkProgram
+//
+//  Purpose: To link the shaders for instanced asteroid drawing
+//           into a program.
+//  Parameter(s):
+//    <1> vertex_shader: The vertex shader
+//    <2> fragment_shader: The fragment shader
+//  Preconditions:
+//    <1> vertex_shader != 0
+//    <2> fragment_shader != 0
+//  Returns: The program, or 0 if it could not be linked.
+//  Side Effect: The instance attributes are bound to their
+//               locations.  If the program could not be
+//               linked, the errors are written to the standard
+//               error stream.
+//
+	unsigned int linkProgram (unsigned int vertex_shader,
+	                          unsigned int fragment_shader)
+	{
+		assert(vertex_shader != 0);
+		assert(fragment_shader != 0);
+
+		GLuint program = glCreateProgram();
+		if(program == 0)
+			return 0;
+
+		glAttachShader(program, vertex_shader);
+		glAttachShader(program, fragment_shader);
+		for(unsigned int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; i++)
+			glBindAttribLocation(program, INSTANCE_ATTRIBUTE_FIRST + i, A_INSTANCE_ATTRIBUTE_NAMES[i]);
+		glLinkProgram(program);
+
+		GLint is_linked = GL_FALSE;
+		glGetProgramiv(program, GL_LINK_STATUS, &is_linked);
+		if(is_linked == GL_FALSE)
+		{
+			GLint log_length = 0;
+			glGetProgramiv(program, GL_INFO_LOG_LENGTH, &log_length);
+			vector<char> v_log(log_length + 1, '\0');
+			glGetProgramInfoLog(program, log_length, NULL, v_log.data());
+			cerr << "Could not link asteroid shader:" << endl;
+			cerr << v_log.data() << endl;
+
+			glDeleteProgram(program);
+			return 0;
+		}
+		return program;
+	}
+
+	// one bucket of instances for each AsteroidMesh at each LOD
+	const unsigned int MESH_BUCKET_COUNT = World::ASTEROID_MODEL_COUNT * World::ASTEROID_LOD_COUNT;
+
+}  // end of anonymous namespace
+
+
+
+bool AsteroidInstanceRenderer :: isAvailable ()
+{
+	assert(DisplayList::isGlutInitialized());
+
+	if(g_support == SUPPORT_UNKNOWN)
+	{
+		bool is_available = VertexBufferModel::isInstancingAvailable();
+#ifdef _WIN32
+		if(is_available)
+			is_available = loadFunctions();
+#endif
+		g_support = is_available ? SUPPORT_YES : SUPPORT_NO;
+	}
+
+	assert(g_support != SUPPORT_UNKNOWN);
+	return g_support == SUPPORT_YES;
+}
+
+
+
+AsteroidInstanceRenderer :: AsteroidInstanceRenderer ()
+		: m_program(0)
+		, m_instance_buffer(0)
+		, m_is_texture_location(-1)
+		, m_is_lighting_location(-1)
+		, m_draw_call_count(0)
+		, mv_instance_data()
+		, mv_mesh_first_instances(MESH_BUCKET_COUNT, 0)
+		, mv_mesh_instance_counts(MESH_BUCKET_COUNT, 0)
+		, mv_mesh_next_instances(MESH_BUCKET_COUNT, 0)
+{
+	assert(!isInitialized());
+	assert(invariant());
+}
+
+AsteroidInstanceRenderer :: ~AsteroidInstanceRenderer ()
+{
+	if(isInitialized() && !DisplayList::isDisabledForExit())
+	{
+		glDeleteProgram(m_program);
+		glDeleteBuffers(1, &m_instance_buffer);
+	}
+}
+
+
+
+void AsteroidInstanceRenderer :: init ()
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(isAvailable());
+	assert(!isInitialized());
+
+	unsigned int vertex_shader   = compileShader(GL_VERTEX_SHADER,
+	                                             createVertexShaderSource(Asteroid::getNoiseField()));
+	unsigned int fragment_shader = compileShader(GL_FRAGMENT_SHADER, FRAGMENT_SHADER_SOURCE);
+
+	unsigned int program = 0;
+	if(vertex_shader != 0 && fragment_shader != 0)
+		program = linkProgram(vertex_shader, fragment_shader);
+
+	// the program keeps the shaders it needs
+	if(vertex_shader != 0)
+		glDeleteShader(vertex_shader);
+	if(fragment_shader != 0)
+		glDeleteShader(fragment_shader);
+
+	if(program == 0)
+	{
+		assert(!isInitialized());
+		return;
+	}
+
+	m_is_texture_location  = glGetUniformLocation(program, "u_is_texture");
+	m_is_lighting_location = glGetUniformLocation(program, "u_is_lighting");
+	glUseProgram(program);
+		glUniform1i(glGetUniformLocation(program, "u_texture"), 0);
+	glUseProgram(0);
+
+	GLuint instance_buffer = 0;
+	glGenBuffers(1, &instance_buffer);
+
+	m_program         = program;
+	m_instance_buffer = instance_buffer;
+
+	assert(isInitialized());
+	assert(invariant());
+}
+
+void AsteroidInstanceRenderer :: draw (const World& world,
+                                       const std::vector<unsigned int>& v_asteroids,
+                                       const std::vector<unsigned int>& v_levels)
+{
+	assert(isInitialized());
+	assert(world.isDisplayed());
+	assert(!Material::isMaterialActive());
+	assert(v_levels.size() == world.getAsteroidCount());
+
+	static const unsigned int INSTANCE_STRIDE = FLOATS_PER_INSTANCE * sizeof(float);
+
+	m_draw_call_count = 0;
+
+	fillInstances(world, v_asteroids, v_levels);
+	if(mv_instance_data.empty())
+		return;
+
+	glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+	glBufferData(GL_ARRAY_BUFFER, mv_instance_data.size() * sizeof(float),
+	             mv_instance_data.data(), GL_STREAM_DRAW);
+
+	glUseProgram(m_program);
+	for(unsigned int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; i++)
+	{
+		glEnableVertexAttribArray(INSTANCE_ATTRIBUTE_FIRST + i);
+		glVertexAttribDivisor(INSTANCE_ATTRIBUTE_FIRST + i, 1);
+	}
+
+	// the meshes usually share a Material
+	bool is_state_cache_enabled = Material::isStateCacheEnabled();
+	Material::setStateCacheEnabled(true);
+
+	for(unsigned int b = 0; b < MESH_BUCKET_COUNT; b++)
+	{
+		unsigned int instance_count = mv_mesh_instance_counts[b];
+		if(instance_count == 0)
+			continue;
+
+		// there is no base instance before OpenGL 4.2, so point
+		//   the attributes at the first instance for this mesh
+		glBindBuffer(GL_ARRAY_BUFFER, m_instance_buffer);
+		for(unsigned int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; i++)
+		{
+			size_t offset = (mv_mesh_first_instances[b] * FLOATS_PER_INSTANCE +
+			                 i * FLOATS_PER_ATTRIBUTE) * sizeof(float);
+			glVertexAttribPointer(INSTANCE_ATTRIBUTE_FIRST + i, FLOATS_PER_ATTRIBUTE, GL_FLOAT, GL_FALSE,
+			                      INSTANCE_STRIDE, (const void*)(offset));
+		}
+
+		unsigned int mesh  = b % World::ASTEROID_MODEL_COUNT;
+		unsigned int level = b / World::ASTEROID_MODEL_COUNT;
+		const VertexBufferModel& model = world.getAsteroidMesh(mesh, level).getBaseVertexBufferModel();
+		for(unsigned int r = 0; r < model.getMaterialRangeCount(); r++)
+		{
+			// the seperate specular pass is not displayed
+			const Material* p_material = model.getMaterialRangeMaterial(r);
+			if(p_material != NULL)
+				p_material->activate();
+
+			glUniform1i(m_is_texture_location,  glIsEnabled(GL_TEXTURE_2D));
+			glUniform1i(m_is_lighting_location, glIsEnabled(GL_LIGHTING));
+			model.drawMaterialRangeInstanced(r, instance_count);
+			m_draw_call_count++;
+
+			if(p_material != NULL)
+				Material::deactivate();
+		}
+	}
+
+	Material::setStateCacheEnabled(is_state_cache_enabled);
+
+	for(unsigned int i = 0; i < INSTANCE_ATTRIBUTE_COUNT; i++)
+	{
+		glVertexAttribDivisor(INSTANCE_ATTRIBUTE_FIRST + i, 0);
+		glDisableVertexAttribArray(INSTANCE_ATTRIBUTE_FIRST + i);
+	}
+	glUseProgram(0);
+	glBindBuffer(GL_ARRAY_BUFFER, 0);
+}
+
+
+
+void AsteroidInstanceRenderer :: fillInstances (const World& world,
+                                                const std::vector<unsigned int>& v_asteroids,
+                                                const std::vector<unsigned int>& v_levels)
+{
+	assert(world.isDisplayed());
+	assert(v_levels.size() == world.getAsteroidCount());
+
+	unsigned int asteroid_count = (unsigned int)(v_asteroids.size());
+	float grid_size = Asteroid::getNoiseField().getGridSize();
+
+	// counting sort by LOD and mesh
+	for(unsigned int b = 0; b < MESH_BUCKET_COUNT; b++)
+		mv_mesh_instance_counts[b] = 0;
+	for(unsigned int i = 0; i < asteroid_count; i++)
+	{
+		unsigned int a = v_asteroids[i];
+		assert(a < world.getAsteroidCount());
+		assert(v_levels[a] < World::ASTEROID_LOD_COUNT);
+		mv_mesh_instance_counts[v_levels[a] * World::ASTEROID_MODEL_COUNT + world.getAsteroidMeshIndex(a)]++;
+	}
+
+	unsigned int first_instance = 0;
+	for(unsigned int b = 0; b < MESH_BUCKET_COUNT; b++)
+	{
+		mv_mesh_first_instances[b] = first_instance;
+		mv_mesh_next_instances[b]  = first_instance;
+		first_instance += mv_mesh_instance_counts[b];
+	}
+	assert(first_instance == asteroid_count);
+
+	mv_instance_data.resize(asteroid_count * FLOATS_PER_INSTANCE);
+	for(unsigned int i = 0; i < asteroid_count; i++)
+	{
+		unsigned int a = v_asteroids[i];
+		assert(a < world.getAsteroidCount());
+		const Asteroid& asteroid = world.getAsteroid(a);
+		unsigned int bucket = v_levels[a] * World::ASTEROID_MODEL_COUNT + world.getAsteroidMeshIndex(a);
+		unsigned int instance = mv_mesh_next_instances[bucket];
+		mv_mesh_next_instances[bucket]++;
+		assert(instance < asteroid_count);
+		float* pa_instance = mv_instance_data.data() + instance * FLOATS_PER_INSTANCE;
+
+		// rows of the matrix from CoordinateSystem::applyDrawTransformations
+		const Vector3& forward  = asteroid.getForward();
+		const Vector3& up       = asteroid.getUp();
+		const Vector3& right    = asteroid.getRight();
+		const Vector3& position = asteroid.getPosition();
+		pa_instance[ 0] = (float)(forward.x);
+		pa_instance[ 1] = (float)(up.x);
+		pa_instance[ 2] = (float)(right.x);
+		pa_instance[ 3] = (float)(position.x);
+		pa_instance[ 4] = (float)(forward.y);
+		pa_instance[ 5] = (float)(up.y);
+		pa_instance[ 6] = (float)(right.y);
+		pa_instance[ 7] = (float)(position.y);
+		pa_instance[ 8] = (float)(forward.z);
+		pa_instance[ 9] = (float)(up.z);
+		pa_instance[10] = (float)(right.z);
+		pa_instance[11] = (float)(position.z);
+
+		// same radius calculation as Asteroid::calculateVertexRadii
+		double radius_average    = (asteroid.getRadius() + asteroid.getInnerRadius()) * 0.5;
+		double radius_half_range = (asteroid.getRadius() - asteroid.getInnerRadius()) * 0.5;
+		Vector3 offset_in_cells = asteroid.getNoiseOffset() / grid_size;
+		Vector3 cell(floor(offset_in_cells.x), floor(offset_in_cells.y), floor(offset_in_cells.z));
+		Vector3 fraction = offset_in_cells - cell;
+		pa_instance[12] = (float)(cell.x);
+		pa_instance[13] = (float)(cell.y);
+		pa_instance[14] = (float)(cell.z);
+		pa_instance[15] = (float)(radius_average);
+		pa_instance[16] = (float)(fraction.x);
+		pa_instance[17] = (float)(fraction.y);
+		pa_instance[18] = (float)(fraction.z);
+		pa_instance[19] = (float)(radius_half_range);
+	}
+}
+
+bool AsteroidInstanceRenderer :: invariant () const
+{
+	if((m_program == 0) != (m_instance_buffer == 0)) return false;
+	return true;
+}
+
+#endif
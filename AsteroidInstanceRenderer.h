@@ -0,0 +1,241 @@
+//
+//  AsteroidInstanceRenderer.h
+//
+//  A module to display all the asteroids in a World with
+//    instanced drawing.
+//
+
+#pragma once
+
+#include <vector>
+
+class World;
+
+
+
+//
+//  AsteroidInstanceRenderer
+//
+//  A class to display the asteroids in a World with one draw
+//    call for each shared AsteroidMesh, instead of one for each
+//    asteroid.  Each asteroid is an instance described by
+//    FLOATS_PER_INSTANCE floats: the rows of its local-to-world
+//    matrix, its average radius and radius range, and its noise
+//    offset.  The vertex shader evaluates the same Perlin noise
+//    as Asteroid to move each vertex of the unit sphere mesh to
+//    the asteroid surface, so the only work on the CPU is
+//    filling the instance buffer.
+//
+//  The noise offset is split into whole grid cells and a
+//    fraction of a cell on the CPU, so the noise lattice is
+//    found exactly even though the shader uses single
+//    precision.  The noise values can still differ from the
+//    ones calculated on the CPU by a rounding error.
+//
+//  The shader reproduces the OpenGL fixed-function pipeline for
+//    the materials used by the asteroids: a texture modulated
+//    by the current colour, or, if lighting is enabled, by the
+//    ambient and diffuse lighting from light 0.  Specular
+//    highlights and the second pass for seperate specular
+//    materials are not displayed.
+//
+//  Each asteroid is displayed at the level of detail (LOD)
+//    chosen for it, so there is one draw call for each
+//    AsteroidMesh and LOD that is used.
+//
+//  Instanced drawing requires OpenGL 3.3.  If it is not
+//    available, or the shader cannot be compiled, an
+//    AsteroidInstanceRenderer cannot be initialized and the
+//    asteroids should be drawn one at a time.
+//
+//  Class Invariant:
+//    <1> (m_program == 0) == (m_instance_buffer == 0)
+//
+class AsteroidInstanceRenderer
+{
+public:
+//
+//  FLOATS_PER_INSTANCE
+//
+//  The number of floats stored for each asteroid in the
+//    instance buffer.
+//
+	static const unsigned int FLOATS_PER_INSTANCE = 20;
+
+//
+//  Class Function: isAvailable
+//
+//  Purpose: To determine if the current OpenGL context supports
+//           instanced asteroid drawing.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> ObjLibrary::DisplayList::isGlutInitialized()
+//  Returns: Whether an AsteroidInstanceRenderer can be
+//           initialized.
+//  Side Effect: The first time this function is called, the
+//               OpenGL functions it needs are found if
+//               necessary.
+//
+	static bool isAvailable ();
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an AsteroidInstanceRenderer that is not
+//           initialized.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new AsteroidInstanceRenderer is created.
+//
+	AsteroidInstanceRenderer ();
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this AsteroidInstanceRenderer.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The shader and instance buffer are destroyed.
+//               As for DisplayLists, nothing is destroyed if
+//               ObjLibrary::DisplayList::isDisabledForExit().
+//
+	~AsteroidInstanceRenderer ();
+
+	AsteroidInstanceRenderer (const AsteroidInstanceRenderer& to_copy) = delete;
+	AsteroidInstanceRenderer& operator= (const AsteroidInstanceRenderer& to_copy) = delete;
+
+//
+//  isInitialized
+//
+//  Purpose: To determine if this AsteroidInstanceRenderer can
+//           display asteroids.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this AsteroidInstanceRenderer has been
+//           initialized successfully.
+//  Side Effect: N/A
+//
+	bool isInitialized () const
+	{
+		return m_program != 0;
+	}
+
+//
+//  getDrawCallCount
+//
+//  Purpose: To determine how many draw calls were used the last
+//           time the asteroids were displayed.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of instanced draw calls made by the
+//           most recent call to draw.
+//  Side Effect: N/A
+//
+	unsigned int getDrawCallCount () const
+	{
+		return m_draw_call_count;
+	}
+
+//
+//  init
+//
+//  Purpose: To prepare this AsteroidInstanceRenderer for use.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> ObjLibrary::DisplayList::isGlutInitialized()
+//    <2> !ObjLibrary::DisplayList::isDisabledForExit()
+//    <3> isAvailable()
+//    <4> !isInitialized()
+//  Returns: N/A
+//  Side Effect: The shader is compiled and the instance buffer
+//               is created.  If the shader cannot be compiled,
+//               the errors are written to the standard error
+//               stream and this AsteroidInstanceRenderer
+//               remains uninitialized.
+//
+	void init ();
+
+//
+//  draw
+//
+//  Purpose: To display the specified asteroids in the
+//           specified World.
+//  Parameter(s):
+//    <1> world: The World
+//    <2> v_asteroids: The indexes of the asteroids to display
+//    <3> v_levels: The LOD to display each asteroid at, indexed
+//                  by asteroid
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> world.isDisplayed()
+//    <3> !ObjLibrary::Material::isMaterialActive()
+//    <4> v_asteroids[i] < world.getAsteroidCount()
+//        WHERE 0 <= i < v_asteroids.size()
+//    <5> v_levels.size() == world.getAsteroidCount()
+//    <6> v_levels[i] < World::ASTEROID_LOD_COUNT
+//        WHERE 0 <= i < v_levels.size()
+//  Returns: N/A
+//  Side Effect: The asteroids in v_asteroids are displayed with
+//               one instanced draw call for each material range
+//               of each AsteroidMesh and LOD that is used.  The shader,
+//               buffer bindings, and vertex attributes are
+//               restored afterwards.
+//
+	void draw (const World& world,
+	           const std::vector<unsigned int>& v_asteroids,
+	           const std::vector<unsigned int>& v_levels);
+
+private:
+//
+//  fillInstances
+//
+//  Purpose: To fill the instance data for the specified
+//           asteroids in the specified World.
+//  Parameter(s):
+//    <1> world: The World
+//    <2> v_asteroids: The indexes of the asteroids
+//    <3> v_levels: The LOD for each asteroid
+//  Preconditions:
+//    <1> world.isDisplayed()
+//    <2> v_asteroids[i] < world.getAsteroidCount()
+//        WHERE 0 <= i < v_asteroids.size()
+//    <3> v_levels.size() == world.getAsteroidCount()
+//  Returns: N/A
+//  Side Effect: mv_instance_data is filled with the asteroids in
+//               v_asteroids, sorted by LOD and then AsteroidMesh.
+//               The instances for mesh m at LOD l start at
+//               mv_mesh_first_instances[b] and there are
+//               mv_mesh_instance_counts[b] of them, where b is
+//               l * World::ASTEROID_MODEL_COUNT + m.
+//
+	void fillInstances (const World& world,
+	                    const std::vector<unsigned int>& v_asteroids,
+	                    const std::vector<unsigned int>& v_levels);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int m_program;
+	unsigned int m_instance_buffer;
+	int m_is_texture_location;
+	int m_is_lighting_location;
+	unsigned int m_draw_call_count;
+
+	// reused between frames to avoid allocations
+	std::vector<float> mv_instance_data;
+	std::vector<unsigned int> mv_mesh_first_instances;
+	std::vector<unsigned int> mv_mesh_instance_counts;
+	std::vector<unsigned int> mv_mesh_next_instances;
+};
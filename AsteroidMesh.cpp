@@ -0,0 +1,248 @@
+//
+//  AsteroidMesh.cpp
+//
+//  This file is only used for display, so it is empty if
+//    HEADLESS_SIMULATION is defined.
+//
+
+#ifndef HEADLESS_SIMULATION
+
+#include "AsteroidMesh.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/VertexBufferModel.h"
+
+#include "Asteroid.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double PI = 3.1415926535897932384626433832795;
+
+	// the asteroid base models start their texture at this
+	//   angle around the Y axis and wrap it clockwise
+	const double TEXTURE_START_RADIANS = -PI / 10.0;
+
+//
+//  addSphereVertex
+//
+//  Purpose: To add a vertex for a unit sphere to a vector of
+//           VertexBufferModel vertex data.
+//  Parameter(s):
+//    <1> rv_vertex_data: The vertex data to add to
+//    <2> direction: The position and normal of the vertex
+//    <3> s: The horizontal texture coordinate
+//    <4> t: The vertical texture coordinate
+//  Preconditions:
+//    <1> direction.isUnit()
+//  Returns: N/A
+//  Side Effect: VertexBufferModel::FLOATS_PER_VERTEX floats are
+//               added to the end of rv_vertex_data.
+//
+	void addSphereVertex (vector<float>& rv_vertex_data,
+	                      const Vector3& direction,
+	                      double s,
+	                      double t)
+	{
+		assert(direction.isUnit());
+
+		rv_vertex_data.push_back((float)(direction.x));
+		rv_vertex_data.push_back((float)(direction.y));
+		rv_vertex_data.push_back((float)(direction.z));
+		rv_vertex_data.push_back((float)(s));
+		rv_vertex_data.push_back((float)(t));
+		rv_vertex_data.push_back((float)(direction.x));
+		rv_vertex_data.push_back((float)(direction.y));
+		rv_vertex_data.push_back((float)(direction.z));
+	}
+
+}  // end of anonymous namespace
+
+
+
+AsteroidMesh :: AsteroidMesh ()
+		: mv_vertex_directions()
+		, mv_buffer_vertexes()
+		, m_base_vertex_buffer_model()
+{
+	assert(isEmpty());
+	assert(invariant());
+}
+
+AsteroidMesh :: AsteroidMesh (const ObjLibrary::ObjModel& base_model)
+		: mv_vertex_directions(base_model.getVertexCount())
+		, mv_buffer_vertexes()
+		, m_base_vertex_buffer_model()
+{
+	assert(Asteroid::isUnitSphere(base_model));
+	assert(base_model.getVertexCount() > 0);
+
+	for(unsigned int v = 0; v < base_model.getVertexCount(); v++)
+		mv_vertex_directions[v] = base_model.getVertexPosition(v);
+
+	m_base_vertex_buffer_model = base_model.getVertexBufferModel(mv_buffer_vertexes);
+
+	assert(!isEmpty());
+	assert(invariant());
+}
+
+AsteroidMesh :: AsteroidMesh (unsigned int slice_count,
+                              unsigned int stack_count,
+                              const ObjLibrary::Material* p_material)
+		: mv_vertex_directions()
+		, mv_buffer_vertexes()
+		, m_base_vertex_buffer_model()
+{
+	assert(slice_count >= 3);
+	assert(stack_count >= 2);
+
+	// vertex directions: south pole, then each ring of
+	//   slice_count vertexes from south to north, then the
+	//   north pole
+	unsigned int ring_count = stack_count - 1;
+	unsigned int south_pole = 0;
+	unsigned int north_pole = 1 + ring_count * slice_count;
+	mv_vertex_directions.push_back(Vector3(0.0, -1.0, 0.0));
+	for(unsigned int r = 1; r <= ring_count; r++)
+	{
+		double latitude = PI * ((double)(r) / stack_count - 0.5);
+		for(unsigned int s = 0; s < slice_count; s++)
+		{
+			double longitude = TEXTURE_START_RADIANS - 2.0 * PI * s / slice_count;
+			mv_vertex_directions.push_back(Vector3(cos(latitude) * cos(longitude),
+			                                       sin(latitude),
+			                                       cos(latitude) * sin(longitude)));
+		}
+	}
+	mv_vertex_directions.push_back(Vector3(0.0, 1.0, 0.0));
+	assert(mv_vertex_directions.size() == north_pole + 1);
+
+	// buffer vertexes: each ring has a duplicate vertex at the
+	//   texture seam, and each pole has one vertex per slice
+	vector<float> v_vertex_data;
+	for(unsigned int r = 1; r <= ring_count; r++)
+		for(unsigned int s = 0; s <= slice_count; s++)
+		{
+			unsigned int direction = 1 + (r - 1) * slice_count + s % slice_count;
+			addSphereVertex(v_vertex_data, mv_vertex_directions[direction],
+			                (double)(s) / slice_count, (double)(r) / stack_count);
+			mv_buffer_vertexes.push_back(direction);
+		}
+	unsigned int first_pole_vertex = (unsigned int)(mv_buffer_vertexes.size());
+	for(unsigned int s = 0; s < slice_count; s++)
+	{
+		double texture_s = (s + 0.5) / slice_count;
+		addSphereVertex(v_vertex_data, mv_vertex_directions[south_pole], texture_s, 0.0);
+		mv_buffer_vertexes.push_back(south_pole);
+		addSphereVertex(v_vertex_data, mv_vertex_directions[north_pole], texture_s, 1.0);
+		mv_buffer_vertexes.push_back(north_pole);
+	}
+
+	// same winding as the asteroid base models
+	unsigned int ring_vertex_count = slice_count + 1;
+	vector<unsigned int> v_indexes;
+	for(unsigned int s = 0; s < slice_count; s++)
+	{
+		unsigned int south = first_pole_vertex + s * 2;
+		v_indexes.push_back(s + 1);
+		v_indexes.push_back(s);
+		v_indexes.push_back(south);
+	}
+	for(unsigned int r = 0; r + 1 < ring_count; r++)
+		for(unsigned int s = 0; s < slice_count; s++)
+		{
+			unsigned int vertex00 =  r      * ring_vertex_count + s;
+			unsigned int vertex01 =  r      * ring_vertex_count + s + 1;
+			unsigned int vertex10 = (r + 1) * ring_vertex_count + s;
+			unsigned int vertex11 = (r + 1) * ring_vertex_count + s + 1;
+			v_indexes.push_back(vertex00);
+			v_indexes.push_back(vertex01);
+			v_indexes.push_back(vertex11);
+			v_indexes.push_back(vertex00);
+			v_indexes.push_back(vertex11);
+			v_indexes.push_back(vertex10);
+		}
+	for(unsigned int s = 0; s < slice_count; s++)
+	{
+		unsigned int north = first_pole_vertex + s * 2 + 1;
+		v_indexes.push_back((ring_count - 1) * ring_vertex_count + s);
+		v_indexes.push_back((ring_count - 1) * ring_vertex_count + s + 1);
+		v_indexes.push_back(north);
+	}
+
+	VertexBufferModel::MaterialRange material_range;
+	material_range.mp_material   = p_material;
+	material_range.m_first_index = 0;
+	material_range.m_index_count = (unsigned int)(v_indexes.size());
+	vector<VertexBufferModel::MaterialRange> v_material_ranges(1, material_range);
+
+	m_base_vertex_buffer_model.init(v_vertex_data, v_indexes, v_material_ranges, true, true);
+
+	assert(!isEmpty());
+	assert(getVertexCount() == slice_count * ring_count + 2);
+	assert(invariant());
+}
+
+
+
+unsigned int AsteroidMesh :: getVertexCount () const
+{
+	assert(!isEmpty());
+
+	return (unsigned int)(mv_vertex_directions.size());
+}
+
+const ObjLibrary::Vector3* AsteroidMesh :: getVertexDirections () const
+{
+	assert(!isEmpty());
+
+	return mv_vertex_directions.data();
+}
+
+const ObjLibrary::VertexBufferModel& AsteroidMesh :: getBaseVertexBufferModel () const
+{
+	assert(!isEmpty());
+
+	return m_base_vertex_buffer_model;
+}
+
+ObjLibrary::VertexBufferModel AsteroidMesh :: createVertexBufferModel (const std::vector<float>& v_vertex_radii) const
+{
+	assert(!isEmpty());
+	assert(v_vertex_radii.size() == getVertexCount());
+
+	vector<float> v_positions(mv_buffer_vertexes.size() * 3);
+	for(unsigned int i = 0; i < mv_buffer_vertexes.size(); i++)
+	{
+		unsigned int vertex = mv_buffer_vertexes[i];
+		assert(vertex < mv_vertex_directions.size());
+
+		Vector3 position = mv_vertex_directions[vertex].getCopyWithNorm(v_vertex_radii[vertex]);
+		v_positions[i * 3 + 0] = (float)(position.x);
+		v_positions[i * 3 + 1] = (float)(position.y);
+		v_positions[i * 3 + 2] = (float)(position.z);
+	}
+
+	return m_base_vertex_buffer_model.getCopyWithPositions(v_positions);
+}
+
+
+
+bool AsteroidMesh :: invariant () const
+{
+	if(m_base_vertex_buffer_model.isEmpty() != mv_vertex_directions.empty()) return false;
+	if(!m_base_vertex_buffer_model.isEmpty() &&
+	   mv_buffer_vertexes.size() != m_base_vertex_buffer_model.getVertexCount()) return false;
+	for(unsigned int i = 0; i < mv_buffer_vertexes.size(); i++)
+		if(mv_buffer_vertexes[i] >= mv_vertex_directions.size()) return false;
+	return true;
+}
+
+#endif
@@ -0,0 +1,215 @@
+//
+//  AsteroidMesh.h
+//
+//  A module to store the parts of an asteroid model that are
+//    shared by every asteroid made from the same base model.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/VertexBufferModel.h"
+
+
+
+//
+//  AsteroidMesh
+//
+//  A class to represent a unit sphere mesh that is displaced to
+//    make asteroids.  Every asteroid made from the same base
+//    model has the same triangles, texture coordinates,
+//    normals, and materials.  Only the distance from the center
+//    to each vertex is different.
+//
+//  An AsteroidMesh stores the direction to each vertex of the
+//    base model and a VertexBufferModel for the base model.  An
+//    asteroid is then described by one radius for each vertex
+//    direction, and its VertexBufferModel is created with
+//    VertexBufferModel::getCopyWithPositions, so only its
+//    vertex positions are stored on the graphics card.
+//
+//  The vertex directions are the vertex positions of the base
+//    model.  The VertexBufferModel may contain a vertex
+//    direction more than once, if the vertex is used with
+//    different texture coordinates or normals.
+//
+//  An AsteroidMesh can also be created for a sphere with a
+//    specified number of slices and stacks, without a base
+//    model.  These are used to display distant asteroids with
+//    fewer triangles.  The texture coordinates match the
+//    asteroid base models, so the texture is in the same place
+//    on the asteroid surface at every level of detail.
+//
+//  Class Invariant:
+//    <1> m_base_vertex_buffer_model.isEmpty() ==
+//        mv_vertex_directions.empty()
+//    <2> m_base_vertex_buffer_model.isEmpty() ||
+//        mv_buffer_vertexes.size() ==
+//        m_base_vertex_buffer_model.getVertexCount()
+//    <3> mv_buffer_vertexes[i] < mv_vertex_directions.size()
+//        WHERE 0 <= i < mv_buffer_vertexes.size()
+//
+class AsteroidMesh
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty AsteroidMesh.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new AsteroidMesh is created.  It does not
+//               contain a mesh.
+//
+	AsteroidMesh ();
+
+//
+//  Constructor
+//
+//  Purpose: To create an AsteroidMesh for the specified base
+//           model.
+//  Parameter(s):
+//    <1> base_model: The base model
+//  Preconditions:
+//    <1> Asteroid::isUnitSphere(base_model)
+//    <2> base_model.getVertexCount() > 0
+//    <3> ObjLibrary::DisplayList::isGlutInitialized()
+//    <4> !ObjLibrary::Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: A new AsteroidMesh is created for base_model.
+//               A VertexBufferModel is created for base_model
+//               and its textures are loaded.  base_model is not
+//               needed after this call.
+//
+	AsteroidMesh (const ObjLibrary::ObjModel& base_model);
+
+//
+//  Constructor
+//
+//  Purpose: To create an AsteroidMesh for a unit sphere with
+//           the specified resolution.
+//  Parameter(s):
+//    <1> slice_count: The number of divisions around the
+//                     sphere
+//    <2> stack_count: The number of divisions from the south
+//                     pole to the north pole
+//    <3> p_material: The Material to display the sphere with
+//  Preconditions:
+//    <1> slice_count >= 3
+//    <2> stack_count >= 2
+//    <3> ObjLibrary::DisplayList::isGlutInitialized()
+//  Returns: N/A
+//  Side Effect: A new AsteroidMesh is created for a sphere with
+//               slice_count * (stack_count - 1) + 2 vertexes.
+//               The sphere is displayed with Material
+//               p_material, which must exist for as long as the
+//               sphere is displayed.  If p_material is NULL,
+//               the sphere is displayed with the current
+//               OpenGL state.
+//
+	AsteroidMesh (unsigned int slice_count,
+	              unsigned int stack_count,
+	              const ObjLibrary::Material* p_material);
+
+	AsteroidMesh (const AsteroidMesh& to_copy) = default;
+	~AsteroidMesh () = default;
+	AsteroidMesh& operator= (const AsteroidMesh& to_copy) = default;
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this AsteroidMesh contains a mesh.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this AsteroidMesh is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const
+	{
+		return m_base_vertex_buffer_model.isEmpty();
+	}
+
+//
+//  getVertexCount
+//
+//  Purpose: To determine the number of vertex directions in
+//           this AsteroidMesh.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> !isEmpty()
+//  Returns: The number of vertex directions.  This is the
+//           number of radii needed to describe an asteroid.
+//  Side Effect: N/A
+//
+	unsigned int getVertexCount () const;
+
+//
+//  getVertexDirections
+//
+//  Purpose: To retrieve the vertex directions for this
+//           AsteroidMesh.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> !isEmpty()
+//  Returns: An array of getVertexCount() unit vectors.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3* getVertexDirections () const;
+
+//
+//  getBaseVertexBufferModel
+//
+//  Purpose: To retrieve the VertexBufferModel for the unit
+//           sphere this AsteroidMesh was created from.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> !isEmpty()
+//  Returns: The VertexBufferModel for the base model.
+//  Side Effect: N/A
+//
+	const ObjLibrary::VertexBufferModel& getBaseVertexBufferModel () const;
+
+//
+//  createVertexBufferModel
+//
+//  Purpose: To create the VertexBufferModel for an asteroid
+//           with the specified vertex radii.
+//  Parameter(s):
+//    <1> v_vertex_radii: The distance from the asteroid center
+//                        to each vertex
+//  Preconditions:
+//    <1> !isEmpty()
+//    <2> v_vertex_radii.size() == getVertexCount()
+//    <3> This function is called from the thread with the
+//        OpenGL context
+//  Returns: A VertexBufferModel with vertex i of the base model
+//           moved to distance v_vertex_radii[i] from the
+//           origin.  It shares everything except the vertex
+//           positions with getBaseVertexBufferModel().
+//  Side Effect: N/A
+//
+	ObjLibrary::VertexBufferModel createVertexBufferModel (
+	              const std::vector<float>& v_vertex_radii) const;
+
+private:
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::vector<ObjLibrary::Vector3> mv_vertex_directions;
+	std::vector<unsigned int> mv_buffer_vertexes;
+	ObjLibrary::VertexBufferModel m_base_vertex_buffer_model;
+};
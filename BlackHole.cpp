@@ -6,12 +6,17 @@
 
 #include <cassert>
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 
 #include "ObjLibrary/Vector3.h"
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
+#ifndef HEADLESS_SIMULATION
+#include "RenderQueue.h"
+#endif
 
 using namespace ObjLibrary;
 
@@ -24,6 +29,7 @@ BlackHole :: BlackHole ()
 	assert(!isInitialized());
 }
 
+#ifndef HEADLESS_SIMULATION
 BlackHole :: BlackHole (const ObjLibrary::Vector3& position,
                         double mass,
                         double sphere_radius,
@@ -39,20 +45,56 @@ BlackHole :: BlackHole (const ObjLibrary::Vector3& position,
 
 	assert(isInitialized());
 }
+#endif
+
+BlackHole :: BlackHole (const ObjLibrary::Vector3& position,
+                        double mass,
+                        double sphere_radius,
+                        double disk_radius)
+		: Entity(position, Vector3(0, 0, 0), mass, sphere_radius)
+		, m_disk_radius(disk_radius)
+{
+	assert(mass > 0.0);
+	assert(sphere_radius >= 0.0);
+	assert(disk_radius   >= 0.0);
+
+	assert(isInitialized());
+}
 
 
 
+#ifndef HEADLESS_SIMULATION
 void BlackHole :: draw () const
 {
 	assert(isInitialized());
 
+	drawSphere();
+
+	// draw accretion disk - has to be last because of transparency
+	Entity::draw();
+}
+
+void BlackHole :: addToRenderQueue (RenderQueue& r_queue,
+                                    unsigned int pass) const
+{
+	assert(isInitialized());
+	assert(pass < RenderQueue::PASS_COUNT);
+
+	r_queue.addCallback(RenderQueue::PASS_OPAQUE, [this] () { drawSphere(); });
+	Entity::addToRenderQueue(r_queue, pass);
+}
+
+
+
+void BlackHole :: drawSphere () const
+{
+	assert(isInitialized());
+
 	glPushMatrix();
 		m_coords.applyDrawTransformations();
 		glColor3f(0.0f, 0.0f, 0.0f);
 		glutSolidSphere(getRadius(), 40, 30);
 	glPopMatrix();
-
-	// draw accretion disk - has to be last because of transparency
-	Entity::draw();
 }
+#endif
 
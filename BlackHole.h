@@ -7,7 +7,9 @@
 #pragma once
 
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
@@ -34,6 +36,7 @@ public:
 //
 	BlackHole ();
 
+#ifndef HEADLESS_SIMULATION
 //
 //  Constructor
 //
@@ -60,11 +63,37 @@ public:
 	           double sphere_radius,
 	           double disk_radius,
 	           const ObjLibrary::DisplayList& disk_display_list);
+#endif
+
+//
+//  Constructor
+//
+//  Purpose: To create a black hole with the specified position,
+//           mass, and radius that cannot be displayed.
+//  Parameter(s):
+//    <1> position: The position
+//    <2> mass: The mass
+//    <3> sphere_radius: The radius of the black hole itself
+//    <4> disk_radius: The radius of the accretion disk
+//  Preconditions: N/A
+//    <1> mass > 0.0
+//    <2> sphere_radius >= 0.0
+//    <3> disk_radius   >= 0.0
+//  Returns: N/A
+//  Side Effect: A new BlackHole is created at position position
+//               with mas mas and radius radius.  It has no
+//               DisplayList for the accretion disk.
+//
+	BlackHole (const ObjLibrary::Vector3& position,
+	           double mass,
+	           double sphere_radius,
+	           double disk_radius);
 
 	BlackHole (const BlackHole& to_copy) = default;
 	~BlackHole () = default;
 	BlackHole& operator= (const BlackHole& to_copy) = default;
 
+#ifndef HEADLESS_SIMULATION
 //
 //  draw
 //
@@ -77,9 +106,44 @@ public:
 //
 	virtual void draw () const;
 
+//
+//  addToRenderQueue
+//
+//  Purpose: To add the commands to display this BlackHole to
+//           the specified RenderQueue.
+//  Parameter(s):
+//    <1> r_queue: The RenderQueue
+//    <2> pass: The pass to display the accretion disk in
+//  Preconditions:
+//    <1> pass < RenderQueue::PASS_COUNT
+//  Returns: N/A
+//  Side Effect: Commands to display this BlackHole are added to
+//               r_queue.  The sphere is always displayed in
+//               RenderQueue::PASS_OPAQUE.  This BlackHole must
+//               exist until r_queue is executed.
+//
+	virtual void addToRenderQueue (RenderQueue& r_queue,
+	                               unsigned int pass) const;
+
+private:
+//
+//  drawSphere
+//
+//  Purpose: To display the sphere for this BlackHole.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The black sphere for this BlackHole is
+//               displayed, without the accretion disk.
+//
+	void drawSphere () const;
+#endif
+
 private:
 	double m_disk_radius;
+#ifndef HEADLESS_SIMULATION
 	ObjLibrary::DisplayList m_disk_display_list;
+#endif
 };
 
 
@@ -0,0 +1,322 @@
+//
+//  BodyStore.cpp
+//
+
+#include "BodyStore.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+
+#if defined(__AVX__)
+	#include <immintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Gravity.h"
+
+using namespace std;
+using namespace ObjLibrary;
+
+
+
+BodyStore :: BodyStore ()
+		: mv_position_x()
+		, mv_position_y()
+		, mv_position_z()
+		, mv_velocity_x()
+		, mv_velocity_y()
+		, mv_velocity_z()
+{
+	assert(invariant());
+}
+
+
+
+Vector3 BodyStore :: getPosition (unsigned int index) const
+{
+	assert(index < getCount());
+
+	return Vector3(mv_position_x[index],
+	               mv_position_y[index],
+	               mv_position_z[index]);
+}
+
+Vector3 BodyStore :: getVelocity (unsigned int index) const
+{
+	assert(index < getCount());
+
+	return Vector3(mv_velocity_x[index],
+	               mv_velocity_y[index],
+	               mv_velocity_z[index]);
+}
+
+const char* BodyStore :: getInstructionSetName ()
+{
+#if defined(__AVX__)
+	return "AVX";
+#elif defined(__SSE2__)
+	return "SSE2";
+#else
+	return "scalar";
+#endif
+}
+
+
+
+void BodyStore :: clear ()
+{
+	mv_position_x.clear();
+	mv_position_y.clear();
+	mv_position_z.clear();
+	mv_velocity_x.clear();
+	mv_velocity_y.clear();
+	mv_velocity_z.clear();
+
+	assert(invariant());
+}
+
+unsigned int BodyStore :: add (const ObjLibrary::Vector3& position,
+                               const ObjLibrary::Vector3& velocity)
+{
+	assert(position.isFinite());
+	assert(velocity.isFinite());
+
+	unsigned int index = getCount();
+	mv_position_x.push_back(position.x);
+	mv_position_y.push_back(position.y);
+	mv_position_z.push_back(position.z);
+	mv_velocity_x.push_back(velocity.x);
+	mv_velocity_y.push_back(velocity.y);
+	mv_velocity_z.push_back(velocity.z);
+
+	assert(invariant());
+	return index;
+}
+
+void BodyStore :: resize (unsigned int count)
+{
+	mv_position_x.resize(count, 0.0);
+	mv_position_y.resize(count, 0.0);
+	mv_position_z.resize(count, 0.0);
+	mv_velocity_x.resize(count, 0.0);
+	mv_velocity_y.resize(count, 0.0);
+	mv_velocity_z.resize(count, 0.0);
+
+	assert(invariant());
+}
+
+void BodyStore :: set (unsigned int index,
+                       const ObjLibrary::Vector3& position,
+                       const ObjLibrary::Vector3& velocity)
+{
+	assert(index < getCount());
+	assert(position.isFinite());
+	assert(velocity.isFinite());
+
+	mv_position_x[index] = position.x;
+	mv_position_y[index] = position.y;
+	mv_position_z[index] = position.z;
+	mv_velocity_x[index] = velocity.x;
+	mv_velocity_y[index] = velocity.y;
+	mv_velocity_z[index] = velocity.z;
+
+	assert(invariant());
+}
+
+void BodyStore :: updatePhysics (double delta_time,
+                                 const ObjLibrary::Vector3& black_hole_position,
+                                 double black_hole_mass)
+{
+	assert(delta_time > 0.0);
+	assert(black_hole_position.isFinite());
+	assert(black_hole_mass > 0.0);
+
+	updatePhysics(0, getCount(), delta_time, black_hole_position, black_hole_mass);
+
+	assert(invariant());
+}
+
+void BodyStore :: updatePhysics (unsigned int begin,
+                                 unsigned int end,
+                                 double delta_time,
+                                 const ObjLibrary::Vector3& black_hole_position,
+                                 double black_hole_mass)
+{
+	assert(begin <= end);
+	assert(end <= getCount());
+	assert(delta_time > 0.0);
+	assert(black_hole_position.isFinite());
+	assert(black_hole_mass > 0.0);
+
+	// same grouping as Entity::updatePhysics
+	double gravity_mass = GRAVITY * black_hole_mass;
+
+	unsigned int i = begin;
+
+	double* p_position_x = mv_position_x.data();
+	double* p_position_y = mv_position_y.data();
+	double* p_position_z = mv_position_z.data();
+	double* p_velocity_x = mv_velocity_x.data();
+	double* p_velocity_y = mv_velocity_y.data();
+	double* p_velocity_z = mv_velocity_z.data();
+
+#if defined(__AVX__)
+	__m256d sign_mask = _mm256_set1_pd(-0.0);
+	__m256d tolerance = _mm256_set1_pd(VECTOR3_ZERO_TOLERENCE);
+	__m256d bh_x      = _mm256_set1_pd(black_hole_position.x);
+	__m256d bh_y      = _mm256_set1_pd(black_hole_position.y);
+	__m256d bh_z      = _mm256_set1_pd(black_hole_position.z);
+	__m256d gm        = _mm256_set1_pd(gravity_mass);
+	__m256d dt        = _mm256_set1_pd(delta_time);
+
+	for(; i + 4 <= end; i += 4)
+	{
+		__m256d old_x = _mm256_loadu_pd(p_position_x + i);
+		__m256d old_y = _mm256_loadu_pd(p_position_y + i);
+		__m256d old_z = _mm256_loadu_pd(p_position_z + i);
+		__m256d vel_x = _mm256_loadu_pd(p_velocity_x + i);
+		__m256d vel_y = _mm256_loadu_pd(p_velocity_y + i);
+		__m256d vel_z = _mm256_loadu_pd(p_velocity_z + i);
+
+		// apply black hole gravity
+		__m256d to_x = _mm256_sub_pd(bh_x, old_x);
+		__m256d to_y = _mm256_sub_pd(bh_y, old_y);
+		__m256d to_z = _mm256_sub_pd(bh_z, old_z);
+
+		__m256d is_not_zero = _mm256_or_pd(
+		        _mm256_or_pd(_mm256_cmp_pd(_mm256_andnot_pd(sign_mask, to_x), tolerance, _CMP_GT_OQ),
+		                     _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, to_y), tolerance, _CMP_GT_OQ)),
+		                     _mm256_cmp_pd(_mm256_andnot_pd(sign_mask, to_z), tolerance, _CMP_GT_OQ));
+
+		__m256d distance_squared = _mm256_add_pd(_mm256_add_pd(_mm256_mul_pd(to_x, to_x),
+		                                                       _mm256_mul_pd(to_y, to_y)),
+		                                         _mm256_mul_pd(to_z, to_z));
+		__m256d magnitude  = _mm256_div_pd(gm, distance_squared);
+		__m256d norm_ratio = _mm256_div_pd(magnitude, _mm256_sqrt_pd(distance_squared));
+
+		__m256d new_vel_x = _mm256_add_pd(vel_x, _mm256_mul_pd(_mm256_mul_pd(to_x, norm_ratio), dt));
+		__m256d new_vel_y = _mm256_add_pd(vel_y, _mm256_mul_pd(_mm256_mul_pd(to_y, norm_ratio), dt));
+		__m256d new_vel_z = _mm256_add_pd(vel_z, _mm256_mul_pd(_mm256_mul_pd(to_z, norm_ratio), dt));
+		vel_x = _mm256_blendv_pd(vel_x, new_vel_x, is_not_zero);
+		vel_y = _mm256_blendv_pd(vel_y, new_vel_y, is_not_zero);
+		vel_z = _mm256_blendv_pd(vel_z, new_vel_z, is_not_zero);
+
+		// move according to velocity
+		_mm256_storeu_pd(p_position_x + i, _mm256_add_pd(old_x, _mm256_mul_pd(vel_x, dt)));
+		_mm256_storeu_pd(p_position_y + i, _mm256_add_pd(old_y, _mm256_mul_pd(vel_y, dt)));
+		_mm256_storeu_pd(p_position_z + i, _mm256_add_pd(old_z, _mm256_mul_pd(vel_z, dt)));
+		_mm256_storeu_pd(p_velocity_x + i, vel_x);
+		_mm256_storeu_pd(p_velocity_y + i, vel_y);
+		_mm256_storeu_pd(p_velocity_z + i, vel_z);
+	}
+#elif defined(__SSE2__)
+	__m128d sign_mask = _mm_set1_pd(-0.0);
+	__m128d tolerance = _mm_set1_pd(VECTOR3_ZERO_TOLERENCE);
+	__m128d bh_x      = _mm_set1_pd(black_hole_position.x);
+	__m128d bh_y      = _mm_set1_pd(black_hole_position.y);
+	__m128d bh_z      = _mm_set1_pd(black_hole_position.z);
+	__m128d gm        = _mm_set1_pd(gravity_mass);
+	__m128d dt        = _mm_set1_pd(delta_time);
+
+	for(; i + 2 <= end; i += 2)
+	{
+		__m128d old_x = _mm_loadu_pd(p_position_x + i);
+		__m128d old_y = _mm_loadu_pd(p_position_y + i);
+		__m128d old_z = _mm_loadu_pd(p_position_z + i);
+		__m128d vel_x = _mm_loadu_pd(p_velocity_x + i);
+		__m128d vel_y = _mm_loadu_pd(p_velocity_y + i);
+		__m128d vel_z = _mm_loadu_pd(p_velocity_z + i);
+
+		// apply black hole gravity
+		__m128d to_x = _mm_sub_pd(bh_x, old_x);
+		__m128d to_y = _mm_sub_pd(bh_y, old_y);
+		__m128d to_z = _mm_sub_pd(bh_z, old_z);
+
+		__m128d is_not_zero = _mm_or_pd(
+		        _mm_or_pd(_mm_cmpgt_pd(_mm_andnot_pd(sign_mask, to_x), tolerance),
+		                  _mm_cmpgt_pd(_mm_andnot_pd(sign_mask, to_y), tolerance)),
+		                  _mm_cmpgt_pd(_mm_andnot_pd(sign_mask, to_z), tolerance));
+
+		__m128d distance_squared = _mm_add_pd(_mm_add_pd(_mm_mul_pd(to_x, to_x),
+		                                                 _mm_mul_pd(to_y, to_y)),
+		                                      _mm_mul_pd(to_z, to_z));
+		__m128d magnitude  = _mm_div_pd(gm, distance_squared);
+		__m128d norm_ratio = _mm_div_pd(magnitude, _mm_sqrt_pd(distance_squared));
+
+		__m128d new_vel_x = _mm_add_pd(vel_x, _mm_mul_pd(_mm_mul_pd(to_x, norm_ratio), dt));
+		__m128d new_vel_y = _mm_add_pd(vel_y, _mm_mul_pd(_mm_mul_pd(to_y, norm_ratio), dt));
+		__m128d new_vel_z = _mm_add_pd(vel_z, _mm_mul_pd(_mm_mul_pd(to_z, norm_ratio), dt));
+		// SSE2 has no blend instruction
+		vel_x = _mm_or_pd(_mm_and_pd(is_not_zero, new_vel_x), _mm_andnot_pd(is_not_zero, vel_x));
+		vel_y = _mm_or_pd(_mm_and_pd(is_not_zero, new_vel_y), _mm_andnot_pd(is_not_zero, vel_y));
+		vel_z = _mm_or_pd(_mm_and_pd(is_not_zero, new_vel_z), _mm_andnot_pd(is_not_zero, vel_z));
+
+		// move according to velocity
+		_mm_storeu_pd(p_position_x + i, _mm_add_pd(old_x, _mm_mul_pd(vel_x, dt)));
+		_mm_storeu_pd(p_position_y + i, _mm_add_pd(old_y, _mm_mul_pd(vel_y, dt)));
+		_mm_storeu_pd(p_position_z + i, _mm_add_pd(old_z, _mm_mul_pd(vel_z, dt)));
+		_mm_storeu_pd(p_velocity_x + i, vel_x);
+		_mm_storeu_pd(p_velocity_y + i, vel_y);
+		_mm_storeu_pd(p_velocity_z + i, vel_z);
+	}
+#endif
+
+	updatePhysicsScalar(i, end, delta_time, black_hole_position, gravity_mass);
+}
+
+
+
+void BodyStore :: updatePhysicsScalar (unsigned int begin,
+                                       unsigned int end,
+                                       double delta_time,
+                                       const ObjLibrary::Vector3& black_hole_position,
+                                       double gravity_mass)
+{
+	assert(begin <= end);
+	assert(end <= getCount());
+	assert(delta_time > 0.0);
+
+	for(unsigned int i = begin; i < end; i++)
+	{
+		double old_x = mv_position_x[i];
+		double old_y = mv_position_y[i];
+		double old_z = mv_position_z[i];
+
+		// apply black hole gravity
+		double to_x = black_hole_position.x - old_x;
+		double to_y = black_hole_position.y - old_y;
+		double to_z = black_hole_position.z - old_z;
+		if(fabs(to_x) > VECTOR3_ZERO_TOLERENCE ||
+		   fabs(to_y) > VECTOR3_ZERO_TOLERENCE ||
+		   fabs(to_z) > VECTOR3_ZERO_TOLERENCE)
+		{
+			double distance_squared = to_x * to_x + to_y * to_y + to_z * to_z;
+			assert(distance_squared > 0.0);
+
+			double magnitude  = gravity_mass / distance_squared;
+			double norm_ratio = magnitude / sqrt(distance_squared);
+			mv_velocity_x[i] += to_x * norm_ratio * delta_time;
+			mv_velocity_y[i] += to_y * norm_ratio * delta_time;
+			mv_velocity_z[i] += to_z * norm_ratio * delta_time;
+		}
+
+		// move according to velocity
+		mv_position_x[i] = old_x + mv_velocity_x[i] * delta_time;
+		mv_position_y[i] = old_y + mv_velocity_y[i] * delta_time;
+		mv_position_z[i] = old_z + mv_velocity_z[i] * delta_time;
+	}
+}
+
+bool BodyStore :: invariant () const
+{
+	if(mv_velocity_x.size() != mv_position_x.size()) return false;
+	if(mv_velocity_y.size() != mv_position_x.size()) return false;
+	if(mv_velocity_z.size() != mv_position_x.size()) return false;
+	if(mv_position_y.size() != mv_position_x.size()) return false;
+	if(mv_position_z.size() != mv_position_x.size()) return false;
+	return true;
+}
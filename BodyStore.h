@@ -0,0 +1,283 @@
+//
+//  BodyStore.h
+//
+//  A module to store the motion of many bodies in a form that
+//    can be updated quickly.
+//
+
+#pragma once
+
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  BodyStore
+//
+//  A class to store the positions and velocities of many
+//    bodies as a structure of arrays.  Each component is kept
+//    in its own contiguous array, so the bodies can be updated
+//    several at a time with SIMD instructions.
+//
+//  The update applies the gravity of a single black hole and
+//    then moves each body according to its velocity, exactly as
+//    Entity::updatePhysics does.  The same operations are
+//    performed in the same order, so the results are
+//    bit-identical to the scalar Entity::updatePhysics as long
+//    as the compiler does not fuse multiplies and adds
+//    differently in the two places.  When building with FMA
+//    enabled, also specify -ffp-contract=off (GCC/Clang) or
+//    /fp:precise (MSVC) to guarentee this.
+//
+//  The instruction set is chosen when compiling BodyStore.cpp:
+//    AVX if __AVX__ is defined (4 bodies at a time), otherwise
+//    SSE2 if __SSE2__ is defined (2 bodies at a time), and
+//    otherwise plain C++.  The remaining bodies are always
+//    updated with plain C++.
+//
+//  A BodyStore is intended to be refilled every physics update:
+//    <1> Call clear() and add() for every body, or call
+//        resize() and then set() for every body
+//    <2> Call updatePhysics()
+//    <3> Call getPosition() and getVelocity() for every body
+//    Memory is reused between updates, so there are no
+//    allocations once the number of bodies is stable.
+//
+//  A BodyStore is only a scratch copy.  The World's asteroids
+//    and crystals still own their positions and velocities, so
+//    they are copied in and back out every physics update, and
+//    copying takes several times as long as the update itself.
+//    Masses are not stored, because the acceleration from the
+//    black hole does not depend on them.
+//
+//  Different ranges of bodies can be set and updated on
+//    different threads at the same time.  Each body is updated
+//    independently, so the results do not depend on how the
+//    bodies are divided into ranges.
+//
+//  Class Invariant:
+//    <1> mv_velocity_x.size() == mv_position_x.size()
+//    <2> mv_velocity_y.size() == mv_position_x.size()
+//    <3> mv_velocity_z.size() == mv_position_x.size()
+//    <4> mv_position_y.size() == mv_position_x.size()
+//    <5> mv_position_z.size() == mv_position_x.size()
+//
+class BodyStore
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty BodyStore.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new BodyStore is created.  It contains no
+//               bodies.
+//
+	BodyStore ();
+
+	BodyStore (const BodyStore& to_copy) = default;
+	~BodyStore () = default;
+	BodyStore& operator= (const BodyStore& to_copy) = default;
+
+//
+//  getCount
+//
+//  Purpose: To determine the number of bodies in this
+//           BodyStore.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of bodies.
+//  Side Effect: N/A
+//
+	unsigned int getCount () const
+	{
+		return (unsigned int)(mv_position_x.size());
+	}
+
+//
+//  getPosition
+//  getVelocity
+//
+//  Purpose: To retrieve the position or velocity of a body.
+//  Parameter(s):
+//    <1> index: Which body
+//  Preconditions:
+//    <1> index < getCount()
+//  Returns: The position or velocity of body index.
+//  Side Effect: N/A
+//
+	ObjLibrary::Vector3 getPosition (unsigned int index) const;
+	ObjLibrary::Vector3 getVelocity (unsigned int index) const;
+
+//
+//  getInstructionSetName
+//
+//  Purpose: To determine which instruction set is used to
+//           update the bodies.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: "AVX", "SSE2", or "scalar".
+//  Side Effect: N/A
+//
+	static const char* getInstructionSetName ();
+
+//
+//  clear
+//
+//  Purpose: To remove all bodies from this BodyStore.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This BodyStore is emptied.
+//
+	void clear ();
+
+//
+//  add
+//
+//  Purpose: To add a body to this BodyStore.
+//  Parameter(s):
+//    <1> position: The position of the body
+//    <2> velocity: The velocity of the body
+//  Preconditions:
+//    <1> position.isFinite()
+//    <2> velocity.isFinite()
+//  Returns: The index of the new body.
+//  Side Effect: The body is added to this BodyStore.
+//
+	unsigned int add (const ObjLibrary::Vector3& position,
+	                  const ObjLibrary::Vector3& velocity);
+
+//
+//  resize
+//
+//  Purpose: To change the number of bodies in this BodyStore.
+//  Parameter(s):
+//    <1> count: The new number of bodies
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This BodyStore is changed to contain count
+//               bodies.  Any new bodies are at the origin and
+//               not moving.
+//
+	void resize (unsigned int count);
+
+//
+//  set
+//
+//  Purpose: To change the position and velocity of a body.
+//  Parameter(s):
+//    <1> index: Which body
+//    <2> position: The new position
+//    <3> velocity: The new velocity
+//  Preconditions:
+//    <1> index < getCount()
+//    <2> position.isFinite()
+//    <3> velocity.isFinite()
+//  Returns: N/A
+//  Side Effect: Body index is set to have position position and
+//               velocity velocity.
+//
+	void set (unsigned int index,
+	          const ObjLibrary::Vector3& position,
+	          const ObjLibrary::Vector3& velocity);
+
+//
+//  updatePhysics
+//
+//  Purpose: To update all bodies in this BodyStore for one time
+//           step.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//    <2> black_hole_position: The position of the black hole
+//    <3> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> delta_time > 0.0
+//    <2> black_hole_position.isFinite()
+//    <3> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: Every body is accelerated by the gravity of the
+//               black hole and then moved based on its updated
+//               velocity.  Bodies at the position of the black
+//               hole are not accelerated.
+//
+	void updatePhysics (double delta_time,
+	                    const ObjLibrary::Vector3& black_hole_position,
+	                    double black_hole_mass);
+
+//
+//  updatePhysics
+//
+//  Purpose: To update a range of bodies in this BodyStore for
+//           one time step.
+//  Parameter(s):
+//    <1> begin: The index of the first body to update
+//    <2> end: One past the index of the last body to update
+//    <3> delta_time: The length of the time step in seconds
+//    <4> black_hole_position: The position of the black hole
+//    <5> black_hole_mass: The mass of the black hole
+//  Preconditions:
+//    <1> begin <= end
+//    <2> end <= getCount()
+//    <3> delta_time > 0.0
+//    <4> black_hole_position.isFinite()
+//    <5> black_hole_mass > 0.0
+//  Returns: N/A
+//  Side Effect: Bodies begin to end - 1 are updated as for the
+//               other overload.  Other bodies are not changed.
+//
+	void updatePhysics (unsigned int begin,
+	                    unsigned int end,
+	                    double delta_time,
+	                    const ObjLibrary::Vector3& black_hole_position,
+	                    double black_hole_mass);
+
+private:
+//
+//  Helper Function: updatePhysicsScalar
+//
+//  Purpose: To update some of the bodies in this BodyStore
+//           without using SIMD instructions.
+//  Parameter(s):
+//    <1> begin: The index of the first body to update
+//    <2> end: One past the index of the last body to update
+//    <3> delta_time: The length of the time step in seconds
+//    <4> black_hole_position: The position of the black hole
+//    <5> gravity_mass: The black hole mass times GRAVITY
+//  Preconditions:
+//    <1> begin <= end
+//    <2> end <= getCount()
+//    <3> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: Bodies begin to end - 1 are updated for one
+//               time step.
+//
+	void updatePhysicsScalar (unsigned int begin,
+	                          unsigned int end,
+	                          double delta_time,
+	                          const ObjLibrary::Vector3& black_hole_position,
+	                          double gravity_mass);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::vector<double> mv_position_x;
+	std::vector<double> mv_position_y;
+	std::vector<double> mv_position_z;
+	std::vector<double> mv_velocity_x;
+	std::vector<double> mv_velocity_y;
+	std::vector<double> mv_velocity_z;
+};
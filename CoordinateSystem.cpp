@@ -4,7 +4,9 @@
 
 #include <cassert>
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 #include "ObjLibrary/Vector3.h"
 
 #include "CoordinateSystem.h"
@@ -97,6 +99,18 @@ void CoordinateSystem :: calculateOrientationMatrix (double a_matrix[]) const
 	a_matrix[15] = 1.0;
 }
 
+void CoordinateSystem :: calculateDrawMatrix (double a_matrix[]) const
+{
+	assert(a_matrix != nullptr);
+
+	// same transformation as applyDrawTransformations
+	calculateOrientationMatrix(a_matrix);
+	a_matrix[12] = m_position.x;
+	a_matrix[13] = m_position.y;
+	a_matrix[14] = m_position.z;
+}
+
+#ifndef HEADLESS_SIMULATION
 void CoordinateSystem :: applyDrawTransformations () const
 {
 	glTranslated(m_position.x, m_position.y, m_position.z);
@@ -113,6 +127,7 @@ void CoordinateSystem :: setupCamera () const
 	             look_at.x,    look_at.y,    look_at.z,
 	                m_up.x,       m_up.y,       m_up.z);
 }
+#endif
 
 
 
@@ -44,8 +44,11 @@ public:
 	ObjLibrary::Vector3 localToWorld (const ObjLibrary::Vector3& local) const;
 	ObjLibrary::Vector3 worldToLocal (const ObjLibrary::Vector3& world) const;
 	void calculateOrientationMatrix (double a_matrix[]) const;
+	void calculateDrawMatrix (double a_matrix[]) const;
+#ifndef HEADLESS_SIMULATION
 	void applyDrawTransformations () const;
 	void setupCamera () const;
+#endif
 
 	void setPosition (const ObjLibrary::Vector3& position);
 	void addPosition (const ObjLibrary::Vector3& delta_position);
@@ -7,9 +7,13 @@
 #include <cassert>
 #include <algorithm>  // for min/max
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
@@ -25,7 +29,9 @@ namespace
 	{
 		return rand() / (RAND_MAX + 1.0);
 	}
+#ifndef HEADLESS_SIMULATION
 	Vector3 Dcolor[5];
+#endif
 }  // end of anonymous namespace
 
 Crystal :: Crystal ()
@@ -38,6 +44,7 @@ Crystal :: Crystal ()
 	assert(invariant());
 }
 
+#ifndef HEADLESS_SIMULATION
 Crystal :: Crystal (const ObjLibrary::Vector3& position,
                     const ObjLibrary::Vector3& velocity,
                     const ObjLibrary::DisplayList& display_list)
@@ -56,6 +63,21 @@ Crystal :: Crystal (const ObjLibrary::Vector3& position,
 	assert(isInitialized());
 	assert(invariant());
 }
+#endif
+
+Crystal :: Crystal (const ObjLibrary::Vector3& position,
+                    const ObjLibrary::Vector3& velocity)
+		: Entity(position,
+		         velocity,
+		         MASS,
+		         RADIUS)
+		, m_rotation_axis(Vector3::getRandomUnitVector())
+		, m_rotation_rate(std::min(random01(), random01()) * ROTATION_RATE_MAX)  // mostly rotate slowly
+		, m_is_gone(false)
+{
+	assert(isInitialized());
+	assert(invariant());
+}
 
 void Crystal :: markGone ()
 {
@@ -73,6 +95,27 @@ void Crystal :: updatePhysics (double delta_time,
 	assert(delta_time > 0.0);
 
 	Entity::updatePhysics(delta_time, black_hole);
+	updateRotation(delta_time);
+
+	assert(invariant());
+}
+
+void Crystal :: updatePhysicsOnRails (double delta_time,
+                                      const Entity& black_hole)
+{
+	assert(isInitialized());
+	assert(delta_time > 0.0);
+
+	Entity::updatePhysicsOnRails(delta_time, black_hole);
+	updateRotation(delta_time);
+
+	assert(invariant());
+}
+
+void Crystal :: updateRotation (double delta_time)
+{
+	assert(isInitialized());
+	assert(delta_time > 0.0);
 
 	double rotation_radians = m_rotation_rate * delta_time;
 	m_coords.rotateAroundArbitrary(m_rotation_axis, rotation_radians);
@@ -92,6 +135,7 @@ bool Crystal :: invariant () const
 //====================================Added Fuction=======================================
 
 
+#ifndef HEADLESS_SIMULATION
 // Drawing Crystal's future postions when they are being chased by drones
 // Color matches with drones' colours
 void Crystal::drawFutureD(const Entity& black_hole, const Entity& Drone, int color) const
@@ -129,4 +173,5 @@ void Crystal::drawFutureD(const Entity& black_hole, const Entity& Drone, int col
 		glScalef(8.0, 8.0, 8.0);
 		glutWireOctahedron();
 	glPopMatrix();
-}
\ No newline at end of file
+}
+#endif
\ No newline at end of file
@@ -9,7 +9,9 @@
 #include <cassert>
 
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
@@ -40,6 +42,7 @@ public:
 //
 	Crystal ();
 
+#ifndef HEADLESS_SIMULATION
 //
 //  Constructor
 //
@@ -60,6 +63,24 @@ public:
 	Crystal (const ObjLibrary::Vector3& position,
 	         const ObjLibrary::Vector3& velocity,
 	         const ObjLibrary::DisplayList& display_list);
+#endif
+
+//
+//  Constructor
+//
+//  Purpose: To create an Crystal with the specified position
+//           and velocity that cannot be displayed.
+//  Parameter(s):
+//    <1> position: The starting position
+//    <2> velocity: The starting velocity
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new Crystal is created at position position
+//               with velocity velocity and a random orientation
+//               and rotation.  It has no DisplayList.
+//
+	Crystal (const ObjLibrary::Vector3& position,
+	         const ObjLibrary::Vector3& velocity);
 
 	Crystal (const Crystal& to_copy) = default;
 	~Crystal () = default;
@@ -114,9 +135,47 @@ public:
 	virtual void updatePhysics (double delta_time,
 	                            const Entity& black_hole);
 
+//
+//  updatePhysicsOnRails
+//
+//  Purpose: To perform the physics updates for this Entity
+//           for one time step by following its exact orbit
+//           around the black hole.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//    <2> black_hole: The black hole
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: This Entity is updated for one time step.  This
+//               includes rotation.
+//
+	virtual void updatePhysicsOnRails (double delta_time,
+	                                   const Entity& black_hole);
+
+//
+//  updateRotation
+//
+//  Purpose: To perform only the rotation part of the physics
+//           update for one time step.  This is used when the
+//           motion has been calculated somewhere else (e.g. in
+//           a BodyStore).
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: This Crystal is rotated for one time step.
+//
+	void updateRotation (double delta_time);
+
 //====================================Added Fuction=======================================
 
+#ifndef HEADLESS_SIMULATION
 	void drawFutureD(const Entity& black_hole, const Entity& Drone, int color) const;
+#endif
 
 private:
 //
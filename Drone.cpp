@@ -9,9 +9,13 @@
 #include <cassert>
 #include <cmath>
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
@@ -29,6 +33,7 @@ Drone::Drone()
 	assert(invariant());
 }
 
+#ifndef HEADLESS_SIMULATION
 Drone::Drone(const ObjLibrary::Vector3& position,
 	const ObjLibrary::Vector3& velocity,
 	double mass,
@@ -53,6 +58,30 @@ Drone::Drone(const ObjLibrary::Vector3& position,
 	assert(isInitialized());
 	assert(invariant());
 }
+#endif
+
+Drone::Drone(const ObjLibrary::Vector3& position,
+	const ObjLibrary::Vector3& velocity,
+	double mass,
+	double radius,
+	double acceleration_main,
+	double acceleration_manoeuver,
+	double rotation_rate_radians)
+	: Entity(position, velocity, mass, radius)
+	, m_is_alive(true)
+	, m_acceleration_main(acceleration_main)
+	, m_acceleration_manoeuver(acceleration_manoeuver)
+	, m_rotation_rate_radians(rotation_rate_radians)
+{
+	assert(mass > 0.0);
+	assert(radius >= 0.0);
+	assert(acceleration_main > 0.0);
+	assert(acceleration_manoeuver > 0.0);
+	assert(rotation_rate_radians > 0.0);
+
+	assert(isInitialized());
+	assert(invariant());
+}
 
 Vector3 Drone::getFollowCameraPosition(double back_distance,
 	double up_distance) const
@@ -65,6 +94,7 @@ Vector3 Drone::getFollowCameraPosition(double back_distance,
 	return camera.getPosition();
 }
 
+#ifndef HEADLESS_SIMULATION
 void Drone::setupFollowCamera(double back_distance,
 	double up_distance) const
 {
@@ -82,7 +112,11 @@ void Drone::drawPath(const Entity& black_hole,
 {
 	assert(isInitialized());
 
-	Drone future = *this;
+	// not cached; see the comment in Drone.h
+	// no DisplayList, so copying is cheap
+	Entity future(getPosition(), getVelocity(), getMass(), getRadius());
+	double distance = black_hole.getPosition().getDistance(getPosition());
+	double delta_time = sqrt(distance) / 256.0;
 
 	glBegin(GL_POINTS);
 	glColor3d(colour.x, colour.y, colour.z);
@@ -90,9 +124,6 @@ void Drone::drawPath(const Entity& black_hole,
 
 	for (unsigned int i = 1; i < point_count; i++)
 	{
-		double distance = black_hole.getPosition().getDistance(getPosition());
-		double delta_time = sqrt(distance) / 256.0;
-
 		future.updatePhysics(delta_time, black_hole);
 
 		double fraction = sqrt(1.0 - (double)(i) / point_count);
@@ -101,6 +132,7 @@ void Drone::drawPath(const Entity& black_hole,
 	}
 	glEnd();
 }
+#endif
 
 void Drone::markDead()
 {
@@ -116,6 +148,8 @@ void Drone::thrustMainEngine(double delta_time)
 
 	assert(m_coords.getForward().isUnit());
 	m_velocity += m_coords.getForward() * m_acceleration_main * delta_time;
+	if (delta_time > 0.0)
+		markTrajectoryChanged();
 
 	assert(invariant());
 }
@@ -128,6 +162,8 @@ void Drone::thrustManoeuver(double delta_time,
 	assert(direction_world.isUnit());
 
 	m_velocity += direction_world * m_acceleration_manoeuver * delta_time;
+	if (delta_time > 0.0)
+		markTrajectoryChanged();
 
 	assert(invariant());
 }
@@ -213,6 +249,7 @@ void Drone::escort(Entity& ship, Entity& drone, Vector3 direction, double deltat
 		else if (drone.getVelocity().getNorm() > safeSpeed)
 		{
 			m_velocity += m_coords.getForward() * (-m_acceleration_main) * deltatime;
+			markTrajectoryChanged();
 		}
 	}
 	// If distance is less than 250, use 2nd engine
@@ -225,6 +262,7 @@ void Drone::escort(Entity& ship, Entity& drone, Vector3 direction, double deltat
 		else if (drone.getVelocity().getNorm() >= safeSpeed2)
 		{
 			m_velocity = Direction + ship.getVelocity();
+			markTrajectoryChanged();
 		
 		}
 	}
@@ -253,6 +291,7 @@ void Drone::swallow(Entity& crystal, Entity& drone, Vector3 direction, double de
 		else if (m_velocity.getNorm() > safeSpeed)
 		{
 			m_velocity += m_coords.getForward() * (-m_acceleration_main) * deltatime;
+			markTrajectoryChanged();
 		}
 	}
 	// Use 2nd engine if distance to crystal i less than 500
@@ -266,6 +305,7 @@ void Drone::swallow(Entity& crystal, Entity& drone, Vector3 direction, double de
 		else if (m_velocity.getNorm() >= safeSpeed)
 		{
 			m_velocity = Direction + crystal.getVelocity();
+			markTrajectoryChanged();
 		}
 	}
 
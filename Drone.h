@@ -9,7 +9,9 @@
 #include <cassert>
 
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
@@ -39,6 +41,7 @@ public:
 	//
 	Drone();
 
+#ifndef HEADLESS_SIMULATION
 	//
 	//  Constructor
 	//
@@ -77,6 +80,43 @@ public:
 		double acceleration_manoeuver,
 		double rotation_rate_radians,
 		const ObjLibrary::DisplayList& display_list);
+#endif
+
+	//
+	//  Constructor
+	//
+	//  Purpose: To create a Drone with the specified position,
+	//           velocity, mass, and radius that cannot be
+	//           displayed.
+	//  Parameter(s):
+	//    <1> position: The starting position
+	//    <2> velocity: The starting velocity
+	//    <3> mass: The mass when the fuel tanks are empty
+	//    <4> radius: The outer collision radius
+	//    <5> acceleration_main: The acceleration provided by the
+	//                           main engine
+	//    <6> acceleration_manoeuver: The acceleration provided by
+	//                                the manoeuvering engine
+	//    <7> rotation_rate_radians: The rotation rate in radians
+	//                               per second
+	//  Preconditions:
+	//    <1> mass                   >  0.0
+	//    <2> radius                 >= 0.0
+	//    <3> acceleration_main      >  0.0
+	//    <4> acceleration_manoeuver >  0.0
+	//    <5> rotation_rate_radians  >  0.0
+	//  Returns: N/A
+	//  Side Effect: A new Drone is created at position position
+	//               with velocity velocity.  It has a mass of mass
+	//               and a radius of radius.  It has no DisplayList.
+	//
+	Drone(const ObjLibrary::Vector3& position,
+		const ObjLibrary::Vector3& velocity,
+		double mass,
+		double radius,
+		double acceleration_main,
+		double acceleration_manoeuver,
+		double rotation_rate_radians);
 
 	Drone(const Drone& to_copy) = default;
 	~Drone() = default;
@@ -119,6 +159,7 @@ public:
 		double back_distance,
 		double up_distance) const;
 
+#ifndef HEADLESS_SIMULATION
 	//
 	//  setupFollowCamera
 	//
@@ -153,13 +194,19 @@ public:
 	//    <1> isInitialized()
 	//  Returns: N/A
 	//  Side Effect: A path of point_count vertexes is displayed for
-	//               this Spaceship is displayed.  It will start
-	//               with a colour of colour and then fade to black
-	//               at the end.
+	//               this Drone.  It will start with a colour of
+	//               colour and then fade to black at the end.
+	//
+	//  Unlike Spaceship::drawPath, this function does not use a
+	//    TrajectoryCache.  Drones thrust in almost every physics
+	//    step to hold formation or chase a crystal, so a cached
+	//    path would be recalculated in almost every frame anyway.
+	//    Instead, the path is predicted again each time.
 	//
 	void drawPath(const Entity& black_hole,
 		unsigned int point_count,
 		const ObjLibrary::Vector3& colour) const;
+#endif
 
 	//
 	//  markDead
@@ -5,30 +5,76 @@
 #include "Entity.h"
 
 #include <cassert>
+#include <atomic>
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/VertexBufferModel.h"
+#endif
 
 #include "Gravity.h"
 #include "CoordinateSystem.h"
+#include "Orbit.h"
+#ifndef HEADLESS_SIMULATION
+#include "RenderQueue.h"
+#endif
 
 using namespace ObjLibrary;
+namespace
+{
+	// shared by all Entities, and Entities may be changed on
+	//   several threads at once
+	std::atomic<unsigned int> next_trajectory_id(1);
+}  // end of anonymous namespace
 
 
 
 Entity :: Entity ()
 		: m_coords()
 		, m_velocity()
+		, m_is_initialized(false)
 		, m_mass(1.0)
 		, m_radius(0.0)
+#ifndef HEADLESS_SIMULATION
 		, m_display_list()
+		, m_vertex_buffer_model()
 		, m_scaling_factor(1.0)
+#endif
+		, m_trajectory_id(next_trajectory_id++)
 {
 	assert(!isInitialized());
 	assert(invariant());
 }
 
+Entity :: Entity (const ObjLibrary::Vector3& position,
+                  const ObjLibrary::Vector3& velocity,
+                  double mass,
+                  double radius)
+		: m_coords(position)
+		, m_velocity(velocity)
+		, m_is_initialized(true)
+		, m_mass(mass)
+		, m_radius(radius)
+#ifndef HEADLESS_SIMULATION
+		, m_display_list()
+		, m_vertex_buffer_model()
+		, m_scaling_factor(1.0)
+#endif
+		, m_trajectory_id(next_trajectory_id++)
+{
+	assert(mass   >= 0.0);
+	assert(radius >= 0.0);
+
+	assert(isInitialized());
+	assert(!isDrawable());
+	assert(invariant());
+}
+
+#ifndef HEADLESS_SIMULATION
 Entity :: Entity (const ObjLibrary::Vector3& position,
                   const ObjLibrary::Vector3& velocity,
                   double mass,
@@ -37,10 +83,13 @@ Entity :: Entity (const ObjLibrary::Vector3& position,
                   double scaling_factor)
 		: m_coords(position)
 		, m_velocity(velocity)
+		, m_is_initialized(true)
 		, m_mass(mass)
 		, m_radius(radius)
 		, m_display_list(display_list)
+		, m_vertex_buffer_model()
 		, m_scaling_factor(scaling_factor)
+		, m_trajectory_id(next_trajectory_id++)
 {
 	assert(mass   >= 0.0);
 	assert(radius >= 0.0);
@@ -48,23 +97,55 @@ Entity :: Entity (const ObjLibrary::Vector3& position,
 	assert(scaling_factor >= 0.0);
 
 	assert(isInitialized());
+	assert(isDrawable());
 	assert(invariant());
 }
+#endif
 
 
 
+#ifndef HEADLESS_SIMULATION
 void Entity :: draw () const
 {
 	assert(isInitialized());
+	assert(isDrawable());
 
 	glPushMatrix();
 		m_coords.applyDrawTransformations();
 		glScaled(m_scaling_factor, m_scaling_factor, m_scaling_factor);
-		assert(m_display_list.isReady());
-		m_display_list.draw();
+		if(m_vertex_buffer_model.isReady())
+			m_vertex_buffer_model.draw();
+		else
+		{
+			assert(m_display_list.isReady());
+			m_display_list.draw();
+		}
 	glPopMatrix();
 }
 
+void Entity :: addToRenderQueue (RenderQueue& r_queue,
+                                 unsigned int pass) const
+{
+	assert(isInitialized());
+	assert(isDrawable());
+	assert(pass < RenderQueue::PASS_COUNT);
+
+	// same transformations as draw
+	double a_matrix[16];
+	m_coords.calculateDrawMatrix(a_matrix);
+	for(unsigned int i = 0; i < 12; i++)
+		a_matrix[i] *= m_scaling_factor;
+
+	if(m_vertex_buffer_model.isReady())
+		r_queue.addModel(pass, m_vertex_buffer_model, a_matrix);
+	else
+	{
+		assert(m_display_list.isReady());
+		r_queue.addDisplayList(pass, m_display_list, a_matrix);
+	}
+}
+#endif
+
 
 
 void Entity :: setVelocity (const ObjLibrary::Vector3& velocity)
@@ -72,6 +153,7 @@ void Entity :: setVelocity (const ObjLibrary::Vector3& velocity)
 	assert(isInitialized());
 
 	m_velocity = velocity;
+	markTrajectoryChanged();
 
 	assert(invariant());
 }
@@ -81,6 +163,18 @@ void Entity :: addVelocity (const ObjLibrary::Vector3& delta)
 	assert(isInitialized());
 
 	m_velocity += delta;
+	markTrajectoryChanged();
+
+	assert(invariant());
+}
+
+void Entity :: setPositionAndVelocity (const ObjLibrary::Vector3& position,
+                                       const ObjLibrary::Vector3& velocity)
+{
+	assert(isInitialized());
+
+	m_coords.setPosition(position);
+	m_velocity = velocity;
 
 	assert(invariant());
 }
@@ -122,13 +216,75 @@ void Entity :: updatePhysics (double delta_time,
 	assert(invariant());
 }
 
+void Entity :: updatePhysicsOnRails (double delta_time,
+                                     const Entity& black_hole)
+{
+	assert(isInitialized());
+	assert(delta_time > 0.0);
 
+	const Vector3& black_hole_position = black_hole.getPosition();
+	Vector3 relative_position = m_coords.getPosition() - black_hole_position;
+	if(relative_position.isZero())
+	{
+		m_coords.setPosition(m_coords.getPosition() + m_velocity * delta_time);
+		return;
+	}
+
+	Orbit orbit(relative_position, m_velocity, GRAVITY * black_hole.getMass());
+	Vector3 new_relative_position;
+	orbit.getStateAt(delta_time, new_relative_position, m_velocity);
+	m_coords.setPosition(black_hole_position + new_relative_position);
+
+	assert(invariant());
+}
+
+
+
+#ifndef HEADLESS_SIMULATION
+void Entity :: setDisplayList (const ObjLibrary::DisplayList& display_list,
+                               double scaling_factor)
+{
+	assert(isInitialized());
+	assert(display_list.isReady());
+	assert(scaling_factor > 0.0);
+
+	m_display_list   = display_list;
+	m_scaling_factor = scaling_factor;
+	m_vertex_buffer_model.makeEmpty();
+
+	assert(isDrawable());
+	assert(invariant());
+}
+
+void Entity :: setVertexBufferModel (const ObjLibrary::VertexBufferModel& vertex_buffer_model,
+                                     double scaling_factor)
+{
+	assert(isInitialized());
+	assert(vertex_buffer_model.isReady());
+	assert(scaling_factor > 0.0);
+
+	m_vertex_buffer_model = vertex_buffer_model;
+	m_scaling_factor      = scaling_factor;
+	m_display_list.makeEmpty();
+
+	assert(isDrawable());
+	assert(invariant());
+}
+#endif
+
+void Entity :: markTrajectoryChanged ()
+{
+	m_trajectory_id = next_trajectory_id++;
+}
 
 bool Entity :: invariant () const
 {
 	if(m_mass <= 0.0) return false;
 	if(m_radius < 0.0) return false;
+#ifndef HEADLESS_SIMULATION
 	if(m_display_list.isPartial()) return false;
+	if(!m_display_list.isEmpty() && !m_vertex_buffer_model.isEmpty()) return false;
 	if(m_scaling_factor <= 0.0) return false;
+#endif
 	return true;
 }
@@ -9,10 +9,15 @@
 #include <cassert>
 
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/VertexBufferModel.h"
+#endif
 
 #include "CoordinateSystem.h"
 
+class RenderQueue;
+
 
 
 //
@@ -29,6 +34,19 @@
 //    <2> m_radius >= 0.0
 //    <3> !m_display_list.isPartial();
 //    <4> m_scaling_factor > 0.0
+//    <5> m_display_list.isEmpty() ||
+//        m_vertex_buffer_model.isEmpty()
+//
+//  The simulation state (position, velocity, mass, and radius)
+//    is independant of the display state.  An Entity created
+//    without a DisplayList is initialized and can be simulated,
+//    but it cannot be drawn.  This allows the world to be run
+//    without an OpenGL context.  If HEADLESS_SIMULATION is
+//    defined, the display state and the drawing functions are
+//    left out entirely, so the OpenGL libraries are not needed.
+//
+//  An Entity can be displayed with either a DisplayList or a
+//    VertexBufferModel.  Setting one replaces the other.
 //
 class Entity
 {
@@ -45,6 +63,31 @@ public:
 //
 	Entity ();
 
+//
+//  Constructor
+//
+//  Purpose: To create an Entity with the specified values and
+//           no DisplayList.
+//  Parameter(s):
+//    <1> position: The starting position
+//    <2> velocity: The starting velocity
+//    <3> mass: The mass
+//    <4> radius: The collision radius
+//  Preconditions: N/A
+//    <1> mass   >  0.0
+//    <2> radius >= 0.0
+//  Returns: N/A
+//  Side Effect: A new Entity is created at position position
+//               with velocity velocity.  It has a mass of mass
+//               and a collision radius of radius.  It cannot be
+//               displayed.
+//
+	Entity (const ObjLibrary::Vector3& position,
+	        const ObjLibrary::Vector3& velocity,
+	        double mass,
+	        double radius);
+
+#ifndef HEADLESS_SIMULATION
 //
 //  Constructor
 //
@@ -74,6 +117,7 @@ public:
 	        double radius,
 	        const ObjLibrary::DisplayList& display_list,
 	        double scaling_factor);
+#endif
 
 	Entity (const Entity& to_copy) = default;
 	~Entity () = default;
@@ -91,7 +135,28 @@ public:
 //
 	bool isInitialized () const
 	{
-		return m_display_list.isReady();
+		return m_is_initialized;
+	}
+
+//
+//  isDrawable
+//
+//  Purpose: To determine whether this Entity can be displayed.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this Entity has been initialized with a
+//           DisplayList or a VertexBufferModel.  If
+//           HEADLESS_SIMULATION is defined, false is always
+//           returned.
+//  Side Effect: N/A
+//
+	bool isDrawable () const
+	{
+#ifdef HEADLESS_SIMULATION
+		return false;
+#else
+		return m_display_list.isReady() || m_vertex_buffer_model.isReady();
+#endif
 	}
 
 //
@@ -222,6 +287,29 @@ public:
 		return m_radius;
 	}
 
+//
+//  getTrajectoryId
+//
+//  Purpose: To determine which trajectory this Entity is
+//           following.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: An identifier for the current trajectory of this
+//           Entity.  The identifier changes whenever the
+//           velocity of this Entity is changed by anything
+//           other than gravity (e.g. thrust or a collision), so
+//           a prediction of the path made with the same
+//           identifier is still valid.  Copies of an Entity
+//           have the same identifier until one of them is
+//           changed.
+//  Side Effect: N/A
+//
+	unsigned int getTrajectoryId () const
+	{
+		return m_trajectory_id;
+	}
+
+#ifndef HEADLESS_SIMULATION
 //
 //  draw
 //
@@ -229,11 +317,34 @@ public:
 //  Parameter(s): N/A
 //  Preconditions:
 //    <1> isInitialized()
+//    <2> isDrawable()
 //  Returns: N/A
 //  Side Effect: This Entity is displayed.
 //
 	virtual void draw () const;
 
+//
+//  addToRenderQueue
+//
+//  Purpose: To add the commands to display this Entity to the
+//           specified RenderQueue.
+//  Parameter(s):
+//    <1> r_queue: The RenderQueue
+//    <2> pass: The pass to display this Entity in
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> isDrawable()
+//    <3> pass < RenderQueue::PASS_COUNT
+//  Returns: N/A
+//  Side Effect: Commands to display this Entity as draw would
+//               are added to r_queue.  The model for this
+//               Entity is stored by pointer, so this Entity
+//               must exist until r_queue is executed.
+//
+	virtual void addToRenderQueue (RenderQueue& r_queue,
+	                               unsigned int pass) const;
+#endif
+
 //
 //  setVelocity
 //
@@ -244,7 +355,8 @@ public:
 //    <1> isInitialized()
 //  Returns: N/A
 //  Side Effect: This Entity is changed to be moving at velocity
-//               velocity.
+//               velocity.  It is given a new trajectory
+//               identifier.
 //
 	void setVelocity (const ObjLibrary::Vector3& velocity);
 
@@ -259,10 +371,33 @@ public:
 //    <1> isInitialized()
 //  Returns: N/A
 //  Side Effect: This velocity of this Entity is increased by
-//               delta.
+//               delta.  It is given a new trajectory
+//               identifier.
 //
 	void addVelocity (const ObjLibrary::Vector3& delta);
 
+//
+//  setPositionAndVelocity
+//
+//  Purpose: To change the position and velocity of this Entity
+//           at the same time.  This is used when the physics
+//           update has been calculated somewhere else (e.g. in
+//           a BodyStore).
+//  Parameter(s):
+//    <1> position: The new position
+//    <2> velocity: The new velocity
+//  Preconditions:
+//    <1> isInitialized()
+//  Returns: N/A
+//  Side Effect: This Entity is moved to position position and
+//               is changed to be moving at velocity velocity.
+//               Its orientation and trajectory identifier are
+//               not changed, so this must only be used for
+//               motion caused by gravity.
+//
+	void setPositionAndVelocity (const ObjLibrary::Vector3& position,
+	                             const ObjLibrary::Vector3& velocity);
+
 //
 //  updatePhysics
 //
@@ -284,6 +419,29 @@ public:
 	virtual void updatePhysics (double delta_time,
 	                            const Entity& black_hole);
 
+//
+//  updatePhysicsOnRails
+//
+//  Purpose: To perform the physics updates for this Entity
+//           for one time step by following its exact orbit
+//           around the black hole.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//    <2> black_hole: The black hole
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: This Entity is moved along its two-body orbit
+//               around black_hole for delta_time seconds.
+//               Unlike updatePhysics, the result does not
+//               depend on the time step, so delta_time can be
+//               very large.  If this Entity is at the center of
+//               the black hole, it moves in a straight line.
+//
+	virtual void updatePhysicsOnRails (double delta_time,
+	                                   const Entity& black_hole);
+
 protected:
 //
 //  setMass
@@ -307,6 +465,69 @@ protected:
 		assert(invariant());
 	}
 
+#ifndef HEADLESS_SIMULATION
+//
+//  setDisplayList
+//
+//  Purpose: To change how this Entity is displayed.  This
+//           allows the DisplayList to be created after the
+//           Entity.
+//  Parameter(s):
+//    <1> display_list: The DisplayList for this Entity
+//    <2> scaling_factor: The scaling factor for display_list
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> display_list.isReady()
+//    <3> scaling_factor > 0.0
+//  Returns: N/A
+//  Side Effect: This Entity is set to be displayed with
+//               DisplayList display_list, uniformly scaled by
+//               scaling_factor.  Any VertexBufferModel is
+//               removed.
+//
+	void setDisplayList (const ObjLibrary::DisplayList& display_list,
+	                     double scaling_factor);
+
+//
+//  setVertexBufferModel
+//
+//  Purpose: To change how this Entity is displayed to use a
+//           VertexBufferModel instead of a DisplayList.
+//  Parameter(s):
+//    <1> vertex_buffer_model: The VertexBufferModel for this
+//                             Entity
+//    <2> scaling_factor: The scaling factor for
+//                        vertex_buffer_model
+//  Preconditions:
+//    <1> isInitialized()
+//    <2> vertex_buffer_model.isReady()
+//    <3> scaling_factor > 0.0
+//  Returns: N/A
+//  Side Effect: This Entity is set to be displayed with
+//               VertexBufferModel vertex_buffer_model,
+//               uniformly scaled by scaling_factor.  Any
+//               DisplayList is removed.
+//
+	void setVertexBufferModel (
+	        const ObjLibrary::VertexBufferModel& vertex_buffer_model,
+	        double scaling_factor);
+#endif
+
+//
+//  markTrajectoryChanged
+//
+//  Purpose: To record that the velocity of this Entity has
+//           been changed by something other than gravity.
+//           Derived classes that change m_velocity directly
+//           must call this.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This Entity is given a new trajectory
+//               identifier.
+//
+	void markTrajectoryChanged ();
+
 private:
 //
 //  invariant
@@ -324,10 +545,15 @@ protected:
 	ObjLibrary::Vector3 m_velocity;
 
 private:
+	bool m_is_initialized;
 	double m_mass;
 	double m_radius;
+#ifndef HEADLESS_SIMULATION
 	ObjLibrary::DisplayList m_display_list;
+	ObjLibrary::VertexBufferModel m_vertex_buffer_model;
 	double m_scaling_factor;
+#endif
+	unsigned int m_trajectory_id;
 };
 
 
@@ -0,0 +1,204 @@
+//
+//  Headless.cpp
+//
+//  A program to run the world simulation without a window.
+//    There is no GLUT, no display lists, and no fixed update
+//    rate: physics steps are run back-to-back as fast as the
+//    CPU allows.  This is useful for batch runs, soak tests,
+//    and profiling on machines without a display.
+//
+//  To build the headless program, define the macro
+//    HEADLESS_SIMULATION when compiling every source file.
+//    The drawing functions and display models are then left
+//    out of the entity classes and the World, and the files
+//    that are only used for display (including main.cpp) are
+//    empty, so the OpenGL libraries are not linked.  Only
+//    ObjLibrary/Vector3.cpp is needed from the ObjLibrary.
+//
+//  Usage: headless [steps [asteroids [seed [threads]]]]
+//
+//  If threads is 0 or not specified, the number of hardware
+//    threads is used.
+//
+//  At the end, a hash of the positions and velocities of every
+//    entity is printed.  Runs with the same arguments should
+//    print the same hash, whatever the number of threads or
+//    optimization level, so it can be used to check that a
+//    change does not change the simulation.
+//
+
+#ifdef HEADLESS_SIMULATION
+
+#include <cassert>
+#include <cstdint>
+#include <cstdlib>
+#include <iostream>
+#include <iomanip>
+#include <chrono>
+
+#include "World.h"
+
+using namespace std;
+using namespace chrono;
+namespace
+{
+	const unsigned int STEP_COUNT_DEFAULT = 3600;
+	const unsigned int SEED_DEFAULT       = 1;
+	const unsigned int THREAD_COUNT_DEFAULT = 0;  // hardware threads
+	const unsigned int REPORT_INTERVAL    = 600;
+	const double SECONDS_PER_PHYSICS = 1.0 / 60.0;
+
+	// 64-bit FNV-1a
+	const uint64_t HASH_OFFSET_BASIS = UINT64_C(14695981039346656037);
+	const uint64_t HASH_PRIME        = UINT64_C(1099511628211);
+
+
+
+	unsigned int parseUnsigned (const char* p_text,
+	                            unsigned int default_value)
+	{
+		assert(p_text != nullptr);
+
+		char* p_end = nullptr;
+		unsigned long value = strtoul(p_text, &p_end, 10);
+		if(p_end == p_text || *p_end != '\0')
+		{
+			cerr << "Invalid number \"" << p_text << "\", using " << default_value << endl;
+			return default_value;
+		}
+		return (unsigned int)(value);
+	}
+
+	unsigned int countDriftingCrystals (const World& world)
+	{
+		unsigned int crystal_count = 0;
+		for(unsigned c = 0; c < world.getCrystalCount(); c++)
+			if(!world.getCrystal(c).isGone())
+				crystal_count++;
+		return crystal_count;
+	}
+
+	void addToHash (uint64_t& r_hash,
+	                const void* p_data,
+	                size_t byte_count)
+	{
+		assert(p_data != nullptr);
+
+		const unsigned char* p_bytes = (const unsigned char*)(p_data);
+		for(size_t i = 0; i < byte_count; i++)
+		{
+			r_hash ^= p_bytes[i];
+			r_hash *= HASH_PRIME;
+		}
+	}
+
+	void addToHash (uint64_t& r_hash,
+	                const ObjLibrary::Vector3& vector)
+	{
+		double a_values[3] = { vector.x, vector.y, vector.z };
+		addToHash(r_hash, a_values, sizeof(a_values));
+	}
+
+	void addToHash (uint64_t& r_hash,
+	                const Entity& entity)
+	{
+		addToHash(r_hash, entity.getPosition());
+		addToHash(r_hash, entity.getVelocity());
+	}
+
+	uint64_t calculateStateHash (const World& world)
+	{
+		uint64_t hash = HASH_OFFSET_BASIS;
+		for(unsigned int a = 0; a < world.getAsteroidCount(); a++)
+			addToHash(hash, world.getAsteroid(a));
+		for(unsigned int c = 0; c < world.getCrystalCount(); c++)
+		{
+			const Crystal& crystal = world.getCrystal(c);
+			unsigned char is_gone = crystal.isGone() ? 1 : 0;
+			addToHash(hash, &is_gone, sizeof(is_gone));
+			addToHash(hash, crystal);
+		}
+		addToHash(hash, world.getPlayer());
+		for(unsigned int d = 0; d < World::DRONE_COUNT; d++)
+		{
+			const Drone& drone = world.getDrone(d);
+			unsigned char is_alive = drone.isAlive() ? 1 : 0;
+			addToHash(hash, &is_alive, sizeof(is_alive));
+			addToHash(hash, drone);
+		}
+		return hash;
+	}
+
+	void printStatus (const World& world,
+	                  unsigned int step,
+	                  duration<double> elapsed)
+	{
+		cout << "Step " << setw(8) << step
+		     << "  " << fixed << setprecision(3) << elapsed.count() << " s"
+		     << "  asteroids: " << world.getAsteroidCount()
+		     << "  crystals: "  << countDriftingCrystals(world)
+		     << "  collected: " << world.getCrystalsCollected()
+		     << "  drones: "    << world.getLiveDroneCount()
+		     << "  player: "    << (world.getPlayer().isAlive() ? "alive" : "dead")
+		     << endl;
+	}
+
+}  // end of anonymous namespace
+
+
+
+int main (int argc, char* argv[])
+{
+	unsigned int step_count     = STEP_COUNT_DEFAULT;
+	unsigned int asteroid_count = World::ASTEROID_COUNT_DEFAULT;
+	unsigned int seed           = SEED_DEFAULT;
+	unsigned int thread_count   = THREAD_COUNT_DEFAULT;
+	if(argc > 1)
+		step_count = parseUnsigned(argv[1], STEP_COUNT_DEFAULT);
+	if(argc > 2)
+		asteroid_count = parseUnsigned(argv[2], World::ASTEROID_COUNT_DEFAULT);
+	if(argc > 3)
+		seed = parseUnsigned(argv[3], SEED_DEFAULT);
+	if(argc > 4)
+		thread_count = parseUnsigned(argv[4], THREAD_COUNT_DEFAULT);
+	if(asteroid_count < 2)
+		asteroid_count = 2;
+
+	srand(seed);
+
+	World world(thread_count);
+	steady_clock::time_point init_start = steady_clock::now();
+	world.init(asteroid_count);
+	duration<double> init_duration = steady_clock::now() - init_start;
+	cout << "Created world with " << asteroid_count << " asteroids in "
+	     << fixed << setprecision(3) << init_duration.count() << " s (seed " << seed << ", "
+	     << world.getThreadCount() << " threads)" << endl;
+
+	steady_clock::time_point start = steady_clock::now();
+	for(unsigned int step = 1; step <= step_count; step++)
+	{
+		world.updatePhysics(SECONDS_PER_PHYSICS);
+		world.handleCollisions();
+
+		if(step % REPORT_INTERVAL == 0)
+			printStatus(world, step, steady_clock::now() - start);
+	}
+	duration<double> total = steady_clock::now() - start;
+
+	// the loop has already reported the last step if it was on
+	//   a report interval
+	if(step_count == 0 || step_count % REPORT_INTERVAL != 0)
+		printStatus(world, step_count, total);
+	cout << "State hash: " << hex << setfill('0') << setw(16)
+	     << calculateStateHash(world) << dec << setfill(' ') << endl;
+	if(step_count > 0)
+	{
+		double milliseconds_per_step = total.count() * 1000.0 / step_count;
+		cout << "Average: " << setprecision(4) << milliseconds_per_step << " ms per step ("
+		     << setprecision(1) << (1000.0 / milliseconds_per_step) << " steps per second)" << endl;
+	}
+
+	return 0;
+}
+
+#endif
@@ -0,0 +1,88 @@
+//
+//  LevelOfDetailSelector.cpp
+//
+
+#include "LevelOfDetailSelector.h"
+
+#include <cassert>
+#include <vector>
+
+using namespace std;
+
+
+
+LevelOfDetailSelector :: LevelOfDetailSelector ()
+		: mv_min_pixel_radii(1, 0.0)
+		, m_hysteresis(0.0)
+		, mv_levels()
+{
+	assert(getLevelCount() == 1);
+	assert(getObjectCount() == 0);
+	assert(invariant());
+}
+
+LevelOfDetailSelector :: LevelOfDetailSelector (const std::vector<double>& v_min_pixel_radii,
+                                                double hysteresis)
+		: mv_min_pixel_radii(v_min_pixel_radii)
+		, m_hysteresis(hysteresis)
+		, mv_levels()
+{
+	assert(!v_min_pixel_radii.empty());
+	assert(v_min_pixel_radii.back() == 0.0);
+	assert(hysteresis >= 0.0);
+	assert(hysteresis <  1.0);
+
+	assert(getLevelCount() == v_min_pixel_radii.size());
+	assert(getObjectCount() == 0);
+	assert(invariant());
+}
+
+
+
+void LevelOfDetailSelector :: setObjectCount (unsigned int object_count)
+{
+	if(object_count != getObjectCount())
+		mv_levels.assign(object_count, getLevelCount() - 1);
+
+	assert(getObjectCount() == object_count);
+	assert(invariant());
+}
+
+unsigned int LevelOfDetailSelector :: update (unsigned int object,
+                                              double pixel_radius)
+{
+	assert(object < getObjectCount());
+	assert(pixel_radius >= 0.0);
+
+	// the last threshold is 0.0, so these loops stop in range
+	unsigned int level = mv_levels[object];
+	while(level > 0 &&
+	      pixel_radius >= mv_min_pixel_radii[level - 1] * (1.0 + m_hysteresis))
+	{
+		level--;
+	}
+	while(pixel_radius < mv_min_pixel_radii[level] * (1.0 - m_hysteresis))
+	{
+		level++;
+		assert(level < getLevelCount());
+	}
+	mv_levels[object] = level;
+
+	assert(invariant());
+	return level;
+}
+
+
+
+bool LevelOfDetailSelector :: invariant () const
+{
+	if(mv_min_pixel_radii.empty()) return false;
+	if(mv_min_pixel_radii.back() != 0.0) return false;
+	for(unsigned int i = 0; i + 1 < mv_min_pixel_radii.size(); i++)
+		if(mv_min_pixel_radii[i] <= mv_min_pixel_radii[i + 1]) return false;
+	if(m_hysteresis < 0.0) return false;
+	if(m_hysteresis >= 1.0) return false;
+	for(unsigned int i = 0; i < mv_levels.size(); i++)
+		if(mv_levels[i] >= mv_min_pixel_radii.size()) return false;
+	return true;
+}
@@ -0,0 +1,180 @@
+//
+//  LevelOfDetailSelector.h
+//
+//  A module to choose the level of detail to display objects at
+//    from their size on the screen.
+//
+
+#pragma once
+
+#include <vector>
+
+
+
+//
+//  LevelOfDetailSelector
+//
+//  A class to choose a level of detail (LOD) for each of a
+//    number of objects, based on their radius on the screen in
+//    pixels.  LOD 0 is the most detailed.  An object is
+//    displayed at LOD i if its radius is at least
+//    mv_min_pixel_radii[i] and it is too small for LOD i - 1.
+//
+//  To keep objects near a threshold from switching back and
+//    forth every frame, the threshold is lowered by the
+//    hysteresis fraction for objects that are already at that
+//    LOD or a more detailed one, and raised by it for objects
+//    that are at a less detailed one.  Therefore, the LOD of
+//    each object is remembered between frames.
+//
+//  Class Invariant:
+//    <1> !mv_min_pixel_radii.empty()
+//    <2> mv_min_pixel_radii.back() == 0.0
+//    <3> mv_min_pixel_radii[i] > mv_min_pixel_radii[i + 1]
+//        WHERE 0 <= i < mv_min_pixel_radii.size() - 1
+//    <4> m_hysteresis >= 0.0
+//    <5> m_hysteresis < 1.0
+//    <6> mv_levels[i] < mv_min_pixel_radii.size()
+//        WHERE 0 <= i < mv_levels.size()
+//
+class LevelOfDetailSelector
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a LevelOfDetailSelector with only one
+//           level of detail.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new LevelOfDetailSelector is created.  Every
+//               object is displayed at LOD 0.  There are no
+//               objects.
+//
+	LevelOfDetailSelector ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a LevelOfDetailSelector with the
+//           specified thresholds.
+//  Parameter(s):
+//    <1> v_min_pixel_radii: The smallest radius on the screen,
+//                           in pixels, for each LOD
+//    <2> hysteresis: The fraction the thresholds are moved by
+//                    to avoid switching LODs too often
+//  Preconditions:
+//    <1> !v_min_pixel_radii.empty()
+//    <2> v_min_pixel_radii.back() == 0.0
+//    <3> v_min_pixel_radii[i] > v_min_pixel_radii[i + 1]
+//        WHERE 0 <= i < v_min_pixel_radii.size() - 1
+//    <4> hysteresis >= 0.0
+//    <5> hysteresis < 1.0
+//  Returns: N/A
+//  Side Effect: A new LevelOfDetailSelector is created with
+//               v_min_pixel_radii.size() LODs.  There are no
+//               objects.
+//
+	LevelOfDetailSelector (const std::vector<double>& v_min_pixel_radii,
+	                       double hysteresis);
+
+	LevelOfDetailSelector (const LevelOfDetailSelector& to_copy) = default;
+	~LevelOfDetailSelector () = default;
+	LevelOfDetailSelector& operator= (const LevelOfDetailSelector& to_copy) = default;
+
+//
+//  getLevelCount
+//
+//  Purpose: To determine how many LODs there are.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of LODs.
+//  Side Effect: N/A
+//
+	unsigned int getLevelCount () const
+	{
+		return (unsigned int)(mv_min_pixel_radii.size());
+	}
+
+//
+//  getObjectCount
+//
+//  Purpose: To determine how many objects LODs are remembered
+//           for.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of objects.
+//  Side Effect: N/A
+//
+	unsigned int getObjectCount () const
+	{
+		return (unsigned int)(mv_levels.size());
+	}
+
+//
+//  getLevels
+//
+//  Purpose: To retrieve the current LOD for every object.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: A vector with getObjectCount() elements, each less
+//           than getLevelCount().  Element i is the LOD for
+//           object i.
+//  Side Effect: N/A
+//
+	const std::vector<unsigned int>& getLevels () const
+	{
+		return mv_levels;
+	}
+
+//
+//  setObjectCount
+//
+//  Purpose: To change how many objects LODs are remembered for.
+//  Parameter(s):
+//    <1> object_count: The number of objects
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: If object_count is different from
+//               getObjectCount(), all objects are reset to the
+//               least detailed LOD.  They will be given the
+//               correct LOD the next time update is called.
+//
+	void setObjectCount (unsigned int object_count);
+
+//
+//  update
+//
+//  Purpose: To choose the LOD for an object.
+//  Parameter(s):
+//    <1> object: Which object
+//    <2> pixel_radius: The radius of the object on the screen,
+//                      in pixels
+//  Preconditions:
+//    <1> object < getObjectCount()
+//    <2> pixel_radius >= 0.0
+//  Returns: The new LOD for object object.
+//  Side Effect: The LOD for object object is changed if its
+//               radius is far enough past a threshold.
+//
+	unsigned int update (unsigned int object,
+	                     double pixel_radius);
+
+private:
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::vector<double> mv_min_pixel_radii;
+	double m_hysteresis;
+	std::vector<unsigned int> mv_levels;
+};
@@ -111,6 +111,35 @@ namespace
 
 	bool g_is_material_active = false;
 
+	// the state cache: the Material whose state was pushed and
+	//   has not been popped, or NULL if there is none
+	bool g_is_state_cache_enabled = false;
+	const Material* gp_pushed_material = NULL;
+	unsigned int g_state_change_issued_count  = 0;
+	unsigned int g_state_change_skipped_count = 0;
+
+	//
+	//  popCachedState
+	//
+	//  Purpose: To pop the OpenGL state for the Material left
+	//           in place by the state cache, if any.
+	//  Parameter(s): N/A
+	//  Precondition(s):  N/A
+	//  Returns: N/A
+	//  Side Effect: If gp_pushed_material is not NULL, the
+	//               OpenGL state is popped and
+	//               gp_pushed_material is set to NULL.
+	//
+	void popCachedState ()
+	{
+		if(gp_pushed_material != NULL)
+		{
+			glPopAttrib();
+			g_state_change_issued_count++;
+			gp_pushed_material = NULL;
+		}
+	}
+
 }	// end of anonymous namespace
 
 
@@ -170,13 +199,54 @@ bool Material :: isMaterialActive ()
 void Material :: deactivate ()
 {
 	if(g_is_material_active)
-		glPopAttrib();
+	{
+		if(g_is_state_cache_enabled && gp_pushed_material != NULL)
+			g_state_change_skipped_count++;  // leave in place
+		else
+		{
+			glPopAttrib();
+			g_state_change_issued_count++;
+			gp_pushed_material = NULL;
+		}
+	}
 
 	g_is_material_active = false;
 
 	assert(!isMaterialActive());
 }
 
+bool Material :: isStateCacheEnabled ()
+{
+	return g_is_state_cache_enabled;
+}
+
+void Material :: setStateCacheEnabled (bool is_enabled)
+{
+	assert(!isMaterialActive());
+
+	if(!is_enabled)
+		popCachedState();
+	g_is_state_cache_enabled = is_enabled;
+
+	assert(isStateCacheEnabled() == is_enabled);
+}
+
+unsigned int Material :: getStateChangeIssuedCount ()
+{
+	return g_state_change_issued_count;
+}
+
+unsigned int Material :: getStateChangeSkippedCount ()
+{
+	return g_state_change_skipped_count;
+}
+
+void Material :: resetStateChangeCounts ()
+{
+	g_state_change_issued_count  = 0;
+	g_state_change_skipped_count = 0;
+}
+
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 
@@ -1139,6 +1209,17 @@ void Material :: activate () const
 	assert(Texture::isGlutInitialized());
 	assert(!isMaterialActive());
 
+	if(gp_pushed_material == this)
+	{
+		// state was left in place by the state cache
+		assert(g_is_state_cache_enabled);
+		g_state_change_skipped_count++;
+		g_is_material_active = true;
+		assert(isMaterialActive());
+		return;
+	}
+	popCachedState();
+
 	GLfloat a_emission[4];
 	GLfloat a_ambient [4];
 	GLfloat a_diffuse [4];
@@ -1180,6 +1261,8 @@ void Material :: activate () const
 	}
 
 	glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT |  GL_CURRENT_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT | GL_ENABLE_BIT);
+	g_state_change_issued_count++;
+	gp_pushed_material = this;
 
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_LESS);
@@ -1350,7 +1433,10 @@ void Material :: activateSeperateSpecular () const
 
 	GLfloat a_specular[4];
 
+	// the specular pass is never left in place
+	popCachedState();
 	glPushAttrib(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT | GL_LIGHTING_BIT | GL_TEXTURE_BIT);
+	g_state_change_issued_count++;
 
 	glEnable(GL_DEPTH_TEST);
 	glDepthFunc(GL_EQUAL);
@@ -2256,6 +2342,26 @@ void Material :: loadDisplayTextures (const std::string& texture_path)
 	assert(invariant());
 }
 
+void Material :: preloadDisplayTextures (std::ostream& r_logstream) const
+{
+	// the texture is already chosen and loaded
+	if(m_texture_type_display != TEXTURE_TYPE_UNSPECIFIED)
+		return;
+
+	// same order as loadDisplayTextures
+	if(m_diffuse_filename != "" &&
+	   TextureManager::preloadImage(m_texture_path + m_diffuse_filename, r_logstream))
+		return;
+	if(m_ambient_filename != "" &&
+	   TextureManager::preloadImage(m_texture_path + m_ambient_filename, r_logstream))
+		return;
+	if(m_specular_filename != "" &&
+	   TextureManager::preloadImage(m_texture_path + m_specular_filename, r_logstream))
+		return;
+	if(m_emission_filename != "")
+		TextureManager::preloadImage(m_texture_path + m_emission_filename, r_logstream);
+}
+
 void Material :: loadAllTextures ()
 {
 	assert(Texture::isGlutInitialized());
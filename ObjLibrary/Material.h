@@ -376,6 +376,86 @@ public:
 //               deactivated.
 //
 	static void deactivate ();
+
+//
+//  Class Function: isStateCacheEnabled
+//
+//  Purpose: To determine if redundant Material state changes
+//           are currently being skipped.
+//  Parameter(s): N/A
+//  Precondition(s):  N/A
+//  Returns: Whether the state cache is enabled.
+//  Side Effect: N/A
+//
+	static bool isStateCacheEnabled ();
+
+//
+//  Class Function: setStateCacheEnabled
+//
+//  Purpose: To enable or disable skipping redundant Material
+//           state changes.  While the state cache is enabled,
+//           deactivate leaves the OpenGL state for the last
+//           Material in place.  If the same Material is
+//           activated next, the state is not pushed or set
+//           again.  If a different Material is activated, the
+//           old state is popped first.
+//  Parameter(s):
+//    <1> is_enabled: Whether the state cache should be enabled
+//  Precondition(s):
+//    <1> !isMaterialActive()
+//  Returns: N/A
+//  Side Effect: The state cache is enabled or disabled.  If it
+//               is disabled, any Material state left in place
+//               is popped, so the OpenGL state is the same as
+//               if the state cache had never been enabled.
+//  Note: While the state cache is enabled, nothing should be
+//        drawn without an active Material, the OpenGL state set
+//        by activate should not be changed between calls to
+//        deactivate and activate, and DisplayLists should not
+//        be created.  Otherwise, the results will be incorrect.
+//
+	static void setStateCacheEnabled (bool is_enabled);
+
+//
+//  Class Function: getStateChangeIssuedCount
+//
+//  Purpose: To determine how many Material state changes have
+//           been sent to OpenGL.
+//  Parameter(s): N/A
+//  Precondition(s):  N/A
+//  Returns: The number of times the state for a Material has
+//           been pushed or popped since the counts were last
+//           reset.
+//  Side Effect: N/A
+//
+	static unsigned int getStateChangeIssuedCount ();
+
+//
+//  Class Function: getStateChangeSkippedCount
+//
+//  Purpose: To determine how many Material state changes have
+//           been skipped by the state cache.
+//  Parameter(s): N/A
+//  Precondition(s):  N/A
+//  Returns: The number of times the state for a Material was
+//           not pushed or popped because of the state cache
+//           since the counts were last reset.
+//  Side Effect: N/A
+//
+	static unsigned int getStateChangeSkippedCount ();
+
+//
+//  Class Function: resetStateChangeCounts
+//
+//  Purpose: To reset the counts of issued and skipped Material
+//           state changes.
+//  Parameter(s): N/A
+//  Precondition(s):  N/A
+//  Returns: N/A
+//  Side Effect: The issued and skipped state change counts are
+//               set to 0.
+//
+	static void resetStateChangeCounts ();
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 //
@@ -2457,6 +2537,30 @@ public:
 //
 	void loadDisplayTextures (const std::string& texture_path);
 
+//
+//  preloadDisplayTextures
+//
+//  Purpose: To read the images for the textures that would be
+//           used when displaying this Material into memory,
+//           without adding them to OpenGL.  This function may
+//           be called from any thread, but not while textures
+//           for this Material are being loaded on another
+//           thread.
+//  Parameter(s):
+//    <1> r_logstream: The stream to write loading errors to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The textures are checked in the same order as
+//               loadDisplayTextures does, and the image for
+//               each one is read with
+//               TextureManager::preloadImage until one is
+//               read successfully.  The current texture path
+//               is prepended to each texture name.  A later
+//               call to loadDisplayTextures will use these
+//               images instead of reading the files.
+//
+	void preloadDisplayTextures (std::ostream& r_logstream) const;
+
 //
 //  loadAllTextures
 //
@@ -20,8 +20,10 @@
 #include <cassert>
 #include <string>
 #include <vector>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
+#include <mutex>
 
 #include "ObjStringParsing.h"
 #include "MtlLibrary.h"
@@ -35,12 +37,78 @@ namespace
 {
 	std::vector<MtlLibrary*> g_mtl_libraries;
 	MtlLibrary g_empty;
+
+	// the same libraries by lowercase file name with path
+	std::unordered_map<std::string, MtlLibrary*> g_mtl_libraries_by_name;
+
+	// how many times unloadAll has been called
+	unsigned int g_unload_count = 0;
+
+	//
+	//  This mutex protects g_mtl_libraries.  It is held while a
+	//    new MtlLibrary is read, so if several threads ask for
+	//    the same library, it is only loaded once.  MTL files
+	//    are small, so this does not slow loading much.
+	//
+	std::mutex g_mtl_libraries_mutex;
+
+
+
+//
+//  findLibrary
+//
+//  Purpose: To find the material library with the specified
+//           name.
+//  Parameter(s):
+//    <1> lower: The name of the material library, in
+//               lowercase
+//  Precondition(s):
+//    <1> g_mtl_libraries_mutex is locked by this thread
+//  Returns: A pointer to the MtlLibrary with name lower, or
+//           NULL if there is none.
+//  Side Effect: N/A
+//
+	MtlLibrary* findLibrary (const string& lower)
+	{
+		unordered_map<string, MtlLibrary*>::const_iterator it = g_mtl_libraries_by_name.find(lower);
+		if(it == g_mtl_libraries_by_name.end())
+			return NULL;
+
+		assert(it->second != NULL);
+		assert(it->second->getFileNameWithPathLowercase() == lower);
+		return it->second;
+	}
+
+//
+//  addLibrary
+//
+//  Purpose: To add the specified MtlLibrary to the list of
+//           material libraries.
+//  Parameter(s):
+//    <1> mtl_library: The material library
+//  Precondition(s):
+//    <1> g_mtl_libraries_mutex is locked by this thread
+//    <2> findLibrary(mtl_library.getFileNameWithPathLowercase())
+//        == NULL
+//  Returns: A reference to the MtlLibrary added.
+//  Side Effect: A copy of mtl_library is added to the list.
+//
+	MtlLibrary& addLibrary (const MtlLibrary& mtl_library)
+	{
+		assert(findLibrary(mtl_library.getFileNameWithPathLowercase()) == NULL);
+
+		MtlLibrary* p_library = new MtlLibrary(mtl_library);
+		g_mtl_libraries.push_back(p_library);
+		g_mtl_libraries_by_name[p_library->getFileNameWithPathLowercase()] = p_library;
+		return *p_library;
+	}
 }
 
 
 
 unsigned int MtlLibraryManager :: getCount ()
 {
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
 	return g_mtl_libraries.size();
 }
 
@@ -48,6 +116,7 @@ MtlLibrary& MtlLibraryManager :: get (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
 	return *(g_mtl_libraries[index]);
 }
 
@@ -62,10 +131,8 @@ bool MtlLibraryManager :: isLoaded (const std::string& name)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
-		if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
-			return true;
-	return false;
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
+	return findLibrary(lower) != NULL;
 }
 
 MtlLibrary& MtlLibraryManager :: get (const char* a_name)
@@ -114,12 +181,13 @@ MtlLibrary& MtlLibraryManager :: get (const string& name, ostream& r_logstream)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
-		if(g_mtl_libraries[i]->getFileNameWithPathLowercase() == lower)
-			return *(g_mtl_libraries[i]);
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
+	MtlLibrary* p_library = findLibrary(lower);
+	if(p_library != NULL)
+		return *p_library;
 
 	if(endsWith(lower, ".mtl"))
-		return add(MtlLibrary(name, r_logstream));
+		return addLibrary(MtlLibrary(name, r_logstream));
 	else
 		return g_empty;
 }
@@ -230,23 +298,31 @@ MtlLibrary& MtlLibraryManager :: add (const MtlLibrary& mtl_library)
 {
 	assert(!isLoaded(mtl_library.getFileNameWithPathLowercase()));
 
-	unsigned int index = g_mtl_libraries.size();
-	g_mtl_libraries.push_back(new MtlLibrary(mtl_library));
-
-	return *(g_mtl_libraries[index]);
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
+	return addLibrary(mtl_library);
 }
 
 void MtlLibraryManager :: unloadAll ()
 {
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		delete g_mtl_libraries[i];
 	g_mtl_libraries.clear();
+	g_mtl_libraries_by_name.clear();
+	g_unload_count++;
+}
+
+unsigned int MtlLibraryManager :: getUnloadCount ()
+{
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
+	return g_unload_count;
 }
 
 void MtlLibraryManager :: loadDisplayTextures ()
 {
 	// such simple code for such a powerful command...
 
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		g_mtl_libraries[i]->loadDisplayTextures();
 }
@@ -255,6 +331,7 @@ void MtlLibraryManager :: loadAllTextures ()
 {
 	// such simple code for such a powerful command...
 
+	lock_guard<mutex> lock(g_mtl_libraries_mutex);
 	for(unsigned int i = 0; i < g_mtl_libraries.size(); i++)
 		g_mtl_libraries[i]->loadAllTextures();
 }
@@ -37,6 +37,18 @@ class Material;
 //
 //  A global service to handle MtlLibraries.
 //
+//  The functions in this module may be called from any thread,
+//    so several ObjModels can be loaded at the same time.  If
+//    they refer to the same MTL file, it is only loaded once.
+//    The MtlLibraries themselves are not protected, so they
+//    should not be changed while other threads are using them.
+//
+//  The libraries are found with a hash table keyed by their
+//    lowercase file name with path, so looking one up takes
+//    the same time no matter how many are loaded.  Because of
+//    this, the file name and path of an MtlLibrary in the
+//    manager must not be changed.
+//
 namespace MtlLibraryManager
 {
 
@@ -331,6 +343,21 @@ MtlLibrary& add (const MtlLibrary& mtl_library);
 //
 void unloadAll ();
 
+//
+//  getUnloadCount
+//
+//  Purpose: To determine how many times the material libraries
+//           have been unloaded.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of times unloadAll has been called.
+//           If this value has changed, any pointers to
+//           Materials from the material library manager may
+//           be invalid.
+//  Side Effect: N/A
+//
+unsigned int getUnloadCount ();
+
 //
 //  loadDisplayTextures
 //
@@ -20,11 +20,16 @@
 #include <cassert>
 #include <cctype>
 #include <cstdlib>	// for atoi
+#include <cstring>	// for memchr, memcpy, memcmp
+#include <cstdint>
 #include <string>
 #include <iostream>
 #include <iomanip>
 #include <fstream>
 #include <vector>
+#include <map>
+#include <sys/types.h>
+#include <sys/stat.h>	// for stat
 
 #include "ObjSettings.h"
 
@@ -36,6 +41,7 @@
 
 #include "ObjStringParsing.h"
 #include "DisplayList.h"
+#include "VertexBufferModel.h"
 #include "Material.h"
 #include "MtlLibrary.h"
 #include "MtlLibraryManager.h"
@@ -75,12 +81,620 @@ namespace
 	const bool DEBUGGING_VALIDATE      = false || DEBUGGING_LOAD;
 	const bool DEBUGGING_VERTEX_BUFFER = false;
 	const bool DEBUGGING_FACE_SHADERS  = false;
+
+
+
+//
+//  readWholeFile
+//
+//  Purpose: To read the entire contents of a file into a
+//           string.
+//  Parameter(s):
+//    <1> filename: The name of the file, including the path
+//    <2> r_contents: The string to store the contents in
+//  Precondition(s): N/A
+//  Returns: Whether the file could be opened.
+//  Side Effect: The contents of file filename are read into
+//               r_contents.  The file is read in binary mode,
+//               so carriage returns are not removed.
+//
+	bool readWholeFile (const string& filename,
+	                    string& r_contents)
+	{
+		ifstream input_file(filename.c_str(), ios::in | ios::binary);
+		if(!input_file.is_open())
+			return false;
+
+		input_file.seekg(0, ios::end);
+		streamoff length = input_file.tellg();
+		input_file.seekg(0, ios::beg);
+		if(length <= 0)
+		{
+			r_contents.clear();
+			return true;
+		}
+
+		r_contents.resize((size_t)(length));
+		input_file.read(&r_contents[0], length);
+		r_contents.resize((size_t)(input_file.gcount()));
+		return true;
+	}
+
+//
+//  isCommand
+//
+//  Purpose: To determine if the specified line of an OBJ file
+//           starts with the specified command.
+//  Parameter(s):
+//    <1> a_line: The beginning of the line
+//    <2> a_line_end: The end of the line
+//    <3> a_command: The command
+//  Precondition(s):
+//    <1> a_line != NULL
+//    <2> a_line_end != NULL
+//    <3> a_line <= a_line_end
+//    <4> a_command != NULL
+//  Returns: Whether the line starts with a_command followed by
+//           a whitespace character.
+//  Side Effect: N/A
+//
+	bool isCommand (const char* a_line,
+	                const char* a_line_end,
+	                const char* a_command)
+	{
+		assert(a_line != NULL);
+		assert(a_line_end != NULL);
+		assert(a_line <= a_line_end);
+		assert(a_command != NULL);
+
+		size_t command_length = strlen(a_command);
+		if((size_t)(a_line_end - a_line) <= command_length)
+			return false;
+		if(memcmp(a_line, a_command, command_length) != 0)
+			return false;
+		return isspace(a_line[command_length]) != 0;
+	}
+
+//
+//  isDigit
+//
+//  Purpose: To determine if the specified character is a
+//           decimal digit.
+//  Parameter(s):
+//    <1> c: The character
+//  Precondition(s): N/A
+//  Returns: Whether c is one of the characters '0' to '9'.
+//  Side Effect: N/A
+//
+	bool isDigit (char c)
+	{
+		return c >= '0' && c <= '9';
+	}
+
+//
+//  readDouble
+//  readInt
+//
+//  Purpose: To read a number from the specified range of
+//           characters in the same way as atof or atoi, but
+//           without looking past the end of the range.
+//  Parameter(s):
+//    <1> a_current: The position to read the number at
+//    <2> a_end: The end of the range
+//  Precondition(s):
+//    <1> a_current != NULL
+//    <2> a_end != NULL
+//    <3> a_current <= a_end
+//    <4> The character at a_end cannot be part of a number
+//  Returns: The number at a_current, after any whitespace.  If
+//           there is no number before a_end, 0 is returned.
+//  Side Effect: N/A
+//  Note: Most numbers in OBJ files are short decimals.  These
+//        are calculated directly, using a single
+//        multiplication or division by an exact power of 10,
+//        which gives the same correctly-rounded result as atof
+//        (Clinger's fast path).  Anything else, such as
+//        numbers with many digits, hexadecimal numbers, and
+//        infinities, is passed on to atof.
+//
+	double readDouble (const char* a_current,
+	                   const char* a_end)
+	{
+		static const double POWERS_OF_10[] =
+		{
+			1.0e0,  1.0e1,  1.0e2,  1.0e3,  1.0e4,  1.0e5,
+			1.0e6,  1.0e7,  1.0e8,  1.0e9,  1.0e10, 1.0e11,
+			1.0e12, 1.0e13, 1.0e14, 1.0e15, 1.0e16, 1.0e17,
+			1.0e18, 1.0e19, 1.0e20, 1.0e21, 1.0e22,
+		};
+		static const int POWER_OF_10_MAX = 22;
+		static const unsigned int DIGIT_COUNT_MAX = 15;  // always < 2^53
+
+		assert(a_current != NULL);
+		assert(a_end != NULL);
+		assert(a_current <= a_end);
+
+		while(a_current < a_end && isspace(*a_current))
+			a_current++;
+		if(a_current == a_end)
+			return 0.0;
+
+		const char* p = a_current;
+		bool is_negative = false;
+		if(*p == '-' || *p == '+')
+		{
+			is_negative = (*p == '-');
+			p++;
+		}
+
+		unsigned long long mantissa = 0;
+		unsigned int digit_count = 0;
+		int exponent = 0;
+		for( ; p < a_end && isDigit(*p); p++, digit_count++)
+			mantissa = mantissa * 10 + (*p - '0');
+		if(p < a_end && *p == '.')
+		{
+			for(p++; p < a_end && isDigit(*p); p++, digit_count++)
+			{
+				mantissa = mantissa * 10 + (*p - '0');
+				exponent--;
+			}
+		}
+		if(digit_count == 0 || digit_count > DIGIT_COUNT_MAX)
+			return atof(a_current);
+		if(p < a_end && (*p == 'e' || *p == 'E'))
+		{
+			p++;
+			bool is_exponent_negative = false;
+			if(p < a_end && (*p == '-' || *p == '+'))
+			{
+				is_exponent_negative = (*p == '-');
+				p++;
+			}
+			if(p == a_end || !isDigit(*p))
+				return atof(a_current);
+			int written_exponent = 0;
+			for( ; p < a_end && isDigit(*p); p++)
+			{
+				if(written_exponent > POWER_OF_10_MAX * 2)
+					return atof(a_current);
+				written_exponent = written_exponent * 10 + (*p - '0');
+			}
+			exponent += is_exponent_negative ? -written_exponent : written_exponent;
+		}
+		if(p < a_end && (*p == 'x' || *p == 'X'))
+			return atof(a_current);
+		if(exponent < -POWER_OF_10_MAX || exponent > POWER_OF_10_MAX)
+			return atof(a_current);
+
+		double value = (double)(mantissa);
+		if(exponent < 0)
+			value /= POWERS_OF_10[-exponent];
+		else
+			value *= POWERS_OF_10[exponent];
+		return is_negative ? -value : value;
+	}
+
+	int readInt (const char* a_current,
+	             const char* a_end)
+	{
+		static const unsigned int DIGIT_COUNT_MAX = 9;
+
+		assert(a_current != NULL);
+		assert(a_end != NULL);
+		assert(a_current <= a_end);
+
+		while(a_current < a_end && isspace(*a_current))
+			a_current++;
+		if(a_current == a_end)
+			return 0;
+
+		const char* p = a_current;
+		bool is_negative = false;
+		if(*p == '-' || *p == '+')
+		{
+			is_negative = (*p == '-');
+			p++;
+		}
+
+		int value = 0;
+		unsigned int digit_count = 0;
+		for( ; p < a_end && isDigit(*p); p++, digit_count++)
+		{
+			if(digit_count >= DIGIT_COUNT_MAX)
+				return atoi(a_current);  // could overflow
+			value = value * 10 + (*p - '0');
+		}
+		return is_negative ? -value : value;
+	}
+
+	// identifies an ObjModel binary cache file
+	const char BINARY_CACHE_MAGIC[8] = { 'O', 'B', 'J', 'C', 'A', 'C', 'H', 'E' };
+
+	// increase this whenever the cache format changes
+	const uint32_t BINARY_CACHE_VERSION = 2;
+
+	// stored as written, so caches from a computer with a
+	//   different byte order are rejected
+	const uint32_t BINARY_CACHE_BYTE_ORDER = 0x01020304;
+
+
+
+//
+//  getFileStamp
+//
+//  Purpose: To determine the size and modification time of the
+//           specified file.
+//  Parameter(s):
+//    <1> filename: The name of the file, including the path
+//    <2> r_size: The variable to store the size in
+//    <3> r_modified_time: The variable to store the
+//                         modification time in
+//  Precondition(s): N/A
+//  Returns: Whether the file exists.
+//  Side Effect: If the file exists, its size in bytes is stored
+//               in r_size and its modification time is stored
+//               in r_modified_time.
+//
+	bool getFileStamp (const string& filename,
+	                   uint64_t& r_size,
+	                   int64_t& r_modified_time)
+	{
+		struct stat info;
+		if(stat(filename.c_str(), &info) != 0)
+			return false;
+
+		r_size          = (uint64_t)(info.st_size);
+		r_modified_time = (int64_t)(info.st_mtime);
+		return true;
+	}
+
+//
+//  appendBinary
+//
+//  Purpose: To append the bytes of a value to a buffer that
+//           will be written to a binary cache file.
+//  Parameter(s):
+//    <1> r_buffer: The buffer
+//    <2> value: The value to append
+//    <2> str: The string to append, preceded by its length
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The bytes of value or str are added to the end
+//               of r_buffer.
+//
+	template <typename T>
+	void appendBinary (string& r_buffer, const T& value)
+	{
+		r_buffer.append(reinterpret_cast<const char*>(&value), sizeof(T));
+	}
+
+	void appendBinary (string& r_buffer, const string& str)
+	{
+		appendBinary(r_buffer, (uint32_t)(str.length()));
+		r_buffer.append(str);
+	}
+
+//
+//  BinaryReader
+//
+//  A class to read values in order from a buffer holding the
+//    contents of a binary cache file.  If a read would go past
+//    the end of the buffer, a zero value is returned instead
+//    and the BinaryReader is marked as failed.  Once it has
+//    failed, all further reads return zero values.
+//
+	class BinaryReader
+	{
+	public:
+		BinaryReader (const string& buffer)
+				: mp_current(buffer.data()),
+				  mp_end(buffer.data() + buffer.size()),
+				  m_is_failed(false)
+		{ }
+
+		bool isFailed () const
+		{
+			return m_is_failed;
+		}
+
+		bool isAtEnd () const
+		{
+			return mp_current == mp_end;
+		}
+
+		// check that count elements of size bytes could fit
+		//   in the rest of the buffer before allocating them
+		bool isRemaining (uint64_t count, size_t size)
+		{
+			if((size_t)(mp_end - mp_current) / size < count)
+				m_is_failed = true;
+			return !m_is_failed;
+		}
+
+		template <typename T>
+		T read ()
+		{
+			T value = T();
+			if(!m_is_failed && (size_t)(mp_end - mp_current) >= sizeof(T))
+			{
+				memcpy(&value, mp_current, sizeof(T));
+				mp_current += sizeof(T);
+			}
+			else
+				m_is_failed = true;
+			return value;
+		}
+
+		string readString ()
+		{
+			uint32_t length = read<uint32_t>();
+			if(!isRemaining(length, 1))
+				return "";
+			string str(mp_current, length);
+			mp_current += length;
+			return str;
+		}
+
+	private:
+		const char* mp_current;
+		const char* mp_end;
+		bool m_is_failed;
+	};
+
+
+
+//
+//  Vector2Less
+//  Vector3Less
+//
+//  Comparison functions to allow Vector2s and Vector3s to be
+//    used as keys in a map.  Vectors are ordered by their x
+//    values, then their y values, and then their z values.
+//
+	struct Vector2Less
+	{
+		bool operator() (const Vector2& a, const Vector2& b) const
+		{
+			if(a.x != b.x)
+				return a.x < b.x;
+			return a.y < b.y;
+		}
+	};
+
+	struct Vector3Less
+	{
+		bool operator() (const Vector3& a, const Vector3& b) const
+		{
+			if(a.x != b.x)
+				return a.x < b.x;
+			if(a.y != b.y)
+				return a.y < b.y;
+			return a.z < b.z;
+		}
+	};
+
+//
+//  FirstUseRenumbering
+//
+//  A class to calculate new indexes for an array of values,
+//    such as the vertexes of an ObjModel, in the order they are
+//    requested.  The first time getNewIndex is called for a
+//    value, it is given the next new index, unless an
+//    identical value already has one.  Values that are never
+//    requested are not given a new index.
+//
+	template <typename VectorType, typename VectorLess>
+	class FirstUseRenumbering
+	{
+	public:
+		FirstUseRenumbering (const vector<VectorType>& v_old_values)
+				: mv_old_values(v_old_values),
+				  mv_new_indexes(v_old_values.size(), NOT_USED),
+				  mv_new_values(),
+				  m_new_indexes_by_value()
+		{ }
+
+		unsigned int getNewIndex (unsigned int old_index)
+		{
+			assert(old_index < mv_old_values.size());
+
+			if(mv_new_indexes[old_index] == NOT_USED)
+			{
+				const VectorType& value = mv_old_values[old_index];
+				typename map<VectorType, unsigned int, VectorLess>::iterator it = m_new_indexes_by_value.find(value);
+				if(it != m_new_indexes_by_value.end())
+					mv_new_indexes[old_index] = it->second;
+				else
+				{
+					unsigned int new_index = (unsigned int)(mv_new_values.size());
+					mv_new_values.push_back(value);
+					m_new_indexes_by_value[value] = new_index;
+					mv_new_indexes[old_index] = new_index;
+				}
+			}
+
+			assert(mv_new_indexes[old_index] < mv_new_values.size());
+			return mv_new_indexes[old_index];
+		}
+
+		const vector<VectorType>& getNewValues () const
+		{
+			return mv_new_values;
+		}
+
+	private:
+		static const unsigned int NOT_USED = 0xFFFFFFFF;
+
+		const vector<VectorType>& mv_old_values;
+		vector<unsigned int> mv_new_indexes;
+		vector<VectorType> mv_new_values;
+		map<VectorType, unsigned int, VectorLess> m_new_indexes_by_value;
+	};
+
+	template <typename VectorType, typename VectorLess>
+	const unsigned int FirstUseRenumbering<VectorType, VectorLess>::NOT_USED;
+
+//
+//  calculateFaceOrderTipsify
+//
+//  Purpose: To calculate an order for a group of faces that
+//           makes good use of a post-transform vertex cache,
+//           using the Tipsify algorithm.
+//  Parameter(s):
+//    <1> v_face_starts: The index in v_face_ids of the first
+//                       vertex of each face, followed by the
+//                       size of v_face_ids
+//    <2> v_face_ids: The vertexes of the faces
+//    <3> id_count: The number of different vertexes
+//    <4> cache_size: The number of vertexes in the cache
+//    <5> rv_face_order: A vector to fill with the new order
+//  Precondition(s):
+//    <1> !v_face_starts.empty()
+//    <2> v_face_starts.back() == v_face_ids.size()
+//    <3> Every element of v_face_ids is less than id_count
+//    <4> cache_size >= 1
+//  Returns: N/A
+//  Side Effect: rv_face_order is set to contain each face index
+//               once, in the order the faces should be drawn.
+//
+//  Tipsify is described in "Fast Triangle Reordering for Vertex
+//    Locality and Reduced Overdraw" by Sander, Nehab, and
+//    Barczak (2007).  It repeatedly chooses a vertex and emits
+//    all the remaining faces that use it.  The next vertex is
+//    chosen from the vertexes of the faces just emitted,
+//    preferring ones that will still be in the cache after all
+//    of their remaining faces are emitted.  If none of them
+//    have faces remaining, the most recently used vertex with
+//    faces remaining is chosen instead, and failing that, the
+//    lowest-numbered one.
+//
+	void calculateFaceOrderTipsify (const vector<unsigned int>& v_face_starts,
+	                                const vector<unsigned int>& v_face_ids,
+	                                unsigned int id_count,
+	                                unsigned int cache_size,
+	                                vector<unsigned int>& rv_face_order)
+	{
+		assert(!v_face_starts.empty());
+		assert(v_face_starts.back() == v_face_ids.size());
+		assert(cache_size >= 1);
+
+		const unsigned int NO_ID = id_count;
+		unsigned int face_count = (unsigned int)(v_face_starts.size() - 1);
+
+		// the faces using each vertex, stored the same way as
+		//   the vertexes of the faces
+		vector<unsigned int> v_adjacency_starts(id_count + 1, 0);
+		for(unsigned int i = 0; i < v_face_ids.size(); i++)
+		{
+			assert(v_face_ids[i] < id_count);
+			v_adjacency_starts[v_face_ids[i] + 1]++;
+		}
+		for(unsigned int id = 0; id < id_count; id++)
+			v_adjacency_starts[id + 1] += v_adjacency_starts[id];
+		assert(v_adjacency_starts.back() == v_face_ids.size());
+
+		vector<unsigned int> v_adjacent_faces(v_face_ids.size());
+		vector<unsigned int> v_adjacency_filled(v_adjacency_starts.begin(), v_adjacency_starts.end() - 1);
+		for(unsigned int f = 0; f < face_count; f++)
+			for(unsigned int i = v_face_starts[f]; i < v_face_starts[f + 1]; i++)
+				v_adjacent_faces[v_adjacency_filled[v_face_ids[i]]++] = f;
+
+		// the number of faces not emitted yet for each vertex
+		vector<unsigned int> v_live_count(id_count);
+		for(unsigned int id = 0; id < id_count; id++)
+			v_live_count[id] = v_adjacency_starts[id + 1] - v_adjacency_starts[id];
+
+		// a vertex is in the cache if it was added less than
+		//   cache_size additions ago
+		vector<unsigned int> v_cache_time(id_count, 0);
+		unsigned int time = cache_size + 1;
+
+		vector<bool> v_is_emitted(face_count, false);
+		vector<unsigned int> v_dead_end_stack;
+		vector<unsigned int> v_candidates;
+		unsigned int next_unchecked = 0;
+
+		rv_face_order.clear();
+		rv_face_order.reserve(face_count);
+
+		unsigned int fanning = (face_count > 0) ? v_face_ids[0] : NO_ID;
+		while(fanning != NO_ID)
+		{
+			// emit all remaining faces around fanning vertex
+			v_candidates.clear();
+			for(unsigned int a = v_adjacency_starts[fanning]; a < v_adjacency_starts[fanning + 1]; a++)
+			{
+				unsigned int face = v_adjacent_faces[a];
+				if(v_is_emitted[face])
+					continue;
+
+				rv_face_order.push_back(face);
+				v_is_emitted[face] = true;
+
+				for(unsigned int i = v_face_starts[face]; i < v_face_starts[face + 1]; i++)
+				{
+					unsigned int id = v_face_ids[i];
+					v_dead_end_stack.push_back(id);
+					v_candidates.push_back(id);
+					assert(v_live_count[id] > 0);
+					v_live_count[id]--;
+					if(time - v_cache_time[id] > cache_size)
+					{
+						v_cache_time[id] = time;
+						time++;
+					}
+				}
+			}
+
+			// choose the next fanning vertex
+			fanning = NO_ID;
+			int best_priority = -1;
+			for(unsigned int c = 0; c < v_candidates.size(); c++)
+			{
+				unsigned int id = v_candidates[c];
+				if(v_live_count[id] == 0)
+					continue;
+
+				// the oldest vertex that will still be in the
+				//   cache after its remaining faces are emitted
+				int priority = 0;
+				if(time - v_cache_time[id] + 2 * v_live_count[id] <= cache_size)
+					priority = (int)(time - v_cache_time[id]);
+				if(priority > best_priority)
+				{
+					best_priority = priority;
+					fanning = id;
+				}
+			}
+
+			// dead end, so try recent vertexes, then any vertex
+			while(fanning == NO_ID && !v_dead_end_stack.empty())
+			{
+				unsigned int id = v_dead_end_stack.back();
+				v_dead_end_stack.pop_back();
+				if(v_live_count[id] > 0)
+					fanning = id;
+			}
+			while(fanning == NO_ID && next_unchecked < id_count)
+			{
+				if(v_live_count[next_unchecked] > 0)
+					fanning = next_unchecked;
+				else
+					next_unchecked++;
+			}
+		}
+
+		assert(rv_face_order.size() == face_count);
+	}
 }
 
 
 
 const unsigned int ObjModel :: NO_TEXTURE_COORDINATES = 0xFFFFFFFF;
 const unsigned int ObjModel :: NO_NORMAL = 0xFFFFFFFF;
+const char* const ObjModel :: BINARY_CACHE_SUFFIX = ".bin";
+const unsigned int ObjModel :: VERTEX_CACHE_SIZE = 16;
 
 
 
@@ -549,7 +1163,7 @@ unsigned int ObjModel :: getFaceCount (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	return mv_meshes[mesh].mv_faces.size();
+	return mv_meshes[mesh].getFaceCount();
 }
 
 unsigned int ObjModel :: getFaceVertexCount (unsigned int mesh, unsigned int face) const
@@ -557,7 +1171,7 @@ unsigned int ObjModel :: getFaceVertexCount (unsigned int mesh, unsigned int fac
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
+	return mv_meshes[mesh].getFaceVertexCount(face);
 }
 
 unsigned int ObjModel :: getFaceVertexIndex (unsigned int mesh, unsigned int face, unsigned int vertex) const
@@ -566,7 +1180,7 @@ unsigned int ObjModel :: getFaceVertexIndex (unsigned int mesh, unsigned int fac
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex;
+	return mv_meshes[mesh].getFaceVertex(face, vertex).m_vertex;
 }
 
 unsigned int ObjModel :: getFaceVertexTextureCoordinates (unsigned int mesh, unsigned int face, unsigned int vertex) const
@@ -575,7 +1189,7 @@ unsigned int ObjModel :: getFaceVertexTextureCoordinates (unsigned int mesh, uns
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate;
+	return mv_meshes[mesh].getFaceVertex(face, vertex).m_texture_coordinate;
 }
 
 unsigned int ObjModel :: getFaceVertexNormal (unsigned int mesh, unsigned int face, unsigned int vertex) const
@@ -584,7 +1198,7 @@ unsigned int ObjModel :: getFaceVertexNormal (unsigned int mesh, unsigned int fa
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	return mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal;
+	return mv_meshes[mesh].getFaceVertex(face, vertex).m_normal;
 }
 
 bool ObjModel :: isFaceTextureCoordinatesAny (unsigned int mesh, unsigned int face) const
@@ -592,9 +1206,9 @@ bool ObjModel :: isFaceTextureCoordinatesAny (unsigned int mesh, unsigned int fa
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	const vector<FaceVertex>& v_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
-	for(unsigned int i = 0; i < v_vertexes.size(); i++)
-		if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+	const Mesh& mesh_data = mv_meshes[mesh];
+	for(unsigned int i = 0; i < mesh_data.getFaceVertexCount(face); i++)
+		if(mesh_data.getFaceVertex(face, i).m_texture_coordinate != NO_TEXTURE_COORDINATES)
 			return true;
 	return false;
 }
@@ -604,9 +1218,9 @@ bool ObjModel :: isFaceNormalAny (unsigned int mesh, unsigned int face) const
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	const vector<FaceVertex>& v_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
-	for(unsigned int i = 0; i < v_vertexes.size(); i++)
-		if(v_vertexes[i].m_normal != NO_NORMAL)
+	const Mesh& mesh_data = mv_meshes[mesh];
+	for(unsigned int i = 0; i < mesh_data.getFaceVertexCount(face); i++)
+		if(mesh_data.getFaceVertex(face, i).m_normal != NO_NORMAL)
 			return true;
 	return false;
 }
@@ -622,14 +1236,11 @@ bool ObjModel :: isMeshTextureCoordinatesAny (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
-	for(unsigned int f = 0; f < v_faces.size(); f++)
-	{
-		const vector<FaceVertex>& v_vertexes = v_faces[f].mv_vertexes;
-		for(unsigned int i = 0; i < v_vertexes.size(); i++)
-			if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
-				return true;
-	}
+	// the faces do not matter here, so check all the vertexes
+	const vector<FaceVertex>& v_vertexes = mv_meshes[mesh].mv_face_vertexes;
+	for(unsigned int i = 0; i < v_vertexes.size(); i++)
+		if(v_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+			return true;
 	return false;
 }
 
@@ -637,14 +1248,11 @@ bool ObjModel :: isMeshNormalAny (unsigned int mesh) const
 {
 	assert(mesh < getMeshCount());
 
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
-	for(unsigned int f = 0; f < v_faces.size(); f++)
-	{
-		const vector<FaceVertex>& v_vertexes = v_faces[f].mv_vertexes;
-		for(unsigned int i = 0; i < v_vertexes.size(); i++)
-			if(v_vertexes[i].m_normal != NO_NORMAL)
-				return true;
-	}
+	// the faces do not matter here, so check all the vertexes
+	const vector<FaceVertex>& v_vertexes = mv_meshes[mesh].mv_face_vertexes;
+	for(unsigned int i = 0; i < v_vertexes.size(); i++)
+		if(v_vertexes[i].m_normal != NO_NORMAL)
+			return true;
 	return false;
 }
 
@@ -683,7 +1291,7 @@ unsigned int ObjModel :: getFaceCountTotal () const
 	unsigned int total = 0;
 
 	for(unsigned int i = 0; i < mv_meshes.size(); i++)
-		total += mv_meshes[i].mv_faces.size();
+		total += mv_meshes[i].getFaceCount();
 	return total;
 }
 
@@ -695,6 +1303,51 @@ bool ObjModel :: isAllTriangles () const
 	return true;
 }
 
+double ObjModel :: getVertexCacheMissRatio (unsigned int cache_size) const
+{
+	assert(isValid());
+	assert(cache_size >= 1);
+
+	unsigned int miss_count     = 0;
+	unsigned int triangle_count = 0;
+
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+	{
+		vector<unsigned int> v_ids;
+		unsigned int id_count = calculateFaceVertexIds(m, v_ids);
+
+		// same cache model as calculateFaceOrderTipsify
+		vector<unsigned int> v_cache_time(id_count, 0);
+		unsigned int time = cache_size + 1;
+
+		const Mesh& mesh = mv_meshes[m];
+		for(unsigned int f = 0; f < mesh.getFaceCount(); f++)
+		{
+			unsigned int first = mesh.mv_face_starts[f];
+			for(unsigned int v = 2; v < mesh.getFaceVertexCount(f); v++)
+			{
+				// one triangle of the fan, as in drawFaces
+				unsigned int a_triangle[3] = { v_ids[first], v_ids[first + v - 1], v_ids[first + v] };
+				for(unsigned int i = 0; i < 3; i++)
+				{
+					unsigned int id = a_triangle[i];
+					if(time - v_cache_time[id] > cache_size)
+					{
+						v_cache_time[id] = time;
+						time++;
+						miss_count++;
+					}
+				}
+				triangle_count++;
+			}
+		}
+	}
+
+	if(triangle_count == 0)
+		return 0.0;
+	return (double)(miss_count) / triangle_count;
+}
+
 bool ObjModel :: isSingleMaterial () const
 {
 	if(mv_meshes.empty())
@@ -892,6 +1545,19 @@ void ObjModel :: printBadMaterials (ostream& r_logstream) const
 		}
 }
 
+void ObjModel :: preloadDisplayTextures () const
+{
+	preloadDisplayTextures(cerr);
+}
+
+void ObjModel :: preloadDisplayTextures (ostream& r_logstream) const
+{
+	// only the materials used by this model, like getDisplayList
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+		if(mv_meshes[m].mp_material != NULL)
+			mv_meshes[m].mp_material->preloadDisplayTextures(r_logstream);
+}
+
 
 
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
@@ -1180,7 +1846,7 @@ void ObjModel :: drawWireframe (double red, double green, double blue) const
 			glBegin(GL_LINE_LOOP);
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
-					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
+					unsigned int vertex = mv_meshes[m].getFaceVertex(f, v).m_vertex;
 					glVertex3dv(mv_vertexes[vertex].getAsArray());
 				}
 			glEnd();
@@ -1294,8 +1960,8 @@ void ObjModel :: drawVertexNormals (double length, double red, double green, dou
 			for(unsigned int f = 0; f < getFaceCount(m); f++)
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
-					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-					unsigned int normal = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
+					unsigned int vertex = mv_meshes[m].getFaceVertex(f, v).m_vertex;
+					unsigned int normal = mv_meshes[m].getFaceVertex(f, v).m_normal;
 
 					if(normal != NO_NORMAL)
 					{
@@ -1370,8 +2036,8 @@ void ObjModel :: drawFaceNormals (double length, double red, double green, doubl
 
 				for(unsigned int v = 0; v < getFaceVertexCount(m, f); v++)
 				{
-					unsigned int vertex = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-					unsigned int normal = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
+					unsigned int vertex = mv_meshes[m].getFaceVertex(f, v).m_vertex;
+					unsigned int normal = mv_meshes[m].getFaceVertex(f, v).m_normal;
 
 					assert(vertex < getVertexCount());
 					center += mv_vertexes[vertex];
@@ -1528,38 +2194,115 @@ DisplayList ObjModel :: getDisplayListMaterialNone () const
 	return list;
 }
 
-#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
-
+VertexBufferModel ObjModel :: getVertexBufferModel () const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
 
+	// only load textures used by this model, as in getDisplayList
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+		if(mv_meshes[i].mp_material != NULL)
+			mv_meshes[i].mp_material->loadDisplayTextures();
 
-#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	return createVertexBufferModel(true, NULL, NULL);
+}
 
-ModelWithShader ObjModel :: getModelWithShader () const
+VertexBufferModel ObjModel :: getVertexBufferModel (vector<unsigned int>& rv_vertexes) const
 {
 	assert(isValid());
+	assert(!Material::isMaterialActive());
 
-	return getModelWithShader(true, true);
+	for(unsigned int i = 0; i < mv_meshes.size(); i++)
+		if(mv_meshes[i].mp_material != NULL)
+			mv_meshes[i].mp_material->loadDisplayTextures();
+
+	return createVertexBufferModel(true, NULL, &rv_vertexes);
 }
 
-ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
-                                                bool is_normals) const
+VertexBufferModel ObjModel :: getVertexBufferModelMaterial (const Material& material) const
 {
 	assert(isValid());
+	assert(!Material::isMaterialActive());
 
-	static const Material MATERIAL_FALLBACK = Material::createSolid("shader_material_fallback",
-	                                                                Vector3(1.0, 0.0, 0.0));
+	// ensure material and all textures are loaded
+	material.activate();
+	Material::deactivate();
+	assert(!Material::isMaterialActive());
 
-	ModelWithShader result;
+	return createVertexBufferModel(false, &material, NULL);
+}
 
-	for(unsigned int m = 0; m < mv_meshes.size(); m++)
-	{
-		if(getPointSetCount(m) == 0 &&
-		   getPolylineCount(m) == 0 &&
-		   getFaceCount    (m) == 0)
-		{
-			// nothing in this mesh, so skip it
-			continue;
-		}
+VertexBufferModel ObjModel :: getVertexBufferModelMaterial (const char* a_name) const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
+	assert(a_name != NULL);
+
+	return getVertexBufferModelMaterial(string(a_name), cerr);
+}
+
+VertexBufferModel ObjModel :: getVertexBufferModelMaterial (const string& name) const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
+
+	return getVertexBufferModelMaterial(name, cerr);
+}
+
+VertexBufferModel ObjModel :: getVertexBufferModelMaterial (const string& name, ostream& r_logstream) const
+{
+	assert(isValid());
+	assert(!Material::isMaterialActive());
+
+	const Material* p_material = getMaterialByName(name);
+	if(p_material != NULL)
+		return getVertexBufferModelMaterial(*p_material);
+	else
+	{
+		r_logstream << "Material \"" << name << "\" does not exist, creating VertexBufferModel without material" << endl;
+		return getVertexBufferModelMaterialNone();
+	}
+}
+
+VertexBufferModel ObjModel :: getVertexBufferModelMaterialNone () const
+{
+	assert(isValid());
+
+	return createVertexBufferModel(false, NULL, NULL);
+}
+
+#endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
+
+
+
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+
+ModelWithShader ObjModel :: getModelWithShader () const
+{
+	assert(isValid());
+
+	return getModelWithShader(true, true);
+}
+
+ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
+                                                bool is_normals) const
+{
+	assert(isValid());
+
+	static const Material MATERIAL_FALLBACK = Material::createSolid("shader_material_fallback",
+	                                                                Vector3(1.0, 0.0, 0.0));
+
+	ModelWithShader result;
+
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		if(getPointSetCount(m) == 0 &&
+		   getPolylineCount(m) == 0 &&
+		   getFaceCount    (m) == 0)
+		{
+			// nothing in this mesh, so skip it
+			continue;
+		}
 
 		unsigned int material_index;
 
@@ -1588,7 +2331,7 @@ ModelWithShader ObjModel :: getModelWithShader (bool is_texture_coordinates,
 		// add faces
 		if(getFaceCount(m) > 0)
 		{
-			assert(!mv_meshes[m].mv_faces.empty());
+			assert(mv_meshes[m].getFaceCount() > 0);
 
 			bool is_mesh_texture_coordinates = is_texture_coordinates;
 			if(!isMeshTextureCoordinatesAny(m))
@@ -1794,25 +2537,25 @@ void ObjModel :: save (const string& filename, ostream& r_logstream) const
 					cout << "Wrote polylines for mesh " << m << endl;
 			}
 
-			if(mv_meshes[m].mv_faces.size() > 0)
+			if(mv_meshes[m].getFaceCount() > 0)
 			{
 				output_file << "# " << getFaceCount(m) << " faces" << endl;
-				for(unsigned int f = 0; f < mv_meshes[m].mv_faces.size(); f++)
+				for(unsigned int f = 0; f < mv_meshes[m].getFaceCount(); f++)
 				{
 					output_file << "f";
-					for(unsigned int i = 0; i < mv_meshes[m].mv_faces[f].mv_vertexes.size(); i++)
+					for(unsigned int i = 0; i < mv_meshes[m].getFaceVertexCount(f); i++)
 					{
-						output_file << " " << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_vertex + 1);
+						output_file << " " << (mv_meshes[m].getFaceVertex(f, i).m_vertex + 1);
 
-						if(mv_meshes[m].mv_faces[f].mv_vertexes[i].m_texture_coordinate != NO_TEXTURE_COORDINATES)
+						if(mv_meshes[m].getFaceVertex(f, i).m_texture_coordinate != NO_TEXTURE_COORDINATES)
 						{
-							output_file << "/" << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_texture_coordinate + 1);
+							output_file << "/" << (mv_meshes[m].getFaceVertex(f, i).m_texture_coordinate + 1);
 
-							if(mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal != NO_NORMAL)
-								output_file << "/" << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal + 1);
+							if(mv_meshes[m].getFaceVertex(f, i).m_normal != NO_NORMAL)
+								output_file << "/" << (mv_meshes[m].getFaceVertex(f, i).m_normal + 1);
 						}
-						else if(mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal != NO_NORMAL)
-							output_file << "//" << (mv_meshes[m].mv_faces[f].mv_vertexes[i].m_normal + 1);
+						else if(mv_meshes[m].getFaceVertex(f, i).m_normal != NO_NORMAL)
+							output_file << "//" << (mv_meshes[m].getFaceVertex(f, i).m_normal + 1);
 
 					}
 					output_file << endl;
@@ -1883,7 +2626,7 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 {
 	assert(ObjStringParsing::isValidFilenameWithPath(filename));
 
-	ifstream input_file;
+	string contents;
 	unsigned int line_count;
 
 	if(DEBUGGING_LOAD)
@@ -1896,11 +2639,9 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 
 	setFileNameWithPath(filename);
 
-	input_file.open(filename.c_str(), ios::in);
-	if(!input_file.is_open())
+	if(!readWholeFile(filename, contents))
 	{
 		r_logstream << "Error: File \"" << filename << "\" does not exist" << endl;
-		input_file.close();
 
 		m_file_load_success = false;
 
@@ -1913,78 +2654,135 @@ void ObjModel :: load (const string& filename, ostream& r_logstream)
 	//
 	//  http://www.martinreddy.net/gfx/3d/OBJ.spec
 	//
+	//  The whole file is read at once and the lines are parsed
+	//    where they are in the buffer, so no strings are
+	//    created for lines that are valid.  The buffer always
+	//    ends with a '\0', so there is a character that cannot
+	//    be part of a number after every line.
+	//
+
+	const char* p_file_end = contents.c_str() + contents.length();
+	const char* p_next_line;
 
 	line_count = 0;
-	while(true)	// drops out at EOF below
+	for(const char* p_line = contents.c_str(); p_line < p_file_end; p_line = p_next_line)
 	{
-		string line;
+		const char* p_line_end;
 		size_t line_length;
 		bool valid;
 
-		getline(input_file, line);
-		if(line == "" && input_file.eof())
-			break;	// drop out if no more lines (but include last line)
+		p_line_end = static_cast<const char*>(memchr(p_line, '\n', p_file_end - p_line));
+		if(p_line_end == NULL)
+		{
+			p_line_end  = p_file_end;
+			p_next_line = p_file_end;
+		}
+		else
+			p_next_line = p_line_end + 1;
 
-		line_length = line.length();
+		line_length = p_line_end - p_line;
 		line_count++;
 
-		if(line_length < 1 || line[0] == '#' || line[0] == '\r' || line[0] == '\n')
+		if(line_length < 1 || p_line[0] == '#' || p_line[0] == '\r' || p_line[0] == '\n')
 			continue;	// skip blank lines and comments
 
 		valid = true;
-		if(line_length < 1)
-			valid = false;
-		else
+		if(isCommand(p_line, p_line_end, "mtllib"))
+			valid = readMaterialLibrary(p_line + 7, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "usemtl"))
+			valid = readMaterial(p_line + 7, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "v"))
+			valid = readVertex(p_line + 2, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "vt"))
+			valid = readTextureCoordinates(p_line + 3, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "vn"))
+			valid = readNormal(p_line + 3, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "p"))
+			valid = readPointSet(p_line + 2, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "l"))
+			valid = readPolyline(p_line + 2, p_line_end, r_logstream);
+		else if(isCommand(p_line, p_line_end, "f"))
+			valid = readFace(p_line + 2, p_line_end, r_logstream);
+		else if(p_line[0] == 'g' && (line_length == 1 || isspace(p_line[1])))
 		{
-			line = whitespaceToSpaces(line);
-
-			if(startsWith(line, "mtllib "))
-				valid = readMaterialLibrary(line.substr(7), r_logstream);
-			else if(startsWith(line, "usemtl "))
-				valid = readMaterial(line.substr(7), r_logstream);
-			else if(startsWith(line, "v "))
-				valid = readVertex(line.substr(2), r_logstream);
-			else if(startsWith(line, "vt "))
-				valid = readTextureCoordinates(line.substr(3), r_logstream);
-			else if(startsWith(line, "vn "))
-				valid = readNormal(line.substr(3), r_logstream);
-			else if(startsWith(line, "p "))
-				valid = readPointSet(line.substr(2), r_logstream);
-			else if(startsWith(line, "l "))
-				valid = readPolyline(line.substr(2), r_logstream);
-			else if(startsWith(line, "f "))
-				valid = readFace(line.substr(2), r_logstream);
-			else if(line[0] == 'g' && (line.length() == 1 || isspace(line[1])))
-			{
-				if(DEBUGGING_LOAD)
-					r_logstream << "In file \"" << filename << "\": ignoring groupings \"" << line.substr(1) << "\"" << endl;
-			}
-			else if(line[0] == 's' && (line.length() == 1 || isspace(line[1])))
-			{
-				if(DEBUGGING_LOAD)
-					r_logstream << "In file \"" << filename << "\": ignoring smoothing group \"" << line.substr(1) << "\"" << endl;
-			}
-			else if(line[0] == 'o' && (line.length() == 1 || isspace(line[1])))
-			{
-				if(DEBUGGING_LOAD)
-					r_logstream << "In file \"" << filename << "\": ignoring object name \"" << line.substr(1) << "\"" << endl;
-			}
-			else
-				valid = false;
+			if(DEBUGGING_LOAD)
+				r_logstream << "In file \"" << filename << "\": ignoring groupings \"" << whitespaceToSpaces(string(p_line + 1, p_line_end)) << "\"" << endl;
+		}
+		else if(p_line[0] == 's' && (line_length == 1 || isspace(p_line[1])))
+		{
+			if(DEBUGGING_LOAD)
+				r_logstream << "In file \"" << filename << "\": ignoring smoothing group \"" << whitespaceToSpaces(string(p_line + 1, p_line_end)) << "\"" << endl;
+		}
+		else if(p_line[0] == 'o' && (line_length == 1 || isspace(p_line[1])))
+		{
+			if(DEBUGGING_LOAD)
+				r_logstream << "In file \"" << filename << "\": ignoring object name \"" << whitespaceToSpaces(string(p_line + 1, p_line_end)) << "\"" << endl;
 		}
+		else
+			valid = false;
 
 		if(!valid)
-			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << line << "\"" << endl;
+			r_logstream << "Line " << setw(6) << line_count << " of file \"" << filename << "\" is invalid: \"" << whitespaceToSpaces(string(p_line, p_line_end)) << "\"" << endl;
 	}
 
-	input_file.close();
-
 	validate();
 	printBadMaterials();
 
 	assert(invariant());
 }
 
+void ObjModel :: loadCached (const string& filename)
+{
+	assert(ObjStringParsing::isValidFilenameWithPath(filename));
+
+	loadCached(filename, cerr);
+
+	assert(invariant());
+}
+
+void ObjModel :: loadCached (const string& filename, const string& logfile)
+{
+	assert(ObjStringParsing::isValidFilenameWithPath(filename));
+
+	ofstream logstream(logfile.c_str());
+	loadCached(filename, logstream);
+	logstream.close();
+
+	assert(invariant());
+}
+
+void ObjModel :: loadCached (const string& filename, ostream& r_logstream)
+{
+	assert(ObjStringParsing::isValidFilenameWithPath(filename));
+
+	string cache_filename = filename + BINARY_CACHE_SUFFIX;
+
+	if(readBinaryCache(cache_filename, filename, r_logstream))
+	{
+		if(DEBUGGING_LOAD)
+			cout << "Loaded " << filename << " from cache" << endl;
+
+		assert(invariant());
+		return;
+	}
+
+	load(filename, r_logstream);
+	if(m_file_load_success)
+	{
+		// the cache stores the optimized model, so this is
+		//   only done when the OBJ file changes
+		if(isValid())
+			optimizeVertexCache();
+
+		// if the cache cannot be written, we just parse the
+		//   OBJ file again next time
+		if(!writeBinaryCache(cache_filename, filename) && DEBUGGING_SAVE)
+			cout << "Could not write cache file " << cache_filename << endl;
+	}
+
+	assert(invariant());
+}
+
 
 
 void ObjModel :: setFileName (const string& filename)
@@ -2276,7 +3074,7 @@ void ObjModel :: setFaceVertexIndex (unsigned int mesh, unsigned int face, unsig
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_vertex = index;
+	mv_meshes[mesh].getFaceVertex(face, vertex).m_vertex = index;
 	if(index >= getVertexCount())
 		m_valid = false;
 
@@ -2289,7 +3087,7 @@ void ObjModel :: setFaceVertexTextureCoordinates (unsigned int mesh, unsigned in
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_texture_coordinate = index;
+	mv_meshes[mesh].getFaceVertex(face, vertex).m_texture_coordinate = index;
 	if(index >= getTextureCoordinateCount() && index != NO_TEXTURE_COORDINATES)
 		m_valid = false;
 
@@ -2302,7 +3100,7 @@ void ObjModel :: setFaceVertexNormal (unsigned int mesh, unsigned int face, unsi
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes[vertex].m_normal = index;
+	mv_meshes[mesh].getFaceVertex(face, vertex).m_normal = index;
 	if(index >= getVertexCount() && index != NO_NORMAL)
 		m_valid = false;
 
@@ -2499,8 +3297,7 @@ unsigned int ObjModel :: addFace (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	unsigned int id = mv_meshes[mesh].mv_faces.size();
-	mv_meshes[mesh].mv_faces.push_back(Face());
+	unsigned int id = mv_meshes[mesh].addFace();
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2515,8 +3312,7 @@ unsigned int ObjModel :: addFaceVertex (unsigned int mesh, unsigned int face, un
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	unsigned int id = mv_meshes[mesh].mv_faces[face].mv_vertexes.size();
-	mv_meshes[mesh].mv_faces[face].mv_vertexes.push_back(FaceVertex(vertex, texture_coordinates, normal));
+	unsigned int id = mv_meshes[mesh].addFaceVertex(face, FaceVertex(vertex, texture_coordinates, normal));
 
 	if(vertex >= getVertexCount())
 		m_valid = false;
@@ -2753,14 +3549,7 @@ void ObjModel :: removeFace (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	vector<Face>& rv_faces = mv_meshes[mesh].mv_faces;
-	unsigned int face_count = rv_faces.size();
-	for(unsigned int i = face + 1; i < face_count; i++)
-	{
-		assert(i >= 1);
-		rv_faces[i - 1] = rv_faces[i];
-	}
-	rv_faces.pop_back();
+	mv_meshes[mesh].removeFace(face);
 
 	if(DEBUGGING_EDITING)
 	{
@@ -2775,7 +3564,7 @@ void ObjModel :: removeFaceAll (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
 
-	mv_meshes[mesh].mv_faces.clear();
+	mv_meshes[mesh].removeFaceAll();
 	mv_meshes[mesh].m_all_triangles = true;
 
 	if(DEBUGGING_EDITING)
@@ -2792,14 +3581,7 @@ void ObjModel :: removeFaceVertex (unsigned int mesh,
 	assert(face < getFaceCount(mesh));
 	assert(vertex < getFaceVertexCount(mesh, face));
 
-	vector<FaceVertex>& rv_vertexes = mv_meshes[mesh].mv_faces[face].mv_vertexes;
-	unsigned int vertex_count = rv_vertexes.size();
-	for(unsigned int i = vertex + 1; i < vertex_count; i++)
-	{
-		assert(i >= 1);
-		rv_vertexes[i - 1] = rv_vertexes[i];
-	}
-	rv_vertexes.pop_back();
+	mv_meshes[mesh].removeFaceVertex(face, vertex);
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2818,7 +3600,7 @@ void ObjModel :: removeFaceVertexAll (unsigned int mesh,
 	assert(mesh < getMeshCount());
 	assert(face < getFaceCount(mesh));
 
-	mv_meshes[mesh].mv_faces[face].mv_vertexes.clear();
+	mv_meshes[mesh].removeFaceVertexAll(face);
 	m_valid = false;
 
 	if(DEBUGGING_EDITING)
@@ -2938,9 +3720,9 @@ void ObjModel :: validate ()
 		}
 
 		mv_meshes[m].m_all_triangles = true;
-		for(unsigned int f = 0; f < mv_meshes[m].mv_faces.size(); f++)
+		for(unsigned int f = 0; f < mv_meshes[m].getFaceCount(); f++)
 		{
-			unsigned int face_vertex_count = mv_meshes[m].mv_faces[f].mv_vertexes.size();
+			unsigned int face_vertex_count = mv_meshes[m].getFaceVertexCount(f);
 			if(face_vertex_count < 3)
 			{
 				m_valid = false;
@@ -2954,9 +3736,9 @@ void ObjModel :: validate ()
 
 			for(unsigned int v = 0; v < face_vertex_count; v++)
 			{
-				unsigned int vertex              = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_vertex;
-				unsigned int texture_coordinates = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_texture_coordinate;
-				unsigned int normal              = mv_meshes[m].mv_faces[f].mv_vertexes[v].m_normal;
+				unsigned int vertex              = mv_meshes[m].getFaceVertex(f, v).m_vertex;
+				unsigned int texture_coordinates = mv_meshes[m].getFaceVertex(f, v).m_texture_coordinate;
+				unsigned int normal              = mv_meshes[m].getFaceVertex(f, v).m_normal;
 
 				if(vertex >= getVertexCount())
 				{
@@ -2997,6 +3779,21 @@ void ObjModel :: validate ()
 	assert(invariant());
 }
 
+void ObjModel :: optimizeVertexCache ()
+{
+	assert(isValid());
+
+	// merge identical values first so the faces using them
+	//   are seen as sharing a vertex
+	renumberByFirstUse();
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+		sortFacesForVertexCache(m);
+	renumberByFirstUse();
+
+	assert(isValid());
+	assert(invariant());
+}
+
 
 
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
@@ -3117,9 +3914,9 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 
 		for(unsigned int v = 0; v < getFaceVertexCount(mesh, f); v++)
 		{
-			unsigned int vertex              = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_vertex;
-			unsigned int texture_coordinates = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_texture_coordinate;
-			unsigned int normal              = mv_meshes[mesh].mv_faces[f].mv_vertexes[v].m_normal;
+			unsigned int vertex              = mv_meshes[mesh].getFaceVertex(f, v).m_vertex;
+			unsigned int texture_coordinates = mv_meshes[mesh].getFaceVertex(f, v).m_texture_coordinate;
+			unsigned int normal              = mv_meshes[mesh].getFaceVertex(f, v).m_normal;
 
 			if(normal != NO_NORMAL)
 				glNormal3dv(mv_normals[normal].getAsArray());
@@ -3144,6 +3941,148 @@ void ObjModel :: drawFaces (unsigned int mesh) const
 		glEnd();
 }
 
+VertexBufferModel ObjModel :: createVertexBufferModel (bool is_mesh_materials,
+                                                       const Material* p_material,
+                                                       vector<unsigned int>* pv_vertexes) const
+{
+	assert(isValid());
+
+	vector<float> v_vertex_data;
+	vector<FaceVertex> v_output_face_vertexes;
+	vector<vector<unsigned int> > vv_range_indexes;
+	vector<VertexBufferModel::MaterialRange> v_material_ranges;
+	bool is_texture_coordinates = false;
+	bool is_normals             = false;
+
+	// the output vertexes for each OBJ vertex, so that each
+	//   combination with texture coordinates and a normal is
+	//   only stored once
+	vector<vector<unsigned int> > vv_vertex_outputs(mv_vertexes.size());
+
+	for(unsigned int m = 0; m < getMeshCount(); m++)
+	{
+		const Mesh& mesh = mv_meshes[m];
+		if(mesh.getFaceCount() == 0)
+			continue;
+
+		// meshes with the same material share a range
+		const Material* p_range_material = is_mesh_materials ? mesh.mp_material : p_material;
+		unsigned int range = 0;
+		while(range < v_material_ranges.size() && v_material_ranges[range].mp_material != p_range_material)
+			range++;
+		if(range == v_material_ranges.size())
+		{
+			VertexBufferModel::MaterialRange material_range;
+			material_range.mp_material   = p_range_material;
+			material_range.m_first_index = 0;
+			material_range.m_index_count = 0;
+			v_material_ranges.push_back(material_range);
+			vv_range_indexes.push_back(vector<unsigned int>());
+		}
+		assert(range < v_material_ranges.size());
+		assert(v_material_ranges.size() == vv_range_indexes.size());
+
+		for(unsigned int f = 0; f < mesh.getFaceCount(); f++)
+		{
+			unsigned int face_vertex_count = mesh.getFaceVertexCount(f);
+			unsigned int first_output = 0;
+			unsigned int previous_output = 0;
+
+			for(unsigned int v = 0; v < face_vertex_count; v++)
+			{
+				const FaceVertex& face_vertex = mesh.getFaceVertex(f, v);
+				assert(face_vertex.m_vertex < mv_vertexes.size());
+
+				// a new output vertex is added unless a match is found
+				vector<unsigned int>& v_outputs = vv_vertex_outputs[face_vertex.m_vertex];
+				unsigned int output = (unsigned int)(v_output_face_vertexes.size());
+				for(unsigned int i = 0; i < v_outputs.size(); i++)
+				{
+					const FaceVertex& existing = v_output_face_vertexes[v_outputs[i]];
+					if(existing.m_texture_coordinate == face_vertex.m_texture_coordinate &&
+					   existing.m_normal             == face_vertex.m_normal)
+					{
+						output = v_outputs[i];
+						break;
+					}
+				}
+
+				if(output == v_output_face_vertexes.size())
+				{
+					v_outputs.push_back(output);
+					v_output_face_vertexes.push_back(face_vertex);
+
+					const Vector3& position = mv_vertexes[face_vertex.m_vertex];
+					v_vertex_data.push_back((float)(position.x));
+					v_vertex_data.push_back((float)(position.y));
+					v_vertex_data.push_back((float)(position.z));
+
+					if(face_vertex.m_texture_coordinate != NO_TEXTURE_COORDINATES)
+					{
+						// flip texture coordinates to match Maya <|>
+						const Vector2& texture_coordinates = mv_texture_coordinates[face_vertex.m_texture_coordinate];
+						v_vertex_data.push_back((float)(      texture_coordinates.x));
+						v_vertex_data.push_back((float)(1.0 - texture_coordinates.y));
+						is_texture_coordinates = true;
+					}
+					else
+					{
+						v_vertex_data.push_back(0.0f);
+						v_vertex_data.push_back(0.0f);
+					}
+
+					if(face_vertex.m_normal != NO_NORMAL)
+					{
+						const Vector3& normal = mv_normals[face_vertex.m_normal];
+						v_vertex_data.push_back((float)(normal.x));
+						v_vertex_data.push_back((float)(normal.y));
+						v_vertex_data.push_back((float)(normal.z));
+						is_normals = true;
+					}
+					else
+					{
+						v_vertex_data.push_back(0.0f);
+						v_vertex_data.push_back(0.0f);
+						v_vertex_data.push_back(0.0f);
+					}
+				}
+				assert(output < v_output_face_vertexes.size());
+
+				// split the face into a triangle fan, as in drawFaces
+				if(v == 0)
+					first_output = output;
+				else if(v >= 2)
+				{
+					vv_range_indexes[range].push_back(first_output);
+					vv_range_indexes[range].push_back(previous_output);
+					vv_range_indexes[range].push_back(output);
+				}
+				previous_output = output;
+			}
+		}
+	}
+	assert(v_vertex_data.size() == v_output_face_vertexes.size() * VertexBufferModel::FLOATS_PER_VERTEX);
+
+	vector<unsigned int> v_indexes;
+	for(unsigned int r = 0; r < v_material_ranges.size(); r++)
+	{
+		v_material_ranges[r].m_first_index = (unsigned int)(v_indexes.size());
+		v_material_ranges[r].m_index_count = (unsigned int)(vv_range_indexes[r].size());
+		v_indexes.insert(v_indexes.end(), vv_range_indexes[r].begin(), vv_range_indexes[r].end());
+	}
+
+	if(pv_vertexes != NULL)
+	{
+		pv_vertexes->resize(v_output_face_vertexes.size());
+		for(unsigned int i = 0; i < v_output_face_vertexes.size(); i++)
+			(*pv_vertexes)[i] = v_output_face_vertexes[i].m_vertex;
+	}
+
+	VertexBufferModel vertex_buffer_model;
+	vertex_buffer_model.init(v_vertex_data, v_indexes, v_material_ranges, is_texture_coordinates, is_normals);
+	return vertex_buffer_model;
+}
+
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 
@@ -3658,7 +4597,7 @@ ObjVbo<unsigned int> ObjModel :: createIndexVboForFaces (unsigned int mesh,
 	assert(vv_arrangement.size() == getVertexCount());
 
 	assert(mesh < mv_meshes.size());
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
+	const Mesh& mesh_data = mv_meshes[mesh];
 
 	// number all the vertex-with-datas, based on where they will be in the VBO
 	vector<unsigned int> v_start;
@@ -3685,9 +4624,9 @@ ObjVbo<unsigned int> ObjModel :: createIndexVboForFaces (unsigned int mesh,
 
 	// calculate the number of triangles needed (non-triangle faces will be triangulated)
 	unsigned int vertex_count_total = 0;
-	for(unsigned int f = 0; f < v_faces.size(); f++)
+	for(unsigned int f = 0; f < mesh_data.getFaceCount(); f++)
 	{
-		unsigned int face_vertex_count = v_faces[f].mv_vertexes.size();
+		unsigned int face_vertex_count = mesh_data.getFaceVertexCount(f);
 		assert(face_vertex_count >= 3);
 
 		unsigned int triangle_count = face_vertex_count - 2;
@@ -3699,13 +4638,13 @@ ObjVbo<unsigned int> ObjModel :: createIndexVboForFaces (unsigned int mesh,
 	unsigned int* d_indexes = new unsigned int[vertex_count_total];
 
 	unsigned int next_index = 0;
-	for(unsigned int f = 0; f < v_faces.size(); f++)
+	for(unsigned int f = 0; f < mesh_data.getFaceCount(); f++)
 	{
-		const vector<FaceVertex>& v_vertex_ids = v_faces[f].mv_vertexes;
-		assert(v_vertex_ids.size() >= 3);
+		unsigned int face_vertex_count = mesh_data.getFaceVertexCount(f);
+		assert(face_vertex_count >= 3);
 
 		// double loop to triangulate faces
-		for(unsigned int t = 2; t < v_vertex_ids.size(); t++)  // per triangle
+		for(unsigned int t = 2; t < face_vertex_count; t++)  // per triangle
 			for(unsigned int i = 0; i < 3; i++)  // 3 vertexes in each triangle
 			{
 				//
@@ -3721,8 +4660,8 @@ ObjVbo<unsigned int> ObjModel :: createIndexVboForFaces (unsigned int mesh,
 
 				unsigned int face_vertex_index = (i == 0) ? 0 : (t - 2 + i);
 
-				assert(face_vertex_index < v_vertex_ids.size());
-				const FaceVertex& face_vertex = v_vertex_ids[face_vertex_index];
+				assert(face_vertex_index < face_vertex_count);
+				const FaceVertex& face_vertex = mesh_data.getFaceVertex(f, face_vertex_index);
 
 				bool is_found = false;
 
@@ -3803,15 +4742,15 @@ void ObjModel :: calculateVertexArrangement (unsigned int mesh,
 
 	rvv_arrangement.resize(mv_vertexes.size());
 
-	const vector<Face>& v_faces = mv_meshes[mesh].mv_faces;
-	for(unsigned int f = 0; f < v_faces.size(); f++)
+	const Mesh& mesh_data = mv_meshes[mesh];
+	for(unsigned int f = 0; f < mesh_data.getFaceCount(); f++)
 	{
-		const vector<FaceVertex>& v_vertex_ids = v_faces[f].mv_vertexes;
+		unsigned int face_vertex_count = mesh_data.getFaceVertexCount(f);
 
-		for(unsigned int i = 0; i < v_vertex_ids.size(); i++)
+		for(unsigned int i = 0; i < face_vertex_count; i++)
 		{
-			assert(i < v_vertex_ids.size());
-			const FaceVertex& face_vertex = v_vertex_ids[i];
+			assert(i < face_vertex_count);
+			const FaceVertex& face_vertex = mesh_data.getFaceVertex(f, i);
 
 			bool is_duplicate = false;
 
@@ -3893,25 +4832,31 @@ unsigned int ObjModel :: getVertexArrangementTotalCount (const VertexArrangement
 
 
 
-bool ObjModel :: readMaterialLibrary (const string& str, ostream& r_logstream)
+bool ObjModel :: readMaterialLibrary (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
-	string::size_type start_index;
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
 
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
+	const char* p_start;
+
+	if(a_begin == a_end)
+		return false;  // nothing after the command
+	else if(isspace(*a_begin))
+		p_start = nextToken(a_begin, a_end);
 	else
-		start_index = 0;
+		p_start = a_begin;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(const char* p_token = p_start; p_token != a_end; p_token = nextToken(p_token, a_end))
 	{
 		string library;
 
-		size_t token_length = getTokenLength(str, token_index);
+		size_t token_length = getTokenLength(p_token, a_end);
 
 		if(token_length == 0)
 			return false;
 
-		library = str.substr(token_index, token_length);
+		library.assign(p_token, token_length);
 
 		//
 		//  Should we add on the current file path? <|>
@@ -3936,115 +4881,126 @@ bool ObjModel :: readMaterialLibrary (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readMaterial (const string& str, ostream& r_logstream)
+bool ObjModel :: readMaterial (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	string material;
 	unsigned int mesh_index;
 
-	size_t length;
-	size_t start_index;
-	size_t end_index;
+	const char* p_start;
 
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
+	if(a_begin == a_end)
+		return false;  // nothing after the command
+	else if(isspace(*a_begin))
+		p_start = nextToken(a_begin, a_end);
 	else
-		start_index = 0;
-
-	length = str.length();
-	for(end_index = start_index; end_index < length && !isspace(str[end_index]); end_index++)
-		; // do nothing
+		p_start = a_begin;
 
-	if(end_index < length)
-		material = str.substr(start_index, end_index - start_index);
-	else
-		material = str.substr(start_index);
+	material.assign(p_start, getTokenLength(p_start, a_end));
+	if(material == "")
+		return false;
 
 	mesh_index = addMesh();
 	setMeshMaterial(mesh_index, material);
 	return true;
 }
 
-bool ObjModel :: readVertex (const string& str, ostream& r_logstream)
+bool ObjModel :: readVertex (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	double x;
 	double y;
 	double z;
 
-	size_t index;
+	const char* p_token;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
+	if(a_begin < a_end && isspace(*a_begin))
+		p_token = nextToken(a_begin, a_end);
 	else
-		index = 0;
+		p_token = a_begin;
 
-	x = atof(str.c_str() + index);
+	x = readDouble(p_token, a_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = nextToken(p_token, a_end);
+	if(p_token == a_end)
 		return false;
 
-	y = atof(str.c_str() + index);
+	y = readDouble(p_token, a_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = nextToken(p_token, a_end);
+	if(p_token == a_end)
 		return false;
 
-	z = atof(str.c_str() + index);
+	z = readDouble(p_token, a_end);
 
 	addVertex(x, y, z);
 	return true;
 }
 
-bool ObjModel :: readTextureCoordinates (const string& str, ostream& r_logstream)
+bool ObjModel :: readTextureCoordinates (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	double u;
 	double v;
 
-	size_t index;
+	const char* p_token;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
+	if(a_begin < a_end && isspace(*a_begin))
+		p_token = nextToken(a_begin, a_end);
 	else
-		index = 0;
+		p_token = a_begin;
 
-	u = atof(str.c_str() + index);
+	u = readDouble(p_token, a_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = nextToken(p_token, a_end);
+	if(p_token == a_end)
 		return false;
 
-	v = atof(str.c_str() + index);
+	v = readDouble(p_token, a_end);
 
 	addTextureCoordinate(u, v);
 	return true;
 }
 
-bool ObjModel :: readNormal (const string& str, ostream& r_logstream)
+bool ObjModel :: readNormal (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	double x;
 	double y;
 	double z;
 
-	size_t index;
+	const char* p_token;
 
-	if(isspace(str[0]))
-		index = nextToken(str, 0);
+	if(a_begin < a_end && isspace(*a_begin))
+		p_token = nextToken(a_begin, a_end);
 	else
-		index = 0;
+		p_token = a_begin;
 
-	x = atof(str.c_str() + index);
+	x = readDouble(p_token, a_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = nextToken(p_token, a_end);
+	if(p_token == a_end)
 		return false;
 
-	y = atof(str.c_str() + index);
+	y = readDouble(p_token, a_end);
 
-	index = nextToken(str, index);
-	if(index == string::npos)
+	p_token = nextToken(p_token, a_end);
+	if(p_token == a_end)
 		return false;
 
-	z = atof(str.c_str() + index);
+	z = readDouble(p_token, a_end);
 
 	if(x == 0.0 && y == 0.0 && z == 0.0)
 	{
@@ -4056,30 +5012,36 @@ bool ObjModel :: readNormal (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
+bool ObjModel :: readPointSet (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	const unsigned int NO_POINT_SET = ~0u;
 
 	unsigned int point_set_index = NO_POINT_SET;
 	unsigned int mesh_index;
 
-	string::size_type start_index;
+	const char* p_start;
 
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
+	if(a_begin == a_end)
+		return false;  // nothing after the command
+	else if(isspace(*a_begin))
+		p_start = nextToken(a_begin, a_end);
 	else
-		start_index = 0;
+		p_start = a_begin;
 
 	if(mv_meshes.empty())
 		mesh_index = addMesh();
 	else
 		mesh_index = mv_meshes.size() - 1;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(const char* p_token = p_start; p_token != a_end; p_token = nextToken(p_token, a_end))
 	{
 		int vertex;
 
-		vertex = atoi(str.c_str() + token_index);
+		vertex = readInt(p_token, a_end);
 		if(vertex < 0)
 			vertex += getVertexCount() + 1;
 		if(vertex <= 0)
@@ -4103,40 +5065,46 @@ bool ObjModel :: readPointSet (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
+bool ObjModel :: readPolyline (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
 	//
 	//  This function reads a polyline of vertexes in the
 	//    model, not a line of the input file.
 	//
 
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	const unsigned int NO_LINE = ~0u;
 
 	unsigned int polyline_index = NO_LINE;
 	unsigned int mesh_index;
 
-	string::size_type start_index;
+	const char* p_start;
 
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
+	if(a_begin == a_end)
+		return false;  // nothing after the command
+	else if(isspace(*a_begin))
+		p_start = nextToken(a_begin, a_end);
 	else
-		start_index = 0;
+		p_start = a_begin;
 
 	if(mv_meshes.empty())
 		mesh_index = addMesh();
 	else
 		mesh_index = mv_meshes.size() - 1;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(const char* p_token = p_start; p_token != a_end; p_token = nextToken(p_token, a_end))
 	{
-		size_t number_index;
+		const char* p_number;
 
 		int vertex;
 		int texture_coordinates;
 
-		number_index = token_index;
+		p_number = p_token;
 
-		vertex = atoi(str.c_str() + number_index);
+		vertex = readInt(p_number, a_end);
 		if(vertex < 0)
 			vertex += getVertexCount() + 1;
 		if(vertex <= 0)
@@ -4146,20 +5114,20 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 			return false;
 		}
 
-		number_index = nextSlashInToken(str, number_index);
-		if(number_index == string::npos)
+		p_number = nextSlashInToken(p_number, a_end);
+		if(p_number == a_end)
 		{
 			texture_coordinates = NO_TEXTURE_COORDINATES;
 		}
 		else
 		{
-			number_index++;
+			p_number++;
 
-			if(isspace(str[number_index]))
+			if(p_number < a_end && isspace(*p_number))
 				texture_coordinates = NO_TEXTURE_COORDINATES;
 			else
 			{
-				texture_coordinates = atoi(str.c_str() + number_index);
+				texture_coordinates = readInt(p_number, a_end);
 				if(texture_coordinates < 0)
 					texture_coordinates += getTextureCoordinateCount() + 1;
 				if(texture_coordinates <= 0)
@@ -4187,36 +5155,42 @@ bool ObjModel :: readPolyline (const string& str, ostream& r_logstream)
 	return true;
 }
 
-bool ObjModel :: readFace (const string& str, ostream& r_logstream)
+bool ObjModel :: readFace (const char* a_begin, const char* a_end, ostream& r_logstream)
 {
+	assert(a_begin != NULL);
+	assert(a_end != NULL);
+	assert(a_begin <= a_end);
+
 	const unsigned int NO_FACE = ~0u;
 
 	unsigned int face_index = NO_FACE;
 	unsigned int mesh_index;
 
-	string::size_type start_index;
+	const char* p_start;
 
-	if(isspace(str[0]))
-		start_index = nextToken(str, 0);
+	if(a_begin == a_end)
+		return false;  // nothing after the command
+	else if(isspace(*a_begin))
+		p_start = nextToken(a_begin, a_end);
 	else
-		start_index = 0;
+		p_start = a_begin;
 
 	if(mv_meshes.empty())
 		mesh_index = addMesh();
 	else
 		mesh_index = mv_meshes.size() - 1;
 
-	for(string::size_type token_index = start_index; token_index != string::npos; token_index = nextToken(str, token_index))
+	for(const char* p_token = p_start; p_token != a_end; p_token = nextToken(p_token, a_end))
 	{
-		size_t number_index;
+		const char* p_number;
 
 		int vertex;
 		int texture_coordinates;
 		int normal;
 
-		number_index = token_index;
+		p_number = p_token;
 
-		vertex = atoi(str.c_str() + number_index);
+		vertex = readInt(p_number, a_end);
 		if(vertex < 0)
 			vertex += getVertexCount() + 1;
 		if(vertex <= 0)
@@ -4226,39 +5200,39 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 			return false;
 		}
 
-		number_index = nextSlashInToken(str, number_index);
-		if(number_index == string::npos)
+		p_number = nextSlashInToken(p_number, a_end);
+		if(p_number == a_end)
 		{
 			texture_coordinates = NO_TEXTURE_COORDINATES;
 			normal = NO_NORMAL;
 		}
 		else
 		{
-			number_index++;
+			p_number++;
 
-			if(str[number_index] == '/')
+			if(p_number < a_end && *p_number == '/')
 				texture_coordinates = NO_TEXTURE_COORDINATES;
 			else
 			{
-				texture_coordinates = atoi(str.c_str() + number_index);
+				texture_coordinates = readInt(p_number, a_end);
 				if(texture_coordinates < 0)
 					texture_coordinates += getTextureCoordinateCount() + 1;
 				if(texture_coordinates <= 0)
 					return false;
 			}
 
-			number_index = nextSlashInToken(str, number_index);
-			if(number_index == string::npos)
+			p_number = nextSlashInToken(p_number, a_end);
+			if(p_number == a_end)
 				normal = NO_NORMAL;
 			else
 			{
-				number_index++;
+				p_number++;
 
-				if(isspace(str[number_index]))
+				if(p_number < a_end && isspace(*p_number))
 					normal = NO_NORMAL;
 				else
 				{
-					normal = atoi(str.c_str() + number_index);
+					normal = readInt(p_number, a_end);
 					if(normal < 0)
 						normal += getNormalCount() + 1;
 					if(normal <= 0)
@@ -4293,6 +5267,298 @@ bool ObjModel :: readFace (const string& str, ostream& r_logstream)
 	return true;
 }
 
+bool ObjModel :: readBinaryCache (const string& cache_filename, const string& filename, ostream& r_logstream)
+{
+	assert(ObjStringParsing::isValidFilenameWithPath(cache_filename));
+	assert(ObjStringParsing::isValidFilenameWithPath(filename));
+
+	string contents;
+	uint64_t source_size;
+	int64_t source_modified_time;
+
+	makeEmpty();
+
+	if(!getFileStamp(filename, source_size, source_modified_time))
+		return false;
+	if(!readWholeFile(cache_filename, contents))
+		return false;
+
+	//
+	//  Format of file (see writeBinaryCache):
+	//
+	//  Header
+	//    -> magic number, format version, byte order
+	//    -> size and modification time of the OBJ file
+	//    -> how many of each element
+	//  Material library names
+	//  Vertices
+	//  Texture coordinate pairs
+	//  Normals
+	//  Meshes
+	//    -> material name and whether all faces are triangles
+	//    -> element counts, then flat arrays of indexes for
+	//       point sets, polylines, and faces
+	//
+
+	BinaryReader reader(contents);
+
+	char magic[sizeof(BINARY_CACHE_MAGIC)];
+	for(unsigned int i = 0; i < sizeof(BINARY_CACHE_MAGIC); i++)
+		magic[i] = reader.read<char>();
+	if(memcmp(magic, BINARY_CACHE_MAGIC, sizeof(BINARY_CACHE_MAGIC)) != 0)
+		return false;
+	if(reader.read<uint32_t>() != BINARY_CACHE_VERSION)
+		return false;
+	if(reader.read<uint32_t>() != BINARY_CACHE_BYTE_ORDER)
+		return false;
+	if(reader.read<uint64_t>() != source_size)
+		return false;
+	if(reader.read<int64_t>() != source_modified_time)
+		return false;
+
+	uint32_t material_library_count   = reader.read<uint32_t>();
+	uint32_t vertex_count             = reader.read<uint32_t>();
+	uint32_t texture_coordinate_count = reader.read<uint32_t>();
+	uint32_t normal_count             = reader.read<uint32_t>();
+	uint32_t mesh_count               = reader.read<uint32_t>();
+	if(reader.isFailed())
+		return false;
+
+	// the cache is for this file, so set the path before
+	//   loading the material libraries
+	setFileNameWithPath(filename);
+
+	vector<string> v_libraries(material_library_count);
+	for(unsigned int i = 0; i < material_library_count && !reader.isFailed(); i++)
+	{
+		v_libraries[i] = reader.readString();
+		if(!ObjStringParsing::isValidFilenameWithPath(v_libraries[i]))
+		{
+			makeEmpty();
+			return false;
+		}
+	}
+
+	if(reader.isRemaining(vertex_count, sizeof(double) * 3))
+	{
+		mv_vertexes.resize(vertex_count);
+		for(unsigned int i = 0; i < vertex_count; i++)
+		{
+			mv_vertexes[i].x = reader.read<double>();
+			mv_vertexes[i].y = reader.read<double>();
+			mv_vertexes[i].z = reader.read<double>();
+		}
+	}
+	if(reader.isRemaining(texture_coordinate_count, sizeof(double) * 2))
+	{
+		mv_texture_coordinates.resize(texture_coordinate_count);
+		for(unsigned int i = 0; i < texture_coordinate_count; i++)
+		{
+			mv_texture_coordinates[i].x = reader.read<double>();
+			mv_texture_coordinates[i].y = reader.read<double>();
+		}
+	}
+	if(reader.isRemaining(normal_count, sizeof(double) * 3))
+	{
+		mv_normals.resize(normal_count);
+		for(unsigned int i = 0; i < normal_count; i++)
+		{
+			mv_normals[i].x = reader.read<double>();
+			mv_normals[i].y = reader.read<double>();
+			mv_normals[i].z = reader.read<double>();
+		}
+	}
+
+	vector<string> v_materials;
+	if(reader.isRemaining(mesh_count, sizeof(uint32_t) * 4))
+	{
+		mv_meshes.resize(mesh_count);
+		v_materials.resize(mesh_count);
+	}
+	for(unsigned int m = 0; m < mv_meshes.size() && !reader.isFailed(); m++)
+	{
+		Mesh& r_mesh = mv_meshes[m];
+
+		v_materials[m]         = reader.readString();
+		r_mesh.m_all_triangles = (reader.read<uint8_t>() != 0);
+
+		uint32_t point_set_count = reader.read<uint32_t>();
+		uint32_t polyline_count  = reader.read<uint32_t>();
+		uint32_t face_count      = reader.read<uint32_t>();
+
+		if(reader.isRemaining(point_set_count, sizeof(uint32_t)))
+		{
+			r_mesh.mv_point_sets.resize(point_set_count);
+			for(unsigned int p = 0; p < point_set_count; p++)
+			{
+				uint32_t count = reader.read<uint32_t>();
+				if(reader.isRemaining(count, sizeof(uint32_t)))
+					r_mesh.mv_point_sets[p].mv_vertexes.resize(count);
+			}
+			for(unsigned int p = 0; p < point_set_count && !reader.isFailed(); p++)
+				for(unsigned int v = 0; v < r_mesh.mv_point_sets[p].mv_vertexes.size(); v++)
+					r_mesh.mv_point_sets[p].mv_vertexes[v] = reader.read<uint32_t>();
+		}
+
+		if(reader.isRemaining(polyline_count, sizeof(uint32_t)))
+		{
+			r_mesh.mv_polylines.resize(polyline_count);
+			for(unsigned int p = 0; p < polyline_count; p++)
+			{
+				uint32_t count = reader.read<uint32_t>();
+				if(reader.isRemaining(count, sizeof(uint32_t) * 2))
+					r_mesh.mv_polylines[p].mv_vertexes.resize(count);
+			}
+			for(unsigned int p = 0; p < polyline_count && !reader.isFailed(); p++)
+				for(unsigned int v = 0; v < r_mesh.mv_polylines[p].mv_vertexes.size(); v++)
+				{
+					PolylineVertex& r_vertex = r_mesh.mv_polylines[p].mv_vertexes[v];
+					r_vertex.m_vertex             = reader.read<uint32_t>();
+					r_vertex.m_texture_coordinate = reader.read<uint32_t>();
+				}
+		}
+
+		if(reader.isRemaining(face_count, sizeof(uint32_t)))
+		{
+			// the face sizes become the start of each face
+			vector<unsigned int> v_face_starts(face_count + 1);
+			uint64_t face_vertex_count = 0;
+			v_face_starts[0] = 0;
+			for(unsigned int f = 0; f < face_count; f++)
+			{
+				face_vertex_count += reader.read<uint32_t>();
+				v_face_starts[f + 1] = (unsigned int)(face_vertex_count);
+			}
+
+			if(reader.isRemaining(face_vertex_count, sizeof(uint32_t) * 3))
+			{
+				r_mesh.mv_face_starts.swap(v_face_starts);
+				r_mesh.mv_face_vertexes.resize((size_t)(face_vertex_count));
+				for(unsigned int v = 0; v < r_mesh.mv_face_vertexes.size(); v++)
+				{
+					FaceVertex& r_vertex = r_mesh.mv_face_vertexes[v];
+					r_vertex.m_vertex             = reader.read<uint32_t>();
+					r_vertex.m_texture_coordinate = reader.read<uint32_t>();
+					r_vertex.m_normal             = reader.read<uint32_t>();
+				}
+			}
+		}
+	}
+
+	if(reader.isFailed() || !reader.isAtEnd())
+	{
+		makeEmpty();
+		return false;
+	}
+
+	// the cache is good, so now connect the materials
+	for(unsigned int i = 0; i < v_libraries.size(); i++)
+		addMaterialLibrary(v_libraries[i], r_logstream);
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+		if(v_materials[m] != "")
+			setMeshMaterial(m, v_materials[m]);
+
+	// the indexes were not checked as they were read
+	m_valid = false;
+	validate();
+	printBadMaterials();
+
+	assert(invariant());
+	return true;
+}
+
+bool ObjModel :: writeBinaryCache (const string& cache_filename, const string& filename) const
+{
+	assert(ObjStringParsing::isValidFilenameWithPath(cache_filename));
+	assert(ObjStringParsing::isValidFilenameWithPath(filename));
+
+	uint64_t source_size;
+	int64_t source_modified_time;
+
+	if(!getFileStamp(filename, source_size, source_modified_time))
+		return false;
+
+	// build the whole file in memory, then write it at once
+	string buffer;
+
+	buffer.append(BINARY_CACHE_MAGIC, sizeof(BINARY_CACHE_MAGIC));
+	appendBinary(buffer, BINARY_CACHE_VERSION);
+	appendBinary(buffer, BINARY_CACHE_BYTE_ORDER);
+	appendBinary(buffer, source_size);
+	appendBinary(buffer, source_modified_time);
+
+	appendBinary(buffer, (uint32_t)(mv_material_libraries.size()));
+	appendBinary(buffer, (uint32_t)(mv_vertexes.size()));
+	appendBinary(buffer, (uint32_t)(mv_texture_coordinates.size()));
+	appendBinary(buffer, (uint32_t)(mv_normals.size()));
+	appendBinary(buffer, (uint32_t)(mv_meshes.size()));
+
+	for(unsigned int i = 0; i < mv_material_libraries.size(); i++)
+		appendBinary(buffer, mv_material_libraries[i].m_file_name);
+
+	for(unsigned int i = 0; i < mv_vertexes.size(); i++)
+	{
+		appendBinary(buffer, mv_vertexes[i].x);
+		appendBinary(buffer, mv_vertexes[i].y);
+		appendBinary(buffer, mv_vertexes[i].z);
+	}
+	for(unsigned int i = 0; i < mv_texture_coordinates.size(); i++)
+	{
+		appendBinary(buffer, mv_texture_coordinates[i].x);
+		appendBinary(buffer, mv_texture_coordinates[i].y);
+	}
+	for(unsigned int i = 0; i < mv_normals.size(); i++)
+	{
+		appendBinary(buffer, mv_normals[i].x);
+		appendBinary(buffer, mv_normals[i].y);
+		appendBinary(buffer, mv_normals[i].z);
+	}
+
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		const Mesh& mesh = mv_meshes[m];
+
+		appendBinary(buffer, mesh.m_material_name);
+		appendBinary(buffer, (uint8_t)(mesh.m_all_triangles ? 1 : 0));
+		appendBinary(buffer, (uint32_t)(mesh.mv_point_sets.size()));
+		appendBinary(buffer, (uint32_t)(mesh.mv_polylines.size()));
+		appendBinary(buffer, (uint32_t)(mesh.getFaceCount()));
+
+		for(unsigned int p = 0; p < mesh.mv_point_sets.size(); p++)
+			appendBinary(buffer, (uint32_t)(mesh.mv_point_sets[p].mv_vertexes.size()));
+		for(unsigned int p = 0; p < mesh.mv_point_sets.size(); p++)
+			for(unsigned int v = 0; v < mesh.mv_point_sets[p].mv_vertexes.size(); v++)
+				appendBinary(buffer, (uint32_t)(mesh.mv_point_sets[p].mv_vertexes[v]));
+
+		for(unsigned int p = 0; p < mesh.mv_polylines.size(); p++)
+			appendBinary(buffer, (uint32_t)(mesh.mv_polylines[p].mv_vertexes.size()));
+		for(unsigned int p = 0; p < mesh.mv_polylines.size(); p++)
+			for(unsigned int v = 0; v < mesh.mv_polylines[p].mv_vertexes.size(); v++)
+			{
+				const PolylineVertex& vertex = mesh.mv_polylines[p].mv_vertexes[v];
+				appendBinary(buffer, (uint32_t)(vertex.m_vertex));
+				appendBinary(buffer, (uint32_t)(vertex.m_texture_coordinate));
+			}
+
+		for(unsigned int f = 0; f < mesh.getFaceCount(); f++)
+			appendBinary(buffer, (uint32_t)(mesh.getFaceVertexCount(f)));
+		for(unsigned int f = 0; f < mesh.getFaceCount(); f++)
+			for(unsigned int v = 0; v < mesh.getFaceVertexCount(f); v++)
+			{
+				const FaceVertex& vertex = mesh.getFaceVertex(f, v);
+				appendBinary(buffer, (uint32_t)(vertex.m_vertex));
+				appendBinary(buffer, (uint32_t)(vertex.m_texture_coordinate));
+				appendBinary(buffer, (uint32_t)(vertex.m_normal));
+			}
+	}
+
+	ofstream output_file(cache_filename.c_str(), ios::out | ios::binary);
+	if(!output_file.is_open())
+		return false;
+	output_file.write(buffer.data(), buffer.size());
+	return !output_file.fail();
+}
+
 void ObjModel :: removeLastPointSet (unsigned int mesh)
 {
 	assert(mesh < getMeshCount());
@@ -4316,10 +5582,133 @@ void ObjModel :: removeLastFace (unsigned int mesh)
 	assert(mesh < getMeshCount());
 	assert(getFaceCount(mesh) >= 1);
 
-	mv_meshes[mesh].mv_faces.pop_back();
+	mv_meshes[mesh].removeFace(getFaceCount(mesh) - 1);
 	m_valid = false;
 }
 
+unsigned int ObjModel :: calculateFaceVertexIds (unsigned int mesh, vector<unsigned int>& rv_ids) const
+{
+	assert(isValid());
+	assert(mesh < getMeshCount());
+
+	const Mesh& mesh_ref = mv_meshes[mesh];
+	rv_ids.resize(mesh_ref.mv_face_vertexes.size());
+
+	// the combinations found so far for each vertex, as in
+	//   createVertexBufferModel
+	vector<vector<unsigned int> > vv_vertex_ids(mv_vertexes.size());
+	vector<const FaceVertex*> vp_id_face_vertexes;
+
+	for(unsigned int i = 0; i < mesh_ref.mv_face_vertexes.size(); i++)
+	{
+		const FaceVertex& face_vertex = mesh_ref.mv_face_vertexes[i];
+		assert(face_vertex.m_vertex < mv_vertexes.size());
+
+		vector<unsigned int>& v_ids = vv_vertex_ids[face_vertex.m_vertex];
+		unsigned int id = (unsigned int)(vp_id_face_vertexes.size());
+		for(unsigned int j = 0; j < v_ids.size(); j++)
+		{
+			const FaceVertex& existing = *(vp_id_face_vertexes[v_ids[j]]);
+			if(existing.m_texture_coordinate == face_vertex.m_texture_coordinate &&
+			   existing.m_normal             == face_vertex.m_normal)
+			{
+				id = v_ids[j];
+				break;
+			}
+		}
+
+		if(id == vp_id_face_vertexes.size())
+		{
+			v_ids.push_back(id);
+			vp_id_face_vertexes.push_back(&face_vertex);
+		}
+		rv_ids[i] = id;
+	}
+
+	return (unsigned int)(vp_id_face_vertexes.size());
+}
+
+void ObjModel :: sortFacesForVertexCache (unsigned int mesh)
+{
+	assert(isValid());
+	assert(mesh < getMeshCount());
+
+	vector<unsigned int> v_ids;
+	unsigned int id_count = calculateFaceVertexIds(mesh, v_ids);
+
+	vector<unsigned int> v_face_order;
+	calculateFaceOrderTipsify(mv_meshes[mesh].mv_face_starts, v_ids, id_count, VERTEX_CACHE_SIZE, v_face_order);
+
+	Mesh& mesh_ref = mv_meshes[mesh];
+	vector<FaceVertex> v_face_vertexes;
+	vector<unsigned int> v_face_starts;
+	v_face_vertexes.reserve(mesh_ref.mv_face_vertexes.size());
+	v_face_starts.reserve(mesh_ref.mv_face_starts.size());
+	for(unsigned int i = 0; i < v_face_order.size(); i++)
+	{
+		unsigned int face = v_face_order[i];
+		v_face_starts.push_back((unsigned int)(v_face_vertexes.size()));
+		v_face_vertexes.insert(v_face_vertexes.end(),
+		                       mesh_ref.mv_face_vertexes.begin() + mesh_ref.mv_face_starts[face],
+		                       mesh_ref.mv_face_vertexes.begin() + mesh_ref.mv_face_starts[face + 1]);
+	}
+	v_face_starts.push_back((unsigned int)(v_face_vertexes.size()));
+	assert(v_face_vertexes.size() == mesh_ref.mv_face_vertexes.size());
+	assert(v_face_starts.size()   == mesh_ref.mv_face_starts.size());
+
+	mesh_ref.mv_face_vertexes.swap(v_face_vertexes);
+	mesh_ref.mv_face_starts  .swap(v_face_starts);
+}
+
+void ObjModel :: renumberByFirstUse ()
+{
+	assert(isValid());
+
+	FirstUseRenumbering<Vector3, Vector3Less> vertexes(mv_vertexes);
+	FirstUseRenumbering<Vector2, Vector2Less> texture_coordinates(mv_texture_coordinates);
+	FirstUseRenumbering<Vector3, Vector3Less> normals(mv_normals);
+
+	for(unsigned int m = 0; m < mv_meshes.size(); m++)
+	{
+		Mesh& mesh = mv_meshes[m];
+
+		for(unsigned int p = 0; p < mesh.mv_point_sets.size(); p++)
+		{
+			vector<unsigned int>& v_point_set_vertexes = mesh.mv_point_sets[p].mv_vertexes;
+			for(unsigned int v = 0; v < v_point_set_vertexes.size(); v++)
+				v_point_set_vertexes[v] = vertexes.getNewIndex(v_point_set_vertexes[v]);
+		}
+
+		for(unsigned int l = 0; l < mesh.mv_polylines.size(); l++)
+		{
+			vector<PolylineVertex>& v_polyline_vertexes = mesh.mv_polylines[l].mv_vertexes;
+			for(unsigned int v = 0; v < v_polyline_vertexes.size(); v++)
+			{
+				PolylineVertex& polyline_vertex = v_polyline_vertexes[v];
+				polyline_vertex.m_vertex = vertexes.getNewIndex(polyline_vertex.m_vertex);
+				if(polyline_vertex.m_texture_coordinate != NO_TEXTURE_COORDINATES)
+					polyline_vertex.m_texture_coordinate = texture_coordinates.getNewIndex(polyline_vertex.m_texture_coordinate);
+			}
+		}
+
+		for(unsigned int i = 0; i < mesh.mv_face_vertexes.size(); i++)
+		{
+			FaceVertex& face_vertex = mesh.mv_face_vertexes[i];
+			face_vertex.m_vertex = vertexes.getNewIndex(face_vertex.m_vertex);
+			if(face_vertex.m_texture_coordinate != NO_TEXTURE_COORDINATES)
+				face_vertex.m_texture_coordinate = texture_coordinates.getNewIndex(face_vertex.m_texture_coordinate);
+			if(face_vertex.m_normal != NO_NORMAL)
+				face_vertex.m_normal = normals.getNewIndex(face_vertex.m_normal);
+		}
+	}
+
+	mv_vertexes            = vertexes.getNewValues();
+	mv_texture_coordinates = texture_coordinates.getNewValues();
+	mv_normals             = normals.getNewValues();
+
+	assert(isValid());
+}
+
 bool ObjModel :: invariant () const
 {
 	if(!ObjStringParsing::isValidFilename(m_file_name)) return false;
@@ -4450,43 +5839,25 @@ ObjModel :: FaceVertex :: FaceVertex (unsigned int vertex, unsigned int texture_
 	m_normal             = normal;
 }
 
-ObjModel :: FaceVertex :: FaceVertex (const ObjModel :: FaceVertex& original)
-{
-	m_vertex             = original.m_vertex;
-	m_texture_coordinate = original.m_texture_coordinate;
-	m_normal             = original.m_normal;
-}
-
-ObjModel :: FaceVertex& ObjModel :: FaceVertex :: operator= (const ObjModel :: FaceVertex& original)
-{
-	if(&original != this)
-	{
-		m_vertex             = original.m_vertex;
-		m_texture_coordinate = original.m_texture_coordinate;
-		m_normal             = original.m_normal;
-	}
-
-	return *this;
-}
 
 
 
 
-ObjModel :: Mesh :: Mesh () : mv_faces()
+ObjModel :: Mesh :: Mesh () : mv_face_vertexes(), mv_face_starts(1, 0)
 {
 	m_material_name = "";
 	mp_material     = NULL;
 	m_all_triangles = true;
 }
 
-ObjModel :: Mesh :: Mesh (const string& material_name, Material* p_material) : mv_faces()
+ObjModel :: Mesh :: Mesh (const string& material_name, Material* p_material) : mv_face_vertexes(), mv_face_starts(1, 0)
 {
 	m_material_name = material_name;
 	mp_material     = p_material;
 	m_all_triangles = true;
 }
 
-ObjModel :: Mesh :: Mesh (const ObjModel :: Mesh& original) : mv_faces(original.mv_faces)
+ObjModel :: Mesh :: Mesh (const ObjModel :: Mesh& original) : mv_face_vertexes(original.mv_face_vertexes), mv_face_starts(original.mv_face_starts)
 {
 	m_material_name = original.m_material_name;
 	mp_material     = original.mp_material;
@@ -4497,11 +5868,114 @@ ObjModel :: Mesh& ObjModel :: Mesh :: operator= (const ObjModel :: Mesh& origina
 {
 	if(&original != NULL)
 	{
-		m_material_name = original.m_material_name;
-		mp_material     = original.mp_material;
-		mv_faces        = original.mv_faces;
-		m_all_triangles = original.m_all_triangles;
+		m_material_name  = original.m_material_name;
+		mp_material      = original.mp_material;
+		mv_face_vertexes = original.mv_face_vertexes;
+		mv_face_starts   = original.mv_face_starts;
+		m_all_triangles  = original.m_all_triangles;
 	}
 
 	return *this;
 }
+
+unsigned int ObjModel :: Mesh :: getFaceCount () const
+{
+	assert(!mv_face_starts.empty());
+
+	return mv_face_starts.size() - 1;
+}
+
+unsigned int ObjModel :: Mesh :: getFaceVertexCount (unsigned int face) const
+{
+	assert(face < getFaceCount());
+
+	return mv_face_starts[face + 1] - mv_face_starts[face];
+}
+
+const ObjModel :: FaceVertex& ObjModel :: Mesh :: getFaceVertex (unsigned int face, unsigned int vertex) const
+{
+	assert(face < getFaceCount());
+	assert(vertex < getFaceVertexCount(face));
+
+	return mv_face_vertexes[mv_face_starts[face] + vertex];
+}
+
+ObjModel :: FaceVertex& ObjModel :: Mesh :: getFaceVertex (unsigned int face, unsigned int vertex)
+{
+	assert(face < getFaceCount());
+	assert(vertex < getFaceVertexCount(face));
+
+	return mv_face_vertexes[mv_face_starts[face] + vertex];
+}
+
+unsigned int ObjModel :: Mesh :: addFace ()
+{
+	unsigned int id = getFaceCount();
+	mv_face_starts.push_back(mv_face_starts.back());
+	return id;
+}
+
+unsigned int ObjModel :: Mesh :: addFaceVertex (unsigned int face, const FaceVertex& face_vertex)
+{
+	assert(face < getFaceCount());
+
+	unsigned int id  = getFaceVertexCount(face);
+	unsigned int end = mv_face_starts[face + 1];
+
+	// usually adding to the last face, so nothing moves
+	mv_face_vertexes.insert(mv_face_vertexes.begin() + end, face_vertex);
+	for(unsigned int f = face + 1; f < mv_face_starts.size(); f++)
+		mv_face_starts[f]++;
+
+	assert(mv_face_starts.back() == mv_face_vertexes.size());
+	return id;
+}
+
+void ObjModel :: Mesh :: removeFace (unsigned int face)
+{
+	assert(face < getFaceCount());
+
+	unsigned int start = mv_face_starts[face];
+	unsigned int count = getFaceVertexCount(face);
+
+	mv_face_vertexes.erase(mv_face_vertexes.begin() + start,
+	                       mv_face_vertexes.begin() + start + count);
+	mv_face_starts.erase(mv_face_starts.begin() + face + 1);
+	for(unsigned int f = face + 1; f < mv_face_starts.size(); f++)
+		mv_face_starts[f] -= count;
+
+	assert(mv_face_starts.back() == mv_face_vertexes.size());
+}
+
+void ObjModel :: Mesh :: removeFaceAll ()
+{
+	mv_face_vertexes.clear();
+	mv_face_starts.assign(1, 0);
+}
+
+void ObjModel :: Mesh :: removeFaceVertex (unsigned int face, unsigned int vertex)
+{
+	assert(face < getFaceCount());
+	assert(vertex < getFaceVertexCount(face));
+
+	mv_face_vertexes.erase(mv_face_vertexes.begin() + mv_face_starts[face] + vertex);
+	for(unsigned int f = face + 1; f < mv_face_starts.size(); f++)
+		mv_face_starts[f]--;
+
+	assert(mv_face_starts.back() == mv_face_vertexes.size());
+}
+
+void ObjModel :: Mesh :: removeFaceVertexAll (unsigned int face)
+{
+	assert(face < getFaceCount());
+
+	unsigned int start = mv_face_starts[face];
+	unsigned int count = getFaceVertexCount(face);
+
+	mv_face_vertexes.erase(mv_face_vertexes.begin() + start,
+	                       mv_face_vertexes.begin() + start + count);
+	for(unsigned int f = face + 1; f < mv_face_starts.size(); f++)
+		mv_face_starts[f] -= count;
+
+	assert(mv_face_starts.back() == mv_face_vertexes.size());
+}
@@ -29,6 +29,7 @@
 #include "ObjSettings.h"
 #include "MtlLibrary.h"
 #include "DisplayList.h"
+#include "VertexBufferModel.h"
 #include "Vector3.h"
 #include "Vector2.h"
 
@@ -106,6 +107,25 @@ public:
 //
 	static const unsigned int NO_NORMAL;
 
+//
+//  BINARY_CACHE_SUFFIX
+//
+//  The suffix added to the name of an OBJ file to get the name
+//    of the binary cache file used by loadCached.
+//
+	static const char* const BINARY_CACHE_SUFFIX;
+
+//
+//  VERTEX_CACHE_SIZE
+//
+//  The number of vertexes in the post-transform vertex cache
+//    that optimizeVertexCache arranges the faces for.  A
+//    smaller cache is assumed than most graphics cards have,
+//    because an order that is good for a small cache is also
+//    good for a larger one, but not the reverse.
+//
+	static const unsigned int VERTEX_CACHE_SIZE;
+
 //
 //  Class Function: loadDisplayTextures
 //
@@ -1073,6 +1093,30 @@ public:
 //
 	bool isAllTriangles () const;
 
+//
+//  getVertexCacheMissRatio
+//
+//  Purpose: To determine how well the faces in this ObjModel
+//           use a post-transform vertex cache of the specified
+//           size.
+//  Parameter(s):
+//    <1> cache_size: The number of vertexes in the cache
+//  Precondition(s):
+//    <1> isValid()
+//    <2> cache_size >= 1
+//  Returns: The average number of vertexes that would be
+//           transformed for each triangle if the faces were
+//           drawn in order as triangle fans with a first-in,
+//           first-out cache of cache_size vertexes.  Each
+//           combination of a vertex, texture coordinates, and
+//           normal is a different vertex.  The result is
+//           between 0.5 and 3.0 for most models, and lower is
+//           better.  If this ObjModel contains no faces, 0.0
+//           is returned.
+//  Side Effect: N/A
+//
+	double getVertexCacheMissRatio (unsigned int cache_size) const;
+
 //
 //  isSingleMaterial
 //
@@ -1208,6 +1252,32 @@ public:
 	void printBadMaterials (const std::string& logfile) const;
 	void printBadMaterials (std::ostream& r_logstream) const;
 
+//
+//  preloadDisplayTextures
+//
+//  Purpose: To read the images for the textures used to
+//           display this ObjModel into memory without adding
+//           them to OpenGL.  This allows the slow part of
+//           loading textures to be done on another thread
+//           before the ObjModel is displayed.
+//  Parameter(s):
+//    <1> r_logstream: The stream to write loading errors to
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: The images for the textures that would be
+//               needed to display this ObjModel are read with
+//               TextureManager::preloadImage.  If a logging
+//               stream is specified, any loading errors are
+//               written to that stream.  Otherwise, any loading
+//               errors are written to the standard error
+//               stream.  This function may be called from any
+//               thread, but not while the textures for the
+//               same materials are being loaded on another
+//               thread.
+//
+	void preloadDisplayTextures () const;
+	void preloadDisplayTextures (std::ostream& r_logstream) const;
+
 #ifndef OBJ_LIBRARY_SHADER_DISPLAY
 //
 //  draw
@@ -1872,6 +1942,109 @@ public:
 //  Side Effect: N/A
 //
 	DisplayList getDisplayListMaterialNone () const;
+
+//
+//  getVertexBufferModel
+//
+//  Purpose: To generate a VertexBufferModel for this ObjModel.
+//           The faces are stored as triangles in an index
+//           buffer, with each combination of vertex, texture
+//           coordinates, and normal stored once in an
+//           interleaved vertex buffer.  The faces for all the
+//           meshes that use the same material are drawn
+//           together.  Point sets and polylines are not
+//           included.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//    <2> !Material::isMaterialActive()
+//  Returns: A VertexBufferModel for the faces of this ObjModel.
+//           Texture coordinates and normals are included if
+//           any face vertex has them.  A face vertex without
+//           them uses (0, 0) and the zero vector.
+//  Side Effect: The textures for the materials used by this
+//               ObjModel are loaded.
+//
+	VertexBufferModel getVertexBufferModel () const;
+
+//
+//  getVertexBufferModel
+//
+//  Purpose: To generate a VertexBufferModel for this ObjModel
+//           and determine which vertex of this ObjModel each of
+//           its vertexes is at.  This is intended for replacing
+//           the vertex positions with
+//           VertexBufferModel::getCopyWithPositions.
+//  Parameter(s):
+//    <1> rv_vertexes: A vector to fill with the vertex
+//                     indexes
+//  Precondition(s):
+//    <1> isValid()
+//    <2> !Material::isMaterialActive()
+//  Returns: The same VertexBufferModel as
+//           getVertexBufferModel().
+//  Side Effect: The textures for the materials used by this
+//               ObjModel are loaded.  rv_vertexes is set to
+//               contain one element for each vertex in the
+//               returned VertexBufferModel, which is the index
+//               of the vertex in this ObjModel that it is
+//               positioned at.
+//
+	VertexBufferModel getVertexBufferModel (
+	               std::vector<unsigned int>& rv_vertexes) const;
+
+//
+//  getVertexBufferModelMaterial
+//
+//  Purpose: To generate a VertexBufferModel for this ObjModel
+//           that displays all the faces with the specified
+//           material, or the material with the specified name.
+//           If there is no Material with the correct name in
+//           the current MTL libraries, the VertexBufferModel
+//           is displayed without a material.
+//  Parameter(s):
+//    <1> material: The material
+//    <1> a_name: The name of the material
+//    <1> name: The name of the material
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> isValid()
+//    <2> !Material::isMaterialActive()
+//    <3> a_name != NULL
+//  Returns: A VertexBufferModel for the faces of this ObjModel
+//           that uses Material material/a_name/name.  It refers
+//           to the Material, which must exist for as long as
+//           the VertexBufferModel is drawn.
+//  Side Effect: If a logging stream is specified, any loading
+//               errors are written to that stream.  Otherwise,
+//               any loading errors are written to the standard
+//               error stream.
+//
+	VertexBufferModel getVertexBufferModelMaterial (
+	                            const Material& material) const;
+	VertexBufferModel getVertexBufferModelMaterial (
+	                                  const char* a_name) const;
+	VertexBufferModel getVertexBufferModelMaterial (
+	                             const std::string& name) const;
+	VertexBufferModel getVertexBufferModelMaterial (
+	                           const std::string& name,
+	                           std::ostream& r_logstream) const;
+
+//
+//  getVertexBufferModelMaterialNone
+//
+//  Purpose: To generate a VertexBufferModel for this ObjModel
+//           without using its materials.  As with
+//           getDisplayListMaterialNone, the VertexBufferModel
+//           is drawn with the current OpenGL state.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: A VertexBufferModel for the faces of this ObjModel
+//           without any materials.
+//  Side Effect: N/A
+//
+	VertexBufferModel getVertexBufferModelMaterialNone () const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
@@ -1987,6 +2160,44 @@ public:
 	void load (const std::string& filename,
 	           std::ostream& r_logstream);
 
+//
+//  loadCached
+//
+//  Purpose: To replace this ObjModel with the model specified
+//           in the specified file, using a binary cache file
+//           if there is an up-to-date one.  A logfile may be
+//           specified as a filename or an output stream.
+//  Parameter(s):
+//    <1> filename: The name of the file containing the model
+//    <2> logfile: The file to write loading errors to
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> ObjStringParsing::isValidFilenameWithPath(filename)
+//    <2> ObjStringParsing::isValidFilenameWithPath(logfile)
+//  Returns: N/A
+//  Side Effect: This ObjModel is set to represent the ObjModel
+//               specified in the file filename, as for load.
+//               If there is a cache file named filename +
+//               BINARY_CACHE_SUFFIX that was created from a
+//               file with the same size and modification time
+//               as file filename, the model is read from the
+//               cache file instead of file filename.
+//               Otherwise, file filename is loaded and, if it
+//               is loaded successfully, optimizeVertexCache is
+//               called and the cache file is created or
+//               replaced.  Either way, the faces and vertexes
+//               may be in a different order than in file
+//               filename.  Errors in parsing file
+//               filename are only reported when it is loaded,
+//               not when the cache is used.  Errors in loading
+//               material libraries are always reported.
+//
+	void loadCached (const std::string& filename);
+	void loadCached (const std::string& filename,
+	                 const std::string& logfile);
+	void loadCached (const std::string& filename,
+	                 std::ostream& r_logstream);
+
 //
 //  setFileName
 //
@@ -3080,6 +3291,32 @@ public:
 //
 	void validate ();
 
+//
+//  optimizeVertexCache
+//
+//  Purpose: To rearrange this ObjModel so that it can be
+//           displayed with fewer vertex transformations and
+//           less memory traffic.  The appearance of the model
+//           is not changed.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: N/A
+//  Side Effect: Vertexes, texture coordinates, and normals
+//               with identical values are merged, and ones that
+//               are not used are removed.  The faces in each
+//               mesh are then reordered with the Tipsify
+//               algorithm so that consecutive faces share
+//               vertexes while they are still in a cache of
+//               VERTEX_CACHE_SIZE vertexes.  Finally, the
+//               vertexes, texture coordinates, and normals are
+//               renumbered in the order they are first used.
+//               The order of the meshes, point sets, and
+//               polylines, and the vertexes within each face,
+//               are not changed.
+//
+	void optimizeVertexCache ();
+
 private:
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
 	//
@@ -3219,6 +3456,35 @@ private:
 //               displayed using the current Material, if any.
 //
 	void drawFaces (unsigned int mesh) const;
+
+//
+//  createVertexBufferModel
+//
+//  Purpose: To generate a VertexBufferModel for the faces of
+//           this ObjModel.
+//  Parameter(s):
+//    <1> is_mesh_materials: Whether to use the material for
+//                           each mesh
+//    <2> p_material: A pointer to the material to use for all
+//                    the faces if is_mesh_materials == false
+//    <3> pv_vertexes: A pointer to a vector to fill with the
+//                     ObjModel vertex for each output vertex,
+//                     or NULL
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: A VertexBufferModel for the faces in this ObjModel.
+//           If is_mesh_materials == true, there is one material
+//           range for each different mesh material.  Otherwise,
+//           there is one material range using p_material, which
+//           may be NULL.
+//  Side Effect: If pv_vertexes != NULL, *pv_vertexes is set to
+//               the index of the vertex in this ObjModel for
+//               each vertex in the VertexBufferModel.
+//
+	VertexBufferModel createVertexBufferModel (
+	          bool is_mesh_materials,
+	          const Material* p_material,
+	          std::vector<unsigned int>* pv_vertexes) const;
 #endif  // OBJ_LIBRARY_SHADER_DISPLAY is not defined
 
 #ifdef OBJ_LIBRARY_SHADER_DISPLAY
@@ -3469,54 +3735,74 @@ private:
 //  readMaterialLibrary
 //
 //  Purpose: To add the material libaries corresponding to the
-//           information in a string to this ObjModel.
+//           information in a range of characters to this
+//           ObjModel.
 //  Parameter(s):
-//    <1> str: The string containing the material libraries
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies one or more material
+//    <1> a_begin: The beginning of the characters containing
+//                 the material libraries
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify one or more material
 //           libaries.
-//  Side Effect: If string str specifies one or more material
+//  Side Effect: If the characters specify one or more material
 //               libraries, those material libraries are added
 //               to the end of the list this ObjModel checks
 //               when searching for a material.  Otherwise,
 //               there is no effect.
 //
-	bool readMaterialLibrary (const std::string& str,
+	bool readMaterialLibrary (const char* a_begin,
+	                          const char* a_end,
 	                          std::ostream& r_logstream);
 
 //
 //  readMaterial
 //
 //  Purpose: To set the current material for this ObjModel
-//           corresponding to the information in a string.
-//  Parameter(s):
-//    <1> str: The string containing the material name
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a material.
-//  Side Effect: If string str specifies a material, that
+//           corresponding to the information in a range of
+//           characters.
+//  Parameter(s):
+//    <1> a_begin: The beginning of the characters containing
+//                 the material name
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a material.
+//  Side Effect: If the characters specify a material, that
 //               material is set to be the current material for
 //               this ObjModel.  Otherwise, there is no effect.
 //
-	bool readMaterial (const std::string& str,
+	bool readMaterial (const char* a_begin,
+	                   const char* a_end,
 	                   std::ostream& r_logstream);
 
 //
 //  readVertex
 //
 //  Purpose: To add a vertex to this ObjModel corresponding to
-//           the information in a string.
-//  Parameter(s):
-//    <1> str: The string containing the vertex information
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a vertex.
-//  Side Effect: If string str specifies a vertex, that vertex.
+//           the information in a range of characters.
+//  Parameter(s):
+//    <1> a_begin: The beginning of the characters containing
+//                 the vertex information
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a vertex.
+//  Side Effect: If the characters specify a vertex, that vertex.
 //               is added to this ObjModel.  Otherwise, there is
 //               no effect.
 //
-	bool readVertex (const std::string& str,
+	bool readVertex (const char* a_begin,
+	                 const char* a_end,
 	                 std::ostream& r_logstream);
 
 //
@@ -3524,93 +3810,171 @@ private:
 //
 //  Purpose: To add a pair of texture coordinates to this
 //           ObjModel corresponding to the information in a
-//           string.
+//           range of characters.
 //  Parameter(s):
-//    <1> str: The string containing the texture coordinate
-//               information
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a pair of texture
+//    <1> a_begin: The beginning of the characters containing
+//                 the texture coordinate information
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a pair of texture
 //           coordinates.
-//  Side Effect: If string str specifies a pair of texture
+//  Side Effect: If the characters specify a pair of texture
 //               coordinates, that pair is added to this
 //               ObjModel.  Otherwise, there is no effect.
 //
-	bool readTextureCoordinates (const std::string& str,
+	bool readTextureCoordinates (const char* a_begin,
+	                             const char* a_end,
 	                             std::ostream& r_logstream);
 
 //
 //  readNormal
 //
 //  Purpose: To add a normal vector to this ObjModel
-//           corresponding to the information in a string.
-//  Parameter(s):
-//    <1> str: The string containing the normal vector
-//               information
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a normal vector.
-//  Side Effect: If string str specifies a normal vector, that
+//           corresponding to the information in a range of
+//           characters.
+//  Parameter(s):
+//    <1> a_begin: The beginning of the characters containing
+//                 the normal vector information
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a normal vector.
+//  Side Effect: If the characters specify a normal vector, that
 //               normal vector is added to this ObjModel.
 //               Otherwise, there is no effect.
 //
-	bool readNormal (const std::string& str,
+	bool readNormal (const char* a_begin,
+	                 const char* a_end,
 	                 std::ostream& r_logstream);
 
 //
 //  readPointSet
 //
 //  Purpose: To add a point set to this ObjModel corresponding
-//           to the information in the specified string.
-//  Parameter(s):
-//    <1> str: The string containing the point set information
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a point set.
-//  Side Effect: If string str specifies a point set, that point
-//               set is added to this ObjModel and this ObjModel
-//               is marked as invalid.  Otherwise, there is no
+//           to the information in a range of characters.
+//  Parameter(s):
+//    <1> a_begin: The beginning of the characters containing
+//                 the point set information
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a point set.
+//  Side Effect: If the characters specify a point set, that
+//               point set is added to this ObjModel and this
+//               ObjModel is marked as invalid.  Otherwise, there is no
 //               effect.
 //
-	bool readPointSet (const std::string& str,
+	bool readPointSet (const char* a_begin,
+	                   const char* a_end,
 	                   std::ostream& r_logstream);
 
 //
 //  readPolyline
 //
 //  Purpose: To add a polyline to this ObjModel corresponding to
-//           the information in a string.
-//  Parameter(s):
-//    <1> str: The string containing the polyline information
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a polyline.
-//  Side Effect: If string str specifies a polyline, that
+//           the information in a range of characters.
+//  Parameter(s):
+//    <1> a_begin: The beginning of the characters containing
+//                 the polyline information
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a polyline.
+//  Side Effect: If the characters specify a polyline, that
 //               polyline/face is added to this ObjModel and
 //               this ObjModel is marked as invalid.  Otherwise,
 //               there is no effect.
 //
-	bool readPolyline (const std::string& str,
+	bool readPolyline (const char* a_begin,
+	                   const char* a_end,
 	                   std::ostream& r_logstream);
 
 //
 //  readFace
 //
 //  Purpose: To add a face to this ObjModel corresponding to the
-//           information in a string.
-//  Parameter(s):
-//    <1> str: The string containing the face information
-//    <2> r_logstream: The stream to write loading errors to
-//  Precondition(s): N/A
-//  Returns: Whether the string specifies a face.
-//  Side Effect: If string str specifies a face, that face is
+//           information in a range of characters.
+//  Parameter(s):
+//    <1> a_begin: The beginning of the characters containing
+//                 the face information
+//    <2> a_end: The end of the characters
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> a_begin != NULL
+//    <2> a_end != NULL
+//    <3> a_begin <= a_end
+//  Returns: Whether the characters specify a face.
+//  Side Effect: If the characters specify a face, that face is
 //               added to this ObjModel and this ObjModel is
 //               marked as invalid.  Otherwise, there is no
 //               effect.
 //
-	bool readFace (const std::string& str,
+	bool readFace (const char* a_begin,
+	               const char* a_end,
 	               std::ostream& r_logstream);
 
+//
+//  readBinaryCache
+//
+//  Purpose: To replace this ObjModel with the model in the
+//           specified binary cache file, if it is up to date.
+//  Parameter(s):
+//    <1> cache_filename: The name of the cache file
+//    <2> filename: The name of the OBJ file the cache was
+//                  created from
+//    <3> r_logstream: The stream to write loading errors to
+//  Precondition(s):
+//    <1> ObjStringParsing::isValidFilenameWithPath(
+//                                             cache_filename)
+//    <2> ObjStringParsing::isValidFilenameWithPath(filename)
+//  Returns: Whether the model was read from the cache file.
+//           If the cache file does not exist, is for a
+//           different version of file filename or of the cache
+//           format, or is damaged, false is returned.
+//  Side Effect: If the cache file is up to date, this ObjModel
+//               is set to represent the model it contains, with
+//               file name filename.  Otherwise, this ObjModel
+//               is set to be empty.
+//
+	bool readBinaryCache (const std::string& cache_filename,
+	                      const std::string& filename,
+	                      std::ostream& r_logstream);
+
+//
+//  writeBinaryCache
+//
+//  Purpose: To write the contents of this ObjModel to the
+//           specified binary cache file.
+//  Parameter(s):
+//    <1> cache_filename: The name of the cache file
+//    <2> filename: The name of the OBJ file this ObjModel was
+//                  loaded from
+//  Precondition(s):
+//    <1> ObjStringParsing::isValidFilenameWithPath(
+//                                             cache_filename)
+//    <2> ObjStringParsing::isValidFilenameWithPath(filename)
+//  Returns: Whether the cache file was written.
+//  Side Effect: A file named cache_filename is created.  If a
+//               file by that name already exists, its contents
+//               are lost.  The size and modification time of
+//               file filename are recorded in the cache file.
+//
+	bool writeBinaryCache (const std::string& cache_filename,
+	                       const std::string& filename) const;
+
 //
 //  removeLastPointSet
 //
@@ -3662,6 +4026,65 @@ private:
 //
 	void removeLastFace (unsigned int mesh);
 
+//
+//  calculateFaceVertexIds
+//
+//  Purpose: To assign a number to each different combination of
+//           vertex, texture coordinates, and normal in the
+//           faces of the specified mesh.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//    <2> rv_ids: A vector to fill with the number for each
+//                face vertex
+//  Precondition(s):
+//    <1> isValid()
+//    <2> mesh < getMeshCount()
+//  Returns: The number of different combinations.
+//  Side Effect: rv_ids is set to contain one element for each
+//               element of the face vertex array for mesh mesh.
+//               The combinations are numbered in order of
+//               first use, starting at 0.
+//
+	unsigned int calculateFaceVertexIds (
+	                      unsigned int mesh,
+	                      std::vector<unsigned int>& rv_ids) const;
+
+//
+//  sortFacesForVertexCache
+//
+//  Purpose: To reorder the faces in the specified mesh to make
+//           good use of the post-transform vertex cache.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//  Precondition(s):
+//    <1> isValid()
+//    <2> mesh < getMeshCount()
+//  Returns: N/A
+//  Side Effect: The faces in mesh mesh are reordered with the
+//               Tipsify algorithm for a cache of
+//               VERTEX_CACHE_SIZE vertexes.
+//
+	void sortFacesForVertexCache (unsigned int mesh);
+
+//
+//  renumberByFirstUse
+//
+//  Purpose: To renumber the vertexes, texture coordinates, and
+//           normals in this ObjModel in the order they are
+//           used.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isValid()
+//  Returns: N/A
+//  Side Effect: The vertexes, texture coordinates, and normals
+//               are renumbered in the order they are first
+//               used by the point sets, polylines, and faces of
+//               each mesh.  Elements with identical values are
+//               merged, and elements that are not used are
+//               removed.
+//
+	void renumberByFirstUse ();
+
 //
 //  invariant
 //
@@ -3776,27 +4199,15 @@ private:
 		FaceVertex (unsigned int vertex,
 		            unsigned int texture_coordinate,
 		            unsigned int normal);
-		FaceVertex (const FaceVertex& original);
+		FaceVertex (const FaceVertex& original) = default;
 		FaceVertex& operator= (
-		                    const FaceVertex& original);
+		          const FaceVertex& original) = default;
 
 		unsigned int m_vertex;
 		unsigned int m_texture_coordinate;
 		unsigned int m_normal;
 	};
 
-	//
-	//  Face
-	//
-	//  A record to represent a face in an ObjModel.  A Face
-	//    contains the indices of the vertexes that form
-	//    the outline of the face.
-	//
-	struct Face
-	{
-		std::vector<FaceVertex> mv_vertexes;
-	};
-
 	//
 	//  Mesh
 	//
@@ -3808,6 +4219,22 @@ private:
 	//    pointer should be set to NULL and the material
 	//    name to the empty string.
 	//
+	//  The vertexes of all the faces are stored one after
+	//    another in a single array, mv_face_vertexes.  Face
+	//    f uses the elements from mv_face_starts[f] up to,
+	//    but not including, mv_face_starts[f + 1], so
+	//    mv_face_starts has one more element than there are
+	//    faces.  This avoids a memory allocation for every
+	//    face.  Adding a vertex to the last face is fast,
+	//    but adding or removing a vertex of an earlier face
+	//    moves all the vertexes after it.
+	//
+	//  Invariant for faces:
+	//    <1> !mv_face_starts.empty()
+	//    <2> mv_face_starts[0] == 0
+	//    <3> mv_face_starts.back() == mv_face_vertexes.size()
+	//    <4> mv_face_starts[i] <= mv_face_starts[i + 1]
+	//
 	struct Mesh
 	{
 		Mesh ();
@@ -3816,11 +4243,30 @@ private:
 		Mesh (const Mesh& original);
 		Mesh& operator= (const Mesh& original);
 
+		unsigned int getFaceCount () const;
+		unsigned int getFaceVertexCount (
+		                         unsigned int face) const;
+		const FaceVertex& getFaceVertex (
+		                        unsigned int face,
+		                        unsigned int vertex) const;
+		FaceVertex& getFaceVertex (unsigned int face,
+		                           unsigned int vertex);
+		unsigned int addFace ();
+		unsigned int addFaceVertex (
+		                   unsigned int face,
+		                   const FaceVertex& face_vertex);
+		void removeFace (unsigned int face);
+		void removeFaceAll ();
+		void removeFaceVertex (unsigned int face,
+		                       unsigned int vertex);
+		void removeFaceVertexAll (unsigned int face);
+
 		std::string m_material_name;
 		Material* mp_material;
 		std::vector<PointSet> mv_point_sets;
 		std::vector<Polyline> mv_polylines;
-		std::vector<Face> mv_faces;
+		std::vector<FaceVertex> mv_face_vertexes;
+		std::vector<unsigned int> mv_face_starts;
 		bool m_all_triangles;
 	};
 
@@ -18,6 +18,7 @@
 //
 
 #include <cassert>
+#include <cctype>
 #include <string>
 
 #include "ObjStringParsing.h"
@@ -84,6 +85,54 @@ size_t ObjStringParsing :: nextSlashInToken (const string& str, size_t current)
 	return string::npos;
 }
 
+const char* ObjStringParsing :: nextToken (const char* a_current, const char* a_end)
+{
+	assert(a_current != NULL);
+	assert(a_end != NULL);
+	assert(a_current <= a_end);
+
+	const char* p = a_current;
+
+	// skip the rest of the current token, then the whitespace
+	while(p < a_end && !isspace(*p))
+		p++;
+	if(p == a_end)
+		return a_end;
+	while(p < a_end && isspace(*p))
+		p++;
+	return p;
+}
+
+size_t ObjStringParsing :: getTokenLength (const char* a_current, const char* a_end)
+{
+	assert(a_current != NULL);
+	assert(a_end != NULL);
+	assert(a_current <= a_end);
+
+	const char* p = a_current;
+	while(p < a_end && !isspace(*p))
+		p++;
+	return p - a_current;
+}
+
+const char* ObjStringParsing :: nextSlashInToken (const char* a_current, const char* a_end)
+{
+	assert(a_current != NULL);
+	assert(a_end != NULL);
+	assert(a_current <= a_end);
+
+	for(const char* p = a_current; p < a_end; p++)
+	{
+		if(*p == '/')
+			return p;
+		else if(isspace(*p))
+			return a_end;
+	}
+
+	// you only get here if there is no next slash
+	return a_end;
+}
+
 
 
 string ObjStringParsing :: toLowercase (const string& str)
@@ -92,6 +92,68 @@ size_t getTokenLength (const std::string& str, size_t current);
 //
 size_t nextSlashInToken(const std::string& str, size_t current);
 
+//
+//  nextToken
+//
+//  Purpose: To determine the position of the next token
+//           character in the specified range of characters.
+//           The next token is defined as for the string
+//           version of this function.
+//  Parameter(s):
+//    <1> a_current: The position to begin searching at
+//    <2> a_end: The end of the range to search
+//  Precondition(s):
+//    <1> a_current != NULL
+//    <2> a_end != NULL
+//    <3> a_current <= a_end
+//  Returns: The position of the beginning of the next token.
+//           If there is no next token, a_end is returned.
+//  Side Effect: N/A
+//
+const char* nextToken (const char* a_current, const char* a_end);
+
+//
+//  getTokenLength
+//
+//  Purpose: To determine the length of the token starting at
+//           the specified position in the specified range of
+//           characters.  The token length is defined as for
+//           the string version of this function.
+//  Parameter(s):
+//    <1> a_current: The beginning of the token
+//    <2> a_end: The end of the range to search
+//  Precondition(s):
+//    <1> a_current != NULL
+//    <2> a_end != NULL
+//    <3> a_current <= a_end
+//  Returns: The length of the token beginning at a_current.
+//           If a_current is a whitespace character or is
+//           a_end, 0 is returned.
+//  Side Effect: N/A
+//
+size_t getTokenLength (const char* a_current, const char* a_end);
+
+//
+//  nextSlashInToken
+//
+//  Purpose: To determine the position of the next slash ('/')
+//           character in the current token of the specified
+//           range of characters, at or after the specified
+//           position.
+//  Parameter(s):
+//    <1> a_current: The position to begin searching at
+//    <2> a_end: The end of the range to search
+//  Precondition(s):
+//    <1> a_current != NULL
+//    <2> a_end != NULL
+//    <3> a_current <= a_end
+//  Returns: The position of the next slash in this token.  If
+//           there is no next slash, a_end is returned.
+//  Side Effect: N/A
+//
+const char* nextSlashInToken (const char* a_current,
+                              const char* a_end);
+
 
 
 //
@@ -1203,36 +1203,48 @@ void TextureBmp :: load (const string& filename, ostream& r_logstream)
 	m_array_size = m_bytes_per_row * m_height;
 	md_texture = new unsigned char[m_array_size];
 
-	// read actual bitmap
-	input_file.read ( (char*)(md_texture), m_array_size);
-
-	input_file.close();
-
-	// reorder pixel colour components
+	//
+	//  The rows are stored bottom to top in the file, so each
+	//    row is read directly into its mirrored position and
+	//    its colour components are reordered while it is still
+	//    in the cache.  This touches each pixel once instead of
+	//    once for the reordering and again to mirror the image.
+	//
 	for(unsigned int y = 0; y < m_height; y++)
-		for(unsigned int x = 0; x < m_width; x++)
+	{
+		unsigned char* p_row = md_texture + (m_height - 1 - y) * m_bytes_per_row;
+		input_file.read((char*)(p_row), m_bytes_per_row);
+
+		if(m_is_alpha)
 		{
-			unsigned int array_spot;
+			unsigned char* p_row_end = p_row + m_width * 4;
+			assert(p_row_end <= md_texture + m_array_size);
 
-			if(m_is_alpha)
+			// BGRA => RGB1
+			for(unsigned char* p_pixel = p_row; p_pixel < p_row_end; p_pixel += 4)
 			{
-				array_spot = y * m_bytes_per_row + x * 4;
-				assert(array_spot + 3 < m_array_size);
-
-				// BGRA => RGB1
-				swap(md_texture[array_spot], md_texture[array_spot + 2]);
-				md_texture[array_spot + 3] = 0xFF;
+				unsigned char blue = p_pixel[0];
+				p_pixel[0] = p_pixel[2];
+				p_pixel[2] = blue;
+				p_pixel[3] = 0xFF;
 			}
-			else
-			{
-				array_spot = y * m_bytes_per_row + x * 3;
-				assert(array_spot + 2 < m_array_size);
+		}
+		else
+		{
+			unsigned char* p_row_end = p_row + m_width * 3;
+			assert(p_row_end <= md_texture + m_array_size);
 
-				// BGR => RGB
-				swap(md_texture[array_spot], md_texture[array_spot + 2]);
+			// BGR => RGB
+			for(unsigned char* p_pixel = p_row; p_pixel < p_row_end; p_pixel += 3)
+			{
+				unsigned char blue = p_pixel[0];
+				p_pixel[0] = p_pixel[2];
+				p_pixel[2] = blue;
 			}
 		}
-	mirrorY();
+	}
+
+	input_file.close();
 
 	assert(invariant());
 }
@@ -1456,18 +1468,82 @@ unsigned int TextureBmp :: addToOpenGL (unsigned int wrap_s,
 
 	glGenTextures(1, &name);
 	glBindTexture(GL_TEXTURE_2D, name);
+	replaceInOpenGL(name, wrap_s, wrap_t, mag_filter, min_filter);
+
+	return name;
+}
+
+void TextureBmp :: replaceInOpenGL (unsigned int texture_name,
+                                    unsigned int wrap_s,
+                                    unsigned int wrap_t,
+                                    unsigned int mag_filter,
+                                    unsigned int min_filter) const
+{
+	assert(isGlutInitialized());
+	assert(texture_name != 0);
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	assert(wrap_s == GL_REPEAT || wrap_s == GL_CLAMP);
+	assert(wrap_t == GL_REPEAT || wrap_t == GL_CLAMP);
+#else
+	assert(wrap_s == GL_REPEAT ||
+	       wrap_s == GL_MIRRORED_REPEAT ||
+	       wrap_s == GL_CLAMP_TO_EDGE ||
+	       wrap_s == GL_CLAMP_TO_BORDER);
+	assert(wrap_t == GL_REPEAT ||
+	       wrap_t == GL_MIRRORED_REPEAT ||
+	       wrap_t == GL_CLAMP_TO_EDGE ||
+	       wrap_t == GL_CLAMP_TO_BORDER);
+#endif
+	assert(mag_filter == GL_NEAREST ||
+	       mag_filter == GL_LINEAR);
+	assert(min_filter == GL_NEAREST ||
+	       min_filter == GL_LINEAR ||
+	       min_filter == GL_NEAREST_MIPMAP_NEAREST ||
+	       min_filter == GL_NEAREST_MIPMAP_LINEAR ||
+	       min_filter == GL_LINEAR_MIPMAP_NEAREST ||
+	       min_filter == GL_LINEAR_MIPMAP_LINEAR);
+
+	GLint old_texture_name;
+	glGetIntegerv(GL_TEXTURE_BINDING_2D, &old_texture_name);
+
+	glBindTexture(GL_TEXTURE_2D, texture_name);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_S, wrap_s);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_WRAP_T, wrap_t);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MAG_FILTER, mag_filter);
 	glTexParameteri(GL_TEXTURE_2D, GL_TEXTURE_MIN_FILTER, min_filter);
 
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+	const unsigned char* a_pixels = md_texture;
+#else
+	//
+	//  Copy the pixels into a pixel buffer object, so that
+	//    glTexImage2D can return before the driver has
+	//    finished transferring them to the texture.  The
+	//    pixel pointer then becomes an offset into the buffer.
+	//
+
+	unsigned int pixel_buffer;
+	glGenBuffers(1, &pixel_buffer);
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, pixel_buffer);
+	glBufferData(GL_PIXEL_UNPACK_BUFFER, m_array_size, NULL, GL_STREAM_DRAW);
+	void* p_mapped = glMapBuffer(GL_PIXEL_UNPACK_BUFFER, GL_WRITE_ONLY);
+	if(p_mapped != NULL)
+	{
+		memcpy(p_mapped, md_texture, m_array_size);
+		glUnmapBuffer(GL_PIXEL_UNPACK_BUFFER);
+	}
+	else
+		glBufferSubData(GL_PIXEL_UNPACK_BUFFER, 0, m_array_size, md_texture);
+	const unsigned char* a_pixels = NULL;  // offset 0 in pixel buffer
+#endif
+
 	if(min_filter == GL_NEAREST || min_filter == GL_LINEAR)
 	{
 		// void glTexImage2D(GLenum target, GLint level, GLint internalFormat, GLsizei width, GLsizei height, GLint border, GLenum format, GLenum type, const GLvoid *pixels);
 		if(m_is_alpha)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, md_texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, a_pixels);
 		else
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,  m_width, m_height, 0, GL_RGB,  GL_UNSIGNED_BYTE, md_texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,  m_width, m_height, 0, GL_RGB,  GL_UNSIGNED_BYTE, a_pixels);
 	}
 	else
 	{
@@ -1482,25 +1558,31 @@ unsigned int TextureBmp :: addToOpenGL (unsigned int wrap_s,
 
 		// GLint gluBuild2DMipmaps(GLenum  target,  GLint  internalFormat,  GLsizei  width,  GLsizei  height,  GLenum  format,  GLenum  type,  const void *  data);
 		if(m_is_alpha)
-			gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, md_texture);
+			gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGBA, m_width, m_height, GL_RGBA, GL_UNSIGNED_BYTE, a_pixels);
 		else
-			gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB,  m_width, m_height, GL_RGB,  GL_UNSIGNED_BYTE, md_texture);
+			gluBuild2DMipmaps(GL_TEXTURE_2D, GL_RGB,  m_width, m_height, GL_RGB,  GL_UNSIGNED_BYTE, a_pixels);
 
 #else
 		// new way of doing mipmaps
 
 		// first load the texture without mipmaps
 		if(m_is_alpha)
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, md_texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGBA, m_width, m_height, 0, GL_RGBA, GL_UNSIGNED_BYTE, a_pixels);
 		else
-			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,  m_width, m_height, 0, GL_RGB,  GL_UNSIGNED_BYTE, md_texture);
+			glTexImage2D(GL_TEXTURE_2D, 0, GL_RGB,  m_width, m_height, 0, GL_RGB,  GL_UNSIGNED_BYTE, a_pixels);
 
 		// then generate the mipmaps
 		glGenerateMipmap(GL_TEXTURE_2D);
 #endif
 	}
 
-	return name;
+#ifdef OBJ_LIBRARY_SHADER_DISPLAY
+	// the buffer is freed once the transfer is finished
+	glBindBuffer(GL_PIXEL_UNPACK_BUFFER, 0);
+	glDeleteBuffers(1, &pixel_buffer);
+#endif
+
+	glBindTexture(GL_TEXTURE_2D, old_texture_name);
 }
 
 
@@ -1021,6 +1021,58 @@ public:
 	                          unsigned int mag_filter,
 	                          unsigned int min_filter) const;
 
+//
+//  replaceInOpenGL
+//
+//  Purpose: To replace the image of an existing OpenGL texture
+//           with this TextureBmp.  Mipmaps are generated.  The
+//           texture keeps its OpenGL name, so anything that
+//           already refers to it, such as a display list, will
+//           use the new image.
+//  Parameter(s):
+//    <1> texture_name: The OpenGL name of the texture
+//    <2> wrap_s:
+//    <3> wrap_t: The behaviour of the texture outside of the
+//                range [0, 1) along the x-/y-axis
+//    <4> mag_filter: The magnification filter
+//    <5> min_filter: The minification filter
+//  Precondition(s):
+//    <1> isGlutInitialized()
+//    <2> texture_name != 0
+#ifndef OBJ_LIBRARY_SHADER_DISPLAY
+//    <3> wrap_s == GL_REPEAT || wrap_s == GL_CLAMP
+//    <4> wrap_t == GL_REPEAT || wrap_t == GL_CLAMP
+#else
+//    <3> wrap_s == GL_REPEAT ||
+//        wrap_s == GL_MIRRORED_REPEAT ||
+//        wrap_s == GL_CLAMP_TO_EDGE ||
+//        wrap_s == GL_CLAMP_TO_BORDER
+//    <4> wrap_t == GL_REPEAT ||
+//        wrap_t == GL_MIRRORED_REPEAT ||
+//        wrap_t == GL_CLAMP_TO_EDGE ||
+//        wrap_t == GL_CLAMP_TO_BORDER
+#endif
+//    <5> mag_filter == GL_NEAREST ||
+//        mag_filter == GL_LINEAR
+//    <6> min_filter == GL_NEAREST ||
+//        min_filter == GL_LINEAR ||
+//        min_filter == GL_NEAREST_MIPMAP_NEAREST ||
+//        min_filter == GL_NEAREST_MIPMAP_LINEAR ||
+//        min_filter == GL_LINEAR_MIPMAP_NEAREST ||
+//        min_filter == GL_LINEAR_MIPMAP_LINEAR
+//  Returns: N/A
+//  Side Effect: The image for texture texture_name is replaced.
+//               With shader display, the pixels are copied
+//               through a pixel buffer object so that the
+//               driver can transfer them in the background.
+//               The texture binding is not changed.
+//
+	void replaceInOpenGL (unsigned int texture_name,
+	                      unsigned int wrap_s,
+	                      unsigned int wrap_t,
+	                      unsigned int mag_filter,
+	                      unsigned int min_filter) const;
+
 private:
 //
 //  Helper Function: createDefault
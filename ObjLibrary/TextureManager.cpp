@@ -20,8 +20,13 @@
 #include <cassert>
 #include <string>
 #include <vector>
+#include <deque>
+#include <unordered_map>
 #include <iostream>
 #include <fstream>
+#include <mutex>
+#include <condition_variable>
+#include <thread>
 
 #include "ObjSettings.h"
 
@@ -53,11 +58,62 @@ namespace
 		Texture m_texture;
 	};
 
-	// some sort of hash table would be nice
-	//  -> convert to map<> when C++11 becomes more widely
-	//     supported?
 	vector<TextureData*> gvp_textures;
 
+	// index into gvp_textures by lowercase name
+	unordered_map<string, unsigned int> g_texture_indexes;
+
+	// protects gvp_textures and g_texture_indexes
+	mutex g_textures_mutex;
+
+	//
+	//  An image read by preloadImage that has not been added
+	//    to OpenGL yet.  mp_image is NULL while the file is
+	//    still being read.
+	//
+	struct PreloadedImage
+	{
+		string m_name_lowercase;
+		TextureBmp* mp_image;
+	};
+
+	vector<PreloadedImage*> gvp_preloaded;
+	mutex g_preloaded_mutex;
+	condition_variable g_preloaded_condition;
+
+	//
+	//  A texture with a placeholder image that is waiting for
+	//    its real image to be read and added to OpenGL.
+	//    mp_image is NULL until the file has been read.
+	//
+	struct StreamingTexture
+	{
+		string m_name;
+		unsigned int m_opengl_name;
+		unsigned int m_wrap_s;
+		unsigned int m_wrap_t;
+		unsigned int m_mag_filter;
+		unsigned int m_min_filter;
+		TextureBmp* mp_image;
+	};
+
+	//
+	//  gvp_streaming contains all streaming textures that have
+	//    not been added to OpenGL yet, in the order they were
+	//    requested.  g_streaming_to_read contains the ones that
+	//    no thread has started reading.  The threads are
+	//    dynamically allocated for the same reason as gp_white
+	//    below: a std::thread that is destroyed while still
+	//    running ends the program.
+	//
+	vector<StreamingTexture*> gvp_streaming;
+	deque<StreamingTexture*> g_streaming_to_read;
+	unsigned int g_streaming_reading_count = 0;
+	vector<thread>* gp_streaming_threads = NULL;
+	bool g_is_streaming_stopping = false;
+	mutex g_streaming_mutex;
+	condition_variable g_streaming_condition;
+
 	//
 	//  This variable has to by dynamically alloated so that it
 	//    is not destroyed when the program terminates.
@@ -123,12 +179,184 @@ namespace
 		        green == g_transparent_green &&
 		        blue  == g_transparent_blue) ? 0x00 : 0xFF;
 	}
+
+
+
+//
+//  findPreloadedImage
+//
+//  Purpose: To find the preloaded image with the specified
+//           name.
+//  Parameter(s):
+//    <1> name_lowercase: The name of the texture, in lowercase
+//  Precondition(s):
+//    <1> g_preloaded_mutex is locked by this thread
+//  Returns: The index of the image in gvp_preloaded, or
+//           TEXTURE_INDEX_INVALID if there is none.
+//  Side Effect: N/A
+//
+	unsigned int findPreloadedImage (const string& name_lowercase)
+	{
+		for(unsigned int i = 0; i < gvp_preloaded.size(); i++)
+		{
+			assert(gvp_preloaded[i] != NULL);
+			if(gvp_preloaded[i]->m_name_lowercase == name_lowercase)
+				return i;
+		}
+		return TEXTURE_INDEX_INVALID;
+	}
+
+//
+//  takePreloadedImage
+//
+//  Purpose: To remove the preloaded image with the specified
+//           name from the list of preloaded images.
+//  Parameter(s):
+//    <1> name_lowercase: The name of the texture, in lowercase
+//  Precondition(s): N/A
+//  Returns: A pointer to the image, or NULL if there is no
+//           preloaded image with that name.  The caller is
+//           responsible for deleting the image.
+//  Side Effect: If another thread is still reading the image,
+//               this function waits for it to finish.
+//
+	TextureBmp* takePreloadedImage (const string& name_lowercase)
+	{
+		unique_lock<mutex> lock(g_preloaded_mutex);
+
+		unsigned int index = findPreloadedImage(name_lowercase);
+		while(index != TEXTURE_INDEX_INVALID && gvp_preloaded[index]->mp_image == NULL)
+		{
+			g_preloaded_condition.wait(lock);
+			index = findPreloadedImage(name_lowercase);
+		}
+		if(index == TEXTURE_INDEX_INVALID)
+			return NULL;
+
+		TextureBmp* p_image = gvp_preloaded[index]->mp_image;
+		delete gvp_preloaded[index];
+		gvp_preloaded.erase(gvp_preloaded.begin() + index);
+
+		assert(p_image != NULL);
+		return p_image;
+	}
+
+//
+//  runStreamingThread
+//
+//  Purpose: To read the images for streaming textures until
+//           streaming is stopped.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: Images are read from files.  Any loading errors
+//               are written to the standard error stream.  This
+//               function does not return until stopStreaming is
+//               called and there are no images left to read.
+//
+	void runStreamingThread ()
+	{
+		unique_lock<mutex> lock(g_streaming_mutex);
+		while(true)
+		{
+			g_streaming_condition.wait(lock, [] ()
+			{
+				return !g_streaming_to_read.empty() || g_is_streaming_stopping;
+			});
+			if(g_streaming_to_read.empty())
+				return;  // stopping
+
+			StreamingTexture* p_streaming = g_streaming_to_read.front();
+			g_streaming_to_read.pop_front();
+			g_streaming_reading_count++;
+			lock.unlock();
+
+			TextureBmp* p_image = new TextureBmp(p_streaming->m_name.c_str(), cerr);
+
+			lock.lock();
+			p_streaming->mp_image = p_image;
+			g_streaming_reading_count--;
+			g_streaming_condition.notify_all();
+		}
+	}
+
+//
+//  addStreamingTexture
+//
+//  Purpose: To add a texture with a placeholder image and start
+//           reading its real image in the background.
+//  Parameter(s):
+//    <1> name: The name of the texture
+//    <2> wrap_s
+//    <3> wrap_t
+//    <4> mag_filter
+//    <5> min_filter: The texture parameters, as for load
+//  Precondition(s):
+//    <1> Texture::isGlutInitialized()
+//    <2> !TextureManager::isLoaded(name)
+//    <3> TextureManager::isStreaming()
+//  Returns: The index of the new texture.
+//  Side Effect: A texture containing a white 1x1 image is
+//               added to OpenGL and to the texture manager with
+//               name name.  The file named name is queued to be
+//               read by a streaming thread.
+//
+	unsigned int addStreamingTexture (const string& name,
+	                                  unsigned int wrap_s,
+	                                  unsigned int wrap_t,
+	                                  unsigned int mag_filter,
+	                                  unsigned int min_filter)
+	{
+		assert(Texture::isGlutInitialized());
+		assert(!TextureManager::isLoaded(name));
+		assert(TextureManager::isStreaming());
+
+		TextureBmp placeholder;
+		unsigned int opengl_name = placeholder.addToOpenGL(wrap_s, wrap_t, mag_filter, min_filter);
+		unsigned int index = TextureManager::add(opengl_name, name);
+
+		StreamingTexture* p_streaming = new StreamingTexture;
+		p_streaming->m_name        = name;
+		p_streaming->m_opengl_name = opengl_name;
+		p_streaming->m_wrap_s      = wrap_s;
+		p_streaming->m_wrap_t      = wrap_t;
+		p_streaming->m_mag_filter  = mag_filter;
+		p_streaming->m_min_filter  = min_filter;
+		p_streaming->mp_image      = NULL;
+
+		{
+			lock_guard<mutex> lock(g_streaming_mutex);
+			gvp_streaming.push_back(p_streaming);
+			g_streaming_to_read.push_back(p_streaming);
+		}
+		g_streaming_condition.notify_all();
+
+		return index;
+	}
+
+//
+//  isFileReadable
+//
+//  Purpose: To determine if the file with the specified name
+//           can be opened.
+//  Parameter(s):
+//    <1> filename: The name of the file
+//  Precondition(s): N/A
+//  Returns: Whether file filename can be opened for reading.
+//  Side Effect: N/A
+//
+	bool isFileReadable (const string& filename)
+	{
+		ifstream input_file(filename.c_str(), ios::in | ios::binary);
+		return input_file.is_open();
+	}
 }
 
 
 
 unsigned int TextureManager :: getCount ()
 {
+	lock_guard<mutex> lock(g_textures_mutex);
 	return gvp_textures.size();
 }
 
@@ -136,6 +364,7 @@ const std::string& getName (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_textures_mutex);
 	assert(index < gvp_textures.size());
 	assert(gvp_textures[index] != NULL);
 	return gvp_textures[index]->m_name;
@@ -145,6 +374,7 @@ const Texture& TextureManager :: get (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_textures_mutex);
 	assert(index < gvp_textures.size());
 	assert(gvp_textures[index] != NULL);
 	return gvp_textures[index]->m_texture;
@@ -167,6 +397,7 @@ const Texture& TextureManager :: get (const string& name)
 		return getDummyTexture();
 	else
 	{
+		lock_guard<mutex> lock(g_textures_mutex);
 		assert(index < gvp_textures.size());
 		assert(gvp_textures[index] != NULL);
 		assert(toLowercase(gvp_textures[index]->m_name) == toLowercase(name));
@@ -178,6 +409,7 @@ void TextureManager :: activate (unsigned int index)
 {
 	assert(index < getCount());
 
+	lock_guard<mutex> lock(g_textures_mutex);
 	assert(index < gvp_textures.size());
 	assert(gvp_textures[index] != NULL);
 	gvp_textures[index]->m_texture.activate();
@@ -213,20 +445,22 @@ unsigned int TextureManager :: getIndex (const char* a_name)
 {
 	assert(a_name != NULL);
 
-	return isLoaded(string(a_name));
+	return getIndex(string(a_name));
 }
 
 unsigned int TextureManager :: getIndex (const std::string& name)
 {
 	string lower = toLowercase(name);
 
-	for(unsigned int i = 0; i < gvp_textures.size(); i++)
-	{
-		assert(gvp_textures[i] != NULL);
-		if(toLowercase(gvp_textures[i]->m_name) == lower)
-			return i;
-	}
-	return TEXTURE_INDEX_INVALID;
+	lock_guard<mutex> lock(g_textures_mutex);
+	unordered_map<string, unsigned int>::const_iterator it = g_texture_indexes.find(lower);
+	if(it == g_texture_indexes.end())
+		return TEXTURE_INDEX_INVALID;
+
+	assert(it->second < gvp_textures.size());
+	assert(gvp_textures[it->second] != NULL);
+	assert(toLowercase(gvp_textures[it->second]->m_name) == lower);
+	return it->second;
 }
 
 bool TextureManager :: isDummyTexture (const Texture& texture)
@@ -274,6 +508,7 @@ unsigned int TextureManager :: add (const Texture& texture, const string& name)
 	assert(texture.isSet());
 	assert(!isLoaded(name));
 
+	lock_guard<mutex> lock(g_textures_mutex);
 	unsigned int texture_count = gvp_textures.size();
 
 	// we could make an initializing constructor for TextureData, but what's the point?
@@ -282,6 +517,7 @@ unsigned int TextureManager :: add (const Texture& texture, const string& name)
 	assert(gvp_textures[texture_count] != NULL);
 	gvp_textures[texture_count]->m_name    = name;
 	gvp_textures[texture_count]->m_texture = texture;
+	g_texture_indexes[toLowercase(name)] = texture_count;
 
 	return texture_count;
 }
@@ -569,13 +805,24 @@ unsigned int TextureManager :: load (const std::string& name,
 	string lower = toLowercase(name);
 	if(endsWith(lower, ".bmp"))
 	{
-		TextureBmp texture_bmp(name.c_str(), r_logstream);
-		if(texture_bmp.isBad())
-		{
-			// TextureBmp prints loading error
-			return TEXTURE_INDEX_INVALID;
-		}
-		else
+		// use the image from preloadImage if there is one
+		TextureBmp* p_texture_bmp = takePreloadedImage(lower);
+
+		//
+		//  Otherwise, if streaming, use a placeholder until the
+		//    image is read in the background.  If the file
+		//    cannot be opened, load it normally so that the
+		//    error is reported and no texture is added.
+		//
+		if(p_texture_bmp == NULL && isStreaming() && isFileReadable(name))
+			return addStreamingTexture(name, wrap_s, wrap_t, mag_filter, min_filter);
+
+		if(p_texture_bmp == NULL)
+			p_texture_bmp = new TextureBmp(name.c_str(), r_logstream);
+		assert(p_texture_bmp != NULL);
+
+		unsigned int index = TEXTURE_INDEX_INVALID;
+		if(!p_texture_bmp->isBad())
 		{
 			//
 			//  Texture is flipped when loading
@@ -586,11 +833,15 @@ unsigned int TextureManager :: load (const std::string& name,
 			//  If changing this, also change load function with
 			//    transparent colour below.
 			//
-			//texture_bmp.mirrorY();
+			//p_texture_bmp->mirrorY();
 			//
 
-			return add(texture_bmp.addToOpenGL(wrap_s, wrap_t, mag_filter, min_filter), name);
+			index = add(p_texture_bmp->addToOpenGL(wrap_s, wrap_t, mag_filter, min_filter), name);
 		}
+		// else TextureBmp printed loading error
+
+		delete p_texture_bmp;
+		return index;
 	}
 	else if(endsWith(lower, ".png"))
 	{
@@ -876,18 +1127,24 @@ unsigned int TextureManager :: load (const std::string& name,
 	string lower = toLowercase(name);
 	if(endsWith(lower, ".bmp"))
 	{
-		TextureBmp texture_bmp(name.c_str(), r_logstream);
-		if(texture_bmp.isBad())
-			return TEXTURE_INDEX_INVALID;
-		else
+		TextureBmp* p_texture_bmp = takePreloadedImage(lower);
+		if(p_texture_bmp == NULL)
+			p_texture_bmp = new TextureBmp(name.c_str(), r_logstream);
+		assert(p_texture_bmp != NULL);
+
+		unsigned int index = TEXTURE_INDEX_INVALID;
+		if(!p_texture_bmp->isBad())
 		{
 			// if texture is Y-mirrored above, also Y-mirror here
 
-			TextureBmp texture_alpha(texture_bmp,
-			                         0, 0, texture_bmp.getWidth(), texture_bmp.getHeight(),
+			TextureBmp texture_alpha(*p_texture_bmp,
+			                         0, 0, p_texture_bmp->getWidth(), p_texture_bmp->getHeight(),
 			                         g_transparent_red, g_transparent_green, g_transparent_blue);
-			return add(texture_alpha.addToOpenGL(wrap_s, wrap_t, mag_filter, min_filter), name);
+			index = add(texture_alpha.addToOpenGL(wrap_s, wrap_t, mag_filter, min_filter), name);
 		}
+
+		delete p_texture_bmp;
+		return index;
 	}
 	else if(endsWith(lower, ".png"))
 	{
@@ -927,14 +1184,199 @@ unsigned int TextureManager :: load (const std::string& name,
 
 
 
+bool TextureManager :: preloadImage (const std::string& name,
+                                     std::ostream& r_logstream)
+{
+	string lower = toLowercase(name);
+	if(!endsWith(lower, ".bmp"))
+		return false;
+	if(isLoaded(name))
+		return true;
+
+	unique_lock<mutex> lock(g_preloaded_mutex);
+	unsigned int index = findPreloadedImage(lower);
+	if(index != TEXTURE_INDEX_INVALID)
+	{
+		// another thread has read or is reading this image
+		while(index != TEXTURE_INDEX_INVALID && gvp_preloaded[index]->mp_image == NULL)
+		{
+			g_preloaded_condition.wait(lock);
+			index = findPreloadedImage(lower);
+		}
+		if(index != TEXTURE_INDEX_INVALID)
+			return !gvp_preloaded[index]->mp_image->isBad();
+		else
+			return isLoaded(name);  // the texture was loaded meanwhile
+	}
+
+	// reserve the name so other threads wait instead of reading the file too
+	PreloadedImage* p_preloaded = new PreloadedImage;
+	p_preloaded->m_name_lowercase = lower;
+	p_preloaded->mp_image         = NULL;
+	gvp_preloaded.push_back(p_preloaded);
+	lock.unlock();
+
+	TextureBmp* p_image = new TextureBmp(name.c_str(), r_logstream);
+	bool is_good = !p_image->isBad();
+
+	lock.lock();
+	p_preloaded->mp_image = p_image;
+	lock.unlock();
+	g_preloaded_condition.notify_all();
+
+	return is_good;
+}
+
+void TextureManager :: discardPreloadedImages ()
+{
+	unique_lock<mutex> lock(g_preloaded_mutex);
+
+	// wait for any images still being read
+	g_preloaded_condition.wait(lock, [] ()
+	{
+		for(unsigned int i = 0; i < gvp_preloaded.size(); i++)
+			if(gvp_preloaded[i]->mp_image == NULL)
+				return false;
+		return true;
+	});
+
+	for(unsigned int i = 0; i < gvp_preloaded.size(); i++)
+	{
+		assert(gvp_preloaded[i] != NULL);
+		delete gvp_preloaded[i]->mp_image;
+		delete gvp_preloaded[i];
+	}
+	gvp_preloaded.clear();
+}
+
+void TextureManager :: startStreaming (unsigned int thread_count)
+{
+	assert(thread_count >= 1);
+	assert(!isStreaming());
+
+	lock_guard<mutex> lock(g_streaming_mutex);
+	g_is_streaming_stopping = false;
+	gp_streaming_threads = new vector<thread>;
+	for(unsigned int i = 0; i < thread_count; i++)
+		gp_streaming_threads->push_back(thread(runStreamingThread));
+}
+
+bool TextureManager :: isStreaming ()
+{
+	lock_guard<mutex> lock(g_streaming_mutex);
+	return gp_streaming_threads != NULL;
+}
+
+unsigned int TextureManager :: getStreamingCount ()
+{
+	lock_guard<mutex> lock(g_streaming_mutex);
+	return gvp_streaming.size();
+}
+
+unsigned int TextureManager :: updateStreaming (unsigned int upload_count_max)
+{
+	assert(Texture::isGlutInitialized());
+
+	// take the textures that are ready, in the order they were requested
+	vector<StreamingTexture*> vp_ready;
+	{
+		lock_guard<mutex> lock(g_streaming_mutex);
+		for(unsigned int i = 0; i < gvp_streaming.size() && vp_ready.size() < upload_count_max; )
+		{
+			assert(gvp_streaming[i] != NULL);
+			if(gvp_streaming[i]->mp_image != NULL)
+			{
+				vp_ready.push_back(gvp_streaming[i]);
+				gvp_streaming.erase(gvp_streaming.begin() + i);
+			}
+			else
+				i++;
+		}
+	}
+
+	// OpenGL calls are made without holding the lock
+	for(unsigned int i = 0; i < vp_ready.size(); i++)
+	{
+		StreamingTexture* p_streaming = vp_ready[i];
+		assert(p_streaming->mp_image != NULL);
+
+		// if the file was bad, the placeholder stays
+		if(!p_streaming->mp_image->isBad())
+		{
+			p_streaming->mp_image->replaceInOpenGL(p_streaming->m_opengl_name,
+			                                       p_streaming->m_wrap_s,
+			                                       p_streaming->m_wrap_t,
+			                                       p_streaming->m_mag_filter,
+			                                       p_streaming->m_min_filter);
+		}
+
+		delete p_streaming->mp_image;
+		delete p_streaming;
+	}
+
+	return vp_ready.size();
+}
+
+void TextureManager :: stopStreaming ()
+{
+	assert(Texture::isGlutInitialized());
+	assert(isStreaming());
+
+	// the threads finish reading the queued images first
+	vector<thread>* p_threads;
+	{
+		lock_guard<mutex> lock(g_streaming_mutex);
+		g_is_streaming_stopping = true;
+		p_threads = gp_streaming_threads;
+	}
+	g_streaming_condition.notify_all();
+
+	assert(p_threads != NULL);
+	for(unsigned int i = 0; i < p_threads->size(); i++)
+		(*p_threads)[i].join();
+	delete p_threads;
+
+	{
+		lock_guard<mutex> lock(g_streaming_mutex);
+		gp_streaming_threads = NULL;
+		assert(g_streaming_to_read.empty());
+		assert(g_streaming_reading_count == 0);
+	}
+
+	updateStreaming(~0u);
+	assert(getStreamingCount() == 0);
+}
+
 void TextureManager :: unloadAll ()
 {
+	{
+		unique_lock<mutex> lock(g_streaming_mutex);
+
+		// discard the streaming textures, including any still being read
+		g_streaming_to_read.clear();
+		g_streaming_condition.wait(lock, [] ()
+		{
+			return g_streaming_reading_count == 0;
+		});
+		for(unsigned int i = 0; i < gvp_streaming.size(); i++)
+		{
+			assert(gvp_streaming[i] != NULL);
+			delete gvp_streaming[i]->mp_image;
+			delete gvp_streaming[i];
+		}
+		gvp_streaming.clear();
+	}
+
+	discardPreloadedImages();
+
+	lock_guard<mutex> lock(g_textures_mutex);
 	for(unsigned int i = 0; i < gvp_textures.size(); i++)
 	{
 		assert(gvp_textures[i] != NULL);
 		delete gvp_textures[i];	// destructor frees video memory
 	}
 	gvp_textures.clear();
+	g_texture_indexes.clear();
 }
 
 
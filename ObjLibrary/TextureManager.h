@@ -59,7 +59,34 @@ class Texture;
 //    -> wrapping and min/magnification options
 //    -> a transparent colour
 //
-//  Name comparisons are always case-insensitive.
+//  Name comparisons are always case-insensitive.  Textures are
+//    found with a hash table keyed by their lowercase names,
+//    so looking up a texture by name takes the same time no
+//    matter how many textures are loaded.  Material keeps a
+//    pointer to each texture after the first lookup, so
+//    activating a Material does not look up names at all.
+//
+//  Adding a texture to OpenGL must be done on the thread with
+//    the OpenGL context, but reading the image file does not.
+//    The preloadImage function can be called from any thread
+//    to read an image into memory ahead of time.  When the
+//    texture is later loaded, the image in memory is used
+//    instead of reading the file again.  The list of textures
+//    is protected by a mutex, so the other functions in this
+//    module can also be called from any thread, but the ones
+//    that load textures or return a Texture reference should
+//    still only be used on the OpenGL thread.
+//
+//  Textures can also be streamed.  After startStreaming is
+//    called, loading a BMP texture adds a white placeholder
+//    texture at once and reads the file on a background
+//    thread.  Each call to updateStreaming (normally once per
+//    frame) adds some of the images that have been read to
+//    OpenGL, replacing the placeholders.  The OpenGL name of
+//    each texture does not change, so Materials and display
+//    lists that already use the placeholder show the real
+//    image without being updated.  This avoids stalling the
+//    frame in which a new texture is first used.
 //
 namespace TextureManager
 {
@@ -615,6 +642,145 @@ unsigned int load (const std::string& name,
                    const Vector3& transparent_colour,
                    std::ostream& r_logstream);
 
+//
+//  preloadImage
+//
+//  Purpose: To read the image for the texture with the
+//           specified name into memory, without adding it to
+//           OpenGL.  This function may be called from any
+//           thread.
+//  Parameter(s):
+//    <1> name: The name of the texture
+//    <2> r_logstream: The stream to write loading errors to
+//  Precondition(s): N/A
+//  Returns: Whether the texture is already loaded or its image
+//           is now in memory.  If name does not end in a
+//           case-insensitive ".bmp", or the file cannot be
+//           read, false is returned.
+//  Side Effect: If the texture is not loaded, and its image
+//               has not already been read, the file named name
+//               is read and any loading errors are written to
+//               r_logstream.  If another thread is already
+//               reading the same image, this function waits
+//               for it to finish instead.  The image is kept
+//               until the texture is loaded with one of the
+//               load functions (including through get or
+//               activate), which then does not read the file
+//               again, or until discardPreloadedImages or
+//               unloadAll is called.  An image that is never
+//               used stays in memory until then, so
+//               discardPreloadedImages should be called once
+//               the preloaded textures have been loaded.
+//
+bool preloadImage (const std::string& name,
+                   std::ostream& r_logstream);
+
+//
+//  discardPreloadedImages
+//
+//  Purpose: To free the images read by preloadImage that have
+//           not been used.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If any images are still being read by
+//               preloadImage, this function waits for them.
+//               All images read by preloadImage that have not
+//               been used to load a texture are then discarded.
+//               Loading those textures later reads the files
+//               again.
+//
+void discardPreloadedImages ();
+
+//
+//  startStreaming
+//
+//  Purpose: To start loading textures in the background.
+//  Parameter(s):
+//    <1> thread_count: The number of threads to read image
+//                      files on
+//  Precondition(s):
+//    <1> thread_count >= 1
+//    <2> !isStreaming()
+//  Returns: N/A
+//  Side Effect: thread_count threads are started.  From now
+//               on, when a BMP texture is loaded without a
+//               transparent colour, and its image has not been
+//               read with preloadImage, a texture with a white
+//               1x1 image is added to OpenGL and returned.  The
+//               file is read by one of the threads and the
+//               image is added to OpenGL by a later call to
+//               updateStreaming.  If the file cannot be opened,
+//               the texture is loaded as if not streaming.
+//               Errors found while reading the file are written
+//               to the standard error stream, and the texture
+//               keeps the placeholder image.
+//
+void startStreaming (unsigned int thread_count = 1);
+
+//
+//  isStreaming
+//
+//  Purpose: To determine if textures are being loaded in the
+//           background.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether startStreaming has been called without a
+//           matching call to stopStreaming.
+//  Side Effect: N/A
+//
+bool isStreaming ();
+
+//
+//  getStreamingCount
+//
+//  Purpose: To determine how many streaming textures still
+//           have a placeholder image.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: The number of textures waiting to be read or to be
+//           added to OpenGL.
+//  Side Effect: N/A
+//
+unsigned int getStreamingCount ();
+
+//
+//  updateStreaming
+//
+//  Purpose: To add the streaming textures that have been read
+//           to OpenGL.
+//  Parameter(s):
+//    <1> upload_count_max: The maximum number of textures to
+//                          add
+//  Precondition(s):
+//    <1> Texture::isGlutInitialized()
+//  Returns: The number of textures added.
+//  Side Effect: Up to upload_count_max textures whose images
+//               have been read replace their placeholder
+//               images, in the order they were requested.
+//               This function does not wait for images that
+//               are still being read.  The current texture
+//               binding is not changed.
+//
+unsigned int updateStreaming (unsigned int upload_count_max);
+
+//
+//  stopStreaming
+//
+//  Purpose: To stop loading textures in the background.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> Texture::isGlutInitialized()
+//    <2> isStreaming()
+//  Returns: N/A
+//  Side Effect: The streaming threads finish reading the images
+//               already requested and are stopped.  All
+//               remaining streaming textures are then added to
+//               OpenGL.  Textures loaded after this are loaded
+//               immediately.
+//
+void stopStreaming ();
+
 //
 //  unloadAll
 //
@@ -623,7 +789,11 @@ unsigned int load (const std::string& name,
 //  Precondition(s): N/A
 //  Returns: tetxure.
 //  Side Effect: All textures are removed from the texture
-//               manager.
+//               manager.  Any images read by preloadImage that
+//               have not been used are also discarded (as by
+//               discardPreloadedImages), as are
+//               the images for streaming textures.  Streaming
+//               is not stopped.
 //
 void unloadAll ();
 
@@ -0,0 +1,564 @@
+//
+//  VertexBufferModel.cpp
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#include <cassert>
+#include <cstddef>	// for NULL, ptrdiff_t
+#include <cstdio>	// for sscanf
+#include <vector>
+
+// ask for the OpenGL 1.5 function declarations on Linux
+#ifndef GL_GLEXT_PROTOTYPES
+	#define GL_GLEXT_PROTOTYPES
+#endif
+#include "../GetGlut.h"
+#include "DisplayList.h"
+#include "Material.h"
+#include "VertexBufferModel.h"
+
+// the Windows headers only go up to OpenGL 1.1
+#ifndef GL_ARRAY_BUFFER
+	#define GL_ARRAY_BUFFER         0x8892
+#endif
+#ifndef GL_ELEMENT_ARRAY_BUFFER
+	#define GL_ELEMENT_ARRAY_BUFFER 0x8893
+#endif
+#ifndef GL_STATIC_DRAW
+	#define GL_STATIC_DRAW          0x88E4
+#endif
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int BUFFER_SUPPORT_UNKNOWN = 0;
+	const unsigned int BUFFER_SUPPORT_YES     = 1;
+	const unsigned int BUFFER_SUPPORT_NO      = 2;
+	unsigned int g_buffer_support = BUFFER_SUPPORT_UNKNOWN;
+	unsigned int g_instancing_support = BUFFER_SUPPORT_UNKNOWN;
+
+	const unsigned int VERTEX_STRIDE = VertexBufferModel::FLOATS_PER_VERTEX * sizeof(float);
+
+#ifdef _WIN32
+	//
+	//  Windows only exports the OpenGL 1.1 functions, so the
+	//    vertex buffer object functions are found at run time
+	//    by isBufferObjectsAvailable.  These have the same
+	//    names as the real functions so the code using them
+	//    is the same on every platform.
+	//
+
+	typedef void (APIENTRY *GenBuffersFunction)    (GLsizei n, GLuint* a_buffers);
+	typedef void (APIENTRY *DeleteBuffersFunction) (GLsizei n, const GLuint* a_buffers);
+	typedef void (APIENTRY *BindBufferFunction)    (GLenum target, GLuint buffer);
+	typedef void (APIENTRY *BufferDataFunction)    (GLenum target, ptrdiff_t size, const void* p_data, GLenum usage);
+	typedef void (APIENTRY *DrawElementsInstancedFunction) (GLenum mode, GLsizei count, GLenum type, const void* p_indexes, GLsizei instance_count);
+
+	GenBuffersFunction    glGenBuffers    = NULL;
+	DeleteBuffersFunction glDeleteBuffers = NULL;
+	BindBufferFunction    glBindBuffer    = NULL;
+	BufferDataFunction    glBufferData    = NULL;
+	DrawElementsInstancedFunction glDrawElementsInstanced = NULL;
+#endif
+
+
+
+//
+//  isOpenGlVersionAtLeast
+//
+//  Purpose: To determine if the current OpenGL context has at
+//           least the specified version.
+//  Parameter(s):
+//    <1> major: The major version number
+//    <2> minor: The minor version number
+//  Precondition(s): N/A
+//  Returns: Whether the OpenGL version is major.minor or later.
+//           If the version cannot be determined, false is
+//           returned.
+//  Side Effect: N/A
+//
+	bool isOpenGlVersionAtLeast (unsigned int major, unsigned int minor)
+	{
+		const char* a_version = (const char*)(glGetString(GL_VERSION));
+		if(a_version == NULL)
+			return false;
+
+		unsigned int version_major = 0;
+		unsigned int version_minor = 0;
+		if(sscanf(a_version, "%u.%u", &version_major, &version_minor) != 2)
+			return false;
+
+		if(version_major != major)
+			return version_major > major;
+		return version_minor >= minor;
+	}
+
+}  // end of anonymous namespace
+
+
+
+bool VertexBufferModel :: isBufferObjectsAvailable ()
+{
+	assert(DisplayList::isGlutInitialized());
+
+	if(g_buffer_support == BUFFER_SUPPORT_UNKNOWN)
+	{
+		bool is_available = isOpenGlVersionAtLeast(1, 5);
+#ifdef _WIN32
+		if(is_available)
+		{
+			glGenBuffers    = (GenBuffersFunction)   (glutGetProcAddress("glGenBuffers"));
+			glDeleteBuffers = (DeleteBuffersFunction)(glutGetProcAddress("glDeleteBuffers"));
+			glBindBuffer    = (BindBufferFunction)   (glutGetProcAddress("glBindBuffer"));
+			glBufferData    = (BufferDataFunction)   (glutGetProcAddress("glBufferData"));
+			is_available = glGenBuffers    != NULL &&
+			               glDeleteBuffers != NULL &&
+			               glBindBuffer    != NULL &&
+			               glBufferData    != NULL;
+		}
+#endif
+		g_buffer_support = is_available ? BUFFER_SUPPORT_YES : BUFFER_SUPPORT_NO;
+	}
+
+	assert(g_buffer_support != BUFFER_SUPPORT_UNKNOWN);
+	return g_buffer_support == BUFFER_SUPPORT_YES;
+}
+
+bool VertexBufferModel :: isInstancingAvailable ()
+{
+	assert(DisplayList::isGlutInitialized());
+
+	if(g_instancing_support == BUFFER_SUPPORT_UNKNOWN)
+	{
+#ifdef __APPLE__
+		// the legacy OpenGL context on Mac OSX is version 2.1
+		bool is_available = false;
+#else
+		bool is_available = isBufferObjectsAvailable() && isOpenGlVersionAtLeast(3, 3);
+#endif
+#ifdef _WIN32
+		if(is_available)
+		{
+			glDrawElementsInstanced = (DrawElementsInstancedFunction)(glutGetProcAddress("glDrawElementsInstanced"));
+			is_available = glDrawElementsInstanced != NULL;
+		}
+#endif
+		g_instancing_support = is_available ? BUFFER_SUPPORT_YES : BUFFER_SUPPORT_NO;
+	}
+
+	assert(g_instancing_support != BUFFER_SUPPORT_UNKNOWN);
+	return g_instancing_support == BUFFER_SUPPORT_YES;
+}
+
+
+
+VertexBufferModel :: VertexBufferModel ()
+{
+	mp_data = NULL;
+}
+
+VertexBufferModel :: VertexBufferModel (const VertexBufferModel& original)
+{
+	mp_data = NULL;
+	copy(original);
+}
+
+VertexBufferModel :: ~VertexBufferModel ()
+{
+	makeEmpty();
+}
+
+VertexBufferModel& VertexBufferModel :: operator= (const VertexBufferModel& original)
+{
+	if(&original != this)
+	{
+		makeEmpty();
+		copy(original);
+	}
+
+	return *this;
+}
+
+
+
+bool VertexBufferModel :: isEmpty () const
+{
+	return (mp_data == NULL);
+}
+
+bool VertexBufferModel :: isReady () const
+{
+	return (mp_data != NULL);
+}
+
+unsigned int VertexBufferModel :: getVertexCount () const
+{
+	assert(isReady());
+
+	return mp_data->m_vertex_count;
+}
+
+unsigned int VertexBufferModel :: getIndexCount () const
+{
+	assert(isReady());
+
+	return mp_data->m_index_count;
+}
+
+unsigned int VertexBufferModel :: getMaterialRangeCount () const
+{
+	assert(isReady());
+
+	return (unsigned int)(mp_data->mv_material_ranges.size());
+}
+
+const Material* VertexBufferModel :: getMaterialRangeMaterial (unsigned int range) const
+{
+	assert(isReady());
+	assert(range < getMaterialRangeCount());
+
+	return mp_data->mv_material_ranges[range].mp_material;
+}
+
+bool VertexBufferModel :: isPositionsReplaced () const
+{
+	assert(isReady());
+
+	return (mp_data->mp_shared != NULL);
+}
+
+VertexBufferModel VertexBufferModel :: getCopyWithPositions (const vector<float>& v_positions) const
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(isReady());
+	assert(v_positions.size() == getVertexCount() * 3);
+
+	// always share with the InnerData that owns the buffers
+	InnerData* p_shared = (mp_data->mp_shared != NULL) ? mp_data->mp_shared : mp_data;
+	assert(p_shared->mp_shared == NULL);
+	p_shared->m_usages++;
+
+	VertexBufferModel result;
+	result.mp_data = new InnerData();
+	result.mp_data->m_vertex_buffer          = p_shared->m_vertex_buffer;
+	result.mp_data->m_index_buffer           = p_shared->m_index_buffer;
+	result.mp_data->m_position_buffer        = 0;
+	result.mp_data->mp_shared                = p_shared;
+	result.mp_data->m_vertex_count           = p_shared->m_vertex_count;
+	result.mp_data->m_index_count            = p_shared->m_index_count;
+	result.mp_data->mv_material_ranges       = p_shared->mv_material_ranges;
+	result.mp_data->m_is_texture_coordinates = p_shared->m_is_texture_coordinates;
+	result.mp_data->m_is_normals             = p_shared->m_is_normals;
+	result.mp_data->m_usages                 = 1;
+
+	if(p_shared->m_vertex_buffer != 0)
+	{
+		glGenBuffers(1, &result.mp_data->m_position_buffer);
+		glBindBuffer(GL_ARRAY_BUFFER, result.mp_data->m_position_buffer);
+		glBufferData(GL_ARRAY_BUFFER, v_positions.size() * sizeof(float), v_positions.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+	}
+	else
+		result.mp_data->mv_positions = v_positions;
+
+	assert(result.isReady());
+	assert(result.isPositionsReplaced());
+	return result;
+}
+
+void VertexBufferModel :: draw () const
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(isReady());
+	assert(!Material::isMaterialActive());
+
+	beginVertexArrays();
+	for(unsigned int r = 0; r < mp_data->mv_material_ranges.size(); r++)
+		drawMaterialRange(r);
+	endVertexArrays();
+
+	assert(!Material::isMaterialActive());
+}
+
+void VertexBufferModel :: drawMaterialRangeInstanced (unsigned int range,
+                                                      unsigned int instance_count) const
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(isInstancingAvailable());
+	assert(isReady());
+	assert(range < getMaterialRangeCount());
+
+	const MaterialRange& material_range = mp_data->mv_material_ranges[range];
+	if(material_range.m_index_count == 0 || instance_count == 0)
+		return;
+
+#ifndef __APPLE__
+	beginVertexArrays();
+	glDrawElementsInstanced(GL_TRIANGLES, material_range.m_index_count, GL_UNSIGNED_INT,
+	                        getIndexStart(material_range.m_first_index), instance_count);
+	endVertexArrays();
+#endif
+}
+
+void VertexBufferModel :: drawMaterialRangeCurrent (unsigned int range) const
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(isReady());
+	assert(range < getMaterialRangeCount());
+
+	const MaterialRange& material_range = mp_data->mv_material_ranges[range];
+	if(material_range.m_index_count == 0)
+		return;
+
+	beginVertexArrays();
+	drawElements(material_range.m_first_index, material_range.m_index_count);
+	endVertexArrays();
+}
+
+
+
+void VertexBufferModel :: makeEmpty ()
+{
+	if(mp_data != NULL)
+	{
+		releaseInnerData(mp_data);
+		mp_data = NULL;
+	}
+
+	assert(isEmpty());
+}
+
+void VertexBufferModel :: init (const vector<float>& v_vertex_data,
+                                const vector<unsigned int>& v_indexes,
+                                const vector<MaterialRange>& v_material_ranges,
+                                bool is_texture_coordinates,
+                                bool is_normals)
+{
+	assert(DisplayList::isGlutInitialized());
+	assert(!DisplayList::isDisabledForExit());
+	assert(v_vertex_data.size() % FLOATS_PER_VERTEX == 0);
+	assert(v_indexes.size() % 3 == 0);
+
+	makeEmpty();
+	assert(isEmpty());
+
+	mp_data = new InnerData();
+	mp_data->m_vertex_buffer          = 0;
+	mp_data->m_index_buffer           = 0;
+	mp_data->m_position_buffer        = 0;
+	mp_data->mp_shared                = NULL;
+	mp_data->m_vertex_count           = (unsigned int)(v_vertex_data.size() / FLOATS_PER_VERTEX);
+	mp_data->m_index_count            = (unsigned int)(v_indexes.size());
+	mp_data->mv_material_ranges       = v_material_ranges;
+	mp_data->m_is_texture_coordinates = is_texture_coordinates;
+	mp_data->m_is_normals             = is_normals;
+	mp_data->m_usages                 = 1;
+
+#ifndef NDEBUG
+	for(unsigned int i = 0; i < v_indexes.size(); i++)
+		assert(v_indexes[i] < mp_data->m_vertex_count);
+	for(unsigned int r = 0; r < v_material_ranges.size(); r++)
+		assert(v_material_ranges[r].m_first_index + v_material_ranges[r].m_index_count <= v_indexes.size());
+#endif
+
+	if(isBufferObjectsAvailable())
+	{
+		unsigned int a_buffers[2];
+		glGenBuffers(2, a_buffers);
+		mp_data->m_vertex_buffer = a_buffers[0];
+		mp_data->m_index_buffer  = a_buffers[1];
+
+		glBindBuffer(GL_ARRAY_BUFFER, mp_data->m_vertex_buffer);
+		glBufferData(GL_ARRAY_BUFFER, v_vertex_data.size() * sizeof(float), v_vertex_data.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ARRAY_BUFFER, 0);
+
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mp_data->m_index_buffer);
+		glBufferData(GL_ELEMENT_ARRAY_BUFFER, v_indexes.size() * sizeof(unsigned int), v_indexes.data(), GL_STATIC_DRAW);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+	else
+	{
+		mp_data->mv_vertex_data = v_vertex_data;
+		mp_data->mv_indexes     = v_indexes;
+	}
+
+	assert(isReady());
+}
+
+
+
+void VertexBufferModel :: beginVertexArrays () const
+{
+	assert(isReady());
+
+	bool is_buffers = (mp_data->m_vertex_buffer != 0);
+	if(is_buffers)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER,         mp_data->m_vertex_buffer);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, mp_data->m_index_buffer);
+	}
+
+	glPushClientAttrib(GL_CLIENT_VERTEX_ARRAY_BIT);
+
+	glEnableClientState(GL_VERTEX_ARRAY);
+	if(mp_data->mp_shared == NULL)
+		glVertexPointer(3, GL_FLOAT, VERTEX_STRIDE, getVertexAttributeStart(POSITION_OFFSET));
+	if(mp_data->m_is_texture_coordinates)
+	{
+		glEnableClientState(GL_TEXTURE_COORD_ARRAY);
+		glTexCoordPointer(2, GL_FLOAT, VERTEX_STRIDE, getVertexAttributeStart(TEXTURE_COORDINATES_OFFSET));
+	}
+	if(mp_data->m_is_normals)
+	{
+		glEnableClientState(GL_NORMAL_ARRAY);
+		glNormalPointer(GL_FLOAT, VERTEX_STRIDE, getVertexAttributeStart(NORMAL_OFFSET));
+	}
+	if(mp_data->mp_shared != NULL)
+	{
+		// replaced positions are tightly packed in their own array
+		if(is_buffers)
+		{
+			glBindBuffer(GL_ARRAY_BUFFER, mp_data->m_position_buffer);
+			glVertexPointer(3, GL_FLOAT, 0, NULL);
+		}
+		else
+			glVertexPointer(3, GL_FLOAT, 0, mp_data->mv_positions.data());
+	}
+}
+
+void VertexBufferModel :: endVertexArrays () const
+{
+	assert(isReady());
+
+	glPopClientAttrib();
+
+	if(mp_data->m_vertex_buffer != 0)
+	{
+		glBindBuffer(GL_ARRAY_BUFFER,         0);
+		glBindBuffer(GL_ELEMENT_ARRAY_BUFFER, 0);
+	}
+}
+
+void VertexBufferModel :: drawMaterialRange (unsigned int range) const
+{
+	assert(isReady());
+	assert(range < getMaterialRangeCount());
+
+	const MaterialRange& material_range = mp_data->mv_material_ranges[range];
+	const Material* p_material = material_range.mp_material;
+
+	// same passes as ObjModel::drawMeshMaterial
+	if(p_material == NULL)
+		drawElements(material_range.m_first_index, material_range.m_index_count);
+	else
+	{
+		p_material->activate();
+		drawElements(material_range.m_first_index, material_range.m_index_count);
+		Material::deactivate();
+
+		if(p_material->isSeperateSpecular())
+		{
+			p_material->activateSeperateSpecular();
+			drawElements(material_range.m_first_index, material_range.m_index_count);
+			Material::deactivate();
+		}
+	}
+}
+
+void VertexBufferModel :: drawElements (unsigned int first_index,
+                                        unsigned int index_count) const
+{
+	assert(isReady());
+	assert(first_index + index_count <= getIndexCount());
+
+	if(index_count == 0)
+		return;
+
+	glDrawElements(GL_TRIANGLES, index_count, GL_UNSIGNED_INT, getIndexStart(first_index));
+}
+
+const void* VertexBufferModel :: getVertexAttributeStart (unsigned int offset) const
+{
+	assert(isReady());
+	assert(offset < FLOATS_PER_VERTEX);
+
+	if(mp_data->m_vertex_buffer != 0)
+		return (const char*)(NULL) + offset * sizeof(float);
+	else if(mp_data->mp_shared != NULL)
+		return mp_data->mp_shared->mv_vertex_data.data() + offset;
+	else
+		return mp_data->mv_vertex_data.data() + offset;
+}
+
+const void* VertexBufferModel :: getIndexStart (unsigned int first_index) const
+{
+	assert(isReady());
+	assert(first_index <= getIndexCount());
+
+	// the "pointer" is a byte offset into the index buffer
+	if(mp_data->m_index_buffer != 0)
+		return (const char*)(NULL) + first_index * sizeof(unsigned int);
+	else if(mp_data->mp_shared != NULL)
+		return mp_data->mp_shared->mv_indexes.data() + first_index;
+	else
+		return mp_data->mv_indexes.data() + first_index;
+}
+
+void VertexBufferModel :: copy (const VertexBufferModel& original)
+{
+	assert(isEmpty());
+
+	mp_data = original.mp_data;
+
+	if(mp_data != NULL)
+		mp_data->m_usages++;
+}
+
+void VertexBufferModel :: releaseInnerData (InnerData* p_data)
+{
+	assert(p_data != NULL);
+	assert(p_data->m_usages > 0);
+
+	p_data->m_usages--;
+	if(p_data->m_usages == 0)
+	{
+		if(!DisplayList::isDisabledForExit())
+		{
+			if(p_data->mp_shared != NULL)
+			{
+				// the other buffers belong to the shared InnerData
+				if(p_data->m_position_buffer != 0)
+					glDeleteBuffers(1, &p_data->m_position_buffer);
+			}
+			else if(p_data->m_vertex_buffer != 0)
+			{
+				unsigned int a_buffers[2] = { p_data->m_vertex_buffer, p_data->m_index_buffer };
+				glDeleteBuffers(2, a_buffers);
+			}
+		}
+
+		InnerData* p_shared = p_data->mp_shared;
+		delete p_data;
+		if(p_shared != NULL)
+			releaseInnerData(p_shared);
+	}
+}
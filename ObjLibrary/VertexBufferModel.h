@@ -0,0 +1,637 @@
+//
+//  VertexBufferModel.h
+//
+//  A module to encapsulate a model stored in OpenGL vertex
+//    buffer objects.
+//
+//  This file is part of the ObjLibrary, by Richard Hamilton,
+//    which is copyright Hamilton 2009-2021.
+//
+//  You may use these files for any purpose as long as you do
+//    not explicitly claim them as your own work or object to
+//    other people using them.
+//
+//  If you are distributing the source files, you must not
+//    remove this notice.  If you are only distributing compiled
+//    code, no credit is required.
+//
+//  A (theoretically) up-to-date version of the ObjLibrary can
+//    be found at:
+//  http://infiniplix.ca/resources/obj_library/
+//
+
+#ifndef OBJ_LIBRARY_VERTEX_BUFFER_MODEL_H
+#define OBJ_LIBRARY_VERTEX_BUFFER_MODEL_H
+
+#include <vector>
+
+
+
+namespace ObjLibrary
+{
+
+class Material;
+
+
+
+//
+//  VertexBufferModel
+//
+//  A wrapper class to encapsulate a model stored in a vertex
+//    buffer and an index buffer, for use without shaders.  A
+//    VertexBufferModel can be created, displayed and destroyed.
+//    If a VertexBufferModel is copied, the internal buffers
+//    will not be copied.  However, the buffers will not be
+//    destroyed until the last reference is removed.  In this
+//    way, a VertexBufferModel is used like a DisplayList.
+//
+//  The vertex data is interleaved, with FLOATS_PER_VERTEX
+//    floats for each vertex: the position (x, y, z), then the
+//    texture coordinates (s, t), and then the normal vector
+//    (x, y, z).  The index buffer lists the vertexes for a
+//    series of triangles.  The triangles are divided into
+//    ranges, and each range is displayed with its own
+//    Material.  A range without a Material is displayed with
+//    the current OpenGL state.
+//
+//  Vertex buffer objects are part of OpenGL 1.5.  If they are
+//    not available, the vertex data is kept in CPU memory and
+//    displayed as a client-side vertex array instead, which
+//    only requires OpenGL 1.1.
+//
+//  With OpenGL 3.3, a material range can also be displayed
+//    many times in a single call with
+//    drawMaterialRangeInstanced.  The caller provides the
+//    shader and the per-instance vertex attributes.
+//
+//  VertexBufferModels are normally created from an ObjModel by
+//    calling ObjModel::getVertexBufferModel().
+//
+//  Many models, such as asteroids made by displacing the
+//    vertexes of a sphere, differ only in their vertex
+//    positions.  getCopyWithPositions() creates a
+//    VertexBufferModel that stores only its own positions and
+//    shares the index buffer, texture coordinates, normals, and
+//    material ranges with the original.
+//
+class VertexBufferModel
+{
+public:
+//
+//  FLOATS_PER_VERTEX
+//
+//  The number of floats stored for each vertex.
+//
+	static const unsigned int FLOATS_PER_VERTEX = 8;
+
+//
+//  POSITION_OFFSET
+//  TEXTURE_COORDINATES_OFFSET
+//  NORMAL_OFFSET
+//
+//  The index of the first float of the position, texture
+//    coordinates, and normal vector in the data for a vertex.
+//
+	static const unsigned int POSITION_OFFSET            = 0;
+	static const unsigned int TEXTURE_COORDINATES_OFFSET = 3;
+	static const unsigned int NORMAL_OFFSET              = 5;
+
+//
+//  MaterialRange
+//
+//  A record to represent a range of the index buffer to be
+//    displayed with a single Material.  The range starts at
+//    index m_first_index and contains m_index_count indexes,
+//    which is 3 for each triangle.  If mp_material is NULL,
+//    the range is displayed without activating a Material.
+//
+	struct MaterialRange
+	{
+		const Material* mp_material;
+		unsigned int m_first_index;
+		unsigned int m_index_count;
+	};
+
+public:
+//
+//  isBufferObjectsAvailable
+//
+//  Purpose: To determine if OpenGL vertex buffer objects can be
+//           used.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//  Returns: Whether the current OpenGL context supports vertex
+//           buffer objects.  If not, VertexBufferModels are
+//           displayed from client-side vertex arrays.
+//  Side Effect: The first time this function is called, the
+//               OpenGL version is checked and, where necessary,
+//               the vertex buffer object functions are found.
+//
+	static bool isBufferObjectsAvailable ();
+
+//
+//  isInstancingAvailable
+//
+//  Purpose: To determine if instanced drawing can be used.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//  Returns: Whether the current OpenGL context supports
+//           vertex buffer objects, instanced drawing, and
+//           per-instance vertex attributes.  This requires
+//           OpenGL 3.3.
+//  Side Effect: The first time this function is called, the
+//               OpenGL version is checked and, where necessary,
+//               the instanced drawing function is found.
+//
+	static bool isInstancingAvailable ();
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a new empty VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new VertexBufferModel is created and marked
+//               as empty.
+//
+	VertexBufferModel ();
+
+//
+//  Copy Constructor
+//
+//  Purpose: To create a new VertexBufferModel as a copy of
+//           another.
+//  Parameter(s):
+//    <1> original: The VertexBufferModel to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: A new VertexBufferModel is created.  If
+//               original is empty, this VertexBufferModel is
+//               marked as empty.  Otherwise, this
+//               VertexBufferModel is set to refer to the same
+//               buffers as original.
+//
+	VertexBufferModel (const VertexBufferModel& original);
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this VertexBufferModel without
+//           memory leaks.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: All dynamically allocated memory is freed.  If
+//               this VertexBufferModel contains the last
+//               reference to its buffers, they are destroyed.
+//
+	~VertexBufferModel ();
+
+//
+//  Assignment Operator
+//
+//  Purpose: To modify this VertexBufferModel to be a copy of
+//           another.
+//  Parameter(s):
+//    <1> original: The VertexBufferModel to copy
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: If original is empty, this VertexBufferModel is
+//               marked as empty.  Otherwise, this
+//               VertexBufferModel is set to refer to the same
+//               buffers as original.  If this VertexBufferModel
+//               contained the last reference to its buffers,
+//               they are destroyed.
+//
+	VertexBufferModel& operator= (const VertexBufferModel& original);
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this VertexBufferModel is empty.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this VertexBufferModel is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const;
+
+//
+//  isReady
+//
+//  Purpose: To determine if this VertexBufferModel is ready to
+//           draw.  This is the case after init() has been
+//           called, until makeEmpty() is called.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: Whether this VertexBufferModel is ready to draw.
+//  Side Effect: N/A
+//
+	bool isReady () const;
+
+//
+//  getVertexCount
+//
+//  Purpose: To determine the number of vertexes in this
+//           VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: The number of vertexes.
+//  Side Effect: N/A
+//
+	unsigned int getVertexCount () const;
+
+//
+//  getIndexCount
+//
+//  Purpose: To determine the number of indexes in this
+//           VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: The number of indexes.  This is 3 times the number
+//           of triangles.
+//  Side Effect: N/A
+//
+	unsigned int getIndexCount () const;
+
+//
+//  getMaterialRangeCount
+//
+//  Purpose: To determine the number of material ranges in this
+//           VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: The number of material ranges.  This is the number
+//           of draw calls needed to display this
+//           VertexBufferModel, not counting the second pass for
+//           materials with seperate specular highlights.
+//  Side Effect: N/A
+//
+	unsigned int getMaterialRangeCount () const;
+
+//
+//  getMaterialRangeMaterial
+//
+//  Purpose: To determine which Material is used to display a
+//           material range.
+//  Parameter(s):
+//    <1> range: Which material range
+//  Precondition(s):
+//    <1> isReady()
+//    <2> range < getMaterialRangeCount()
+//  Returns: A pointer to the Material for material range range,
+//           or NULL if it is displayed without a Material.
+//  Side Effect: N/A
+//
+	const Material* getMaterialRangeMaterial (
+	                                 unsigned int range) const;
+
+//
+//  isPositionsReplaced
+//
+//  Purpose: To determine if this VertexBufferModel was created
+//           by getCopyWithPositions.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: Whether this VertexBufferModel stores only its
+//           vertex positions and shares the rest of its data.
+//  Side Effect: N/A
+//
+	bool isPositionsReplaced () const;
+
+//
+//  getCopyWithPositions
+//
+//  Purpose: To create a VertexBufferModel that is the same as
+//           this one except for the vertex positions.
+//  Parameter(s):
+//    <1> v_positions: The new vertex positions, with 3 floats
+//                     (x, y, z) for each vertex
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> isReady()
+//    <4> v_positions.size() == getVertexCount() * 3
+//  Returns: A VertexBufferModel with the positions in
+//           v_positions.  Only the positions are stored for
+//           it, and the other data is shared with this
+//           VertexBufferModel.  The shared data is not
+//           destroyed until this VertexBufferModel and all the
+//           copies with positions have been destroyed.
+//  Side Effect: If vertex buffer objects are available, the
+//               positions are copied to video memory.
+//
+	VertexBufferModel getCopyWithPositions (
+	             const std::vector<float>& v_positions) const;
+
+//
+//  draw
+//
+//  Purpose: To display the contents of this VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> isReady()
+//    <4> !Material::isMaterialActive()
+//  Returns: N/A
+//  Side Effect: Each material range of this VertexBufferModel
+//               is displayed with its Material.  The OpenGL
+//               client state and buffer bindings are restored
+//               afterwards.
+//
+	void draw () const;
+
+//
+//  drawMaterialRangeInstanced
+//
+//  Purpose: To display many instances of one material range of
+//           this VertexBufferModel with the current OpenGL
+//           state.
+//  Parameter(s):
+//    <1> range: Which material range
+//    <2> instance_count: The number of instances
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> isInstancingAvailable()
+//    <4> isReady()
+//    <5> range < getMaterialRangeCount()
+//  Returns: N/A
+//  Side Effect: The triangles in material range range are
+//               displayed instance_count times with one draw
+//               call.  The Material for the range is not
+//               activated, so the caller should activate it.
+//               The position, texture coordinates, and normal
+//               are provided as the standard vertex attributes
+//               (gl_Vertex, gl_MultiTexCoord0, and gl_Normal).
+//               The caller must bind a shader and set up any
+//               per-instance vertex attributes.  The OpenGL
+//               client state and buffer bindings are restored
+//               afterwards.
+//
+	void drawMaterialRangeInstanced (
+	                      unsigned int range,
+	                      unsigned int instance_count) const;
+
+//
+//  drawMaterialRangeCurrent
+//
+//  Purpose: To display one material range of this
+//           VertexBufferModel with the current OpenGL state.
+//  Parameter(s):
+//    <1> range: Which material range
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> isReady()
+//    <4> range < getMaterialRangeCount()
+//  Returns: N/A
+//  Side Effect: The triangles in material range range are
+//               displayed.  The Material for the range is not
+//               activated, so many ranges with the same
+//               Material can be displayed with one activation.
+//               The OpenGL client state and buffer bindings
+//               are restored afterwards.
+//
+	void drawMaterialRangeCurrent (unsigned int range) const;
+
+//
+//  makeEmpty
+//
+//  Purpose: To mark this VertexBufferModel as empty.
+//  Parameter(s): N/A
+//  Precondition(s): N/A
+//  Returns: N/A
+//  Side Effect: This VertexBufferModel is marked as empty.  If
+//               this VertexBufferModel contains the last
+//               reference to its buffers, they are destroyed.
+//               As for DisplayLists, nothing is destroyed if
+//               DisplayList::isDisabledForExit().
+//
+	void makeEmpty ();
+
+//
+//  init
+//
+//  Purpose: To set the contents of this VertexBufferModel.
+//  Parameter(s):
+//    <1> v_vertex_data: The interleaved vertex data
+//    <2> v_indexes: The vertexes of the triangles
+//    <3> v_material_ranges: The material ranges
+//    <4> is_texture_coordinates: Whether the texture
+//                                coordinates should be used
+//    <5> is_normals: Whether the normals should be used
+//  Precondition(s):
+//    <1> DisplayList::isGlutInitialized()
+//    <2> !DisplayList::isDisabledForExit()
+//    <3> v_vertex_data.size() % FLOATS_PER_VERTEX == 0
+//    <4> v_indexes.size() % 3 == 0
+//    <5> Every element of v_indexes is less than
+//        v_vertex_data.size() / FLOATS_PER_VERTEX
+//    <6> Every element of v_material_ranges is inside
+//        v_indexes
+//  Returns: N/A
+//  Side Effect: This VertexBufferModel is set to display the
+//               specified triangles.  If vertex buffer objects
+//               are available, the data is copied to video
+//               memory.  Otherwise, it is copied into this
+//               VertexBufferModel.  If is_texture_coordinates
+//               or is_normals is false, the corresponding part
+//               of the vertex data is ignored.  Any Material in
+//               v_material_ranges must exist for as long as
+//               this VertexBufferModel is drawn.
+//
+	void init (const std::vector<float>& v_vertex_data,
+	           const std::vector<unsigned int>& v_indexes,
+	           const std::vector<MaterialRange>& v_material_ranges,
+	           bool is_texture_coordinates,
+	           bool is_normals);
+
+private:
+//
+//  beginVertexArrays
+//
+//  Purpose: To set up the OpenGL vertex arrays for displaying
+//           this VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//  Returns: N/A
+//  Side Effect: The OpenGL client state is saved, and the
+//               buffers and vertex arrays for this
+//               VertexBufferModel are bound.
+//
+	void beginVertexArrays () const;
+
+//
+//  endVertexArrays
+//
+//  Purpose: To restore the OpenGL state after displaying this
+//           VertexBufferModel.
+//  Parameter(s): N/A
+//  Precondition(s):
+//    <1> isReady()
+//    <2> beginVertexArrays has been called
+//  Returns: N/A
+//  Side Effect: The OpenGL client state saved by
+//               beginVertexArrays is restored and the buffers
+//               are unbound.
+//
+	void endVertexArrays () const;
+
+//
+//  drawMaterialRange
+//
+//  Purpose: To display one material range.
+//  Parameter(s):
+//    <1> range: Which material range
+//  Precondition(s):
+//    <1> isReady()
+//    <2> range < getMaterialRangeCount()
+//    <3> The vertex arrays have been set up
+//  Returns: N/A
+//  Side Effect: The triangles in material range range are
+//               displayed with its Material.
+//
+	void drawMaterialRange (unsigned int range) const;
+
+//
+//  drawElements
+//
+//  Purpose: To display the triangles for a range of the index
+//           buffer with the current OpenGL state.
+//  Parameter(s):
+//    <1> first_index: The first index to display
+//    <2> index_count: The number of indexes to display
+//  Precondition(s):
+//    <1> isReady()
+//    <2> first_index + index_count <= getIndexCount()
+//    <3> The vertex arrays have been set up
+//  Returns: N/A
+//  Side Effect: The specified triangles are displayed.
+//
+	void drawElements (unsigned int first_index,
+	                   unsigned int index_count) const;
+
+//
+//  getVertexAttributeStart
+//
+//  Purpose: To determine the value to pass to OpenGL for the
+//           start of a vertex attribute.
+//  Parameter(s):
+//    <1> offset: The index of the first float of the
+//                attribute in the data for a vertex
+//  Precondition(s):
+//    <1> isReady()
+//    <2> offset < FLOATS_PER_VERTEX
+//  Returns: If the vertex data is in a buffer object, the byte
+//           offset of the attribute in the buffer.  Otherwise,
+//           a pointer to the attribute for the first vertex.
+//  Side Effect: N/A
+//
+	const void* getVertexAttributeStart (unsigned int offset) const;
+
+//
+//  getIndexStart
+//
+//  Purpose: To determine the value to pass to OpenGL for the
+//           start of a range of the index buffer.
+//  Parameter(s):
+//    <1> first_index: The first index in the range
+//  Precondition(s):
+//    <1> isReady()
+//    <2> first_index <= getIndexCount()
+//  Returns: If the indexes are in a buffer object, the byte
+//           offset of index first_index in the buffer.
+//           Otherwise, a pointer to index first_index.
+//  Side Effect: N/A
+//
+	const void* getIndexStart (unsigned int first_index) const;
+
+//
+//  copy
+//
+//  Purpose: To copy the values of another VertexBufferModel to
+//           this VertexBufferModel.
+//  Parameter(s):
+//    <1> original: The VertexBufferModel to copy
+//  Precondition(s):
+//    <1> isEmpty()
+//  Returns: N/A
+//  Side Effect: If original is empty, this VertexBufferModel is
+//               marked as empty.  Otherwise, this
+//               VertexBufferModel is set to refer to the same
+//               buffers as original.
+//
+	void copy (const VertexBufferModel& original);
+
+private:
+	//
+	//  InnerData
+	//
+	//  A record to store information about the buffers for a
+	//    model.  The buffer names, a usage count, and the
+	//    material ranges are stored.  If vertex buffer
+	//    objects are not available, the buffer names are 0 and
+	//    the vertex data and indexes are stored here instead.
+	//
+	//  If the positions have been replaced, mp_shared points to
+	//    the InnerData that owns the other buffers, and this
+	//    InnerData holds one usage of it.  The vertex and index
+	//    buffer names are copied from there, but only the
+	//    position buffer (or the positions) belong to this
+	//    InnerData.
+	//
+	struct InnerData
+	{
+		unsigned int m_vertex_buffer;
+		unsigned int m_index_buffer;
+		unsigned int m_position_buffer;
+		std::vector<float> mv_vertex_data;
+		std::vector<unsigned int> mv_indexes;
+		std::vector<float> mv_positions;
+		InnerData* mp_shared;
+		unsigned int m_vertex_count;
+		unsigned int m_index_count;
+		std::vector<MaterialRange> mv_material_ranges;
+		bool m_is_texture_coordinates;
+		bool m_is_normals;
+		unsigned int m_usages;
+	};
+
+//
+//  releaseInnerData
+//
+//  Purpose: To remove one usage of the specified InnerData.
+//  Parameter(s):
+//    <1> p_data: The InnerData
+//  Precondition(s):
+//    <1> p_data != NULL
+//    <2> p_data->m_usages > 0
+//  Returns: N/A
+//  Side Effect: The usage count for p_data is decreased.  If
+//               it reaches 0, the buffers belonging to p_data
+//               are destroyed, p_data is deleted, and the
+//               usage of the shared InnerData, if any, is
+//               removed.
+//
+	static void releaseInnerData (InnerData* p_data);
+
+private:
+	InnerData* mp_data;
+};
+
+
+
+}  // end of namespace ObjLibrary
+
+#endif
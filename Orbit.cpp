@@ -0,0 +1,207 @@
+//
+//  Orbit.cpp
+//
+
+#include "Orbit.h"
+
+#include <cassert>
+#include <cmath>
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double PI = 3.1415926535897932384626433832795;
+
+	const unsigned int SOLVE_ITERATIONS_MAX = 50;
+	const double SOLVE_TOLERANCE = 1.0e-12;
+	const double LAGUERRE_ORDER  = 5.0;
+
+	// below this, the Stumpff functions use their series
+	const double STUMPFF_SERIES_LIMIT = 1.0e-3;
+
+
+
+//
+//  stumpffC
+//  stumpffS
+//
+//  Purpose: To calculate the Stumpff functions C(z) and S(z)
+//           used by the universal variable formulation.
+//  Parameter(s):
+//    <1> z: The argument
+//  Preconditions: N/A
+//  Returns: C(z) or S(z).
+//  Side Effect: N/A
+//
+	double stumpffC (double z)
+	{
+		if(fabs(z) < STUMPFF_SERIES_LIMIT)
+			return 1.0 / 2.0 - z * (1.0 / 24.0 - z * (1.0 / 720.0 - z / 40320.0));
+		else if(z > 0.0)
+			return (1.0 - cos(sqrt(z))) / z;
+		else
+			return (cosh(sqrt(-z)) - 1.0) / -z;
+	}
+
+	double stumpffS (double z)
+	{
+		if(fabs(z) < STUMPFF_SERIES_LIMIT)
+			return 1.0 / 6.0 - z * (1.0 / 120.0 - z * (1.0 / 5040.0 - z / 362880.0));
+		else if(z > 0.0)
+		{
+			double root = sqrt(z);
+			return (root - sin(root)) / (root * root * root);
+		}
+		else
+		{
+			double root = sqrt(-z);
+			return (sinh(root) - root) / (root * root * root);
+		}
+	}
+
+}  // end of anonymous namespace
+
+
+
+Orbit :: Orbit (const ObjLibrary::Vector3& position,
+                const ObjLibrary::Vector3& velocity,
+                double gravitational_parameter)
+		: m_position(position)
+		, m_velocity(velocity)
+		, m_gravitational_parameter(gravitational_parameter)
+		, m_distance(position.getNorm())
+		, m_radial_velocity_factor(position.dotProduct(velocity) / sqrt(gravitational_parameter))
+		, m_inverse_semimajor_axis(0.0)
+		, m_eccentricity(0.0)
+		, m_periapsis(0.0)
+{
+	assert(position.isFinite());
+	assert(!position.isZero());
+	assert(velocity.isFinite());
+	assert(gravitational_parameter > 0.0);
+
+	double mu = gravitational_parameter;
+	m_inverse_semimajor_axis = 2.0 / m_distance - velocity.getNormSquared() / mu;
+
+	Vector3 eccentricity_vector = (position * (velocity.getNormSquared() - mu / m_distance) -
+	                               velocity * position.dotProduct(velocity)) / mu;
+	m_eccentricity = eccentricity_vector.getNorm();
+
+	double angular_momentum_squared = position.crossProduct(velocity).getNormSquared();
+	m_periapsis = angular_momentum_squared / (mu * (1.0 + m_eccentricity));
+
+	assert(invariant());
+}
+
+
+
+double Orbit :: getPeriod () const
+{
+	assert(isBound());
+
+	double semimajor_axis = getSemimajorAxis();
+	return 2.0 * PI * sqrt(semimajor_axis * semimajor_axis * semimajor_axis / m_gravitational_parameter);
+}
+
+void Orbit :: getStateAt (double time,
+                          ObjLibrary::Vector3& r_position,
+                          ObjLibrary::Vector3& r_velocity) const
+{
+	assert(isfinite(time));
+
+	if(time == 0.0)
+	{
+		r_position = m_position;
+		r_velocity = m_velocity;
+		return;
+	}
+
+	// an ellipse repeats every period
+	if(isBound())
+		time = fmod(time, getPeriod());
+
+	double root_mu = sqrt(m_gravitational_parameter);
+	double chi     = solveUniversalAnomaly(time);
+	double chi2    = chi * chi;
+	double z       = m_inverse_semimajor_axis * chi2;
+	double c       = stumpffC(z);
+	double s       = stumpffS(z);
+
+	// Lagrange coefficients
+	double f = 1.0 - chi2 * c / m_distance;
+	double g = time - chi2 * chi * s / root_mu;
+	r_position = m_position * f + m_velocity * g;
+
+	double distance = r_position.getNorm();
+	assert(distance > 0.0);
+	double f_dot = root_mu / (distance * m_distance) * chi * (z * s - 1.0);
+	double g_dot = 1.0 - chi2 * c / distance;
+	r_velocity = m_position * f_dot + m_velocity * g_dot;
+}
+
+
+
+double Orbit :: solveUniversalAnomaly (double time) const
+{
+	double root_mu = sqrt(m_gravitational_parameter);
+	double alpha   = m_inverse_semimajor_axis;
+	double r0      = m_distance;
+	double sigma0  = m_radial_velocity_factor;
+
+	// initial guess
+	double chi;
+	if(alpha > 0.0)
+		chi = root_mu * time * alpha;
+	else if(alpha < 0.0)
+	{
+		double a = 1.0 / alpha;
+		double sign = (time >= 0.0) ? 1.0 : -1.0;
+		double denominator = sigma0 * root_mu + sign * sqrt(-m_gravitational_parameter * a) * (1.0 - r0 * alpha);
+		double ratio = -2.0 * m_gravitational_parameter * alpha * time / denominator;
+		if(ratio > 0.0)
+			chi = sign * sqrt(-a) * log(ratio);
+		else
+			chi = root_mu * time / r0;
+	}
+	else
+		chi = root_mu * time / r0;
+
+	// Laguerre-Conway iteration, which converges for almost any
+	//   starting point
+	for(unsigned int i = 0; i < SOLVE_ITERATIONS_MAX; i++)
+	{
+		double chi2 = chi * chi;
+		double z = alpha * chi2;
+		double c = stumpffC(z);
+		double s = stumpffS(z);
+
+		double value = sigma0 * chi2 * c + (1.0 - r0 * alpha) * chi2 * chi * s + r0 * chi - root_mu * time;
+		double first = sigma0 * chi * (1.0 - z * s) + (1.0 - r0 * alpha) * chi2 * c + r0;
+		double second = sigma0 * (1.0 - z * c) + (1.0 - r0 * alpha) * chi * (1.0 - z * s);
+
+		double n = LAGUERRE_ORDER;
+		double discriminant = fabs((n - 1.0) * (n - 1.0) * first * first - n * (n - 1.0) * value * second);
+		double denominator = first + ((first >= 0.0) ? 1.0 : -1.0) * sqrt(discriminant);
+		if(denominator == 0.0)
+			break;
+
+		double step = n * value / denominator;
+		chi -= step;
+		if(fabs(step) <= SOLVE_TOLERANCE * fmax(1.0, fabs(chi)))
+			break;
+	}
+
+	return chi;
+}
+
+bool Orbit :: invariant () const
+{
+	if(m_gravitational_parameter <= 0.0) return false;
+	if(!m_position.isFinite()) return false;
+	if(m_position.isZero()) return false;
+	if(!m_velocity.isFinite()) return false;
+	return true;
+}
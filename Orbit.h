@@ -0,0 +1,222 @@
+//
+//  Orbit.h
+//
+//  A module to represent a two-body orbit around a point mass.
+//
+
+#pragma once
+
+#include <cassert>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  Orbit
+//
+//  A class to represent the path of a body moving under the
+//    gravity of a single point mass, with no other forces.  The
+//    path is an exact conic section (ellipse, parabola, or
+//    hyperbola), so the position and velocity can be found at
+//    any time in constant time without integrating.
+//
+//  The Orbit is created from the state vectors (position and
+//    velocity relative to the central mass) at an epoch time of
+//    0.0.  The orbital elements are calculated from these.  The
+//    state at other times is found by solving Kepler's equation
+//    in universal variables, which works the same way for all
+//    conic sections, including nearly-parabolic and radial
+//    orbits.
+//
+//  Class Invariant:
+//    <1> m_gravitational_parameter > 0.0
+//    <2> m_position.isFinite()
+//    <3> !m_position.isZero()
+//    <4> m_velocity.isFinite()
+//
+class Orbit
+{
+public:
+//
+//  Constructor
+//
+//  Purpose: To create an Orbit from state vectors.
+//  Parameter(s):
+//    <1> position: The position of the body relative to the
+//                  central mass at time 0.0
+//    <2> velocity: The velocity of the body relative to the
+//                  central mass at time 0.0
+//    <3> gravitational_parameter: The gravitational parameter
+//                                 (GRAVITY times mass) of the
+//                                 central mass
+//  Preconditions:
+//    <1> position.isFinite()
+//    <2> !position.isZero()
+//    <3> velocity.isFinite()
+//    <4> gravitational_parameter > 0.0
+//  Returns: N/A
+//  Side Effect: A new Orbit is created.
+//
+	Orbit (const ObjLibrary::Vector3& position,
+	       const ObjLibrary::Vector3& velocity,
+	       double gravitational_parameter);
+
+	Orbit (const Orbit& to_copy) = default;
+	~Orbit () = default;
+	Orbit& operator= (const Orbit& to_copy) = default;
+
+//
+//  isBound
+//
+//  Purpose: To determine if the body is captured by the central
+//           mass.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this Orbit is an ellipse (or circle).
+//  Side Effect: N/A
+//
+	bool isBound () const
+	{
+		return m_inverse_semimajor_axis > 0.0;
+	}
+
+//
+//  getSemimajorAxis
+//
+//  Purpose: To determine the semimajor axis of this Orbit.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> getInverseSemimajorAxis() != 0.0
+//  Returns: The semimajor axis.  This is negative for a
+//           hyperbolic Orbit.
+//  Side Effect: N/A
+//
+	double getSemimajorAxis () const
+	{
+		assert(m_inverse_semimajor_axis != 0.0);
+
+		return 1.0 / m_inverse_semimajor_axis;
+	}
+
+//
+//  getInverseSemimajorAxis
+//
+//  Purpose: To determine the reciprocal of the semimajor axis
+//           of this Orbit.  Unlike the semimajor axis, this is
+//           defined for parabolic orbits.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The reciprocal of the semimajor axis.  This is
+//           positive for an ellipse, 0.0 for a parabola, and
+//           negative for a hyperbola.
+//  Side Effect: N/A
+//
+	double getInverseSemimajorAxis () const
+	{
+		return m_inverse_semimajor_axis;
+	}
+
+//
+//  getEccentricity
+//
+//  Purpose: To determine the eccentricity of this Orbit.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The eccentricity.  This is 0.0 for a circle, less
+//           than 1.0 for an ellipse, and greater than 1.0 for a
+//           hyperbola.
+//  Side Effect: N/A
+//
+	double getEccentricity () const
+	{
+		return m_eccentricity;
+	}
+
+//
+//  getPeriapsis
+//
+//  Purpose: To determine the closest approach of this Orbit to
+//           the central mass.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The periapsis distance.
+//  Side Effect: N/A
+//
+	double getPeriapsis () const
+	{
+		return m_periapsis;
+	}
+
+//
+//  getPeriod
+//
+//  Purpose: To determine how long it takes to go once around
+//           this Orbit.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isBound()
+//  Returns: The orbital period in seconds.
+//  Side Effect: N/A
+//
+	double getPeriod () const;
+
+//
+//  getStateAt
+//
+//  Purpose: To determine the position and velocity on this
+//           Orbit at the specified time.
+//  Parameter(s):
+//    <1> time: The time since the epoch in seconds
+//    <2> r_position: A reference to a Vector3 to store the
+//                    position
+//    <3> r_velocity: A reference to a Vector3 to store the
+//                    velocity
+//  Preconditions:
+//    <1> isfinite(time)
+//  Returns: N/A
+//  Side Effect: r_position and r_velocity are set to the
+//               position and velocity relative to the central
+//               mass at time time.  The time may be negative.
+//
+	void getStateAt (double time,
+	                 ObjLibrary::Vector3& r_position,
+	                 ObjLibrary::Vector3& r_velocity) const;
+
+private:
+//
+//  Helper Function: solveUniversalAnomaly
+//
+//  Purpose: To solve the universal form of Kepler's equation.
+//  Parameter(s):
+//    <1> time: The time since the epoch in seconds
+//  Preconditions: N/A
+//  Returns: The universal anomaly at time time.
+//  Side Effect: N/A
+//
+	double solveUniversalAnomaly (double time) const;
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	// state vectors at epoch
+	ObjLibrary::Vector3 m_position;
+	ObjLibrary::Vector3 m_velocity;
+	double m_gravitational_parameter;
+
+	// derived orbital elements
+	double m_distance;
+	double m_radial_velocity_factor;  // dot(r, v) / sqrt(mu)
+	double m_inverse_semimajor_axis;
+	double m_eccentricity;
+	double m_periapsis;
+};
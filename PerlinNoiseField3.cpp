@@ -26,6 +26,12 @@ namespace
 	const unsigned int DEFAULT_SEED_Q0 = 1498573726;
 	const unsigned int DEFAULT_SEED_Q1 = 3476519523;
 	const unsigned int DEFAULT_SEED_Q2 = 3905844518;
+
+	// corners are in the order 000, 001, 010, 011, 100, ...
+	const unsigned int CORNER_COUNT = 8;
+
+	// the gradient table is intended for small regions
+	const unsigned int GRADIENT_TABLE_SIZE_MAX = 0x100000;
 }
 
 
@@ -42,6 +48,13 @@ PerlinNoiseField3 :: PerlinNoiseField3 ()
 		, m_seed_q0(DEFAULT_SEED_Q0)
 		, m_seed_q1(DEFAULT_SEED_Q1)
 		, m_seed_q2(DEFAULT_SEED_Q2)
+		, m_table_x0(0)
+		, m_table_y0(0)
+		, m_table_z0(0)
+		, m_table_size_x(0)
+		, m_table_size_y(0)
+		, m_table_size_z(0)
+		, mv_gradient_table()
 {
 	assert(invariant());
 }
@@ -59,6 +72,13 @@ PerlinNoiseField3 :: PerlinNoiseField3 (float grid_size,
 		, m_seed_q0(DEFAULT_SEED_Q0)
 		, m_seed_q1(DEFAULT_SEED_Q1)
 		, m_seed_q2(DEFAULT_SEED_Q2)
+		, m_table_x0(0)
+		, m_table_y0(0)
+		, m_table_z0(0)
+		, m_table_size_x(0)
+		, m_table_size_y(0)
+		, m_table_size_z(0)
+		, mv_gradient_table()
 {
 	assert(grid_size > 0.0f);
 
@@ -87,12 +107,62 @@ PerlinNoiseField3 :: PerlinNoiseField3 (float grid_size,
 		, m_seed_q0(seed_q0)
 		, m_seed_q1(seed_q1)
 		, m_seed_q2(seed_q2)
+		, m_table_x0(0)
+		, m_table_y0(0)
+		, m_table_z0(0)
+		, m_table_size_x(0)
+		, m_table_size_y(0)
+		, m_table_size_z(0)
+		, mv_gradient_table()
 {
 	assert(grid_size > 0.0f);
 
 	assert(invariant());
 }
 
+PerlinNoiseField3 :: PerlinNoiseField3 (const PerlinNoiseField3& original,
+                                        const ObjLibrary::Vector3& table_minimum,
+                                        const ObjLibrary::Vector3& table_maximum)
+		: PerlinNoiseField3(original)
+{
+	assert(table_minimum.x <= table_maximum.x);
+	assert(table_minimum.y <= table_maximum.y);
+	assert(table_minimum.z <= table_maximum.z);
+
+	// include the far corners of the cells at the maximum
+	double min_x = floor(table_minimum.x / m_grid_size);
+	double min_y = floor(table_minimum.y / m_grid_size);
+	double min_z = floor(table_minimum.z / m_grid_size);
+	double size_x = floor(table_maximum.x / m_grid_size) - min_x + 2.0;
+	double size_y = floor(table_maximum.y / m_grid_size) - min_y + 2.0;
+	double size_z = floor(table_maximum.z / m_grid_size) - min_z + 2.0;
+
+	// a box that is too big is left without a table, which is
+	//   slower but gives the same values
+	if(size_x * size_y * size_z <= GRADIENT_TABLE_SIZE_MAX &&
+	   min_x >= INT_MIN && min_x + size_x <= INT_MAX &&
+	   min_y >= INT_MIN && min_y + size_y <= INT_MAX &&
+	   min_z >= INT_MIN && min_z + size_z <= INT_MAX)
+	{
+		m_table_x0 = (int)(min_x);
+		m_table_y0 = (int)(min_y);
+		m_table_z0 = (int)(min_z);
+		m_table_size_x = (unsigned int)(size_x);
+		m_table_size_y = (unsigned int)(size_y);
+		m_table_size_z = (unsigned int)(size_z);
+		fillGradientTable();
+	}
+	else
+	{
+		m_table_size_x = 0;
+		m_table_size_y = 0;
+		m_table_size_z = 0;
+		mv_gradient_table.clear();
+	}
+
+	assert(invariant());
+}
+
 
 
 float PerlinNoiseField3 :: getGridSize () const
@@ -105,6 +175,26 @@ float PerlinNoiseField3 :: getAmplitude () const
 	return m_amplitude;
 }
 
+void PerlinNoiseField3 :: getSeeds (unsigned int a_seeds[SEED_COUNT]) const
+{
+	assert(a_seeds != nullptr);
+
+	a_seeds[0] = m_seed_x1;
+	a_seeds[1] = m_seed_x2;
+	a_seeds[2] = m_seed_y1;
+	a_seeds[3] = m_seed_y2;
+	a_seeds[4] = m_seed_z1;
+	a_seeds[5] = m_seed_z2;
+	a_seeds[6] = m_seed_q0;
+	a_seeds[7] = m_seed_q1;
+	a_seeds[8] = m_seed_q2;
+}
+
+bool PerlinNoiseField3 :: isGradientTable () const
+{
+	return !mv_gradient_table.empty();
+}
+
 float PerlinNoiseField3 :: valueNoise (float x, float y, float z) const
 {
 	int x0 = (int)(floor(x / m_grid_size));
@@ -147,26 +237,78 @@ float PerlinNoiseField3 :: perlinNoise (float x, float y, float z) const
 	int x0 = (int)(floor(x / m_grid_size));
 	int y0 = (int)(floor(y / m_grid_size));
 	int z0 = (int)(floor(z / m_grid_size));
-	int x1 = x0 + 1;
-	int y1 = y0 + 1;
-	int z1 = z0 + 1;
 
 	float x_frac = x / m_grid_size - x0;
 	float y_frac = y / m_grid_size - y0;
 	float z_frac = z / m_grid_size - z0;
 
+	Vector3 a_lattice[CORNER_COUNT];
+	calculateCellLattice(x0, y0, z0, a_lattice);
+	return perlinNoiseInCell(a_lattice, x_frac, y_frac, z_frac);
+}
+
+void PerlinNoiseField3 :: perlinNoiseBatch (unsigned int count,
+                                            const float* pa_x,
+                                            const float* pa_y,
+                                            const float* pa_z,
+                                            float* pa_result) const
+{
+	assert(count == 0 || pa_x != nullptr);
+	assert(count == 0 || pa_y != nullptr);
+	assert(count == 0 || pa_z != nullptr);
+	assert(count == 0 || pa_result != nullptr);
+
+	// the gradients for the most recent cell
+	bool is_lattice_set = false;
+	int lattice_x = 0;
+	int lattice_y = 0;
+	int lattice_z = 0;
+	Vector3 a_lattice[CORNER_COUNT];
+
+	for(unsigned int i = 0; i < count; i++)
+	{
+		// same operations as the single-point version
+		int x0 = (int)(floor(pa_x[i] / m_grid_size));
+		int y0 = (int)(floor(pa_y[i] / m_grid_size));
+		int z0 = (int)(floor(pa_z[i] / m_grid_size));
+
+		float x_frac = pa_x[i] / m_grid_size - x0;
+		float y_frac = pa_y[i] / m_grid_size - y0;
+		float z_frac = pa_z[i] / m_grid_size - z0;
+
+		if(!is_lattice_set ||
+		   x0 != lattice_x ||
+		   y0 != lattice_y ||
+		   z0 != lattice_z)
+		{
+			lattice_x = x0;
+			lattice_y = y0;
+			lattice_z = z0;
+			calculateCellLattice(lattice_x, lattice_y, lattice_z, a_lattice);
+			is_lattice_set = true;
+		}
+
+		pa_result[i] = perlinNoiseInCell(a_lattice, x_frac, y_frac, z_frac);
+	}
+}
+
+float PerlinNoiseField3 :: perlinNoiseInCell (const ObjLibrary::Vector3 a_lattice[8],
+                                              float x_frac,
+                                              float y_frac,
+                                              float z_frac) const
+{
 	float x_fade = fade(x_frac);
 	float y_fade = fade(y_frac);
 	float z_fade = fade(z_frac);
 
-	Vector3 lattice000 = lattice(x0, y0, z0);
-	Vector3 lattice001 = lattice(x0, y0, z1);
-	Vector3 lattice010 = lattice(x0, y1, z0);
-	Vector3 lattice011 = lattice(x0, y1, z1);
-	Vector3 lattice100 = lattice(x1, y0, z0);
-	Vector3 lattice101 = lattice(x1, y0, z1);
-	Vector3 lattice110 = lattice(x1, y1, z0);
-	Vector3 lattice111 = lattice(x1, y1, z1);
+	const Vector3& lattice000 = a_lattice[0];
+	const Vector3& lattice001 = a_lattice[1];
+	const Vector3& lattice010 = a_lattice[2];
+	const Vector3& lattice011 = a_lattice[3];
+	const Vector3& lattice100 = a_lattice[4];
+	const Vector3& lattice101 = a_lattice[5];
+	const Vector3& lattice110 = a_lattice[6];
+	const Vector3& lattice111 = a_lattice[7];
 
 	Vector3 direction000(     - x_frac,      - y_frac,      - z_frac);
 	Vector3 direction001(     - x_frac,      - y_frac, 1.0f - z_frac);
@@ -259,6 +401,12 @@ void PerlinNoiseField3 :: setGridSize (float grid_size)
 
 	m_grid_size = grid_size;
 
+	// the table is for the old lattice points
+	m_table_size_x = 0;
+	m_table_size_y = 0;
+	m_table_size_z = 0;
+	mv_gradient_table.clear();
+
 	assert(invariant());
 }
 
@@ -289,6 +437,9 @@ void PerlinNoiseField3 :: setSeeds (unsigned int seed_x1,
 	m_seed_q1 = seed_q1;
 	m_seed_q2 = seed_q2;
 
+	if(isGradientTable())
+		fillGradientTable();
+
 	assert(invariant());
 }
 
@@ -343,6 +494,25 @@ float PerlinNoiseField3 :: interpolate (float v0,
 }
 
 ObjLibrary::Vector3 PerlinNoiseField3 :: lattice (int x, int y, int z) const
+{
+	// outside the table (or no table), unsigned values wrap
+	//   around to large numbers
+	unsigned int table_x = (unsigned int)(x) - (unsigned int)(m_table_x0);
+	unsigned int table_y = (unsigned int)(y) - (unsigned int)(m_table_y0);
+	unsigned int table_z = (unsigned int)(z) - (unsigned int)(m_table_z0);
+	if(table_x < m_table_size_x &&
+	   table_y < m_table_size_y &&
+	   table_z < m_table_size_z)
+	{
+		unsigned int index = (table_z * m_table_size_y + table_y) * m_table_size_x + table_x;
+		assert(index < mv_gradient_table.size());
+		return mv_gradient_table[index];
+	}
+
+	return calculateLattice(x, y, z);
+}
+
+ObjLibrary::Vector3 PerlinNoiseField3 :: calculateLattice (int x, int y, int z) const
 {
 	unsigned int value1 = pseudorandom(x, y, z);
 	unsigned int value2 = pseudorandom(x + 1, y + 1, z + 1);  //  <|>
@@ -350,6 +520,40 @@ ObjLibrary::Vector3 PerlinNoiseField3 :: lattice (int x, int y, int z) const
 	                                          unsignedIntTo01(value2));
 }
 
+void PerlinNoiseField3 :: calculateCellLattice (int x0, int y0, int z0,
+                                                ObjLibrary::Vector3 a_lattice[8]) const
+{
+	int x1 = x0 + 1;
+	int y1 = y0 + 1;
+	int z1 = z0 + 1;
+
+	a_lattice[0] = lattice(x0, y0, z0);
+	a_lattice[1] = lattice(x0, y0, z1);
+	a_lattice[2] = lattice(x0, y1, z0);
+	a_lattice[3] = lattice(x0, y1, z1);
+	a_lattice[4] = lattice(x1, y0, z0);
+	a_lattice[5] = lattice(x1, y0, z1);
+	a_lattice[6] = lattice(x1, y1, z0);
+	a_lattice[7] = lattice(x1, y1, z1);
+}
+
+void PerlinNoiseField3 :: fillGradientTable ()
+{
+	mv_gradient_table.resize(m_table_size_x * m_table_size_y * m_table_size_z);
+
+	unsigned int index = 0;
+	for(unsigned int z = 0; z < m_table_size_z; z++)
+		for(unsigned int y = 0; y < m_table_size_y; y++)
+			for(unsigned int x = 0; x < m_table_size_x; x++)
+			{
+				mv_gradient_table[index] = calculateLattice(m_table_x0 + (int)(x),
+				                                            m_table_y0 + (int)(y),
+				                                            m_table_z0 + (int)(z));
+				index++;
+			}
+	assert(index == mv_gradient_table.size());
+}
+
 void PerlinNoiseField3 :: printValue (float value) const
 {
 	assert(value >= -1.0f);
@@ -375,5 +579,6 @@ void PerlinNoiseField3 :: printValue (float value) const
 bool PerlinNoiseField3 :: invariant () const
 {
 	if(m_grid_size <= 0.0) return false;
+	if(mv_gradient_table.size() != m_table_size_x * m_table_size_y * m_table_size_z) return false;
 	return true;
 }
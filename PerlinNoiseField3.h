@@ -6,6 +6,8 @@
 
 #pragma once
 
+#include <vector>
+
 #include "ObjLibrary/Vector3.h"
 
 
@@ -15,11 +17,23 @@
 //
 //  A class to calculate 3D value noise and Perlin noise.
 //
+//  Calculating the gradient at a lattice point is slow, so a
+//    PerlinNoiseField3 can optionally store the gradients for a
+//    box-shaped region in a table.  This only makes evaluation
+//    faster; the values are the same with or without the table.
+//
 //  Class Invariant:
 //    <1> m_grid_size > 0.0
+//    <2> mv_gradient_table.size() ==
+//        m_table_size_x * m_table_size_y * m_table_size_z
 //
 class PerlinNoiseField3
 {
+public:
+	// the number of seeds, in the order x1, x2, y1, y2, z1, z2,
+	//   q0, q1, q2 used by the constructor and setSeeds
+	static const unsigned int SEED_COUNT = 9;
+
 public:
 	PerlinNoiseField3 ();
 	PerlinNoiseField3 (float grid_size,
@@ -35,15 +49,36 @@ public:
 	                  unsigned int seed_q0,
 	                  unsigned int seed_q1,
 	                  unsigned int seed_q2);
+	// a copy of original with the lattice gradients precomputed
+	//   for every point in the box from table_minimum to
+	//   table_maximum; if the box has more than about a million
+	//   lattice points, there is no table and isGradientTable()
+	//   returns false
+	PerlinNoiseField3 (const PerlinNoiseField3& original,
+	                   const ObjLibrary::Vector3& table_minimum,
+	                   const ObjLibrary::Vector3& table_maximum);
 	PerlinNoiseField3 (const PerlinNoiseField3& to_copy) = default;
 	~PerlinNoiseField3 () = default;
 	PerlinNoiseField3& operator= (const PerlinNoiseField3& to_copy) = default;
 
 	float getGridSize () const;
 	float getAmplitude () const;
+	void getSeeds (unsigned int a_seeds[SEED_COUNT]) const;
+	bool isGradientTable () const;
 	float valueNoise (float x, float y, float z) const;
 	float perlinNoise (float x, float y, float z) const;
 
+	// evaluates count points, giving the same values as
+	//   perlinNoise; the lattice gradients are only calculated
+	//   again when a point is in a different cell from the point
+	//   before it, so this is faster when nearby points are
+	//   adjacent in the arrays
+	void perlinNoiseBatch (unsigned int count,
+	                       const float* pa_x,
+	                       const float* pa_y,
+	                       const float* pa_z,
+	                       float* pa_result) const;
+
 	void printPerlin (unsigned int print_rows,
 	                  unsigned int print_columns,
 	                  float interval) const;
@@ -73,6 +108,14 @@ private:
 	                   float v1,
 	                   float fraction) const;
 	ObjLibrary::Vector3 lattice (int x, int y, int z) const;
+	ObjLibrary::Vector3 calculateLattice (int x, int y, int z) const;
+	void fillGradientTable ();
+	void calculateCellLattice (int x0, int y0, int z0,
+	                           ObjLibrary::Vector3 a_lattice[8]) const;
+	float perlinNoiseInCell (const ObjLibrary::Vector3 a_lattice[8],
+	                         float x_frac,
+	                         float y_frac,
+	                         float z_frac) const;
 	void printValue (float value) const;
 	bool invariant () const;
 
@@ -88,4 +131,14 @@ private:
 	unsigned int m_seed_q0;
 	unsigned int m_seed_q1;
 	unsigned int m_seed_q2;
+
+	// lattice points from (m_table_x0, m_table_y0, m_table_z0)
+	//   with x fastest and z slowest
+	int m_table_x0;
+	int m_table_y0;
+	int m_table_z0;
+	unsigned int m_table_size_x;
+	unsigned int m_table_size_y;
+	unsigned int m_table_size_z;
+	std::vector<ObjLibrary::Vector3> mv_gradient_table;
 };
@@ -0,0 +1,129 @@
+//
+//  RadiusCubemap.cpp
+//
+
+#include "RadiusCubemap.h"
+
+#include <cassert>
+#include <cmath>
+#include <vector>
+#include <functional>
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace ObjLibrary;
+
+
+
+RadiusCubemap :: RadiusCubemap ()
+		: mv_samples()
+{
+	assert(isEmpty());
+	assert(invariant());
+}
+
+RadiusCubemap :: RadiusCubemap (const RadiusFunction& radius_function)
+		: mv_samples(FACE_COUNT * SAMPLES_PER_FACE)
+{
+	assert(radius_function);
+
+	std::vector<Vector3> v_directions;
+	v_directions.reserve(mv_samples.size());
+	for(unsigned int face = 0; face < FACE_COUNT; face++)
+		for(unsigned int row = 0; row < SAMPLES_PER_EDGE; row++)
+			for(unsigned int column = 0; column < SAMPLES_PER_EDGE; column++)
+				v_directions.push_back(getSampleDirection(face, column, row));
+	assert(v_directions.size() == mv_samples.size());
+
+	radius_function((unsigned int)(v_directions.size()), v_directions.data(), mv_samples.data());
+
+	assert(!isEmpty());
+	assert(invariant());
+}
+
+
+
+double RadiusCubemap :: getRadius (const ObjLibrary::Vector3& direction) const
+{
+	assert(!isEmpty());
+	assert(!direction.isZero());
+
+	// choose the face the direction points through
+	double abs_x = fabs(direction.x);
+	double abs_y = fabs(direction.y);
+	double abs_z = fabs(direction.z);
+	unsigned int face;
+	double major;
+	double u;
+	double v;
+	if(abs_x >= abs_y && abs_x >= abs_z)
+	{
+		face  = (direction.x >= 0.0) ? 0 : 1;
+		major = abs_x;
+		u     = direction.y;
+		v     = direction.z;
+	}
+	else if(abs_y >= abs_z)
+	{
+		face  = (direction.y >= 0.0) ? 2 : 3;
+		major = abs_y;
+		u     = direction.z;
+		v     = direction.x;
+	}
+	else
+	{
+		face  = (direction.z >= 0.0) ? 4 : 5;
+		major = abs_z;
+		u     = direction.x;
+		v     = direction.y;
+	}
+	assert(major > 0.0);
+
+	// position on face in grid cells, in [0, RESOLUTION]
+	double column_real = (u / major + 1.0) * 0.5 * RESOLUTION;
+	double row_real    = (v / major + 1.0) * 0.5 * RESOLUTION;
+	unsigned int column = (unsigned int)(column_real);
+	unsigned int row    = (unsigned int)(row_real);
+	if(column >= RESOLUTION)
+		column = RESOLUTION - 1;
+	if(row >= RESOLUTION)
+		row = RESOLUTION - 1;
+	double column_fraction = column_real - column;
+	double row_fraction    = row_real    - row;
+
+	const float* p_corner = mv_samples.data() + face * SAMPLES_PER_FACE + row * SAMPLES_PER_EDGE + column;
+	double bottom = p_corner[0]                    + (p_corner[1]                    - p_corner[0])                    * column_fraction;
+	double top    = p_corner[SAMPLES_PER_EDGE]     + (p_corner[SAMPLES_PER_EDGE + 1] - p_corner[SAMPLES_PER_EDGE])     * column_fraction;
+	return bottom + (top - bottom) * row_fraction;
+}
+
+
+
+ObjLibrary::Vector3 RadiusCubemap :: getSampleDirection (unsigned int face,
+                                                         unsigned int column,
+                                                         unsigned int row)
+{
+	assert(face < FACE_COUNT);
+	assert(column <= RESOLUTION);
+	assert(row <= RESOLUTION);
+
+	double major = (face % 2 == 0) ? 1.0 : -1.0;
+	double u = column * 2.0 / RESOLUTION - 1.0;
+	double v = row    * 2.0 / RESOLUTION - 1.0;
+
+	// same axis order as getRadius
+	Vector3 direction;
+	switch(face / 2)
+	{
+	case 0:  direction = Vector3(major, u, v);  break;
+	case 1:  direction = Vector3(v, major, u);  break;
+	default: direction = Vector3(u, v, major);  break;
+	}
+	return direction.getNormalized();
+}
+
+bool RadiusCubemap :: invariant () const
+{
+	if(!mv_samples.empty() && mv_samples.size() != FACE_COUNT * SAMPLES_PER_FACE) return false;
+	return true;
+}
@@ -0,0 +1,168 @@
+//
+//  RadiusCubemap.h
+//
+//  A module to store the surface radius of a body in every
+//    direction as a table.
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  RadiusCubemap
+//
+//  A class to store a function of direction, such as the
+//    distance from the center of an irregular body to its
+//    surface, so that it can be looked up quickly.  The
+//    function is sampled at a grid of points on each face of a
+//    cube around the origin, and is then approximated with
+//    bilinear interpolation between the 4 nearest samples on
+//    the face the direction points through.
+//
+//  The samples on the edges of each face are shared with the
+//    neighbouring faces (they are the same directions), so the
+//    approximation is continuous everywhere, including across
+//    the cube edges.  The approximation is exact at the sample
+//    points.  Between them, the error depends on how quickly
+//    the function changes compared to the grid spacing, which
+//    is about 2 / RESOLUTION radians at the face centers and
+//    half that at the corners.
+//
+//  Class Invariant:
+//    <1> mv_samples.empty() ||
+//        mv_samples.size() == FACE_COUNT * SAMPLES_PER_FACE
+//
+class RadiusCubemap
+{
+public:
+//
+//  RESOLUTION
+//
+//  The number of grid cells along each edge of each cube
+//    face.  There are RESOLUTION + 1 samples along each edge.
+//
+	static const unsigned int RESOLUTION = 16;
+
+//
+//  RadiusFunction
+//
+//  The type of function sampled to fill a RadiusCubemap.  The
+//    parameters are the number of directions, an array of that
+//    many unit vectors, and an array to fill with the values
+//    for those directions.  All the samples are requested in a
+//    single call, ordered so that neighbouring samples are
+//    usually next to each other, so that the function can
+//    evaluate them in bulk.
+//
+	typedef std::function<void(unsigned int,
+	                           const ObjLibrary::Vector3*,
+	                           float*)> RadiusFunction;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty RadiusCubemap.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new RadiusCubemap is created.  It contains no
+//               samples.
+//
+	RadiusCubemap ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a RadiusCubemap by sampling the specified
+//           function.
+//  Parameter(s):
+//    <1> radius_function: The function to sample
+//  Preconditions:
+//    <1> radius_function
+//  Returns: N/A
+//  Side Effect: A new RadiusCubemap is created.  radius_function
+//               is called once with all the sample directions.
+//
+	RadiusCubemap (const RadiusFunction& radius_function);
+
+	RadiusCubemap (const RadiusCubemap& to_copy) = default;
+	~RadiusCubemap () = default;
+	RadiusCubemap& operator= (const RadiusCubemap& to_copy) = default;
+
+//
+//  isEmpty
+//
+//  Purpose: To determine if this RadiusCubemap contains any
+//           samples.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether this RadiusCubemap is empty.
+//  Side Effect: N/A
+//
+	bool isEmpty () const
+	{
+		return mv_samples.empty();
+	}
+
+//
+//  getRadius
+//
+//  Purpose: To determine the approximate value of the sampled
+//           function in the specified direction.
+//  Parameter(s):
+//    <1> direction: The direction
+//  Preconditions:
+//    <1> !isEmpty()
+//    <2> !direction.isZero()
+//  Returns: The value interpolated from the samples nearest to
+//           direction.  direction does not have to be
+//           normalized.
+//  Side Effect: N/A
+//
+	double getRadius (const ObjLibrary::Vector3& direction) const;
+
+private:
+//
+//  Helper Function: getSampleDirection
+//
+//  Purpose: To determine the direction for a sample.
+//  Parameter(s):
+//    <1> face: Which cube face
+//    <2> column: The sample column on the face
+//    <3> row: The sample row on the face
+//  Preconditions:
+//    <1> face < FACE_COUNT
+//    <2> column <= RESOLUTION
+//    <3> row <= RESOLUTION
+//  Returns: A unit vector in the direction of the sample.
+//  Side Effect: N/A
+//
+	static ObjLibrary::Vector3 getSampleDirection (unsigned int face,
+	                                               unsigned int column,
+	                                               unsigned int row);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	static const unsigned int FACE_COUNT       = 6;
+	static const unsigned int SAMPLES_PER_EDGE = RESOLUTION + 1;
+	static const unsigned int SAMPLES_PER_FACE = SAMPLES_PER_EDGE * SAMPLES_PER_EDGE;
+
+	std::vector<float> mv_samples;
+};
@@ -0,0 +1,323 @@
+//
+//  RenderQueue.cpp
+//
+//  This file is only used for display, so it is empty if
+//    HEADLESS_SIMULATION is defined.
+//
+
+#ifndef HEADLESS_SIMULATION
+
+#include "RenderQueue.h"
+
+#include <cassert>
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <functional>
+#include <algorithm>
+
+#include "GetGlut.h"
+#include "ObjLibrary/Vector3.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/MtlLibraryManager.h"
+#include "ObjLibrary/Texture.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/VertexBufferModel.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int COMMAND_MODEL_RANGE  = 0;
+	const unsigned int COMMAND_DISPLAY_LIST = 1;
+	const unsigned int COMMAND_CALLBACK     = 2;
+
+	// callbacks sort before everything else in their pass
+	const unsigned int MATERIAL_ID_CALLBACK = 0;
+	const unsigned int MATERIAL_ID_NONE     = 1;
+	const unsigned int MATERIAL_ID_FIRST    = 2;
+
+	const unsigned int TEXTURE_SHIFT  = RenderQueue::DEPTH_BITS;
+	const unsigned int MATERIAL_SHIFT = TEXTURE_SHIFT  + RenderQueue::TEXTURE_BITS;
+	const unsigned int PASS_SHIFT     = MATERIAL_SHIFT + RenderQueue::MATERIAL_BITS;
+	const uint64_t MATERIAL_MASK = (UINT64_C(1) << RenderQueue::MATERIAL_BITS) - 1;
+	const uint64_t TEXTURE_MASK  = (UINT64_C(1) << RenderQueue::TEXTURE_BITS)  - 1;
+	const uint64_t DEPTH_MAX     = (UINT64_C(1) << RenderQueue::DEPTH_BITS)    - 1;
+
+	static_assert(RenderQueue::PASS_BITS + RenderQueue::MATERIAL_BITS +
+	              RenderQueue::TEXTURE_BITS + RenderQueue::DEPTH_BITS == 64,
+	              "RenderQueue sort key must use 64 bits");
+	static_assert(RenderQueue::PASS_COUNT <= (1u << RenderQueue::PASS_BITS),
+	              "RenderQueue passes must fit in the sort key");
+}  // end of anonymous namespace
+
+
+
+uint64_t RenderQueue :: calculateSortKey (unsigned int pass,
+                                          unsigned int material,
+                                          unsigned int texture,
+                                          double depth)
+{
+	assert(pass < PASS_COUNT);
+
+	if(depth < 0.0)
+		depth = 0.0;
+	if(depth > 1.0)
+		depth = 1.0;
+	uint64_t depth_bits = (uint64_t)(depth * DEPTH_MAX);
+	if(pass == PASS_TRANSPARENT)
+		depth_bits = DEPTH_MAX - depth_bits;  // back to front
+
+	return ((uint64_t)(pass) << PASS_SHIFT) |
+	       (((uint64_t)(material) & MATERIAL_MASK) << MATERIAL_SHIFT) |
+	       (((uint64_t)(texture)  & TEXTURE_MASK)  << TEXTURE_SHIFT) |
+	       depth_bits;
+}
+
+
+
+RenderQueue :: RenderQueue ()
+		: mv_commands()
+		, mv_order()
+		, mv_callbacks()
+		, m_material_ids()
+		, m_material_unload_count(MtlLibraryManager::getUnloadCount())
+		, m_camera_position()
+		, m_far_distance(1.0)
+{
+	assert(getCommandCount() == 0);
+	assert(invariant());
+}
+
+
+
+void RenderQueue :: clear ()
+{
+	mv_commands.clear();
+	mv_order.clear();
+	mv_callbacks.clear();
+
+	// the Materials may have been deleted
+	unsigned int unload_count = MtlLibraryManager::getUnloadCount();
+	if(unload_count != m_material_unload_count)
+	{
+		m_material_ids.clear();
+		m_material_unload_count = unload_count;
+	}
+
+	assert(getCommandCount() == 0);
+	assert(invariant());
+}
+
+void RenderQueue :: setCamera (const ObjLibrary::Vector3& position,
+                               double far_distance)
+{
+	assert(far_distance > 0.0);
+
+	m_camera_position = position;
+	m_far_distance    = far_distance;
+
+	assert(invariant());
+}
+
+void RenderQueue :: addModel (unsigned int pass,
+                              const ObjLibrary::VertexBufferModel& model,
+                              const double a_matrix[])
+{
+	assert(pass < PASS_COUNT);
+	assert(model.isReady());
+	assert(a_matrix != nullptr);
+
+	Command command;
+	command.m_type            = COMMAND_MODEL_RANGE;
+	command.mp_model          = &model;
+	command.mp_display_list   = NULL;
+	command.m_callback        = 0;
+	for(unsigned int i = 0; i < 16; i++)
+		command.ma_matrix[i] = a_matrix[i];
+
+	double depth = calculateDepth(a_matrix);
+	for(unsigned int r = 0; r < model.getMaterialRangeCount(); r++)
+	{
+		const Material* p_material = model.getMaterialRangeMaterial(r);
+		unsigned int texture = 0;
+		if(p_material != NULL && p_material->isDiffuseMap())
+		{
+			const Texture* p_texture = p_material->getDiffuseMap();
+			if(p_texture != NULL)
+				texture = p_texture->getOpenGLName();
+		}
+
+		command.m_sort_key  = calculateSortKey(pass, getMaterialId(p_material), texture, depth);
+		command.m_range     = r;
+		command.mp_material = p_material;
+		addCommand(command);
+	}
+
+	assert(invariant());
+}
+
+void RenderQueue :: addDisplayList (unsigned int pass,
+                                    const ObjLibrary::DisplayList& display_list,
+                                    const double a_matrix[])
+{
+	assert(pass < PASS_COUNT);
+	assert(display_list.isReady());
+	assert(a_matrix != nullptr);
+
+	Command command;
+	command.m_sort_key        = calculateSortKey(pass, MATERIAL_ID_NONE, 0, calculateDepth(a_matrix));
+	command.m_type            = COMMAND_DISPLAY_LIST;
+	command.mp_model          = NULL;
+	command.m_range           = 0;
+	command.mp_material       = NULL;
+	command.mp_display_list   = &display_list;
+	command.m_callback        = 0;
+	for(unsigned int i = 0; i < 16; i++)
+		command.ma_matrix[i] = a_matrix[i];
+	addCommand(command);
+
+	assert(invariant());
+}
+
+void RenderQueue :: addCallback (unsigned int pass,
+                                 const std::function<void ()>& callback)
+{
+	assert(pass < PASS_COUNT);
+	assert(callback);
+
+	Command command;
+	command.m_sort_key        = calculateSortKey(pass, MATERIAL_ID_CALLBACK, 0, 0.0);
+	command.m_type            = COMMAND_CALLBACK;
+	command.mp_model          = NULL;
+	command.m_range           = 0;
+	command.mp_material       = NULL;
+	command.mp_display_list   = NULL;
+	command.m_callback        = (unsigned int)(mv_callbacks.size());
+	mv_callbacks.push_back(callback);
+	addCommand(command);
+
+	assert(invariant());
+}
+
+void RenderQueue :: execute ()
+{
+	assert(!Material::isMaterialActive());
+	assert(!Material::isStateCacheEnabled());
+
+	stable_sort(mv_order.begin(), mv_order.end(),
+	            [this] (unsigned int a, unsigned int b)
+	            {
+	                return mv_commands[a].m_sort_key < mv_commands[b].m_sort_key;
+	            });
+
+	unsigned int current_pass = PASS_COUNT;
+	for(unsigned int i = 0; i < mv_order.size(); i++)
+	{
+		const Command& command = mv_commands[mv_order[i]];
+
+		// the state cache would restore the depth mask when popped
+		unsigned int pass = (unsigned int)(command.m_sort_key >> PASS_SHIFT);
+		if(pass != current_pass)
+		{
+			Material::setStateCacheEnabled(false);
+			glDepthMask(pass == PASS_SKYBOX ? GL_FALSE : GL_TRUE);
+			current_pass = pass;
+		}
+
+		if(command.m_type == COMMAND_MODEL_RANGE)
+		{
+			// consecutive ranges with the same Material skip
+			//   activating it again
+			Material::setStateCacheEnabled(true);
+
+			glPushMatrix();
+				glMultMatrixd(command.ma_matrix);
+
+				// same passes as VertexBufferModel::drawMaterialRange
+				const Material* p_material = command.mp_material;
+				if(p_material == NULL)
+					command.mp_model->drawMaterialRangeCurrent(command.m_range);
+				else
+				{
+					p_material->activate();
+					command.mp_model->drawMaterialRangeCurrent(command.m_range);
+					Material::deactivate();
+
+					if(p_material->isSeperateSpecular())
+					{
+						p_material->activateSeperateSpecular();
+						command.mp_model->drawMaterialRangeCurrent(command.m_range);
+						Material::deactivate();
+					}
+				}
+			glPopMatrix();
+		}
+		else
+		{
+			// DisplayLists and callbacks may draw without a Material
+			Material::setStateCacheEnabled(false);
+
+			if(command.m_type == COMMAND_DISPLAY_LIST)
+			{
+				glPushMatrix();
+					glMultMatrixd(command.ma_matrix);
+					command.mp_display_list->draw();
+				glPopMatrix();
+			}
+			else
+			{
+				assert(command.m_type == COMMAND_CALLBACK);
+				assert(command.m_callback < mv_callbacks.size());
+				mv_callbacks[command.m_callback]();
+			}
+		}
+	}
+
+	Material::setStateCacheEnabled(false);
+	glDepthMask(GL_TRUE);
+
+	assert(!Material::isMaterialActive());
+	assert(invariant());
+}
+
+
+
+unsigned int RenderQueue :: getMaterialId (const ObjLibrary::Material* p_material)
+{
+	if(p_material == NULL)
+		return MATERIAL_ID_NONE;
+
+	map<const Material*, unsigned int>::const_iterator found = m_material_ids.find(p_material);
+	if(found != m_material_ids.end())
+		return found->second;
+
+	unsigned int id = MATERIAL_ID_FIRST + (unsigned int)(m_material_ids.size());
+	if(id > MATERIAL_MASK)
+		return MATERIAL_ID_NONE;  // out of identifiers, so don't batch it
+	m_material_ids[p_material] = id;
+	return id;
+}
+
+double RenderQueue :: calculateDepth (const double a_matrix[]) const
+{
+	assert(a_matrix != nullptr);
+
+	Vector3 position(a_matrix[12], a_matrix[13], a_matrix[14]);
+	return position.getDistance(m_camera_position) / m_far_distance;
+}
+
+void RenderQueue :: addCommand (const Command& command)
+{
+	mv_order.push_back((unsigned int)(mv_commands.size()));
+	mv_commands.push_back(command);
+}
+
+bool RenderQueue :: invariant () const
+{
+	if(mv_order.size() != mv_commands.size()) return false;
+	if(m_far_distance <= 0.0) return false;
+	return true;
+}
+
+#endif
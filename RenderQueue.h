@@ -0,0 +1,353 @@
+//
+//  RenderQueue.h
+//
+//  A module to collect draw commands for a frame and execute
+//    them in an order that minimizes OpenGL state changes.
+//
+
+#pragma once
+
+#include <cstdint>
+#include <vector>
+#include <map>
+#include <functional>
+
+#include "ObjLibrary/Vector3.h"
+
+namespace ObjLibrary
+{
+	class Material;
+	class DisplayList;
+	class VertexBufferModel;
+}
+
+
+
+//
+//  RenderQueue
+//
+//  A class to collect the draw commands for a frame, sort them,
+//    and execute them all in one place.  Each command has a
+//    64-bit sort key made of, from the most significant bits:
+//    <1> the pass (PASS_BITS bits)
+//    <2> the Material (MATERIAL_BITS bits)
+//    <3> the texture (TEXTURE_BITS bits)
+//    <4> the depth (DEPTH_BITS bits)
+//
+//  Commands in the same pass with the same Material are executed
+//    one after another with the Material state cache enabled,
+//    so the Material state is only set once for all of them.
+//    Opaque commands are drawn front to back
+//    and transparent ones back to front.  Commands with the same
+//    key are executed in the order they were added.
+//
+//  There are three kinds of commands:
+//    <1> A material range of a VertexBufferModel.  These are
+//        the only commands that share Material activations.
+//    <2> A DisplayList.  Any Materials are stored inside the
+//        DisplayList, so these cannot be batched.
+//    <3> A callback function, for drawing that is not a model,
+//        such as lines and the instanced asteroids.
+//  The first two kinds are plain data, so they could be created
+//    on another thread.  Models and DisplayLists are stored by
+//    pointer, so they must exist until the RenderQueue is
+//    executed or cleared.
+//
+//  The identifiers for Materials are remembered between frames.
+//    They are forgotten when the RenderQueue is cleared after the
+//    material libraries have been unloaded, so a new Material at
+//    the address of a deleted one is not given its identifier.
+//    If there are more Materials than will fit in MATERIAL_BITS
+//    bits, the rest are sorted as if they had no Material.  They
+//    are still drawn correctly, but are not batched.
+//
+//  Class Invariant:
+//    <1> mv_order.size() == mv_commands.size()
+//    <2> m_far_distance > 0.0
+//
+class RenderQueue
+{
+public:
+//
+//  PASS_SKYBOX
+//  PASS_OPAQUE
+//  PASS_TRANSPARENT
+//  PASS_OVERLAY
+//
+//  The passes of a frame, in the order they are drawn.  The
+//    depth buffer is not written in PASS_SKYBOX.  Commands in
+//    PASS_TRANSPARENT are drawn from back to front.
+//
+	static const unsigned int PASS_SKYBOX      = 0;
+	static const unsigned int PASS_OPAQUE      = 1;
+	static const unsigned int PASS_TRANSPARENT = 2;
+	static const unsigned int PASS_OVERLAY     = 3;
+
+//
+//  PASS_COUNT
+//
+//  The number of passes.
+//
+	static const unsigned int PASS_COUNT = 4;
+
+//
+//  PASS_BITS
+//  MATERIAL_BITS
+//  TEXTURE_BITS
+//  DEPTH_BITS
+//
+//  The number of bits used for each part of the sort key.
+//
+	static const unsigned int PASS_BITS     =  4;
+	static const unsigned int MATERIAL_BITS = 16;
+	static const unsigned int TEXTURE_BITS  = 16;
+	static const unsigned int DEPTH_BITS    = 28;
+
+//
+//  calculateSortKey
+//
+//  Purpose: To calculate the sort key for a command.
+//  Parameter(s):
+//    <1> pass: The pass
+//    <2> material: The identifier for the Material
+//    <3> texture: The identifier for the texture
+//    <4> depth: The depth, as a fraction of the far distance
+//  Preconditions:
+//    <1> pass < PASS_COUNT
+//  Returns: The sort key.  material and texture are truncated
+//           to MATERIAL_BITS and TEXTURE_BITS bits, and depth
+//           is clamped to the range [0.0, 1.0] and quantized
+//           to DEPTH_BITS bits.  If pass is PASS_TRANSPARENT,
+//           the depth order is reversed.
+//  Side Effect: N/A
+//
+	static uint64_t calculateSortKey (unsigned int pass,
+	                                  unsigned int material,
+	                                  unsigned int texture,
+	                                  double depth);
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new RenderQueue is created with no commands
+//               and the camera at the origin with a far
+//               distance of 1.0.
+//
+	RenderQueue ();
+
+	RenderQueue (const RenderQueue& to_copy) = default;
+	~RenderQueue () = default;
+	RenderQueue& operator= (const RenderQueue& to_copy) = default;
+
+//
+//  getCommandCount
+//
+//  Purpose: To determine how many commands are in this
+//           RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of commands.
+//  Side Effect: N/A
+//
+	unsigned int getCommandCount () const
+	{
+		return (unsigned int)(mv_commands.size());
+	}
+
+//
+//  clear
+//
+//  Purpose: To remove all commands from this RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This RenderQueue is emptied.  The memory is
+//               kept for the next frame.  If the material
+//               libraries have been unloaded since the last
+//               time, the Material identifiers are forgotten.
+//
+	void clear ();
+
+//
+//  setCamera
+//
+//  Purpose: To set the camera that command depths are
+//           measured from.
+//  Parameter(s):
+//    <1> position: The camera position
+//    <2> far_distance: The distance to the far clipping plane
+//  Preconditions:
+//    <1> far_distance > 0.0
+//  Returns: N/A
+//  Side Effect: Commands added after this use the specified
+//               camera to calculate their depths.
+//
+	void setCamera (const ObjLibrary::Vector3& position,
+	                double far_distance);
+
+//
+//  addModel
+//
+//  Purpose: To add a command to draw each material range of the
+//           specified VertexBufferModel.
+//  Parameter(s):
+//    <1> pass: The pass to draw in
+//    <2> model: The VertexBufferModel
+//    <3> a_matrix: The model transformation matrix, in the
+//                  format used by glMultMatrixd
+//  Preconditions:
+//    <1> pass < PASS_COUNT
+//    <2> model.isReady()
+//    <3> a_matrix != nullptr
+//  Returns: N/A
+//  Side Effect: One command is added for each material range of
+//               model.  model must exist until this RenderQueue
+//               is executed or cleared.
+//
+	void addModel (unsigned int pass,
+	               const ObjLibrary::VertexBufferModel& model,
+	               const double a_matrix[]);
+
+//
+//  addDisplayList
+//
+//  Purpose: To add a command to draw the specified DisplayList.
+//  Parameter(s):
+//    <1> pass: The pass to draw in
+//    <2> display_list: The DisplayList
+//    <3> a_matrix: The model transformation matrix, in the
+//                  format used by glMultMatrixd
+//  Preconditions:
+//    <1> pass < PASS_COUNT
+//    <2> display_list.isReady()
+//    <3> a_matrix != nullptr
+//  Returns: N/A
+//  Side Effect: A command is added to draw display_list.
+//               display_list must exist until this RenderQueue
+//               is executed or cleared.
+//
+	void addDisplayList (unsigned int pass,
+	                     const ObjLibrary::DisplayList& display_list,
+	                     const double a_matrix[]);
+
+//
+//  addCallback
+//
+//  Purpose: To add a command to call the specified function.
+//  Parameter(s):
+//    <1> pass: The pass to call it in
+//    <2> callback: The function to call
+//  Preconditions:
+//    <1> pass < PASS_COUNT
+//    <2> callback
+//  Returns: N/A
+//  Side Effect: A command is added to call callback.  It is
+//               called before any model in the same pass, with
+//               no Material active and the current matrix
+//               unchanged.
+//
+	void addCallback (unsigned int pass,
+	                  const std::function<void ()>& callback);
+
+//
+//  execute
+//
+//  Purpose: To execute the commands in this RenderQueue.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> !ObjLibrary::Material::isMaterialActive()
+//    <2> !ObjLibrary::Material::isStateCacheEnabled()
+//  Returns: N/A
+//  Side Effect: The commands are sorted by their keys and
+//               executed.  The commands are not removed.  The
+//               Material state cache is disabled afterwards.
+//
+	void execute ();
+
+private:
+//
+//  Command
+//
+//  A record to store one command.  Only the fields for the
+//    kind of command are used.
+//
+	struct Command
+	{
+		uint64_t m_sort_key;
+		unsigned int m_type;
+		const ObjLibrary::VertexBufferModel* mp_model;
+		unsigned int m_range;
+		const ObjLibrary::Material* mp_material;
+		const ObjLibrary::DisplayList* mp_display_list;
+		unsigned int m_callback;
+		double ma_matrix[16];
+	};
+
+//
+//  getMaterialId
+//
+//  Purpose: To determine the identifier for the specified
+//           Material.
+//  Parameter(s):
+//    <1> p_material: A pointer to the Material
+//  Preconditions: N/A
+//  Returns: The identifier for p_material.  If p_material is
+//           NULL or there are no identifiers left, the
+//           identifier for no Material is returned.
+//  Side Effect: If p_material has not been seen before and
+//               there is an identifier left, it is assigned the
+//               next identifier.
+//
+	unsigned int getMaterialId (const ObjLibrary::Material* p_material);
+
+//
+//  calculateDepth
+//
+//  Purpose: To calculate the depth for a command.
+//  Parameter(s):
+//    <1> a_matrix: The model transformation matrix
+//  Preconditions:
+//    <1> a_matrix != nullptr
+//  Returns: The distance from the camera to the origin of the
+//           model, as a fraction of the far distance.
+//  Side Effect: N/A
+//
+	double calculateDepth (const double a_matrix[]) const;
+
+//
+//  addCommand
+//
+//  Purpose: To add the specified command.
+//  Parameter(s):
+//    <1> command: The command
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: command is added to this RenderQueue.
+//
+	void addCommand (const Command& command);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	std::vector<Command> mv_commands;
+	std::vector<unsigned int> mv_order;
+	std::vector<std::function<void ()>> mv_callbacks;
+	std::map<const ObjLibrary::Material*, unsigned int> m_material_ids;
+	unsigned int m_material_unload_count;
+	ObjLibrary::Vector3 m_camera_position;
+	double m_far_distance;
+};
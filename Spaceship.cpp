@@ -9,13 +9,18 @@
 #include <cassert>
 #include <cmath>
 
+#ifndef HEADLESS_SIMULATION
 #include "GetGlut.h"
+#endif
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
 #include "Drone.h"
+#include "TrajectoryCache.h"
 
 using namespace ObjLibrary;
 Vector3 Doffset[5];
@@ -32,6 +37,7 @@ Spaceship :: Spaceship ()
 	assert(invariant());
 }
 
+#ifndef HEADLESS_SIMULATION
 Spaceship :: Spaceship (const ObjLibrary::Vector3& position,
                         const ObjLibrary::Vector3& velocity,
                         double mass,
@@ -55,6 +61,29 @@ Spaceship :: Spaceship (const ObjLibrary::Vector3& position,
 	assert(isInitialized());
 	assert(invariant());
 }
+#endif
+
+Spaceship :: Spaceship (const ObjLibrary::Vector3& position,
+                        const ObjLibrary::Vector3& velocity,
+                        double mass,
+                        double radius,
+                        double acceleration_main,
+                        double acceleration_manoeuver,
+                        double rotation_rate_radians)
+		: Entity(position, velocity, mass, radius)
+		, m_is_alive(true)
+		, m_acceleration_main(acceleration_main)
+		, m_acceleration_manoeuver(acceleration_manoeuver)
+		, m_rotation_rate_radians(rotation_rate_radians)
+{
+	assert(mass                   >  0.0);
+	assert(radius                 >= 0.0);
+	assert(acceleration_main      >  0.0);
+	assert(acceleration_manoeuver >  0.0);
+	assert(rotation_rate_radians  >  0.0);
+	assert(isInitialized());
+	assert(invariant());
+}
 
 Vector3 Spaceship :: getFollowCameraPosition (double back_distance,
                                               double up_distance) const
@@ -67,6 +96,7 @@ Vector3 Spaceship :: getFollowCameraPosition (double back_distance,
 	return camera.getPosition();
 }
 
+#ifndef HEADLESS_SIMULATION
 void Spaceship :: setupFollowCamera (double back_distance,
                                      double up_distance) const
 {
@@ -80,26 +110,30 @@ void Spaceship :: setupFollowCamera (double back_distance,
 
 void Spaceship :: drawPath (const Entity& black_hole,
                             unsigned int point_count,
-                            const ObjLibrary::Vector3& colour) const
+                            const ObjLibrary::Vector3& colour,
+                            double current_time,
+                            TrajectoryCache& r_cache) const
 {
 	assert(isInitialized());
+	assert(point_count >= 1);
 
-	Spaceship future = *this;
+	double distance   = black_hole.getPosition().getDistance(getPosition());
+	double delta_time = sqrt(distance) / 25.0;
+	if(delta_time > 0.0)
+		r_cache.update(*this, black_hole, current_time, delta_time, point_count);
+	else
+		r_cache.invalidate();
 
 	glBegin(GL_LINE_STRIP);
 		glColor3d(colour.x, colour.y, colour.z);
-		glVertex3d(future.getPosition().x, future.getPosition().y, future.getPosition().z);
+		glVertex3d(getPosition().x, getPosition().y, getPosition().z);
 
-		for(unsigned int i = 1; i < point_count; i++)
+		for(unsigned int i = 1; i <= r_cache.getPointCount(); i++)
 		{
-			double distance   = black_hole.getPosition().getDistance(getPosition());
-			double delta_time = sqrt(distance) / 25.0;
-
-			future.updatePhysics(delta_time, black_hole);
-
+			const Vector3& point = r_cache.getPoint(i - 1);
 			double fraction = sqrt(1.0 - (double)(i) / point_count);
 			glColor3d(colour.x * fraction, colour.y * fraction, colour.z * fraction);
-			glVertex3d(future.getPosition().x, future.getPosition().y, future.getPosition().z);
+			glVertex3d(point.x, point.y, point.z);
 		}
 	glEnd();
 
@@ -144,6 +178,7 @@ void Spaceship::drawFutureD(const Entity& black_hole, const Entity& Drone, int c
 	glutWireOctahedron();
 	glPopMatrix();
 }
+#endif
 
 void Spaceship :: markDead ()
 {
@@ -160,6 +195,10 @@ void Spaceship :: thrustMainEngine (double delta_time)
 	assert(m_coords.getForward().isUnit());
 	m_velocity += m_coords.getForward() * m_acceleration_main * delta_time;
 
+	// thrust while paused or warping does not change the path
+	if(delta_time > 0.0)
+		markTrajectoryChanged();
+
 	assert(invariant());
 }
 
@@ -171,6 +210,8 @@ void Spaceship :: thrustManoeuver (double delta_time,
 	assert(direction_world.isUnit());
 
 	m_velocity += direction_world * m_acceleration_manoeuver * delta_time;
+	if(delta_time > 0.0)
+		markTrajectoryChanged();
 
 	assert(invariant());
 }
@@ -225,6 +266,7 @@ bool Spaceship :: invariant () const
 	return true;
 }
 
+#ifndef HEADLESS_SIMULATION
 // drawing current position of chasing drone with white torus
 void Spaceship::drawDroneschase(ObjLibrary::Vector3 ShipLo, int chase)
 {
@@ -336,6 +378,7 @@ void Spaceship::drawDronesdead(ObjLibrary::Vector3 ShipLo)
 	glutWireTorus(0.5, 1.4, 10, 8);
 	glPopMatrix();
 }
+#endif
 
 // Sendding escort coordinate to drones
 Vector3 Spaceship::SendPosition(int droneN)
@@ -9,11 +9,14 @@
 #include <cassert>
 
 #include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
 #include "ObjLibrary/DisplayList.h"
+#endif
 
 #include "CoordinateSystem.h"
 #include "Entity.h"
 #include "Drone.h"
+#include "TrajectoryCache.h"
 
 
 
@@ -43,6 +46,7 @@ public:
 //
 	Spaceship ();
 
+#ifndef HEADLESS_SIMULATION
 //
 //  Constructor
 //
@@ -81,6 +85,43 @@ public:
 	           double acceleration_manoeuver,
 	           double rotation_rate_radians,
 	           const ObjLibrary::DisplayList& display_list);
+#endif
+
+//
+//  Constructor
+//
+//  Purpose: To create an Spaceship with the specified position,
+//           velocity, mass, and radius that cannot be
+//           displayed.
+//  Parameter(s):
+//    <1> position: The starting position
+//    <2> velocity: The starting velocity
+//    <3> mass: The mass when the fuel tanks are empty
+//    <4> radius: The outer collision radius
+//    <5> acceleration_main: The acceleration provided by the
+//                           main engine
+//    <6> acceleration_manoeuver: The acceleration provided by
+//                                the manoeuvering engine
+//    <7> rotation_rate_radians: The rotation rate in radians
+//                               per second
+//  Preconditions:
+//    <1> mass                   >  0.0
+//    <2> radius                 >= 0.0
+//    <3> acceleration_main      >  0.0
+//    <4> acceleration_manoeuver >  0.0
+//    <5> rotation_rate_radians  >  0.0
+//  Returns: N/A
+//  Side Effect: A new Spaceship is created at position position
+//               with velocity velocity.  It has a mass of mass
+//               and a radius of radius.  It has no DisplayList.
+//
+	Spaceship (const ObjLibrary::Vector3& position,
+	           const ObjLibrary::Vector3& velocity,
+	           double mass,
+	           double radius,
+	           double acceleration_main,
+	           double acceleration_manoeuver,
+	           double rotation_rate_radians);
 
 	Spaceship (const Spaceship& to_copy) = default;
 	~Spaceship () = default;
@@ -123,6 +164,7 @@ public:
 	                                  double back_distance,
 	                                  double up_distance) const;
 
+#ifndef HEADLESS_SIMULATION
 //
 //  setupFollowCamera
 //
@@ -153,17 +195,25 @@ public:
 //    <1> black_hole: The black hole
 //    <2> point_count: How many points ahead to display
 //    <3> colour: How colour of the path
+//    <4> current_time: The current simulation time
+//    <5> r_cache: The TrajectoryCache for this Spaceship
 //  Preconditions:
 //    <1> isInitialized()
+//    <2> point_count >= 1
 //  Returns: N/A
-//  Side Effect: A path of point_count vertexes is displayed for
-//               this Spaceship is displayed.  It will start
-//               with a colour of colour and then fade to black
-//               at the end.
+//  Side Effect: r_cache is updated for this Spaceship, which
+//               only recalculates the path if this Spaceship
+//               has changed course.  A path of point_count
+//               vertexes is displayed for this Spaceship.  It
+//               will start with a colour of colour and then
+//               fade to black at the end.
 //
 	void drawPath (const Entity& black_hole,
 	               unsigned int point_count,
-	               const ObjLibrary::Vector3& colour) const;
+	               const ObjLibrary::Vector3& colour,
+	               double current_time,
+	               TrajectoryCache& r_cache) const;
+#endif
 
 //
 //  markDead
@@ -189,7 +239,9 @@ public:
 //    <1> isInitialized()
 //    <2> delta_time >= 0.0
 //  Returns: N/A
-//  Side Effect: This spaceship accelerates forward.
+//  Side Effect: This spaceship accelerates forward.  If
+//               delta_time > 0.0, it is given a new trajectory
+//               identifier.
 //
 	void thrustMainEngine (double delta_time);
 
@@ -208,7 +260,8 @@ public:
 //    <3> direction_world.isUnit()
 //  Returns: N/A
 //  Side Effect: This spaceship accelerates in direction
-//               direction_world.
+//               direction_world.  If delta_time > 0.0, it is
+//               given a new trajectory identifier.
 //
 	void thrustManoeuver (
 	                double delta_time,
@@ -246,10 +299,12 @@ public:
 //  Side Effect: N/A
 //
 	bool invariant () const;
+#ifndef HEADLESS_SIMULATION
 	void drawDronesdead(ObjLibrary::Vector3 ShipLo);
 	void drawDroneschase(ObjLibrary::Vector3 ShipLo, int chase);
 	void drawDrones(ObjLibrary::Vector3 ShipLo, int live);
 	void drawFutureD(const Entity& black_hole, const Entity& Drone, int color) const;
+#endif
 	ObjLibrary::Vector3 SendPosition(int droneN);
 
 
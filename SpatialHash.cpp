@@ -0,0 +1,284 @@
+//
+//  SpatialHash.cpp
+//
+
+#include "SpatialHash.h"
+
+#include <cassert>
+#include <cmath>
+#include <climits>
+#include <vector>
+#include <utility>    // for pair
+#include <algorithm>  // for min/max/sort/unique
+
+#include "ObjLibrary/Vector3.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const unsigned int BUCKET_COUNT_MIN = 16;
+
+	// large primes for hashing cell coordinates
+	const unsigned int HASH_PRIME_X = 73856093;
+	const unsigned int HASH_PRIME_Y = 19349663;
+	const unsigned int HASH_PRIME_Z = 83492791;
+
+}  // end of anonymous namespace
+
+
+
+SpatialHash :: SpatialHash ()
+		: m_cell_size(1.0)
+		, m_is_built(false)
+		, m_bucket_mask(0)
+		, mv_spheres()
+		, mv_huge_spheres()
+		, mv_entries()
+		, mv_sorted_entries()
+		, mv_bucket_starts()
+{
+	assert(invariant());
+}
+
+
+
+void SpatialHash :: getCandidatePairs (vector<pair<unsigned int, unsigned int> >& rv_pairs) const
+{
+	assert(isBuilt());
+
+	rv_pairs.clear();
+
+	// pairs in the same cell
+	unsigned int bucket_count = m_bucket_mask + 1;
+	for(unsigned int b = 0; b < bucket_count; b++)
+	{
+		unsigned int end = mv_bucket_starts[b + 1];
+		for(unsigned int e1 = mv_bucket_starts[b]; e1 < end; e1++)
+		{
+			const Entry&  entry1  = mv_sorted_entries[e1];
+			const Sphere& sphere1 = mv_spheres[entry1.m_sphere];
+
+			for(unsigned int e2 = e1 + 1; e2 < end; e2++)
+			{
+				const Entry& entry2 = mv_sorted_entries[e2];
+				if(entry2.m_x != entry1.m_x ||
+				   entry2.m_y != entry1.m_y ||
+				   entry2.m_z != entry1.m_z)
+				{
+					continue;  // different cell, same bucket
+				}
+
+				const Sphere& sphere2 = mv_spheres[entry2.m_sphere];
+				if(sphere1.m_is_passive && sphere2.m_is_passive)
+					continue;
+				if(!isFirstSharedCell(sphere1, sphere2, entry1))
+					continue;  // reported in another cell
+
+				if(sphere1.m_id < sphere2.m_id)
+					rv_pairs.push_back(make_pair(sphere1.m_id, sphere2.m_id));
+				else
+					rv_pairs.push_back(make_pair(sphere2.m_id, sphere1.m_id));
+			}
+		}
+	}
+
+	// huge spheres are paired with everything
+	for(unsigned int h = 0; h < mv_huge_spheres.size(); h++)
+	{
+		unsigned int huge_index = mv_huge_spheres[h];
+		const Sphere& huge = mv_spheres[huge_index];
+
+		for(unsigned int s = 0; s < mv_spheres.size(); s++)
+		{
+			const Sphere& other = mv_spheres[s];
+			if(other.m_is_huge && s <= huge_index)
+				continue;  // pair of huge spheres already reported
+			if(huge.m_is_passive && other.m_is_passive)
+				continue;
+
+			if(huge.m_id < other.m_id)
+				rv_pairs.push_back(make_pair(huge.m_id, other.m_id));
+			else
+				rv_pairs.push_back(make_pair(other.m_id, huge.m_id));
+		}
+	}
+}
+
+void SpatialHash :: getCandidates (const ObjLibrary::Vector3& center,
+                                   double radius,
+                                   vector<unsigned int>& rv_ids) const
+{
+	assert(isBuilt());
+	assert(radius >= 0.0);
+
+	rv_ids.clear();
+
+	int min_x = toCell(center.x - radius);
+	int min_y = toCell(center.y - radius);
+	int min_z = toCell(center.z - radius);
+	int max_x = toCell(center.x + radius);
+	int max_y = toCell(center.y + radius);
+	int max_z = toCell(center.z + radius);
+
+	double cell_count = (max_x - (double)(min_x) + 1.0) *
+	                    (max_y - (double)(min_y) + 1.0) *
+	                    (max_z - (double)(min_z) + 1.0);
+	if(cell_count > MAX_CELLS_PER_SPHERE)
+	{
+		// too many cells to check, so return everything
+		for(unsigned int s = 0; s < mv_spheres.size(); s++)
+			rv_ids.push_back(mv_spheres[s].m_id);
+	}
+	else
+	{
+		for(int x = min_x; x <= max_x; x++)
+			for(int y = min_y; y <= max_y; y++)
+				for(int z = min_z; z <= max_z; z++)
+				{
+					unsigned int b = getBucket(x, y, z);
+					for(unsigned int e = mv_bucket_starts[b]; e < mv_bucket_starts[b + 1]; e++)
+					{
+						const Entry& entry = mv_sorted_entries[e];
+						if(entry.m_x == x && entry.m_y == y && entry.m_z == z)
+							rv_ids.push_back(mv_spheres[entry.m_sphere].m_id);
+					}
+				}
+
+		for(unsigned int h = 0; h < mv_huge_spheres.size(); h++)
+			rv_ids.push_back(mv_spheres[mv_huge_spheres[h]].m_id);
+	}
+
+	sort(rv_ids.begin(), rv_ids.end());
+	rv_ids.erase(unique(rv_ids.begin(), rv_ids.end()), rv_ids.end());
+}
+
+
+
+void SpatialHash :: clear (double cell_size)
+{
+	assert(cell_size > 0.0);
+
+	m_cell_size = cell_size;
+	m_is_built = false;
+	mv_spheres.clear();
+	mv_huge_spheres.clear();
+	mv_entries.clear();
+	mv_sorted_entries.clear();
+
+	assert(invariant());
+}
+
+void SpatialHash :: insert (unsigned int id,
+                            const ObjLibrary::Vector3& center,
+                            double radius,
+                            bool is_passive)
+{
+	assert(radius >= 0.0);
+	assert(center.isFinite());
+
+	Sphere sphere;
+	sphere.m_id         = id;
+	sphere.m_is_passive = is_passive;
+	sphere.m_min_x = toCell(center.x - radius);
+	sphere.m_min_y = toCell(center.y - radius);
+	sphere.m_min_z = toCell(center.z - radius);
+	sphere.m_max_x = toCell(center.x + radius);
+	sphere.m_max_y = toCell(center.y + radius);
+	sphere.m_max_z = toCell(center.z + radius);
+
+	double cell_count = (sphere.m_max_x - (double)(sphere.m_min_x) + 1.0) *
+	                    (sphere.m_max_y - (double)(sphere.m_min_y) + 1.0) *
+	                    (sphere.m_max_z - (double)(sphere.m_min_z) + 1.0);
+	sphere.m_is_huge = (cell_count > MAX_CELLS_PER_SPHERE);
+
+	unsigned int sphere_index = (unsigned int)(mv_spheres.size());
+	mv_spheres.push_back(sphere);
+
+	if(sphere.m_is_huge)
+		mv_huge_spheres.push_back(sphere_index);
+	else
+	{
+		Entry entry;
+		entry.m_sphere = sphere_index;
+		for(entry.m_x = sphere.m_min_x; entry.m_x <= sphere.m_max_x; entry.m_x++)
+			for(entry.m_y = sphere.m_min_y; entry.m_y <= sphere.m_max_y; entry.m_y++)
+				for(entry.m_z = sphere.m_min_z; entry.m_z <= sphere.m_max_z; entry.m_z++)
+					mv_entries.push_back(entry);
+	}
+
+	m_is_built = false;
+	assert(invariant());
+}
+
+void SpatialHash :: build ()
+{
+	// choose a power-of-2 table size with a load factor <= 0.5
+	unsigned int bucket_count = BUCKET_COUNT_MIN;
+	while(bucket_count < mv_entries.size() * 2)
+		bucket_count *= 2;
+	m_bucket_mask = bucket_count - 1;
+
+	// counting sort entries by bucket
+	mv_bucket_starts.assign(bucket_count + 1, 0);
+	for(unsigned int e = 0; e < mv_entries.size(); e++)
+	{
+		const Entry& entry = mv_entries[e];
+		mv_bucket_starts[getBucket(entry.m_x, entry.m_y, entry.m_z) + 1]++;
+	}
+	for(unsigned int b = 0; b < bucket_count; b++)
+		mv_bucket_starts[b + 1] += mv_bucket_starts[b];
+
+	mv_sorted_entries.resize(mv_entries.size());
+	vector<unsigned int>::iterator next_begin = mv_bucket_starts.begin();
+	vector<unsigned int> v_next(next_begin, next_begin + bucket_count);
+	for(unsigned int e = 0; e < mv_entries.size(); e++)
+	{
+		const Entry& entry = mv_entries[e];
+		unsigned int b = getBucket(entry.m_x, entry.m_y, entry.m_z);
+		mv_sorted_entries[v_next[b]] = entry;
+		v_next[b]++;
+	}
+
+	m_is_built = true;
+	assert(invariant());
+}
+
+
+
+int SpatialHash :: toCell (double value) const
+{
+	// leave room to loop up to the maximum without overflowing
+	//   and written so that NaN is clamped too
+	double cell = floor(value / m_cell_size);
+	if(!(cell >= INT_MIN + 1))
+		return INT_MIN + 1;
+	else if(cell > INT_MAX - 1)
+		return INT_MAX - 1;
+	else
+		return (int)(cell);
+}
+
+unsigned int SpatialHash :: getBucket (int x, int y, int z) const
+{
+	unsigned int hash = ((unsigned int)(x) * HASH_PRIME_X) ^
+	                    ((unsigned int)(y) * HASH_PRIME_Y) ^
+	                    ((unsigned int)(z) * HASH_PRIME_Z);
+	return hash & m_bucket_mask;
+}
+
+bool SpatialHash :: isFirstSharedCell (const Sphere& sphere1,
+                                       const Sphere& sphere2,
+                                       const Entry& entry)
+{
+	return entry.m_x == max(sphere1.m_min_x, sphere2.m_min_x) &&
+	       entry.m_y == max(sphere1.m_min_y, sphere2.m_min_y) &&
+	       entry.m_z == max(sphere1.m_min_z, sphere2.m_min_z);
+}
+
+bool SpatialHash :: invariant () const
+{
+	if(m_cell_size <= 0.0) return false;
+	if(m_is_built && mv_sorted_entries.size() != mv_entries.size()) return false;
+	return true;
+}
@@ -0,0 +1,307 @@
+//
+//  SpatialHash.h
+//
+//  A module to find potentially-colliding pairs of spheres.
+//
+
+#pragma once
+
+#include <vector>
+#include <utility>  // for pair
+
+#include "ObjLibrary/Vector3.h"
+
+
+
+//
+//  SpatialHash
+//
+//  A class to act as a broad phase for collision checking.  It
+//    divides space into a uniform grid of cubic cells and
+//    stores each sphere in every cell overlapped by its
+//    bounding box.  The cells are stored in a hash table, so
+//    the grid is unbounded and empty cells use no memory.  Two
+//    spheres can only collide if they share a cell.
+//
+//  A SpatialHash is intended to be rebuilt every physics
+//    update:
+//      <1> Call clear() with the cell size
+//      <2> Call insert() for every sphere
+//      <3> Call build()
+//      <4> Call getCandidatePairs() and/or getCandidates()
+//    Memory is reused between rebuilds, so there are no
+//    allocations once the number of spheres is stable.
+//
+//  Each sphere is either active or passive.  Pairs of passive
+//    spheres are never reported.  This allows large numbers of
+//    small objects (e.g. crystals) that do not collide with
+//    each other to be checked against fewer large objects
+//    (e.g. asteroids) efficiently.
+//
+//  The cell size should be at least the diameter of most of the
+//    spheres.  A sphere is never stored in more than
+//    MAX_CELLS_PER_SPHERE cells; if it would be, it is instead
+//    treated as overlapping every cell.
+//
+//  Class Invariant:
+//    <1> m_cell_size > 0.0
+//    <2> !m_is_built || mv_sorted_entries.size() == mv_entries.size()
+//
+class SpatialHash
+{
+public:
+//
+//  MAX_CELLS_PER_SPHERE
+//
+//  The maximum number of cells that a single sphere is stored
+//    in.  Larger spheres are stored in a seperate list and
+//    tested against everything.
+//
+	static const unsigned int MAX_CELLS_PER_SPHERE = 64;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty SpatialHash.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new SpatialHash is created with a cell size
+//               of 1.0.  It contains no spheres.
+//
+	SpatialHash ();
+
+	SpatialHash (const SpatialHash& to_copy) = default;
+	~SpatialHash () = default;
+	SpatialHash& operator= (const SpatialHash& to_copy) = default;
+
+//
+//  getCellSize
+//
+//  Purpose: To determine the size of the grid cells.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The edge length of each grid cell.
+//  Side Effect: N/A
+//
+	double getCellSize () const
+	{
+		return m_cell_size;
+	}
+
+//
+//  getSphereCount
+//
+//  Purpose: To determine how many spheres have been inserted.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of spheres.
+//  Side Effect: N/A
+//
+	unsigned int getSphereCount () const
+	{
+		return (unsigned int)(mv_spheres.size());
+	}
+
+//
+//  isBuilt
+//
+//  Purpose: To determine if this SpatialHash is ready to be
+//           queried.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether build() has been called since the last
+//           sphere was inserted.
+//  Side Effect: N/A
+//
+	bool isBuilt () const
+	{
+		return m_is_built;
+	}
+
+//
+//  getCandidatePairs
+//
+//  Purpose: To determine all pairs of spheres that might
+//           collide.
+//  Parameter(s):
+//    <1> rv_pairs: A vector to fill with the pairs
+//  Preconditions:
+//    <1> isBuilt()
+//  Returns: N/A
+//  Side Effect: rv_pairs is replaced with the ids of every pair
+//               of spheres that share a cell and are not both
+//               passive.  Each pair is reported exactly once,
+//               with the smaller id first.  The pairs are not
+//               in any particular order.
+//
+	void getCandidatePairs (
+	   std::vector<std::pair<unsigned int, unsigned int> >& rv_pairs) const;
+
+//
+//  getCandidates
+//
+//  Purpose: To determine all spheres that might overlap the
+//           specified sphere.
+//  Parameter(s):
+//    <1> center: The center of the query sphere
+//    <2> radius: The radius of the query sphere
+//    <3> rv_ids: A vector to fill with the ids
+//  Preconditions:
+//    <1> isBuilt()
+//    <2> radius >= 0.0
+//  Returns: N/A
+//  Side Effect: rv_ids is replaced with the ids of every sphere
+//               that shares a cell with the query sphere, in
+//               increasing order without duplicates.
+//
+	void getCandidates (const ObjLibrary::Vector3& center,
+	                    double radius,
+	                    std::vector<unsigned int>& rv_ids) const;
+
+//
+//  clear
+//
+//  Purpose: To remove all spheres from this SpatialHash and
+//           change the cell size.
+//  Parameter(s):
+//    <1> cell_size: The new cell size
+//  Preconditions:
+//    <1> cell_size > 0.0
+//  Returns: N/A
+//  Side Effect: This SpatialHash is emptied and its cell size is
+//               set to cell_size.
+//
+	void clear (double cell_size);
+
+//
+//  insert
+//
+//  Purpose: To add a sphere to this SpatialHash.
+//  Parameter(s):
+//    <1> id: An identifier for the sphere
+//    <2> center: The center of the sphere
+//    <3> radius: The radius of the sphere
+//    <4> is_passive: Whether the sphere is passive
+//  Preconditions:
+//    <1> radius >= 0.0
+//    <2> center.isFinite()
+//  Returns: N/A
+//  Side Effect: The sphere is added to this SpatialHash.  It
+//               will not be found until build() is called.
+//
+	void insert (unsigned int id,
+	             const ObjLibrary::Vector3& center,
+	             double radius,
+	             bool is_passive);
+
+//
+//  build
+//
+//  Purpose: To prepare this SpatialHash to be queried.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The spheres are sorted into the hash table.
+//
+	void build ();
+
+private:
+//
+//  Sphere
+//
+//  A record of an inserted sphere and the range of cells it
+//    overlaps.
+//
+	struct Sphere
+	{
+		unsigned int m_id;
+		bool m_is_passive;
+		bool m_is_huge;
+		int m_min_x, m_min_y, m_min_z;
+		int m_max_x, m_max_y, m_max_z;
+	};
+
+//
+//  Entry
+//
+//  A record of one cell containing one sphere.  m_sphere is the
+//    index into mv_spheres.
+//
+	struct Entry
+	{
+		int m_x, m_y, m_z;
+		unsigned int m_sphere;
+	};
+
+//
+//  Helper Function: toCell
+//
+//  Purpose: To determine the cell coordinate for a position
+//           along one axis.
+//  Parameter(s):
+//    <1> value: The position along the axis
+//  Preconditions: N/A
+//  Returns: The index of the cell containing value, clamped to
+//           the range of an int, excluding INT_MIN and INT_MAX.
+//           If value is NaN, INT_MIN + 1 is returned.
+//  Side Effect: N/A
+//
+	int toCell (double value) const;
+
+//
+//  Helper Function: getBucket
+//
+//  Purpose: To determine the hash table bucket for a cell.
+//  Parameter(s):
+//    <1> x
+//    <2> y
+//    <3> z: The cell coordinates
+//  Preconditions:
+//    <1> isBuilt()
+//  Returns: The bucket index.
+//  Side Effect: N/A
+//
+	unsigned int getBucket (int x, int y, int z) const;
+
+//
+//  Helper Function: isFirstSharedCell
+//
+//  Purpose: To determine whether the specified cell is the
+//           lowest cell shared by two spheres.  This is used to
+//           report each pair only once.
+//  Parameter(s):
+//    <1> sphere1
+//    <2> sphere2: The spheres
+//    <3> entry: The cell
+//  Preconditions: N/A
+//  Returns: Whether entry is the lowest shared cell.
+//  Side Effect: N/A
+//
+	static bool isFirstSharedCell (const Sphere& sphere1,
+	                               const Sphere& sphere2,
+	                               const Entry& entry);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	double m_cell_size;
+	bool m_is_built;
+	unsigned int m_bucket_mask;
+	std::vector<Sphere> mv_spheres;
+	std::vector<unsigned int> mv_huge_spheres;
+	std::vector<Entry> mv_entries;
+	std::vector<Entry> mv_sorted_entries;
+	std::vector<unsigned int> mv_bucket_starts;
+};
+
@@ -0,0 +1,144 @@
+//
+//  ThreadPool.cpp
+//
+
+#include "ThreadPool.h"
+
+#include <cassert>
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+#include <algorithm>  // for min
+
+using namespace std;
+
+
+
+ThreadPool :: ThreadPool (unsigned int thread_count)
+		: m_thread_count(thread_count)
+		, mv_workers()
+		, m_mutex()
+		, m_start_condition()
+		, m_done_condition()
+		, m_generation(0)
+		, m_busy_workers(0)
+		, m_is_stopping(false)
+		, mp_chunk(nullptr)
+		, m_count(0)
+		, m_chunk_size(1)
+		, m_next_chunk(0)
+{
+	if(m_thread_count == 0)
+		m_thread_count = thread::hardware_concurrency();
+	if(m_thread_count == 0)
+		m_thread_count = 1;  // unknown
+
+	for(unsigned int i = 1; i < m_thread_count; i++)
+		mv_workers.push_back(thread(&ThreadPool::runWorker, this));
+
+	assert(invariant());
+}
+
+ThreadPool :: ~ThreadPool ()
+{
+	{
+		lock_guard<mutex> lock(m_mutex);
+		m_is_stopping = true;
+	}
+	m_start_condition.notify_all();
+
+	for(unsigned int i = 0; i < mv_workers.size(); i++)
+		mv_workers[i].join();
+}
+
+
+
+void ThreadPool :: runChunks (unsigned int count,
+                              unsigned int chunk_size,
+                              const Chunk& chunk)
+{
+	assert(chunk_size > 0);
+	assert(chunk);
+
+	if(mv_workers.empty() || count <= chunk_size)
+	{
+		// not worth waking the workers
+		for(unsigned int begin = 0; begin < count; begin += chunk_size)
+			chunk(begin, min(begin + chunk_size, count));
+		return;
+	}
+
+	{
+		lock_guard<mutex> lock(m_mutex);
+		mp_chunk     = &chunk;
+		m_count      = count;
+		m_chunk_size = chunk_size;
+		m_next_chunk = 0;
+		m_busy_workers = (unsigned int)(mv_workers.size());
+		m_generation++;
+	}
+	m_start_condition.notify_all();
+
+	runAvailableChunks();
+
+	unique_lock<mutex> lock(m_mutex);
+	m_done_condition.wait(lock, [this] { return m_busy_workers == 0; });
+	mp_chunk = nullptr;
+
+	assert(invariant());
+}
+
+
+
+void ThreadPool :: runWorker ()
+{
+	// the generation when the worker was created, not when it
+	//   started running (it may already have been incremented)
+	unsigned int generation_done = 0;
+
+	unique_lock<mutex> lock(m_mutex);
+	while(true)
+	{
+		m_start_condition.wait(lock, [this, generation_done]
+		                       { return m_is_stopping || m_generation != generation_done; });
+		if(m_is_stopping)
+			return;
+		generation_done = m_generation;
+
+		lock.unlock();
+		runAvailableChunks();
+		lock.lock();
+
+		assert(m_busy_workers > 0);
+		m_busy_workers--;
+		if(m_busy_workers == 0)
+			m_done_condition.notify_one();
+	}
+}
+
+void ThreadPool :: runAvailableChunks ()
+{
+	assert(mp_chunk != nullptr);
+	assert(m_chunk_size > 0);
+
+	unsigned int chunk_count = (m_count + m_chunk_size - 1) / m_chunk_size;
+	while(true)
+	{
+		unsigned int c = m_next_chunk.fetch_add(1);
+		if(c >= chunk_count)
+			return;
+
+		unsigned int begin = c * m_chunk_size;
+		(*mp_chunk)(begin, min(begin + m_chunk_size, m_count));
+	}
+}
+
+bool ThreadPool :: invariant () const
+{
+	if(m_thread_count < 1) return false;
+	if(mv_workers.size() != m_thread_count - 1) return false;
+	return true;
+}
@@ -0,0 +1,177 @@
+//
+//  ThreadPool.h
+//
+//  A module to run loops across several threads.
+//
+
+#pragma once
+
+#include <vector>
+#include <functional>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <atomic>
+
+
+
+//
+//  ThreadPool
+//
+//  A class to represent a set of worker threads that are
+//    created once and reused to run the iterations of a loop in
+//    parallel.  The loop is divided into chunks of a fixed
+//    size, and each chunk is run by whichever thread is free
+//    next.  The thread that calls runChunks also runs chunks,
+//    so a ThreadPool with 1 thread has no worker threads and
+//    runs everything on the calling thread.
+//
+//  The chunk boundaries depend only on the iteration count and
+//    the chunk size, never on the number of threads.  If each
+//    chunk only changes the data for its own iterations, the
+//    results are the same for any number of threads.
+//
+//  A ThreadPool is not itself thread-safe: only one thread may
+//    call runChunks at a time, and runChunks may not be called
+//    from inside a chunk.
+//
+//  Class Invariant:
+//    <1> m_thread_count >= 1
+//    <2> mv_workers.size() == m_thread_count - 1
+//
+class ThreadPool
+{
+public:
+//
+//  Chunk
+//
+//  The type of function run for each chunk.  The parameters
+//    are the first iteration in the chunk and one past the last
+//    iteration in the chunk.
+//
+	typedef std::function<void(unsigned int, unsigned int)> Chunk;
+
+public:
+//
+//  Constructor
+//
+//  Purpose: To create a ThreadPool with the specified number of
+//           threads.
+//  Parameter(s):
+//    <1> thread_count: The number of threads, including the
+//                      thread calling runChunks, or 0 to use
+//                      the number of hardware threads
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new ThreadPool is created.  thread_count - 1
+//               worker threads are started.
+//
+	ThreadPool (unsigned int thread_count = 0);
+
+	ThreadPool (const ThreadPool& to_copy) = delete;
+
+//
+//  Destructor
+//
+//  Purpose: To safely destroy this ThreadPool.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The worker threads are stopped and joined.
+//
+	~ThreadPool ();
+
+	ThreadPool& operator= (const ThreadPool& to_copy) = delete;
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine the number of threads used by this
+//           ThreadPool.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of threads, including the thread that
+//           calls runChunks.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const
+	{
+		return m_thread_count;
+	}
+
+//
+//  runChunks
+//
+//  Purpose: To run a loop in parallel.
+//  Parameter(s):
+//    <1> count: The number of iterations
+//    <2> chunk_size: The number of iterations in each chunk
+//    <3> chunk: The function to run for each chunk
+//  Preconditions:
+//    <1> chunk_size > 0
+//    <2> chunk
+//  Returns: N/A
+//  Side Effect: chunk is called once for each range
+//               [i, min(i + chunk_size, count)), where i is a
+//               multiple of chunk_size less than count.  The
+//               chunks may be run in any order and on any
+//               thread.  This function does not return until
+//               all chunks have finished.
+//
+	void runChunks (unsigned int count,
+	                unsigned int chunk_size,
+	                const Chunk& chunk);
+
+private:
+//
+//  Helper Function: runWorker
+//
+//  Purpose: To run chunks on a worker thread until this
+//           ThreadPool is destroyed.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Chunks are run.
+//
+	void runWorker ();
+
+//
+//  Helper Function: runAvailableChunks
+//
+//  Purpose: To run chunks of the current loop until there are
+//           none left to start.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Chunks are run.
+//
+	void runAvailableChunks ();
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	unsigned int m_thread_count;
+	std::vector<std::thread> mv_workers;
+
+	std::mutex m_mutex;
+	std::condition_variable m_start_condition;
+	std::condition_variable m_done_condition;
+	unsigned int m_generation;
+	unsigned int m_busy_workers;
+	bool m_is_stopping;
+
+	// the current loop
+	const Chunk* mp_chunk;
+	unsigned int m_count;
+	unsigned int m_chunk_size;
+	std::atomic<unsigned int> m_next_chunk;
+};
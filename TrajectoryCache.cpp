@@ -0,0 +1,146 @@
+//
+//  TrajectoryCache.cpp
+//
+
+#include "TrajectoryCache.h"
+
+#include <cassert>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Entity.h"
+
+using namespace ObjLibrary;
+namespace
+{
+	// the time step can change by this factor before the
+	//   prediction is recalculated
+	const double STEP_RATIO_MAX = 1.25;
+
+	// the fraction of the prediction that can be passed before
+	//   it is recalculated to limit the integration error
+	const double REBUILD_FRACTION = 0.25;
+
+}  // end of anonymous namespace
+
+
+
+TrajectoryCache :: TrajectoryCache ()
+		: m_is_built(false)
+		, m_trajectory_id(0)
+		, m_step(1.0)
+		, m_build_time(0.0)
+		, m_first_point_time(0.0)
+		, mv_points()
+		, m_tail()
+		, m_rebuild_count(0)
+{
+	assert(getPointCount() == 0);
+	assert(invariant());
+}
+
+
+
+void TrajectoryCache :: update (const Entity& entity,
+                                const Entity& black_hole,
+                                double current_time,
+                                double step,
+                                unsigned int point_count)
+{
+	assert(entity.isInitialized());
+	assert(step > 0.0);
+	assert(point_count >= 1);
+
+	if(!isValidFor(entity, current_time, step, point_count))
+		rebuild(entity, current_time, step);
+	else
+	{
+		// remove the points the Entity has already passed
+		unsigned int passed_count = 0;
+		while(passed_count < mv_points.size() &&
+		      m_first_point_time + passed_count * m_step <= current_time)
+		{
+			passed_count++;
+		}
+		if(passed_count > 0)
+		{
+			mv_points.erase(mv_points.begin(), mv_points.begin() + passed_count);
+			m_first_point_time += passed_count * m_step;
+		}
+	}
+
+	// continue the prediction from the last point
+	while(mv_points.size() + 1 < point_count)
+	{
+		m_tail.updatePhysics(m_step, black_hole);
+		mv_points.push_back(m_tail.getPosition());
+	}
+
+	assert(getPointCount() == point_count - 1);
+	assert(invariant());
+}
+
+void TrajectoryCache :: invalidate ()
+{
+	m_is_built = false;
+	mv_points.clear();
+
+	assert(getPointCount() == 0);
+	assert(invariant());
+}
+
+
+
+bool TrajectoryCache :: isValidFor (const Entity& entity,
+                                    double current_time,
+                                    double step,
+                                    unsigned int point_count) const
+{
+	assert(entity.isInitialized());
+	assert(step > 0.0);
+
+	if(!m_is_built)
+		return false;
+	if(entity.getTrajectoryId() != m_trajectory_id)
+		return false;
+	if(step > m_step * STEP_RATIO_MAX || step * STEP_RATIO_MAX < m_step)
+		return false;
+	if(current_time < m_build_time)
+		return false;
+	if(current_time - m_build_time > m_step * point_count * REBUILD_FRACTION)
+		return false;
+	if(mv_points.size() + 1 > point_count)
+		return false;
+	return true;
+}
+
+void TrajectoryCache :: rebuild (const Entity& entity,
+                                 double current_time,
+                                 double step)
+{
+	assert(entity.isInitialized());
+	assert(step > 0.0);
+
+	m_is_built         = true;
+	m_trajectory_id    = entity.getTrajectoryId();
+	m_step             = step;
+	m_build_time       = current_time;
+	m_first_point_time = current_time + step;
+	mv_points.clear();
+	m_rebuild_count++;
+
+	// no DisplayList, so copying is cheap
+	m_tail = Entity(entity.getPosition(), entity.getVelocity(),
+	                entity.getMass(),     entity.getRadius());
+
+	assert(getPointCount() == 0);
+	assert(invariant());
+}
+
+bool TrajectoryCache :: invariant () const
+{
+	if(m_step <= 0.0) return false;
+	if(!m_is_built && !mv_points.empty()) return false;
+	return true;
+}
@@ -0,0 +1,231 @@
+//
+//  TrajectoryCache.h
+//
+//  A module to remember the predicted path of an Entity between
+//    frames.
+//
+
+#pragma once
+
+#include <cassert>
+#include <vector>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "Entity.h"
+
+
+
+//
+//  TrajectoryCache
+//
+//  A class to store the predicted future positions of an Entity
+//    that is only affected by the gravity of a black hole.  The
+//    prediction is made by repeatedly calling updatePhysics on a
+//    copy of the Entity with a fixed time step, which is too
+//    expensive to repeat for every Entity in every frame.
+//
+//  Instead, the predicted points are kept between frames.  As
+//    the simulation time passes the time of the first point, that
+//    point is removed and a new point is added at the end by
+//    continuing the prediction from the last point.  This keeps
+//    the same number of points ahead of the Entity at the cost
+//    of a single physics step per point removed.
+//
+//  The whole prediction is only recalculated when it is no
+//    longer valid:
+//    <1> The trajectory identifier of the Entity has changed,
+//        because thrust or a collision changed its velocity
+//    <2> The requested time step is too different from the one
+//        used for the prediction
+//    <3> The prediction is too old, so the errors from the
+//        large time step could be noticeable
+//    <4> The simulation time has gone backwards (e.g. the World
+//        was restarted)
+//
+//  This only saves time for an Entity that coasts for many
+//    frames at a time, such as the player's Spaceship.  Drones
+//    change course almost every physics step, so they do not
+//    use a TrajectoryCache.
+//
+//  Class Invariant:
+//    <1> m_step > 0.0
+//    <2> m_is_built || mv_points.empty()
+//
+class TrajectoryCache
+{
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create an empty TrajectoryCache.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new TrajectoryCache is created.  It does not
+//               contain a prediction.
+//
+	TrajectoryCache ();
+
+	TrajectoryCache (const TrajectoryCache& to_copy) = default;
+	~TrajectoryCache () = default;
+	TrajectoryCache& operator= (const TrajectoryCache& to_copy) = default;
+
+//
+//  getPointCount
+//
+//  Purpose: To determine how many predicted points are in this
+//           TrajectoryCache.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of predicted points.  This does not
+//           include the current position of the Entity.
+//  Side Effect: N/A
+//
+	unsigned int getPointCount () const
+	{
+		return (unsigned int)(mv_points.size());
+	}
+
+//
+//  getPoint
+//
+//  Purpose: To retrieve a predicted point.
+//  Parameter(s):
+//    <1> index: Which point
+//  Preconditions:
+//    <1> index < getPointCount()
+//  Returns: Predicted point index.  The points are one time
+//           step apart, and the first one is at most one time
+//           step after the time of the last update.
+//  Side Effect: N/A
+//
+	const ObjLibrary::Vector3& getPoint (unsigned int index) const
+	{
+		assert(index < getPointCount());
+
+		return mv_points[index];
+	}
+
+//
+//  getRebuildCount
+//
+//  Purpose: To determine how many times the prediction in this
+//           TrajectoryCache has been recalculated from the
+//           beginning.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of times the prediction was rebuilt.
+//  Side Effect: N/A
+//
+	unsigned int getRebuildCount () const
+	{
+		return m_rebuild_count;
+	}
+
+//
+//  update
+//
+//  Purpose: To bring the prediction in this TrajectoryCache up
+//           to date.
+//  Parameter(s):
+//    <1> entity: The Entity to predict the path of
+//    <2> black_hole: The black hole
+//    <3> current_time: The current simulation time
+//    <4> step: The time step between predicted points
+//    <5> point_count: The number of points to display,
+//                     including the current position of entity
+//  Preconditions:
+//    <1> entity.isInitialized()
+//    <2> step > 0.0
+//    <3> point_count >= 1
+//  Returns: N/A
+//  Side Effect: This TrajectoryCache is updated to contain
+//               point_count - 1 predicted points for entity
+//               after time current_time.  If the existing
+//               prediction is still valid, it is reused, and
+//               only the points that have been passed are
+//               replaced.  Otherwise, the prediction is
+//               recalculated with a time step of step.
+//
+	void update (const Entity& entity,
+	             const Entity& black_hole,
+	             double current_time,
+	             double step,
+	             unsigned int point_count);
+
+//
+//  invalidate
+//
+//  Purpose: To discard the prediction in this TrajectoryCache.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: This TrajectoryCache is emptied.  The next call
+//               to update will recalculate the prediction.
+//
+	void invalidate ();
+
+private:
+//
+//  Helper Function: isValidFor
+//
+//  Purpose: To determine if the prediction in this
+//           TrajectoryCache can be reused.
+//  Parameter(s):
+//    <1> entity: The Entity to predict the path of
+//    <2> current_time: The current simulation time
+//    <3> step: The requested time step
+//    <4> point_count: The requested number of points
+//  Preconditions:
+//    <1> entity.isInitialized()
+//    <2> step > 0.0
+//  Returns: Whether the existing prediction is valid.
+//  Side Effect: N/A
+//
+	bool isValidFor (const Entity& entity,
+	                 double current_time,
+	                 double step,
+	                 unsigned int point_count) const;
+
+//
+//  Helper Function: rebuild
+//
+//  Purpose: To start a new prediction in this TrajectoryCache.
+//  Parameter(s):
+//    <1> entity: The Entity to predict the path of
+//    <2> current_time: The current simulation time
+//    <3> step: The time step between predicted points
+//  Preconditions:
+//    <1> entity.isInitialized()
+//    <2> step > 0.0
+//  Returns: N/A
+//  Side Effect: All predicted points are removed, and the
+//               prediction is restarted from the current state
+//               of entity.
+//
+	void rebuild (const Entity& entity,
+	              double current_time,
+	              double step);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	bool m_is_built;
+	unsigned int m_trajectory_id;
+	double m_step;
+	double m_build_time;
+	double m_first_point_time;
+	std::vector<ObjLibrary::Vector3> mv_points;
+	Entity m_tail;  // state at the last predicted point
+	unsigned int m_rebuild_count;
+};
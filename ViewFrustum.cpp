@@ -0,0 +1,112 @@
+//
+//  ViewFrustum.cpp
+//
+
+#include "ViewFrustum.h"
+
+#include <cassert>
+#include <cmath>
+#include <limits>
+
+#include "ObjLibrary/Vector3.h"
+
+#include "CoordinateSystem.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double DEGREES_TO_RADIANS = 0.017453292519943295;
+
+	const unsigned int PLANE_NEAR   = 0;
+	const unsigned int PLANE_FAR    = 1;
+	const unsigned int PLANE_LEFT   = 2;
+	const unsigned int PLANE_RIGHT  = 3;
+	const unsigned int PLANE_BOTTOM = 4;
+	const unsigned int PLANE_TOP    = 5;
+}
+
+
+
+ViewFrustum :: ViewFrustum ()
+		: ViewFrustum(CoordinateSystem(), 90.0, 1.0, 1.0, 1000.0, 1)
+{
+	assert(invariant());
+}
+
+ViewFrustum :: ViewFrustum (const CoordinateSystem& camera,
+                            double field_of_view_degrees,
+                            double aspect_ratio,
+                            double near_distance,
+                            double far_distance,
+                            int viewport_height)
+		: m_camera_position(camera.getPosition())
+		, m_pixels_per_slope(1.0)
+{
+	assert(field_of_view_degrees > 0.0);
+	assert(field_of_view_degrees < 180.0);
+	assert(aspect_ratio > 0.0);
+	assert(near_distance > 0.0);
+	assert(far_distance > near_distance);
+	assert(viewport_height > 0);
+
+	const Vector3& position = camera.getPosition();
+	const Vector3& forward  = camera.getForward();
+	const Vector3& up       = camera.getUp();
+	const Vector3& right    = camera.getRight();
+
+	// slope of the frustum edges from the forward direction
+	double slope_vertical   = tan(field_of_view_degrees * DEGREES_TO_RADIANS * 0.5);
+	double slope_horizontal = slope_vertical * aspect_ratio;
+
+	ma_normals[PLANE_NEAR]   =  forward;
+	ma_normals[PLANE_FAR]    = -forward;
+	ma_normals[PLANE_LEFT]   = ( right + forward * slope_horizontal).getNormalized();
+	ma_normals[PLANE_RIGHT]  = (-right + forward * slope_horizontal).getNormalized();
+	ma_normals[PLANE_BOTTOM] = ( up    + forward * slope_vertical).getNormalized();
+	ma_normals[PLANE_TOP]    = (-up    + forward * slope_vertical).getNormalized();
+
+	// the side planes all pass through the camera
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+		ma_distances[p] = -ma_normals[p].dotProduct(position);
+	ma_distances[PLANE_NEAR] -= near_distance;
+	ma_distances[PLANE_FAR]  += far_distance;
+
+	m_pixels_per_slope = viewport_height * 0.5 / slope_vertical;
+
+	assert(invariant());
+}
+
+
+
+bool ViewFrustum :: isSphereVisible (const ObjLibrary::Vector3& center,
+                                     double radius) const
+{
+	assert(radius >= 0.0);
+
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+		if(ma_normals[p].dotProduct(center) + ma_distances[p] < -radius)
+			return false;
+	return true;
+}
+
+double ViewFrustum :: getPixelRadius (const ObjLibrary::Vector3& center,
+                                      double radius) const
+{
+	assert(radius >= 0.0);
+
+	double depth = ma_normals[PLANE_NEAR].dotProduct(center - m_camera_position);
+	if(depth <= radius)
+		return numeric_limits<double>::max();
+	return radius / depth * m_pixels_per_slope;
+}
+
+
+
+bool ViewFrustum :: invariant () const
+{
+	for(unsigned int p = 0; p < PLANE_COUNT; p++)
+		if(!ma_normals[p].isUnit()) return false;
+	if(m_pixels_per_slope <= 0.0) return false;
+	return true;
+}
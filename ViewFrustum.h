@@ -0,0 +1,152 @@
+//
+//  ViewFrustum.h
+//
+//  A module to determine which bounding spheres can be seen by
+//    a perspective camera.
+//
+
+#pragma once
+
+#include "ObjLibrary/Vector3.h"
+
+class CoordinateSystem;
+
+
+
+//
+//  ViewFrustum
+//
+//  A class to represent the volume of space that can be seen by
+//    a camera set up with CoordinateSystem::setupCamera and a
+//    symmetric perspective projection (as from gluPerspective).
+//    The frustum is stored as 6 planes with normals pointing
+//    inwards.
+//
+//  A ViewFrustum is used to skip drawing entities that cannot
+//    be seen.  A sphere is reported as visible if it might
+//    intersect the frustum, so spheres near a corner of the
+//    frustum can be reported as visible even though they are
+//    not.  Spheres that cover less than a fraction of a pixel
+//    can also be culled with getPixelRadius.
+//
+//  Class Invariant:
+//    <1> ma_normals[i].isUnit()
+//        WHERE 0 <= i < PLANE_COUNT
+//    <2> m_pixels_per_slope > 0.0
+//
+class ViewFrustum
+{
+public:
+//
+//  PLANE_COUNT
+//
+//  The number of planes bounding a ViewFrustum.
+//
+	static const unsigned int PLANE_COUNT = 6;
+
+public:
+//
+//  Default Constructor
+//
+//  Purpose: To create a ViewFrustum with default values.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new ViewFrustum is created for a camera at
+//               the origin looking along the X axis with a 90
+//               degree field of view, a near distance of 1.0,
+//               and a far distance of 1000.0, drawn into a
+//               viewport 1 pixel high.
+//
+	ViewFrustum ();
+
+//
+//  Constructor
+//
+//  Purpose: To create a ViewFrustum for the specified camera.
+//  Parameter(s):
+//    <1> camera: The camera position and orientation
+//    <2> field_of_view_degrees: The vertical field of view, as
+//                               passed to gluPerspective
+//    <3> aspect_ratio: The width of the viewport divided by its
+//                      height
+//    <4> near_distance: The distance to the near clipping plane
+//    <5> far_distance: The distance to the far clipping plane
+//    <6> viewport_height: The height of the viewport in pixels
+//  Preconditions:
+//    <1> field_of_view_degrees > 0.0
+//    <2> field_of_view_degrees < 180.0
+//    <3> aspect_ratio > 0.0
+//    <4> near_distance > 0.0
+//    <5> far_distance > near_distance
+//    <6> viewport_height > 0
+//  Returns: N/A
+//  Side Effect: A new ViewFrustum is created for the volume of
+//               space seen by camera.
+//
+	ViewFrustum (const CoordinateSystem& camera,
+	             double field_of_view_degrees,
+	             double aspect_ratio,
+	             double near_distance,
+	             double far_distance,
+	             int viewport_height);
+
+	ViewFrustum (const ViewFrustum& to_copy) = default;
+	~ViewFrustum () = default;
+	ViewFrustum& operator= (const ViewFrustum& to_copy) = default;
+
+//
+//  isSphereVisible
+//
+//  Purpose: To determine if the specified sphere might be seen
+//           by the camera.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//  Preconditions:
+//    <1> radius >= 0.0
+//  Returns: Whether the sphere with center center and radius
+//           radius might intersect this ViewFrustum.  If false
+//           is returned, the sphere is entirely outside it.
+//  Side Effect: N/A
+//
+	bool isSphereVisible (const ObjLibrary::Vector3& center,
+	                      double radius) const;
+
+//
+//  getPixelRadius
+//
+//  Purpose: To determine approximately how large the specified
+//           sphere appears on the screen.
+//  Parameter(s):
+//    <1> center: The center of the sphere
+//    <2> radius: The radius of the sphere
+//  Preconditions:
+//    <1> radius >= 0.0
+//  Returns: The radius of the sphere in pixels if it was in the
+//           center of the screen at the same distance from the
+//           camera.  If the camera is inside the sphere, a very
+//           large value is returned.
+//  Side Effect: N/A
+//
+	double getPixelRadius (const ObjLibrary::Vector3& center,
+	                       double radius) const;
+
+private:
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	ObjLibrary::Vector3 m_camera_position;
+	ObjLibrary::Vector3 ma_normals[PLANE_COUNT];
+	double ma_distances[PLANE_COUNT];
+	double m_pixels_per_slope;
+};
@@ -0,0 +1,771 @@
+//
+//  World.cpp
+//
+
+#include "World.h"
+
+#include <cassert>
+#include <cmath>
+#include <cstdlib>
+#include <vector>
+#include <utility>    // for pair
+#include <algorithm>  // for min/max/sort
+
+#include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/DisplayList.h"
+#include "ObjLibrary/VertexBufferModel.h"
+#endif
+
+#include "Gravity.h"
+#include "Entity.h"
+#include "BlackHole.h"
+#include "Asteroid.h"
+#ifndef HEADLESS_SIMULATION
+#include "AsteroidMesh.h"
+#endif
+#include "Crystal.h"
+#include "Spaceship.h"
+#include "Drone.h"
+#include "Collisions.h"
+#include "SpatialHash.h"
+#include "BodyStore.h"
+#include "ThreadPool.h"
+
+using namespace std;
+using namespace ObjLibrary;
+namespace
+{
+	const double BLACK_HOLE_RADIUS  =    50.0;
+	const double PLAYER_RADIUS      =     4.0;
+
+	const double BLACK_HOLE_MASS = 5.0e16;  // kg
+	const double PLAYER_MASS     = 1000.0;  // kg
+
+	const double CRYSTAL_KNOCK_OFF_RANGE = 500.0;
+	const unsigned int CRYSTAL_KNOCK_OFF_COUNT = 10;
+	const double CRYSTAL_KNOCK_OFF_SPEED = 10.0;
+
+	// a multiple of 4 so that SIMD groups are not split
+	const unsigned int BODY_CHUNK_SIZE = 256;
+	const unsigned int BODY_ON_RAILS_CHUNK_SIZE = 64;
+
+	const double  PLAYER_START_DISTANCE = 1000.0;
+	const Vector3 PLAYER_START_FORWARD(1.0, 0.0, 0.0);
+
+#ifndef HEADLESS_SIMULATION
+	// slices and stacks for the generated asteroid spheres,
+	//   with LOD 0 from the base models (20 x 15)
+	const unsigned int A_ASTEROID_LOD_SLICES[World::ASTEROID_LOD_COUNT] = { 0, 12, 8, 6 };
+	const unsigned int A_ASTEROID_LOD_STACKS[World::ASTEROID_LOD_COUNT] = { 0,  9, 6, 4 };
+#endif
+
+	// Drone offset positions
+	const Vector3 DRONE_OFFSET1(3.0, 4.0, 0.0);
+	const Vector3 DRONE_OFFSET2(0.0, 8.0, -6.0);
+	const Vector3 DRONE_OFFSET3(0.0, 8.0, 6.0);
+	const Vector3 DRONE_OFFSET4(0.0, -5.0, 0.0);
+	const Vector3 DRONE_OFFSET5(0.0, 10.0, 0.0);
+
+	double random01 ()
+	{
+		return rand() / (RAND_MAX + 1.0);
+	}
+
+	double random2 (double min_value, double max_value)
+	{
+		assert(min_value <= max_value);
+
+		return min_value + random01() * (max_value - min_value);
+	}
+
+}  // end of anonymous namespace
+
+const double World :: DISK_RADIUS = 10000.0;
+
+// chosen so triangle edges are a few pixels long
+const double World :: ASTEROID_LOD_PIXEL_RADII[ASTEROID_LOD_COUNT] = { 40.0, 16.0, 6.0, 0.0 };
+
+
+
+World :: World (unsigned int thread_count)
+		: m_is_displayed(false)
+#ifndef HEADLESS_SIMULATION
+		, m_is_asteroid_vertex_buffers_needed(true)
+		, m_disk_display_list()
+		, m_crystal_display_list()
+		, m_player_display_list()
+		, mv_asteroid_meshes()
+#endif
+		, m_black_hole()
+		, mv_asteroids()
+		, mv_crystals()
+		, m_player()
+		, m_crystals_collected(0)
+		, m_chasing(NO_CRYSTAL)
+		, m_pursuit(0)
+		, m_live_drones(DRONE_COUNT)
+		, m_simulation_time(0.0)
+		, m_thread_pool(thread_count)
+		, mv_moving_crystals()
+		, m_body_store()
+		, m_spatial_hash()
+		, mv_collision_pairs()
+{
+	for(unsigned int i = 0; i < DRONE_COUNT; i++)
+	{
+		ma_drone_status[i] = 3;
+		ma_avoid[i] = NO_ASTEROID;
+	}
+
+	assert(!isDisplayed());
+	assert(invariant());
+}
+
+
+
+double World :: getCircularOrbitSpeed (double distance) const
+{
+	assert(distance > 0.0);
+
+	return sqrt(GRAVITY * m_black_hole.getMass() / distance);
+}
+
+
+
+#ifndef HEADLESS_SIMULATION
+void World :: setDisplayModels (const ObjLibrary::DisplayList& disk,
+                                const ObjLibrary::DisplayList& crystal,
+                                const ObjLibrary::DisplayList& player,
+                                const ObjLibrary::DisplayList a_drones[],
+                                const ObjLibrary::ObjModel a_asteroid_models[])
+{
+	assert(disk.isReady());
+	assert(crystal.isReady());
+	assert(player.isReady());
+	assert(a_drones != nullptr);
+	assert(a_asteroid_models != nullptr);
+
+	m_disk_display_list    = disk;
+	m_crystal_display_list = crystal;
+	m_player_display_list  = player;
+	for(unsigned int i = 0; i < DRONE_COUNT; i++)
+	{
+		assert(a_drones[i].isReady());
+		ma_drone_display_lists[i] = a_drones[i];
+	}
+	mv_asteroid_meshes.clear();
+	for(unsigned int m = 0; m < ASTEROID_MODEL_COUNT; m++)
+		mv_asteroid_meshes.push_back(AsteroidMesh(a_asteroid_models[m]));
+	for(unsigned int lod = 1; lod < ASTEROID_LOD_COUNT; lod++)
+		for(unsigned int m = 0; m < ASTEROID_MODEL_COUNT; m++)
+		{
+			// same material as the base model
+			const VertexBufferModel& base = mv_asteroid_meshes[m].getBaseVertexBufferModel();
+			const Material* p_material = NULL;
+			if(base.getMaterialRangeCount() > 0)
+				p_material = base.getMaterialRangeMaterial(0);
+			mv_asteroid_meshes.push_back(AsteroidMesh(A_ASTEROID_LOD_SLICES[lod],
+			                                          A_ASTEROID_LOD_STACKS[lod],
+			                                          p_material));
+		}
+	assert(mv_asteroid_meshes.size() == ASTEROID_MODEL_COUNT * ASTEROID_LOD_COUNT);
+	m_is_displayed = true;
+
+	assert(isDisplayed());
+	assert(invariant());
+}
+#endif
+
+void World :: init (unsigned int asteroid_count)
+{
+	assert(asteroid_count >= 2);
+
+	// remove existing entities (if any)
+	mv_asteroids.clear();
+	mv_crystals.clear();
+	m_crystals_collected = 0;
+	m_simulation_time = 0.0;
+
+	// create new entities
+#ifndef HEADLESS_SIMULATION
+	if(m_is_displayed)
+		m_black_hole = BlackHole(Vector3::ZERO, BLACK_HOLE_MASS,
+		                         BLACK_HOLE_RADIUS, DISK_RADIUS, m_disk_display_list);
+	else
+#endif
+		m_black_hole = BlackHole(Vector3::ZERO, BLACK_HOLE_MASS,
+		                         BLACK_HOLE_RADIUS, DISK_RADIUS);
+	initAsteroids(asteroid_count);
+	initPlayer();
+
+	assert(invariant());
+}
+
+#ifndef HEADLESS_SIMULATION
+void World :: setAsteroidVertexBuffersNeeded (bool is_needed)
+{
+	// asteroids created while they were not needed have none
+	bool is_missing = m_is_displayed && !m_is_asteroid_vertex_buffers_needed &&
+	                  !mv_asteroids.empty();
+
+	m_is_asteroid_vertex_buffers_needed = is_needed;
+	if(is_needed && is_missing)
+		initAsteroidVertexBuffers();
+
+	assert(isAsteroidVertexBuffersNeeded() == is_needed);
+	assert(invariant());
+}
+#endif
+
+void World :: knockOffCrystals ()
+{
+	const Vector3& player_position = m_player.getPosition();
+
+	for(unsigned a = 0; a < mv_asteroids.size(); a++)
+	{
+		Asteroid& asteroid = mv_asteroids[a];
+		if(asteroid.isCrystals())
+		{
+			Vector3 asteroid_position  = asteroid.getPosition();
+			Vector3 asteroid_to_player = player_position - asteroid_position;
+			double asteroid_radius = asteroid.getRadiusForDirection(asteroid_to_player.getNormalized());
+			double maximum_distance = asteroid_radius + CRYSTAL_KNOCK_OFF_RANGE;
+
+			if(asteroid_to_player.isNormLessThan(maximum_distance))
+			{
+				Vector3 knock_off_position = asteroid_position + 2.0*asteroid_to_player.getCopyWithNorm(asteroid_radius);
+				for(unsigned c = 0; c < CRYSTAL_KNOCK_OFF_COUNT; c++)
+					addCrystal(knock_off_position, 1.0*asteroid.getVelocity());
+				asteroid.removeCrystals();
+			}
+		}
+	}
+
+	assert(invariant());
+}
+
+void World :: updatePhysics (double delta_time)
+{
+	assert(delta_time > 0.0);
+
+	// move asteroids and crystals in bulk, in parallel
+	mv_moving_crystals.clear();
+	for(unsigned c = 0; c < mv_crystals.size(); c++)
+		if(!mv_crystals[c].isGone())
+			mv_moving_crystals.push_back(c);
+
+	unsigned int body_count = (unsigned int)(mv_asteroids.size() + mv_moving_crystals.size());
+	m_body_store.resize(body_count);
+	m_thread_pool.runChunks(body_count, BODY_CHUNK_SIZE,
+	                        [this, delta_time] (unsigned int begin, unsigned int end)
+	                        {
+	                            updateBodies(begin, end, delta_time);
+	                        });
+
+	if (m_player.isAlive())
+	{
+		m_player.updatePhysics(delta_time, m_black_hole);
+	}
+
+	// select last alive drone for chasing crystals
+	for (unsigned int i = 0; i < DRONE_COUNT; i++)
+	{
+		if (ma_drones[i].isAlive())
+		{
+			m_pursuit = i;
+		}
+	}
+	// last drone Chases last live Crystals
+	m_chasing = NO_CRYSTAL;
+	for (unsigned int i = 0; i < DRONE_COUNT; i++)
+	{
+		if (ma_drones[i].isAlive())
+		{
+			// Decide Status of Drones
+			// Decide crystal number
+			ma_drone_status[i] = 3;
+			for (unsigned c = 0; c < mv_crystals.size(); c++)
+			{
+
+				if (!mv_crystals[c].isGone())
+				{
+					m_chasing = c;
+					ma_drone_status[m_pursuit] = 2;
+				}
+			}
+			// Ast. are inside safedistance, mark the index of the coloest one
+			int mindist = 100000000;
+			for (unsigned a = 0; a < mv_asteroids.size(); a++)
+			{
+				double safedistance = ((ma_drones[i].getVelocity() - mv_asteroids[a].getVelocity()).getNorm() / 25.0) + mv_asteroids[a].getRadius() + ma_drones[i].getRadius() + 50.0;
+				double squaredistance = safedistance * safedistance;
+				if ((ma_drones[i].getPosition()).getDistanceSquared(mv_asteroids[a].getPosition()) <= squaredistance)
+				{
+					// Index of Minimum distance asts. will be saved for each drone
+					if (squaredistance < mindist)
+					{
+						mindist = squaredistance;
+						ma_avoid[i] = a;
+					}
+					ma_drone_status[i] = 1;
+				}
+			}
+		}
+
+	}
+
+
+	// Drone actions
+	for (unsigned int i = 0; i < DRONE_COUNT; i++)
+	{
+		if (ma_drones[i].isAlive())
+		{
+			// If ast is too close avoid
+			if (ma_drone_status[i] == 1)
+			{
+				if (ma_avoid[i] != NO_ASTEROID)
+				{
+					ma_drones[i].avoid(mv_asteroids[ma_avoid[i]], ma_drones[i], delta_time);
+				}
+			}
+			// If ast. is not close
+			else if (ma_drone_status[i] == 2)
+			{
+				for (unsigned c = 0; c < mv_crystals.size(); c++)
+				{
+					if (m_chasing != NO_CRYSTAL)
+					{
+						ma_drones[m_pursuit].swallow(mv_crystals[m_chasing], ma_drones[m_pursuit], mv_crystals[m_chasing].getPosition(), delta_time);
+					}
+				}
+			}
+			// Escort if it is not eating crystal or avoiding
+			else if (ma_drone_status[i] == 3)
+			{
+					ma_drones[i].escort(m_player, ma_drones[i], m_player.SendPosition(i), delta_time);
+			}
+			ma_drones[i].updatePhysics(delta_time, m_black_hole);
+		}
+	}
+
+	m_simulation_time += delta_time;
+
+	assert(invariant());
+}
+
+void World :: updatePhysicsOnRails (double delta_time)
+{
+	assert(delta_time > 0.0);
+
+	mv_moving_crystals.clear();
+	for(unsigned c = 0; c < mv_crystals.size(); c++)
+		if(!mv_crystals[c].isGone())
+			mv_moving_crystals.push_back(c);
+
+	unsigned int asteroid_count = (unsigned int)(mv_asteroids.size());
+	unsigned int body_count = asteroid_count + (unsigned int)(mv_moving_crystals.size());
+	m_thread_pool.runChunks(body_count, BODY_ON_RAILS_CHUNK_SIZE,
+	                        [this, delta_time, asteroid_count] (unsigned int begin, unsigned int end)
+	                        {
+	                            for(unsigned int b = begin; b < end; b++)
+	                            {
+	                                if(b < asteroid_count)
+	                                    mv_asteroids[b].updatePhysicsOnRails(delta_time, m_black_hole);
+	                                else
+	                                    mv_crystals[mv_moving_crystals[b - asteroid_count]].updatePhysicsOnRails(delta_time, m_black_hole);
+	                            }
+	                        });
+
+	if(m_player.isAlive())
+		m_player.updatePhysicsOnRails(delta_time, m_black_hole);
+	for(unsigned int i = 0; i < DRONE_COUNT; i++)
+		if(ma_drones[i].isAlive())
+			ma_drones[i].updatePhysicsOnRails(delta_time, m_black_hole);
+
+	m_simulation_time += delta_time;
+
+	assert(invariant());
+}
+
+void World :: handleCollisions ()
+{
+/*
+	if(Collisions::isCollision(m_player, m_black_hole))
+		m_player.markDead();
+*/
+
+	//
+	//  Each entity is given an id in the spatial hash:
+	//    asteroids:  [0, asteroid_count)
+	//    crystals:   [crystal_start, player_id)
+	//    player:     player_id
+	//    drones:     (player_id, player_id + DRONE_COUNT]
+	//
+	//  Sorting the candidate pairs by id gives the order used
+	//    by the original all-pairs loops, so velocities after
+	//    the elastic collisions do not change.
+	//
+
+	unsigned int asteroid_count = (unsigned int)(mv_asteroids.size());
+	unsigned int crystal_start  = asteroid_count;
+	unsigned int player_id      = crystal_start + (unsigned int)(mv_crystals.size());
+	unsigned int drone_start    = player_id + 1;
+
+	double radius_max = m_player.getRadius();
+	for(unsigned a = 0; a < asteroid_count; a++)
+		radius_max = max(radius_max, mv_asteroids[a].getRadius());
+	assert(radius_max > 0.0);
+
+	m_spatial_hash.clear(radius_max * 2.0);
+	for(unsigned a = 0; a < asteroid_count; a++)
+		m_spatial_hash.insert(a, mv_asteroids[a].getPosition(), mv_asteroids[a].getRadius(), false);
+	for(unsigned c = 0; c < mv_crystals.size(); c++)
+		if(!mv_crystals[c].isGone())
+			m_spatial_hash.insert(crystal_start + c, mv_crystals[c].getPosition(), mv_crystals[c].getRadius(), true);
+	m_spatial_hash.insert(player_id, m_player.getPosition(), m_player.getRadius(), false);
+	for(unsigned int i = 0; i < DRONE_COUNT; i++)
+		m_spatial_hash.insert(drone_start + i, ma_drones[i].getPosition(), ma_drones[i].getRadius(), false);
+	m_spatial_hash.build();
+
+	m_spatial_hash.getCandidatePairs(mv_collision_pairs);
+	sort(mv_collision_pairs.begin(), mv_collision_pairs.end());
+
+	// find the first pair that starts with a crystal
+	unsigned int crystal_pairs_start = 0;
+	while(crystal_pairs_start < mv_collision_pairs.size() &&
+	      mv_collision_pairs[crystal_pairs_start].first < crystal_start)
+	{
+		crystal_pairs_start++;
+	}
+
+	// crystals to player and drones
+	for(unsigned p = crystal_pairs_start; p < mv_collision_pairs.size(); p++)
+	{
+		unsigned int id1 = mv_collision_pairs[p].first;
+		unsigned int id2 = mv_collision_pairs[p].second;
+		if(id1 >= player_id)
+			continue;  // player to drone
+		assert(id2 >= player_id);
+
+		Crystal& crystal = mv_crystals[id1 - crystal_start];
+		if(!crystal.isGone())
+		{
+			if(id2 == player_id)
+			{
+				if(Collisions::isCollision(m_player, crystal))
+				{
+					assert(!crystal.isGone());
+					crystal.markGone();
+					m_crystals_collected++;
+				}
+			}
+			// Drone to Crystal
+			else
+			{
+				if (Collisions::isCollision(ma_drones[id2 - drone_start], crystal))
+				{
+					assert(!crystal.isGone());
+					crystal.markGone();
+					m_crystals_collected++;
+				}
+			}
+		}
+	}
+
+	// asteroids to everything
+	for(unsigned p = 0; p < crystal_pairs_start; p++)
+	{
+		unsigned int id1 = mv_collision_pairs[p].first;
+		unsigned int id2 = mv_collision_pairs[p].second;
+		assert(id1 < asteroid_count);
+		Asteroid& asteroid = mv_asteroids[id1];
+
+		if(id2 < crystal_start)
+		{
+			Asteroid& asteroid2 = mv_asteroids[id2];
+			if(Collisions::isCollision(asteroid, asteroid2))
+				Collisions::elastic(asteroid, asteroid2);
+		}
+		else if(id2 < player_id)
+		{
+			Crystal& crystal = mv_crystals[id2 - crystal_start];
+			if(!crystal.isGone())
+				if(Collisions::isCollision(crystal, asteroid))
+				{
+					Collisions::elastic(crystal, asteroid);
+					//Collisions::bounceOff(crystal, asteroid);  // does about the same thing
+				}
+		}
+		else if(id2 == player_id)
+		{
+			if (Collisions::isCollision(m_player, asteroid))
+			{
+				m_player.markDead();
+			}
+		}
+		// Drone to Asts.
+		else
+		{
+			unsigned int k = id2 - drone_start;
+			assert(k < DRONE_COUNT);
+			if (ma_drones[k].isAlive())
+			{
+				if (Collisions::isCollision(ma_drones[k], asteroid))
+				{
+					ma_drones[k].markDead();
+					ma_drone_status[k] = 0;
+					m_live_drones--;
+				}
+			}
+		}
+	}
+
+	assert(invariant());
+}
+
+
+
+void World :: updateBodies (unsigned int begin,
+                            unsigned int end,
+                            double delta_time)
+{
+	assert(begin <= end);
+	assert(end <= m_body_store.getCount());
+	assert(delta_time > 0.0);
+
+	unsigned int asteroid_count = (unsigned int)(mv_asteroids.size());
+
+	for(unsigned int b = begin; b < end; b++)
+	{
+		const Entity& entity = (b < asteroid_count) ? (const Entity&)(mv_asteroids[b])
+		                                            : (const Entity&)(mv_crystals[mv_moving_crystals[b - asteroid_count]]);
+		m_body_store.set(b, entity.getPosition(), entity.getVelocity());
+	}
+
+	m_body_store.updatePhysics(begin, end, delta_time, m_black_hole.getPosition(), m_black_hole.getMass());
+
+	for(unsigned int b = begin; b < end; b++)
+	{
+		if(b < asteroid_count)
+		{
+			Asteroid& asteroid = mv_asteroids[b];
+			asteroid.setPositionAndVelocity(m_body_store.getPosition(b), m_body_store.getVelocity(b));
+			asteroid.updateRotation(delta_time);
+		}
+		else
+		{
+			Crystal& crystal = mv_crystals[mv_moving_crystals[b - asteroid_count]];
+			crystal.setPositionAndVelocity(m_body_store.getPosition(b), m_body_store.getVelocity(b));
+			crystal.updateRotation(delta_time);
+		}
+	}
+}
+
+void World :: initAsteroids (unsigned int asteroid_count)
+{
+	static const double DISTANCE_MIN = DISK_RADIUS * 0.2;
+	static const double DISTANCE_MAX = DISK_RADIUS * 0.8;
+
+	static const double SPEED_FACTOR_MIN = 0.5;
+	static const double SPEED_FACTOR_MAX = 1.5;
+
+	static const double OUTER_RADIUS_MIN =  50.0;
+	static const double OUTER_RADIUS_MAX = 400.0;
+	static const double INNER_FRACTION_MIN = 0.1;
+	static const double INNER_FRACTION_MAX = 0.5;
+
+	static const double  COLLISION_AHEAD_DISTANCE  = 1500.0;
+	static const double  COLLISION_HALF_SEPERATION =  500.0;
+	static const Vector3 COLLISION_POSITION_1(COLLISION_AHEAD_DISTANCE, PLAYER_START_DISTANCE,  COLLISION_HALF_SEPERATION);
+	static const Vector3 COLLISION_POSITION_2(COLLISION_AHEAD_DISTANCE, PLAYER_START_DISTANCE, -COLLISION_HALF_SEPERATION);
+
+	assert(asteroid_count >= 2);
+
+	// create 2 asteroids to collide in front of player
+	double collider_speed1 = getCircularOrbitSpeed(COLLISION_POSITION_1.getNorm()) * 0.9;
+	double collider_speed2 = getCircularOrbitSpeed(COLLISION_POSITION_2.getNorm()) * 1.1;
+	Vector3 collider_velocity1 = Vector3(0.0, 0.0, -collider_speed1);
+	Vector3 collider_velocity2 = Vector3(0.0, 0.0,  collider_speed2);
+	double collider_inner_radius1 = OUTER_RADIUS_MAX * INNER_FRACTION_MIN;
+	double collider_inner_radius2 = OUTER_RADIUS_MIN * INNER_FRACTION_MAX;
+
+	// the models are added afterwards, in parallel
+	mv_asteroids.reserve(asteroid_count);
+	mv_asteroids.push_back(Asteroid(COLLISION_POSITION_1, collider_velocity1,
+	                                collider_inner_radius1, OUTER_RADIUS_MAX));
+	mv_asteroids.push_back(Asteroid(COLLISION_POSITION_2, collider_velocity2,
+	                                collider_inner_radius2, OUTER_RADIUS_MIN));
+
+	// create remaining asteroids
+	for(unsigned a = 2; a < asteroid_count; a++)
+	{
+		// choose a random position in a thick shell around the black hole
+		double distance = random2(DISTANCE_MIN, DISTANCE_MAX);
+		Vector3 position = Vector3::getRandomUnitVector() * distance;
+
+		// choose starting velocity
+		double speed_circle = getCircularOrbitSpeed(distance);
+		double speed_factor = random2(SPEED_FACTOR_MIN, SPEED_FACTOR_MAX);
+		double speed = speed_circle * speed_factor;
+		Vector3 velocity = Vector3::getRandomUnitVector().getRejection(position);  // tangent to gravity
+		assert(!velocity.isZero());
+		velocity.setNorm(speed);
+
+		// mostly smaller asteroids
+		double outer_radius = min(random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX),
+		                          random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX));
+
+		double inner_fraction = random2(INNER_FRACTION_MIN, INNER_FRACTION_MAX);
+		double inner_radius   = outer_radius * inner_fraction;
+
+		mv_asteroids.push_back(Asteroid(position, velocity,
+		                                inner_radius, outer_radius));
+	}
+	assert(mv_asteroids.size() == asteroid_count);
+
+	// the radius cubemaps need more noise samples than the
+	//   vertexes, so they are made on all threads too
+#ifndef HEADLESS_SIMULATION
+	if(m_is_displayed && m_is_asteroid_vertex_buffers_needed)
+		initAsteroidVertexBuffers();
+	else
+#endif
+		initAsteroidRadiusCubemaps();
+}
+
+#ifndef HEADLESS_SIMULATION
+void World :: initAsteroidVertexBuffers ()
+{
+	assert(isDisplayed());
+	assert(isAsteroidVertexBuffersNeeded());
+	assert(mv_asteroid_meshes.size() == ASTEROID_MODEL_COUNT * ASTEROID_LOD_COUNT);
+
+	// only one float per vertex, so all the radii can be
+	//   calculated before any are used
+	unsigned int asteroid_count = (unsigned int)(mv_asteroids.size());
+	vector<vector<float> > vv_radii(asteroid_count * ASTEROID_LOD_COUNT);
+
+	// evaluating the noise does not need OpenGL
+	m_thread_pool.runChunks(asteroid_count, 1,
+	                        [this, &vv_radii] (unsigned int begin, unsigned int end)
+	                        {
+	                            for(unsigned int a = begin; a < end; a++)
+	                            {
+	                                if(!mv_asteroids[a].isRadiusCubemap())
+	                                    mv_asteroids[a].initRadiusCubemap();
+
+	                                for(unsigned int lod = 0; lod < ASTEROID_LOD_COUNT; lod++)
+	                                {
+	                                    const AsteroidMesh& mesh = getAsteroidMesh(getAsteroidMeshIndex(a), lod);
+	                                    vv_radii[a * ASTEROID_LOD_COUNT + lod] = mv_asteroids[a].calculateVertexRadii(mesh);
+	                                }
+	                            }
+	                        });
+
+	// creating VertexBufferModels must be done on this thread
+	vector<VertexBufferModel> v_lod_models(ASTEROID_LOD_COUNT);
+	for(unsigned int a = 0; a < asteroid_count; a++)
+	{
+		for(unsigned int lod = 0; lod < ASTEROID_LOD_COUNT; lod++)
+		{
+			const AsteroidMesh& mesh = getAsteroidMesh(getAsteroidMeshIndex(a), lod);
+			v_lod_models[lod] = mesh.createVertexBufferModel(vv_radii[a * ASTEROID_LOD_COUNT + lod]);
+		}
+		mv_asteroids[a].setVertexBufferModels(v_lod_models);
+	}
+}
+#endif
+
+void World :: initAsteroidRadiusCubemaps ()
+{
+	m_thread_pool.runChunks((unsigned int)(mv_asteroids.size()), 1,
+	                        [this] (unsigned int begin, unsigned int end)
+	                        {
+	                            for(unsigned int a = begin; a < end; a++)
+	                                if(!mv_asteroids[a].isRadiusCubemap())
+	                                    mv_asteroids[a].initRadiusCubemap();
+	                        });
+}
+
+void World :: initPlayer ()
+{
+	const double PLAYER_FORWARD_POWER  = 500.0;  // m/s^2
+	const double PLAYER_MANEUVER_POWER =  50.0;  // m/s^2
+	const double PLAYER_ROTATION_RATE  =   3.0;  // radians / second
+	const double DRONE_MASS   = 100.0;
+	const double DRONE_RADIUS =   2.0;
+	const double DRONEPOWER = 250.0;
+	const double DRONEMPOWER = 25.0;
+	const double DRONEROTATE = 1.0;
+	double  player_speed    = getCircularOrbitSpeed(PLAYER_START_DISTANCE);
+	Vector3 player_position(0.0, PLAYER_START_DISTANCE, 0.0);
+
+	//---------------------
+	//Position of 5 drones
+	//---------------------
+	Vector3 a_drone_positions[DRONE_COUNT] =
+	{
+		player_position + DRONE_OFFSET1,
+		player_position + DRONE_OFFSET2,
+		player_position + DRONE_OFFSET3,
+		player_position + DRONE_OFFSET4,
+		player_position + DRONE_OFFSET5,
+	};
+
+	Vector3 player_velocity = PLAYER_START_FORWARD * player_speed;
+
+#ifndef HEADLESS_SIMULATION
+	if(m_is_displayed)
+	{
+		assert(m_player_display_list.isReady());
+		m_player = Spaceship(player_position, player_velocity,
+		                     PLAYER_MASS, PLAYER_RADIUS,
+		                     PLAYER_FORWARD_POWER, PLAYER_MANEUVER_POWER, PLAYER_ROTATION_RATE,
+		                     m_player_display_list);
+	}
+	else
+#endif
+	{
+		m_player = Spaceship(player_position, player_velocity,
+		                     PLAYER_MASS, PLAYER_RADIUS,
+		                     PLAYER_FORWARD_POWER, PLAYER_MANEUVER_POWER, PLAYER_ROTATION_RATE);
+	}
+
+	// Initialize Drone
+	m_live_drones = DRONE_COUNT;
+	for(unsigned int i = 0; i < DRONE_COUNT; i++)
+	{
+		ma_avoid[i] = NO_ASTEROID;
+#ifndef HEADLESS_SIMULATION
+		if(m_is_displayed)
+			ma_drones[i] = Drone(a_drone_positions[i], player_velocity, DRONE_MASS, DRONE_RADIUS,
+			                     DRONEPOWER, DRONEMPOWER, DRONEROTATE, ma_drone_display_lists[i]);
+		else
+#endif
+			ma_drones[i] = Drone(a_drone_positions[i], player_velocity, DRONE_MASS, DRONE_RADIUS,
+			                     DRONEPOWER, DRONEMPOWER, DRONEROTATE);
+	}
+}
+
+void World :: addCrystal (const ObjLibrary::Vector3& position,
+                          const ObjLibrary::Vector3& asteroid_velocity)
+{
+	Vector3 crystal_velocity = asteroid_velocity + Vector3::getRandomUnitVector() * CRYSTAL_KNOCK_OFF_SPEED;
+#ifndef HEADLESS_SIMULATION
+	if(m_is_displayed)
+		mv_crystals.push_back(Crystal(position, crystal_velocity, m_crystal_display_list));
+	else
+#endif
+		mv_crystals.push_back(Crystal(position, crystal_velocity));
+}
+
+
+
+bool World :: invariant () const
+{
+	if(m_live_drones > DRONE_COUNT) return false;
+	if(m_simulation_time < 0.0) return false;
+	return true;
+}
@@ -0,0 +1,694 @@
+//
+//  World.h
+//
+//  A module to represent the simulated world.
+//
+
+#pragma once
+
+#include <cassert>
+#include <vector>
+#include <utility>  // for pair
+
+#include "ObjLibrary/Vector3.h"
+#ifndef HEADLESS_SIMULATION
+#include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/DisplayList.h"
+#endif
+
+#include "BlackHole.h"
+#include "Asteroid.h"
+#ifndef HEADLESS_SIMULATION
+#include "AsteroidMesh.h"
+#endif
+#include "Crystal.h"
+#include "Spaceship.h"
+#include "Drone.h"
+#include "SpatialHash.h"
+#include "BodyStore.h"
+#include "ThreadPool.h"
+
+
+
+//
+//  World
+//
+//  A class to represent the simulated world: the black hole,
+//    the asteroids, the crystals, the player, and the drones.
+//    The World contains all the simulation state and the rules
+//    for advancing it, but does not handle input, timing, or
+//    drawing.
+//
+//  A World can be run with or without display models.  If
+//    setDisplayModels has not been called, the entities are
+//    created without DisplayLists.  They can be simulated but
+//    not drawn, and no OpenGL context is needed.
+//
+//  Class Invariant:
+//    <1> m_live_drones <= DRONE_COUNT
+//    <2> m_simulation_time >= 0.0
+//
+class World
+{
+public:
+//
+//  DRONE_COUNT
+//
+//  The number of drones escorting the player.
+//
+	static const unsigned int DRONE_COUNT = 5;
+
+//
+//  ASTEROID_MODEL_COUNT
+//
+//  The number of base models used to generate asteroids.
+//
+	static const unsigned int ASTEROID_MODEL_COUNT = 25;
+
+//
+//  ASTEROID_LOD_COUNT
+//
+//  The number of levels of detail (LODs) that asteroids can be
+//    displayed at.  LOD 0 uses the base models and the others
+//    use generated spheres with fewer triangles.
+//
+	static const unsigned int ASTEROID_LOD_COUNT = 4;
+
+//
+//  ASTEROID_COUNT_DEFAULT
+//
+//  The default number of asteroids in the world.
+//
+	static const unsigned int ASTEROID_COUNT_DEFAULT = 100;
+
+//
+//  DISK_RADIUS
+//
+//  The radius of the black hole accretion disk.  Asteroids are
+//    created inside this radius.
+//
+	static const double DISK_RADIUS;
+
+//
+//  ASTEROID_LOD_PIXEL_RADII
+//
+//  The smallest radius on the screen, in pixels, that an
+//    asteroid should have to be displayed at each level of
+//    detail.  The last element is 0.0.
+//
+	static const double ASTEROID_LOD_PIXEL_RADII[ASTEROID_LOD_COUNT];
+
+//
+//  NO_CRYSTAL
+//
+//  A constant returned by getChasingCrystal() to indicate that
+//    no crystal is being chased.
+//
+	static const unsigned int NO_CRYSTAL = 0xFFFFFFFF;
+
+public:
+//
+//  Constructor
+//
+//  Purpose: To create an empty World without display models.
+//  Parameter(s):
+//    <1> thread_count: The number of threads to use for the
+//                      physics updates, or 0 to use the number
+//                      of hardware threads
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: A new World is created.  It contains no
+//               entities until init is called.  The worker
+//               threads are started.
+//
+	World (unsigned int thread_count = 0);
+
+	World (const World& to_copy) = delete;
+	~World () = default;
+	World& operator= (const World& to_copy) = delete;
+
+//
+//  isDisplayed
+//
+//  Purpose: To determine whether this World creates entities
+//           that can be displayed.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether display models have been set.  If
+//           HEADLESS_SIMULATION is defined, they cannot be
+//           set, so false is always returned.
+//  Side Effect: N/A
+//
+	bool isDisplayed () const
+	{
+		return m_is_displayed;
+	}
+
+#ifndef HEADLESS_SIMULATION
+//
+//  isAsteroidVertexBuffersNeeded
+//
+//  Purpose: To determine whether this World creates a
+//           VertexBufferModel for each asteroid.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether asteroids created by this World are given
+//           their own VertexBufferModels when it is displayed.
+//  Side Effect: N/A
+//
+	bool isAsteroidVertexBuffersNeeded () const
+	{
+		return m_is_asteroid_vertex_buffers_needed;
+	}
+#endif
+
+//
+//  getBlackHole
+//  getPlayer
+//
+//  Purpose: To retrieve the black hole or the player ship.  The
+//           player is const IFF this World is.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The black hole or player.
+//  Side Effect: N/A
+//
+	const BlackHole& getBlackHole () const
+	{
+		return m_black_hole;
+	}
+	const Spaceship& getPlayer () const
+	{
+		return m_player;
+	}
+	Spaceship& getPlayer ()
+	{
+		return m_player;
+	}
+
+//
+//  getAsteroidCount
+//  getAsteroid
+//
+//  Purpose: To retrieve the asteroids.
+//  Parameter(s):
+//    <1> index: Which asteroid
+//  Preconditions:
+//    <1> index < getAsteroidCount()
+//  Returns: The number of asteroids or the asteroid with index
+//           index.
+//  Side Effect: N/A
+//
+	unsigned int getAsteroidCount () const
+	{
+		return (unsigned int)(mv_asteroids.size());
+	}
+	const Asteroid& getAsteroid (unsigned int index) const
+	{
+		assert(index < getAsteroidCount());
+
+		return mv_asteroids[index];
+	}
+
+//
+//  getAsteroidMeshIndex
+//
+//  Purpose: To determine which shared mesh is used to display
+//           an asteroid.
+//  Parameter(s):
+//    <1> index: Which asteroid
+//  Preconditions:
+//    <1> index < getAsteroidCount()
+//  Returns: The index of the AsteroidMesh for asteroid index,
+//           which is less than ASTEROID_MODEL_COUNT.
+//  Side Effect: N/A
+//
+	unsigned int getAsteroidMeshIndex (unsigned int index) const
+	{
+		assert(index < getAsteroidCount());
+
+		return index % ASTEROID_MODEL_COUNT;
+	}
+
+#ifndef HEADLESS_SIMULATION
+//
+//  getAsteroidMesh
+//
+//  Purpose: To retrieve one of the shared asteroid meshes.
+//  Parameter(s):
+//    <1> mesh: Which mesh
+//    <2> lod: Which level of detail
+//  Preconditions:
+//    <1> isDisplayed()
+//    <2> mesh < ASTEROID_MODEL_COUNT
+//    <3> lod < ASTEROID_LOD_COUNT
+//  Returns: The AsteroidMesh with index mesh at level of detail
+//           lod.
+//  Side Effect: N/A
+//
+	const AsteroidMesh& getAsteroidMesh (unsigned int mesh,
+	                                     unsigned int lod) const
+	{
+		assert(isDisplayed());
+		assert(mesh < ASTEROID_MODEL_COUNT);
+		assert(lod < ASTEROID_LOD_COUNT);
+
+		return mv_asteroid_meshes[lod * ASTEROID_MODEL_COUNT + mesh];
+	}
+#endif
+
+//
+//  getCrystalCount
+//  getCrystal
+//
+//  Purpose: To retrieve the crystals.  This includes crystals
+//           that are gone.
+//  Parameter(s):
+//    <1> index: Which crystal
+//  Preconditions:
+//    <1> index < getCrystalCount()
+//  Returns: The number of crystals or the crystal with index
+//           index.
+//  Side Effect: N/A
+//
+	unsigned int getCrystalCount () const
+	{
+		return (unsigned int)(mv_crystals.size());
+	}
+	const Crystal& getCrystal (unsigned int index) const
+	{
+		assert(index < getCrystalCount());
+
+		return mv_crystals[index];
+	}
+
+//
+//  getDrone
+//  getDroneStatus
+//
+//  Purpose: To retrieve a drone or its current AI state.
+//  Parameter(s):
+//    <1> index: Which drone
+//  Preconditions:
+//    <1> index < DRONE_COUNT
+//  Returns: The drone with index index or its status.  The
+//           status is 0 for dead, 1 for avoiding an asteroid,
+//           2 for chasing a crystal, and 3 for escorting the
+//           player.
+//  Side Effect: N/A
+//
+	const Drone& getDrone (unsigned int index) const
+	{
+		assert(index < DRONE_COUNT);
+
+		return ma_drones[index];
+	}
+	int getDroneStatus (unsigned int index) const
+	{
+		assert(index < DRONE_COUNT);
+
+		return ma_drone_status[index];
+	}
+
+//
+//  getChasingCrystal
+//  getPursuitDrone
+//
+//  Purpose: To determine which crystal is being chased and
+//           which drone is chasing it.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The index of the crystal being chased, or
+//           NO_CRYSTAL if there is none, or the index of the
+//           drone doing the chasing.
+//  Side Effect: N/A
+//
+	unsigned int getChasingCrystal () const
+	{
+		return m_chasing;
+	}
+	unsigned int getPursuitDrone () const
+	{
+		return m_pursuit;
+	}
+
+//
+//  getCrystalsCollected
+//  getLiveDroneCount
+//
+//  Purpose: To determine the number of crystals collected or
+//           the number of drones still alive.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The requested count.
+//  Side Effect: N/A
+//
+	unsigned int getCrystalsCollected () const
+	{
+		return m_crystals_collected;
+	}
+	unsigned int getLiveDroneCount () const
+	{
+		return m_live_drones;
+	}
+
+//
+//  getThreadCount
+//
+//  Purpose: To determine the number of threads used for the
+//           physics updates.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The number of threads.
+//  Side Effect: N/A
+//
+	unsigned int getThreadCount () const
+	{
+		return m_thread_pool.getThreadCount();
+	}
+
+//
+//  getThreadPool
+//
+//  Purpose: To retrieve the ThreadPool used for the physics
+//           updates, so that other work can share its threads
+//           instead of starting more.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: A reference to the ThreadPool.  It must only be
+//           used from the thread that updates this World, and
+//           not while an update is running.
+//  Side Effect: N/A
+//
+	ThreadPool& getThreadPool ()
+	{
+		return m_thread_pool;
+	}
+
+//
+//  getSimulationTime
+//
+//  Purpose: To determine how much simulated time has passed
+//           since this World was initialized.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: The simulation time in seconds.
+//  Side Effect: N/A
+//
+	double getSimulationTime () const
+	{
+		return m_simulation_time;
+	}
+
+//
+//  getCircularOrbitSpeed
+//
+//  Purpose: To determine the speed needed for a circular orbit
+//           around the black hole at the specified distance.
+//  Parameter(s):
+//    <1> distance: The orbit radius
+//  Preconditions:
+//    <1> distance > 0.0
+//  Returns: The orbital speed.
+//  Side Effect: N/A
+//
+	double getCircularOrbitSpeed (double distance) const;
+
+#ifndef HEADLESS_SIMULATION
+//
+//  setDisplayModels
+//
+//  Purpose: To set the models used to display the entities in
+//           this World.
+//  Parameter(s):
+//    <1> disk: The DisplayList for the accretion disk
+//    <2> crystal: The DisplayList for crystals
+//    <3> player: The DisplayList for the player ship
+//    <4> a_drones: An array of DRONE_COUNT DisplayLists for
+//                  the drones
+//    <5> a_asteroid_models: An array of ASTEROID_MODEL_COUNT
+//                           base models for the asteroids
+//  Preconditions:
+//    <1> disk.isReady()
+//    <2> crystal.isReady()
+//    <3> player.isReady()
+//    <4> a_drones != nullptr
+//    <5> a_asteroid_models != nullptr
+//  Returns: N/A
+//  Side Effect: Entities created by this World after this call
+//               will be displayable.  An AsteroidMesh is
+//               created for each asteroid base model, so
+//               a_asteroid_models is not needed after this
+//               call.  AsteroidMeshes with fewer triangles are
+//               also created for the other levels of detail.
+//
+	void setDisplayModels (
+	          const ObjLibrary::DisplayList& disk,
+	          const ObjLibrary::DisplayList& crystal,
+	          const ObjLibrary::DisplayList& player,
+	          const ObjLibrary::DisplayList a_drones[],
+	          const ObjLibrary::ObjModel a_asteroid_models[]);
+#endif
+
+//
+//  init
+//
+//  Purpose: To remove any existing entities from this World and
+//           create a new set.
+//  Parameter(s):
+//    <1> asteroid_count: The number of asteroids
+//  Preconditions:
+//    <1> asteroid_count >= 2
+//  Returns: N/A
+//  Side Effect: This World is reset with a new black hole,
+//               asteroid_count asteroids, no crystals, the
+//               player, and the drones.
+//
+	void init (unsigned int asteroid_count = ASTEROID_COUNT_DEFAULT);
+
+#ifndef HEADLESS_SIMULATION
+//
+//  setAsteroidVertexBuffersNeeded
+//
+//  Purpose: To change whether this World creates a
+//           VertexBufferModel for each asteroid.  They are only
+//           needed to draw the asteroids one at a time, so they
+//           can be skipped if the asteroids are drawn instanced
+//           from the shared AsteroidMeshes.
+//  Parameter(s):
+//    <1> is_needed: Whether the VertexBufferModels are needed
+//  Preconditions:
+//    <1> This function is called from the thread with the
+//        OpenGL context
+//  Returns: N/A
+//  Side Effect: Asteroids created after this call are given
+//               VertexBufferModels if and only if is_needed and
+//               isDisplayed().  If is_needed, isDisplayed(),
+//               and the existing asteroids were created without
+//               VertexBufferModels, they are given them now.
+//               The default is true.
+//
+	void setAsteroidVertexBuffersNeeded (bool is_needed);
+#endif
+
+//
+//  knockOffCrystals
+//
+//  Purpose: To knock crystals off all asteroids near the
+//           player.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Every asteroid with crystals that is within
+//               range of the player releases its crystals.
+//
+	void knockOffCrystals ();
+
+//
+//  updatePhysics
+//
+//  Purpose: To advance the entities in this World by one time
+//           step.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//  Preconditions:
+//    <1> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: All entities are moved and the drones decide
+//               what to do.  The asteroids and crystals are
+//               copied into a BodyStore, moved together, and
+//               copied back, divided into chunks across the
+//               worker threads.  The results do not depend on
+//               the number of threads.
+//
+	void updatePhysics (double delta_time);
+
+//
+//  updatePhysicsOnRails
+//
+//  Purpose: To advance the entities in this World by a possibly
+//           very long time step, as for time acceleration.
+//  Parameter(s):
+//    <1> delta_time: The length of the time step in seconds
+//  Preconditions:
+//    <1> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: All living entities are moved along their exact
+//               orbits around the black hole for delta_time
+//               seconds.  The drones do not think, so they
+//               coast along their orbits.
+//
+//  The entities are "on rails", so handleCollisions should not
+//    be called between these time steps.  Entities would pass
+//    through each other during a long time step, and resolving
+//    collisions only at the ends of the steps can throw
+//    asteroids out at unrealistic speeds.
+//
+	void updatePhysicsOnRails (double delta_time);
+
+//
+//  handleCollisions
+//
+//  Purpose: To detect and resolve collisions between the
+//           entities in this World.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Colliding entities bounce, are collected, or
+//               are destroyed.  A spatial hash is used to find
+//               the pairs of entities that might be colliding,
+//               and the collisions are resolved in the same order
+//               as if every pair were checked.
+//
+	void handleCollisions ();
+
+private:
+//
+//  Helper Function: initAsteroids
+//  Helper Function: initPlayer
+//  Helper Function: addCrystal
+//
+//  Purpose: To create the asteroids, the player and drones, or
+//           a single crystal.
+//  Parameter(s):
+//    <1> asteroid_count: The number of asteroids
+//    <1> position: The position of the new crystal
+//    <2> asteroid_velocity: The velocity of the asteroid the
+//                           crystal was knocked off
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: The entities are added to this World.
+//
+	void initAsteroids (unsigned int asteroid_count);
+	void initPlayer ();
+	void addCrystal (const ObjLibrary::Vector3& position,
+	                 const ObjLibrary::Vector3& asteroid_velocity);
+
+#ifndef HEADLESS_SIMULATION
+//
+//  Helper Function: initAsteroidVertexBuffers
+//
+//  Purpose: To create the VertexBufferModels for the asteroids.
+//           The vertex radii are calculated in parallel, and
+//           only the VertexBufferModels are created on the
+//           calling thread.  Any missing radius cubemaps are
+//           made in the same parallel pass.
+//  Parameter(s): N/A
+//  Preconditions:
+//    <1> isDisplayed()
+//    <2> This function is called from the thread with the
+//        OpenGL context
+//  Returns: N/A
+//  Side Effect: Each asteroid is given a VertexBufferModel
+//               for each level of detail, based on the shared
+//               asteroid meshes.  This uses a lot of video
+//               memory, so it is only done if
+//               isAsteroidVertexBuffersNeeded().
+//
+	void initAsteroidVertexBuffers ();
+#endif
+
+//
+//  Helper Function: initAsteroidRadiusCubemaps
+//
+//  Purpose: To make the radius cubemaps for the asteroids in
+//           parallel.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: N/A
+//  Side Effect: Each asteroid without a radius cubemap is
+//               given one.
+//
+	void initAsteroidRadiusCubemaps ();
+
+//
+//  Helper Function: updateBodies
+//
+//  Purpose: To move a range of the asteroids and crystals for
+//           one time step by copying them into the BodyStore,
+//           updating it, and copying the results back.
+//  Parameter(s):
+//    <1> begin: The first body to update
+//    <2> end: One past the last body to update
+//    <3> delta_time: The length of the time step in seconds
+//  Preconditions:
+//    <1> begin <= end
+//    <2> end <= m_body_store.getCount()
+//    <3> delta_time > 0.0
+//  Returns: N/A
+//  Side Effect: Bodies begin to end - 1 are moved and rotated.
+//               Bodies [0, getAsteroidCount()) are the
+//               asteroids, and the rest are the crystals listed
+//               in mv_moving_crystals.  Only data for these
+//               bodies is changed, so different ranges can be
+//               updated on different threads at the same time.
+//
+	void updateBodies (unsigned int begin,
+	                   unsigned int end,
+	                   double delta_time);
+
+//
+//  invariant
+//
+//  Purpose: To determine whether the class invariant is true.
+//  Parameter(s): N/A
+//  Preconditions: N/A
+//  Returns: Whether the class invariant is true.
+//  Side Effect: N/A
+//
+	bool invariant () const;
+
+private:
+	static const unsigned int NO_ASTEROID = 0xFFFFFFFF;
+
+	bool m_is_displayed;
+#ifndef HEADLESS_SIMULATION
+	bool m_is_asteroid_vertex_buffers_needed;
+	ObjLibrary::DisplayList m_disk_display_list;
+	ObjLibrary::DisplayList m_crystal_display_list;
+	ObjLibrary::DisplayList m_player_display_list;
+	ObjLibrary::DisplayList ma_drone_display_lists[DRONE_COUNT];
+	std::vector<AsteroidMesh> mv_asteroid_meshes;
+#endif
+
+	BlackHole m_black_hole;
+	std::vector<Asteroid> mv_asteroids;
+	std::vector<Crystal> mv_crystals;
+	Spaceship m_player;
+	unsigned int m_crystals_collected;
+
+	Drone ma_drones[DRONE_COUNT];
+	int ma_drone_status[DRONE_COUNT];
+	unsigned int ma_avoid[DRONE_COUNT];
+	unsigned int m_chasing;
+	unsigned int m_pursuit;
+	unsigned int m_live_drones;
+	double m_simulation_time;
+
+	ThreadPool m_thread_pool;
+	std::vector<unsigned int> mv_moving_crystals;
+	BodyStore m_body_store;
+	SpatialHash m_spatial_hash;
+	std::vector<std::pair<unsigned int, unsigned int> > mv_collision_pairs;
+};
+
@@ -1,8 +1,15 @@
 //
 //  main.cpp
 //
+//  The headless simulation in Headless.cpp has its own main
+//    function, so nothing in this file is compiled if
+//    HEADLESS_SIMULATION is defined.
+//
+
+#ifndef HEADLESS_SIMULATION
 
 #include <cassert>
+#include <cstdlib>  // for atexit
 #include <climits>
 #include <cctype>  // for toupper
 #include <sstream>
@@ -16,30 +23,36 @@
 
 #include "ObjLibrary/Vector3.h"
 #include "ObjLibrary/ObjModel.h"
+#include "ObjLibrary/Material.h"
+#include "ObjLibrary/VertexBufferModel.h"
 #include "ObjLibrary/DisplayList.h"
 #include "ObjLibrary/SpriteFont.h"
+#include "ObjLibrary/TextureManager.h"
 
-#include "Gravity.h"
 #include "CoordinateSystem.h"
-#include "PerlinNoiseField3.h"
 #include "Entity.h"
 #include "BlackHole.h"
 #include "Asteroid.h"
 #include "Crystal.h"
 #include "Spaceship.h"
-#include "Collisions.h"
 #include "Drone.h"
+#include "World.h"
+#include "AsteroidMesh.h"
+#include "AsteroidInstanceRenderer.h"
+#include "ViewFrustum.h"
+#include "LevelOfDetailSelector.h"
+#include "RenderQueue.h"
+#include "TrajectoryCache.h"
+#include "ThreadPool.h"
 
 using namespace std;
 using namespace chrono;
 using namespace ObjLibrary;
 
 void initDisplay ();
+void stopTextureStreaming ();
 void loadModels ();
 void initEntities ();
-void initAsteroids ();
-void initPlayer ();
-double getCircularOrbitSpeed (double distance);
 void initTime ();
 
 unsigned char fixShift (unsigned char key);
@@ -50,16 +63,13 @@ void specialUp (int special_key, int x, int y);
 
 void update ();
 void handleInput (double delta_time);
-void knockOffCrystals ();
-void addCrystal (const ObjLibrary::Vector3& position,
-                 const ObjLibrary::Vector3& asteroid_velocity);
-void updatePhysics (double delta_time);
-void handleCollisions ();
 
 void reshape (int w, int h);
 void display ();
-void drawSkybox ();
-void drawEntities (bool is_show_debug);
+void queueSkybox ();
+void queueEntities (bool is_show_debug);
+bool isVisible (const Vector3& center, double radius);
+void drawPathsAndDebug (bool is_show_debug);
 void drawOverlays ();
 
 namespace
@@ -82,6 +92,7 @@ namespace
 	const microseconds PHYSICS_MICROSECONDS(1000000 / PHYSICS_PER_SECOND);
 	const unsigned int MAXIMUM_UPDATES_PER_FRAME = 10;
 	const unsigned int FAST_PHYSICS_FACTOR = 10;
+	const unsigned int WARP_PHYSICS_FACTOR = 1000;
 	const double SIMULATE_SLOW_SECONDS = 0.05;
 
 	system_clock::time_point next_update_time;
@@ -94,85 +105,56 @@ namespace
 	bool g_is_paused     = false;
 	bool g_is_show_debug = false;
 
-	const unsigned int ASTEROID_COUNT = 100;
-
-	const double BLACK_HOLE_RADIUS  =    50.0;
-	const double DISK_RADIUS        = 10000.0;
-	const double PLAYER_RADIUS      =     4.0;
 	const double DEBUG_MAX_DISTANCE =  2000.0;
 
-	static const double BLACK_HOLE_MASS = 5.0e16;  // kg
-	static const double PLAYER_MASS     = 1000.0;  // kg
-
+	// textures read in the background are added this many per frame
+	const unsigned int TEXTURE_UPLOADS_PER_FRAME = 2;
 
 	DisplayList g_skybox_display_list;
 	DisplayList g_disk_display_list;
 	DisplayList g_crystal_display_list;
 	DisplayList g_player_display_list;
-	DisplayList bad_drones_list[5];
-	
-	BlackHole g_black_hole;
-
-	static const unsigned int ASTEROID_MODEL_COUNT = 25;
-	ObjModel ga_asteroid_models[ASTEROID_MODEL_COUNT];
+	DisplayList bad_drones_list[World::DRONE_COUNT];
 
-	vector<Asteroid> gv_asteroids;
-
-	const double CRYSTAL_KNOCK_OFF_RANGE = 500.0;
-	const unsigned int CRYSTAL_KNOCK_OFF_COUNT = 10;
-	const double CRYSTAL_KNOCK_OFF_SPEED = 10.0;
-	vector<Crystal> gv_crystals;
+	ObjModel ga_asteroid_models[World::ASTEROID_MODEL_COUNT];
 
 	const double  CAMERA_BACK_DISTANCE  =   20.0;
 	const double  CAMERA_UP_DISTANCE    =    5.0;
-	const double  PLAYER_START_DISTANCE = 1000.0;
-	const Vector3 PLAYER_START_FORWARD(1.0, 0.0, 0.0);
-	Spaceship g_player;
-	unsigned int g_crystals_collected = 0;
-
-	// New variables
-	// States for Drones
-	int droneStatus[6] = { 3, 3, 3, 3, 3, 3 };
-	int chasing = 10000;
-	int pursuit;
-	int avoid[5] = { 1000,1000,1000,1000,1000 };
-
-	unsigned int live_drones = 5;
-	
-	// Drone class
-	Drone drones[5];
+	const double  CAMERA_FIELD_OF_VIEW  =   60.0;  // degrees
+	const double  CAMERA_NEAR_DISTANCE  =    1.0;
+	const double  CAMERA_FAR_DISTANCE   = 100000.0;
+
+	// entities smaller than this on the screen are not drawn
+	const double MIN_DRAWN_PIXEL_RADIUS = 0.25;
+
+	// fraction asteroids must pass a LOD threshold by to change LOD
+	const double ASTEROID_LOD_HYSTERESIS = 0.2;
+
 	// drone obj model
 	ObjModel bad_drones;
-	
-	// Drone offset position
-	Vector3 Doffset1(3.0, 4.0, 0.0);
-	Vector3 Doffset2(0.0, 8.0, -6.0);
-	Vector3 Doffset3(0.0, 8.0, 6.0);
-	Vector3 Doffset4(0.0, -5.0, 0.0);
-	Vector3 Doffset5(0.0, 10.0, 0.0);
-	Vector3 Doffset[5];
-
-	double random01 ()
-	{
-		return rand() / (RAND_MAX + 1.0);
-	}
 
-	double random2 (double min_value, double max_value)
-	{
-		assert(min_value <= max_value);
+	World g_world;
+	AsteroidInstanceRenderer g_asteroid_renderer;
+	LevelOfDetailSelector g_asteroid_lod_selector;
 
-		return min_value + random01() * (max_value - min_value);
-	}
+	// what the camera can see this frame
+	ViewFrustum g_view_frustum;
+	vector<unsigned int> gv_drawn_asteroids;  // reused between frames
+	unsigned int g_drawn_entity_count  = 0;
+	unsigned int g_culled_entity_count = 0;
+
+	// draw commands for this frame, reused between frames
+	RenderQueue g_render_queue;
+
+	// predicted path of the player, reused between frames
+	TrajectoryCache g_player_path_cache;
 
 }  // end of anonymous namespace
 
+
+
 int main (int argc, char* argv[])
 {
-	Doffset[0] = Vector3(3.0, 4.0, 0.0);
-	Doffset[1] = Vector3(0.0, 8.0, -6.0);
-	Doffset[2] = Vector3(0.0, 8.0, 6.0);
-	Doffset[3] = Vector3(0.0, -5.0, 0.0);
-	Doffset[4] = Vector3(0.0, 10.0, 0.0);
 	glutInitWindowSize(640, 480);
 	glutInitWindowPosition(0, 0);
 
@@ -205,168 +187,110 @@ void initDisplay ()
 	glEnable(GL_DEPTH_TEST);
 	glEnable(GL_CULL_FACE);
 
+	// textures not preloaded by loadModels do not stall a frame
+	TextureManager::startStreaming();
+	atexit(stopTextureStreaming);  // threads must not outlive main
+
 	glutPostRedisplay();
 }
 
+void stopTextureStreaming ()
+{
+	if(TextureManager::isStreaming())
+		TextureManager::stopStreaming();
+}
+
 void loadModels ()
 {
 	// change this to an absolute path on Mac computers
 	string path = "Models/";
 	
-	g_skybox_display_list  = ObjModel(path + "Skybox.obj")     .getDisplayList();
-	g_disk_display_list    = ObjModel(path + "Disk.obj")       .getDisplayList();
-	g_crystal_display_list = ObjModel(path + "Crystal.obj")    .getDisplayList();
-	g_player_display_list  = ObjModel(path + "Sagittarius.obj").getDisplayList();
-	
-	bad_drones.load("./Models/Grapple.obj");
-	
-	bad_drones_list[0] = bad_drones.getDisplayListMaterial("grapple_body_orange");
-	bad_drones_list[1] = bad_drones.getDisplayListMaterial("grapple_body_red");
-	bad_drones_list[2] = bad_drones.getDisplayListMaterial("grapple_body_yellow");
-	bad_drones_list[3] = bad_drones.getDisplayListMaterial("grapple_body_blue");
-	bad_drones_list[4] = bad_drones.getDisplayListMaterial("grapple_body_green");
-	
-	assert(ASTEROID_MODEL_COUNT <= 26);  // only 26 letters to use
-	for(unsigned m = 0; m < ASTEROID_MODEL_COUNT; m++)
+	// models are read from binary caches when they are up to date
+	ObjModel skybox_model;
+	ObjModel disk_model;
+	ObjModel crystal_model;
+	ObjModel player_model;
+	vector<ObjModel*> vp_models;
+	vector<string> v_filenames;
+	vp_models.push_back(&skybox_model);   v_filenames.push_back(path + "Skybox.obj");
+	vp_models.push_back(&disk_model);     v_filenames.push_back(path + "Disk.obj");
+	vp_models.push_back(&crystal_model);  v_filenames.push_back(path + "Crystal.obj");
+	vp_models.push_back(&player_model);   v_filenames.push_back(path + "Sagittarius.obj");
+	vp_models.push_back(&bad_drones);     v_filenames.push_back("./Models/Grapple.obj");
+
+	assert(World::ASTEROID_MODEL_COUNT <= 26);  // only 26 letters to use
+	for(unsigned int m = 0; m < World::ASTEROID_MODEL_COUNT; m++)
 	{
 		string filename = "AsteroidA.obj";
 		assert(filename[8] == 'A');
 		filename[8] = 'A' + m;
-		ga_asteroid_models[m].load(path + filename);
+		vp_models.push_back(&ga_asteroid_models[m]);
+		v_filenames.push_back(path + filename);
 	}
+	assert(vp_models.size() == v_filenames.size());
+
+	// reading the files and texture images does not need OpenGL
+	g_world.getThreadPool().runChunks((unsigned int)(vp_models.size()), 1,
+	                                  [&vp_models, &v_filenames] (unsigned int begin, unsigned int end)
+	                                  {
+	                                      for(unsigned int i = begin; i < end; i++)
+	                                      {
+	                                          vp_models[i]->loadCached(v_filenames[i]);
+	                                          vp_models[i]->preloadDisplayTextures();
+	                                      }
+	                                  });
+
+	// display lists must be created on this thread
+	g_skybox_display_list  = skybox_model.getDisplayList();
+	g_disk_display_list    = disk_model.getDisplayList();
+	g_crystal_display_list = crystal_model.getDisplayList();
+	g_player_display_list  = player_model.getDisplayList();
+
+	bad_drones_list[0] = bad_drones.getDisplayListMaterial("grapple_body_orange");
+	bad_drones_list[1] = bad_drones.getDisplayListMaterial("grapple_body_red");
+	bad_drones_list[2] = bad_drones.getDisplayListMaterial("grapple_body_yellow");
+	bad_drones_list[3] = bad_drones.getDisplayListMaterial("grapple_body_blue");
+	bad_drones_list[4] = bad_drones.getDisplayListMaterial("grapple_body_green");
 
 	font.load(path + "Font.bmp");
-}
 
-void initEntities ()
-{
-	// remove existing entities (if any)
-	gv_asteroids.clear();
-	gv_crystals.clear();
-	g_crystals_collected = 0;
-
-	// create new entities
-	g_black_hole = BlackHole(Vector3::ZERO, BLACK_HOLE_MASS,
-	                         BLACK_HOLE_RADIUS, DISK_RADIUS, g_disk_display_list);
-	initAsteroids();
-	initPlayer();
-}
+	g_world.setDisplayModels(g_disk_display_list, g_crystal_display_list, g_player_display_list,
+	                         bad_drones_list, ga_asteroid_models);
 
-void initAsteroids ()
-{
-	static const double DISTANCE_MIN = DISK_RADIUS * 0.2;
-	static const double DISTANCE_MAX = DISK_RADIUS * 0.8;
-
-	static const double SPEED_FACTOR_MIN = 0.5;
-	static const double SPEED_FACTOR_MAX = 1.5;
-
-	static const double OUTER_RADIUS_MIN =  50.0;
-	static const double OUTER_RADIUS_MAX = 400.0;
-	static const double INNER_FRACTION_MIN = 0.1;
-	static const double INNER_FRACTION_MAX = 0.5;
-
-	static const double  COLLISION_AHEAD_DISTANCE  = 1500.0;
-	static const double  COLLISION_HALF_SEPERATION =  500.0;
-	static const Vector3 COLLISION_POSITION_1(COLLISION_AHEAD_DISTANCE, PLAYER_START_DISTANCE,  COLLISION_HALF_SEPERATION);
-	static const Vector3 COLLISION_POSITION_2(COLLISION_AHEAD_DISTANCE, PLAYER_START_DISTANCE, -COLLISION_HALF_SEPERATION);
-
-	// create 2 asteroids to collide in front of player
-	double collider_speed1 = getCircularOrbitSpeed(COLLISION_POSITION_1.getNorm()) * 0.9;
-	double collider_speed2 = getCircularOrbitSpeed(COLLISION_POSITION_2.getNorm()) * 1.1;
-	Vector3 collider_velocity1 = Vector3(0.0, 0.0, -collider_speed1);
-	Vector3 collider_velocity2 = Vector3(0.0, 0.0,  collider_speed2);
-	double collider_inner_radius1 = OUTER_RADIUS_MAX * INNER_FRACTION_MIN;
-	double collider_inner_radius2 = OUTER_RADIUS_MIN * INNER_FRACTION_MAX;
-
-	assert(1 < ASTEROID_MODEL_COUNT);
-	assert(!ga_asteroid_models[0].isEmpty());
-	assert(!ga_asteroid_models[1].isEmpty());
-	gv_asteroids.push_back(Asteroid(COLLISION_POSITION_1, collider_velocity1,
-	                                collider_inner_radius1, OUTER_RADIUS_MAX,
-	                                ga_asteroid_models[0]));
-	gv_asteroids.push_back(Asteroid(COLLISION_POSITION_2, collider_velocity2,
-	                                collider_inner_radius2, OUTER_RADIUS_MIN,
-	                                ga_asteroid_models[1]));
-
-	// create remaining asteroids
-	for(unsigned a = 2; a < ASTEROID_COUNT; a++)
+	// the asteroid meshes are not display lists, so load their
+	//   textures from the preloaded images now
+	for(unsigned int m = 0; m < World::ASTEROID_MODEL_COUNT; m++)
 	{
-		// choose a random position in a thick shell around the black hole
-		double distance = random2(DISTANCE_MIN, DISTANCE_MAX);
-		Vector3 position = Vector3::getRandomUnitVector() * distance;
-
-		// choose starting velocity
-		double speed_circle = getCircularOrbitSpeed(distance);
-		double speed_factor = random2(SPEED_FACTOR_MIN, SPEED_FACTOR_MAX);
-		double speed = speed_circle * speed_factor;
-		Vector3 velocity = Vector3::getRandomUnitVector().getRejection(position);  // tangent to gravity
-		assert(!velocity.isZero());
-		velocity.setNorm(speed);
-
-		// mostly smaller asteroids
-		double outer_radius = min(random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX),
-		                          random2(OUTER_RADIUS_MIN, OUTER_RADIUS_MAX));
-
-		double inner_fraction = random2(INNER_FRACTION_MIN, INNER_FRACTION_MAX);
-		double inner_radius   = outer_radius * inner_fraction;
-
-		unsigned int model_index = a % ASTEROID_MODEL_COUNT;
-		assert(model_index < ASTEROID_MODEL_COUNT);
-		assert(!ga_asteroid_models[model_index].isEmpty());
-
-		gv_asteroids.push_back(Asteroid(position, velocity,
-		                                inner_radius, outer_radius,
-		                                ga_asteroid_models[model_index]));
+		const VertexBufferModel& mesh = g_world.getAsteroidMesh(m, 0).getBaseVertexBufferModel();
+		for(unsigned int r = 0; r < mesh.getMaterialRangeCount(); r++)
+		{
+			const Material* p_material = mesh.getMaterialRangeMaterial(r);
+			if(p_material != NULL)
+			{
+				p_material->activate();  // load into video memory
+				Material::deactivate();
+			}
+		}
 	}
-	assert(gv_asteroids.size() == ASTEROID_COUNT);
-}
 
-void initPlayer ()
-{
-	const double PLAYER_FORWARD_POWER  = 500.0;  // m/s^2
-	const double PLAYER_MANEUVER_POWER =  50.0;  // m/s^2
-	const double PLAYER_ROTATION_RATE  =   3.0;  // radians / second
-	const double DRONEPOWER = 250.0;
-	const double DRONEMPOWER = 25.0;
-	const double DRONEROTATE = 1.0;
-	double  player_speed    = getCircularOrbitSpeed(PLAYER_START_DISTANCE);
-	Vector3 player_position(0.0, PLAYER_START_DISTANCE, 0.0);
-
-	//---------------------
-	//Position of 5 drones
-	//---------------------
-	Vector3 drone_p0 = player_position + Doffset1;
-	Vector3 drone_p1 = player_position + Doffset2;
-	Vector3 drone_p2 = player_position + Doffset3;
-	Vector3 drone_p3 = player_position + Doffset4;
-	Vector3 drone_p4 = player_position + Doffset5;
-
-	Vector3 player_velocity = PLAYER_START_FORWARD * player_speed;
-
-	assert(g_player_display_list.isReady());
-	g_player = Spaceship(player_position, player_velocity,
-	                     PLAYER_MASS, PLAYER_RADIUS,
-	                     PLAYER_FORWARD_POWER, PLAYER_MANEUVER_POWER, PLAYER_ROTATION_RATE,
-	                     g_player_display_list);
-
-	// Initialize Drone
-	drones[0] = Drone(drone_p0, player_velocity, 100, 2,
-		DRONEPOWER, DRONEMPOWER, DRONEROTATE, bad_drones_list[0]);
-	drones[1] = Drone(drone_p1, player_velocity, 100, 2,
-		DRONEPOWER, DRONEMPOWER, DRONEROTATE, bad_drones_list[1]);
-	drones[2] = Drone(drone_p2, player_velocity, 100, 2,
-		DRONEPOWER, DRONEMPOWER, DRONEROTATE, bad_drones_list[2]);
-	drones[3] = Drone(drone_p3, player_velocity, 100, 2,
-		DRONEPOWER, DRONEMPOWER, DRONEROTATE, bad_drones_list[3]);
-	drones[4] = Drone(drone_p4, player_velocity, 100, 2,
-		DRONEPOWER, DRONEMPOWER, DRONEROTATE, bad_drones_list[4]);
+	// images for textures that were not used are not kept
+	TextureManager::discardPreloadedImages();
+
+	g_asteroid_lod_selector = LevelOfDetailSelector(vector<double>(World::ASTEROID_LOD_PIXEL_RADII,
+	                                                               World::ASTEROID_LOD_PIXEL_RADII + World::ASTEROID_LOD_COUNT),
+	                                                ASTEROID_LOD_HYSTERESIS);
+
+	// otherwise, the asteroids are drawn one at a time
+	if(AsteroidInstanceRenderer::isAvailable())
+		g_asteroid_renderer.init();
+
+	// instanced asteroids are drawn from the shared meshes
+	g_world.setAsteroidVertexBuffersNeeded(!g_asteroid_renderer.isInitialized());
 }
 
-double getCircularOrbitSpeed (double distance)
+void initEntities ()
 {
-	assert(distance > 0.0);
-
-	return sqrt(GRAVITY * g_black_hole.getMass() / distance);
+	g_world.init();
 }
 
 void initTime ()
@@ -468,16 +392,28 @@ void update ()
 	                        next_update_time < current_time; i++)
 	{
 		double delta_time = SECONDS_PER_PHYSICS;
+		bool is_warp = false;
 		if(g_is_paused)
 			delta_time = 0.0;
+		else if(key_pressed['h'])
+		{
+			// time warp: no control, exact orbits
+			delta_time *= WARP_PHYSICS_FACTOR;
+			is_warp = true;
+		}
 		else if(key_pressed['g'])
 			delta_time *= FAST_PHYSICS_FACTOR;
 
-		handleInput(delta_time);
+		handleInput(is_warp ? 0.0 : delta_time);  // no thrust while warping
 		if(delta_time > 0.0)
 		{
-			updatePhysics(delta_time);
-			handleCollisions();
+			if(is_warp)
+				g_world.updatePhysicsOnRails(delta_time);  // no collisions
+			else
+			{
+				g_world.updatePhysics(delta_time);
+				g_world.handleCollisions();
+			}
 
 			old_update_times[next_old_update_index % SMOOTH_RATE_COUNT] = current_time;
 			next_old_update_index++;
@@ -501,41 +437,43 @@ void update ()
 
 void handleInput (double delta_time)
 {
+	Spaceship& player = g_world.getPlayer();
+
 	//
 	//  Accelerate player - depends on physics rate
 	//
 
 	if(key_pressed[' '])
-		g_player.thrustMainEngine(delta_time);
+		player.thrustMainEngine(delta_time);
 	if(key_pressed[';'] || key_pressed['\''])  // either key
-		g_player.thrustManoeuver(delta_time,  g_player.getForward());
+		player.thrustManoeuver(delta_time,  player.getForward());
 	if(key_pressed['/'])
-		g_player.thrustManoeuver(delta_time, -g_player.getForward());
+		player.thrustManoeuver(delta_time, -player.getForward());
 	if(key_pressed['w'] || key_pressed['e'])  // either key
-		g_player.thrustManoeuver(delta_time,  g_player.getUp());
+		player.thrustManoeuver(delta_time,  player.getUp());
 	if(key_pressed['s'])
-		g_player.thrustManoeuver(delta_time, -g_player.getUp());
+		player.thrustManoeuver(delta_time, -player.getUp());
 	if(key_pressed['d'])
-		g_player.thrustManoeuver(delta_time,  g_player.getRight());
+		player.thrustManoeuver(delta_time,  player.getRight());
 	if(key_pressed['a'])
-		g_player.thrustManoeuver(delta_time, -g_player.getRight());
+		player.thrustManoeuver(delta_time, -player.getRight());
 
 	//
 	//  Rotate player - independant of physics rate
 	//
 
 	if(key_pressed['.'])
-		g_player.rotateAroundForward(SECONDS_PER_PHYSICS, true);
+		player.rotateAroundForward(SECONDS_PER_PHYSICS, true);
 	if(key_pressed[','])
-		g_player.rotateAroundForward(SECONDS_PER_PHYSICS, false);
+		player.rotateAroundForward(SECONDS_PER_PHYSICS, false);
 	if(key_pressed[KEY_PRESSED_UP])
-		g_player.rotateAroundRight(SECONDS_PER_PHYSICS, false);
+		player.rotateAroundRight(SECONDS_PER_PHYSICS, false);
 	if(key_pressed[KEY_PRESSED_DOWN])
-		g_player.rotateAroundRight(SECONDS_PER_PHYSICS, true);
+		player.rotateAroundRight(SECONDS_PER_PHYSICS, true);
 	if(key_pressed[KEY_PRESSED_LEFT])
-		g_player.rotateAroundUp(SECONDS_PER_PHYSICS, false);
+		player.rotateAroundUp(SECONDS_PER_PHYSICS, false);
 	if(key_pressed[KEY_PRESSED_RIGHT])
-		g_player.rotateAroundUp(SECONDS_PER_PHYSICS, true);
+		player.rotateAroundUp(SECONDS_PER_PHYSICS, true);
 
 	//
 	//  Other
@@ -544,7 +482,7 @@ void handleInput (double delta_time)
 	// 'g' is handled in update
 	if(key_pressed['k'])
 	{
-		knockOffCrystals();
+		g_world.knockOffCrystals();
 		key_pressed['k'] = false;  // only once per keypress
 	}
 	if(key_pressed['p'])
@@ -566,264 +504,160 @@ void handleInput (double delta_time)
 	}
 }
 
-void knockOffCrystals ()
+void reshape (int w, int h)
 {
-	const Vector3& player_position = g_player.getPosition();
+	glViewport (0, 0, w, h);
 
-	for(unsigned a = 0; a < gv_asteroids.size(); a++)
-	{
-		Asteroid& asteroid = gv_asteroids[a];
-		if(asteroid.isCrystals())
-		{
-			Vector3 asteroid_position  = asteroid.getPosition();
-			Vector3 asteroid_to_player = player_position - asteroid_position;
-			double asteroid_radius = asteroid.getRadiusForDirection(asteroid_to_player.getNormalized());
-			double maximum_distance = asteroid_radius + CRYSTAL_KNOCK_OFF_RANGE;
+	window_width  = w;
+	window_height = h;
 
-			if(asteroid_to_player.isNormLessThan(maximum_distance))
-			{
-				Vector3 knock_off_position = asteroid_position + 2.0*asteroid_to_player.getCopyWithNorm(asteroid_radius);
-				for(unsigned c = 0; c < CRYSTAL_KNOCK_OFF_COUNT; c++)
-					addCrystal(knock_off_position, 1.0*asteroid.getVelocity());
-				asteroid.removeCrystals();
-			}
-		}
-	}
+	glMatrixMode(GL_PROJECTION);
+	glLoadIdentity();
+	gluPerspective(CAMERA_FIELD_OF_VIEW, (GLdouble)w / (GLdouble)h, CAMERA_NEAR_DISTANCE, CAMERA_FAR_DISTANCE);
+	glMatrixMode(GL_MODELVIEW);
+
+	glutPostRedisplay();
 }
 
-void addCrystal (const ObjLibrary::Vector3& position,
-                 const ObjLibrary::Vector3& asteroid_velocity)
+void display ()
 {
-	Vector3 crystal_velocity = asteroid_velocity + Vector3::getRandomUnitVector() * CRYSTAL_KNOCK_OFF_SPEED;
-	gv_crystals.push_back(Crystal(position, crystal_velocity, g_crystal_display_list));
+	TextureManager::updateStreaming(TEXTURE_UPLOADS_PER_FRAME);
+	Material::resetStateChangeCounts();
+
+	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
+	// clear the screen - any drawing before here will not display
+
+	glLoadIdentity();
+	g_world.getPlayer().setupFollowCamera(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
+	// camera is set up - any drawing before here will display incorrectly
+
+	CoordinateSystem camera = g_world.getPlayer().getCoordinateSystem();
+	camera.setPosition(g_world.getPlayer().getFollowCameraPosition(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE));
+	int viewport_height = max(window_height, 1);
+	g_view_frustum = ViewFrustum(camera, CAMERA_FIELD_OF_VIEW, (double)(window_width) / viewport_height,
+	                             CAMERA_NEAR_DISTANCE, CAMERA_FAR_DISTANCE, viewport_height);
+
+	g_render_queue.clear();
+	g_render_queue.setCamera(camera.getPosition(), CAMERA_FAR_DISTANCE);
+	queueSkybox();
+	queueEntities(g_is_show_debug);
+	g_render_queue.addCallback(RenderQueue::PASS_OVERLAY, drawOverlays);
+	g_render_queue.execute();
+
+	if(key_pressed['y'])
+		sleep(SIMULATE_SLOW_SECONDS);  // simulate slow drawing
+
+	// send the current image to the screen - any drawing after here will not display
+	glutSwapBuffers();
 }
 
-void updatePhysics (double delta_time)
+void queueSkybox ()
 {
-	for(unsigned a = 0; a < gv_asteroids.size(); a++)
-		gv_asteroids[a].updatePhysics(delta_time, g_black_hole);
+	Vector3 camera = g_world.getPlayer().getFollowCameraPosition(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
+
+	// centered on the camera and rotated 90 degrees around the Z
+	//   axis to line band of clouds on skybox up with accretion disk
+	double a_matrix[16] = {  0.0,      1.0,      0.0,     0.0,
+	                        -1.0,      0.0,      0.0,     0.0,
+	                         0.0,      0.0,      1.0,     0.0,
+	                         camera.x, camera.y, camera.z, 1.0 };
+	g_render_queue.addDisplayList(RenderQueue::PASS_SKYBOX, g_skybox_display_list, a_matrix);
+}
 
-	for(unsigned c = 0; c < gv_crystals.size(); c++)
-		if(!gv_crystals[c].isGone())
-			gv_crystals[c].updatePhysics(delta_time, g_black_hole);
+void queueEntities (bool is_show_debug)
+{
+	Spaceship& player = g_world.getPlayer();
+	const BlackHole& black_hole = g_world.getBlackHole();
 
-	if (g_player.isAlive())
-	{
-		g_player.updatePhysics(delta_time, g_black_hole);
-	}
-	
-	// =======================================================Added codes
-	// =======================================================Added codes
-	// =======================================================Added codes
+	g_drawn_entity_count  = 0;
+	g_culled_entity_count = 0;
 
-	// select last alive drone for chasing crystals 
-	for (int i = 0; i < 5; i++)
+	gv_drawn_asteroids.clear();
+	g_asteroid_lod_selector.setObjectCount(g_world.getAsteroidCount());
+	for(unsigned a = 0; a < g_world.getAsteroidCount(); a++)
 	{
-		if (drones[i].isAlive())
+		const Asteroid& asteroid = g_world.getAsteroid(a);
+		if(isVisible(asteroid.getPosition(), asteroid.getRadius()))
 		{
-			pursuit = i;
+			gv_drawn_asteroids.push_back(a);
+			g_asteroid_lod_selector.update(a, g_view_frustum.getPixelRadius(asteroid.getPosition(),
+			                                                                asteroid.getRadius()));
 		}
+		else
+			g_culled_entity_count++;
 	}
-	// last drone Chases last live Crystals
-	chasing = 10000;
-	for (int i = 0; i < 5; i++)
-	{
-		if (drones[i].isAlive())
-		{
-			// Decide Status of Drones
-			// Decide crystal number
-			droneStatus[i] = 3;
-			for (unsigned c = 0; c < gv_crystals.size(); c++)
-			{
+	g_drawn_entity_count += (unsigned int)(gv_drawn_asteroids.size());
 
-				if (!gv_crystals[c].isGone())
-				{
-					chasing = c;
-					droneStatus[pursuit] = 2;
-				}
-			}
-			// Ast. are inside safedistance, mark the index of the coloest one
-			int mindist = 100000000;
-			for (int a = 0; a < gv_asteroids.size(); a++)
-			{
-				double safedistance = ((drones[i].getVelocity() - gv_asteroids[a].getVelocity()).getNorm() / 25.0) + gv_asteroids[a].getRadius() + drones[i].getRadius() + 50.0;
-				double squaredistance = safedistance * safedistance;
-				if ((drones[i].getPosition()).getDistanceSquared(gv_asteroids[a].getPosition()) <= squaredistance)
-				{
-					// Index of Minimum distance asts. will be saved for each drone
-					if (squaredistance < mindist)
-					{
-						mindist = squaredistance;
-						avoid[i] = a;
-					}
-					droneStatus[i] = 1;
-				}
-			}
-		}
-		
-	}
-
-
-	// Drone actions 
-	for (int i = 0; i < 5; i++)
+	const vector<unsigned int>& v_asteroid_levels = g_asteroid_lod_selector.getLevels();
+	if(g_asteroid_renderer.isInitialized())
 	{
-		if (drones[i].isAlive())
-		{
-			// If ast is too close avoid
-			if (droneStatus[i] == 1)
-			{
-				if (avoid[i] < 1000)
-//				for (int a = 0; a < gv_asteroids.size(); a++)
-				{
-					drones[i].avoid(gv_asteroids[avoid[i]], drones[i], delta_time);
-				}
-			}
-			// If ast. is not close
-			else if (droneStatus[i] == 2)
-			{
-				for (unsigned c = 0; c < gv_crystals.size(); c++)
-				{
-					if (chasing < 10000)
-					{					
-						drones[pursuit].swallow(gv_crystals[chasing], drones[pursuit], gv_crystals[chasing].getPosition(), delta_time);
-					}
-				}
-			}
-			// Escort if it is not eating crystal or avoiding
-			else if (droneStatus[i] == 3)
-			{
-					drones[i].escort(g_player, drones[i], g_player.SendPosition(i), delta_time);
-			}
-			drones[i].updatePhysics(delta_time, g_black_hole);
-		}
+		g_render_queue.addCallback(RenderQueue::PASS_OPAQUE,
+		                           [] ()
+		                           {
+		                               g_asteroid_renderer.draw(g_world, gv_drawn_asteroids,
+		                                                        g_asteroid_lod_selector.getLevels());
+		                           });
 	}
-}
-
-void handleCollisions ()
-{
-/*
-	if(Collisions::isCollision(g_player, g_black_hole))
-		g_player.markDead();
-*/
-	for(unsigned c = 0; c < gv_crystals.size(); c++)
+	else
 	{
-		Crystal& crystal = gv_crystals[c];
-		if(!crystal.isGone())
+		for(unsigned i = 0; i < gv_drawn_asteroids.size(); i++)
 		{
-
-			if(Collisions::isCollision(g_player, crystal))
-			{
-				assert(!crystal.isGone());
-				crystal.markGone();
-				g_crystals_collected++;
-			}
-			// =======================Added codes==================
-			// Drone to Crystal
-			for (int i = 0; i < 5; i++)
-			{
-				if (Collisions::isCollision(drones[i], crystal))
-				{
-					assert(!crystal.isGone());
-					crystal.markGone();
-					g_crystals_collected++;
-				}
-			}
+			unsigned int a = gv_drawn_asteroids[i];
+			g_world.getAsteroid(a).addLevelOfDetailToRenderQueue(g_render_queue, RenderQueue::PASS_OPAQUE,
+			                                                     v_asteroid_levels[a]);
 		}
 	}
 
-	for(unsigned a = 0; a < gv_asteroids.size(); a++)
+	for(unsigned c = 0; c < g_world.getCrystalCount(); c++)
 	{
-		Asteroid& asteroid = gv_asteroids[a];
+		const Crystal& crystal = g_world.getCrystal(c);
+		if(crystal.isGone())
+			continue;
 
-		for(unsigned a2 = a + 1; a2 < gv_asteroids.size(); a2++)
+		if(isVisible(crystal.getPosition(), crystal.getRadius()))
 		{
-			Asteroid& asteroid2 = gv_asteroids[a2];
-			if(Collisions::isCollision(asteroid, asteroid2))
-				Collisions::elastic(asteroid, asteroid2);
+			crystal.addToRenderQueue(g_render_queue, RenderQueue::PASS_OPAQUE);
+			g_drawn_entity_count++;
 		}
+		else
+			g_culled_entity_count++;
+	}
 
-		for(unsigned c = 0; c < gv_crystals.size(); c++)
-		{
-			Crystal& crystal = gv_crystals[c];
-			if(!crystal.isGone())
-				if(Collisions::isCollision(crystal, asteroid))
-				{
-					Collisions::elastic(crystal, asteroid);
-					//Collisions::bounceOff(crystal, asteroid);  // does about the same thing
-				}
-		}
+	if(player.isAlive())
+		player.addToRenderQueue(g_render_queue, RenderQueue::PASS_OPAQUE);
 
-		if (Collisions::isCollision(g_player, asteroid))
-		{
-			g_player.markDead();
-		}
+	for (unsigned int k = 0; k < World::DRONE_COUNT; k++)
+	{
+		const Drone& drone = g_world.getDrone(k);
+		if(!drone.isAlive())
+			continue;
 
-		// =======================Added codes==================
-		// Drone to Asts.
-		for (int k = 0; k < 5; k++)
+		if(isVisible(drone.getPosition(), drone.getRadius()))
 		{
-			if (drones[k].isAlive())
-			{
-				if (Collisions::isCollision(drones[k], asteroid))
-				{
-					drones[k].markDead();
-					droneStatus[k] = 0;
-					live_drones--;
-				}
-			}
+			drone.addToRenderQueue(g_render_queue, RenderQueue::PASS_OPAQUE);
+			g_drawn_entity_count++;
 		}
+		else
+			g_culled_entity_count++;
 	}
-}
 
-void reshape (int w, int h)
-{
-	glViewport (0, 0, w, h);
-
-	window_width  = w;
-	window_height = h;
+	// lines are not models, so they are drawn all at once
+	g_render_queue.addCallback(RenderQueue::PASS_OPAQUE,
+	                           [is_show_debug] () { drawPathsAndDebug(is_show_debug); });
 
-	glMatrixMode(GL_PROJECTION);
-	glLoadIdentity();
-	gluPerspective(60, (GLdouble)w / (GLdouble)h, 1.0, 100000.0);
-	glMatrixMode(GL_MODELVIEW);
-
-	glutPostRedisplay();
+	// accretion disk is transparent
+	black_hole.addToRenderQueue(g_render_queue, RenderQueue::PASS_TRANSPARENT);
 }
 
-void display ()
+bool isVisible (const Vector3& center, double radius)
 {
-	glClear(GL_COLOR_BUFFER_BIT | GL_DEPTH_BUFFER_BIT);
-	// clear the screen - any drawing before here will not display
-
-	glLoadIdentity();
-	g_player.setupFollowCamera(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
-	// camera is set up - any drawing before here will display incorrectly
-
-	drawSkybox();  // has to be first
-	drawEntities(g_is_show_debug);
-	drawOverlays();
-
-	if(key_pressed['y'])
-		sleep(SIMULATE_SLOW_SECONDS);  // simulate slow drawing
-
-	// send the current image to the screen - any drawing after here will not display
-	glutSwapBuffers();
-}
+	assert(radius >= 0.0);
 
-void drawSkybox ()
-{
-	glPushMatrix();
-		Vector3 camera = g_player.getFollowCameraPosition(CAMERA_BACK_DISTANCE, CAMERA_UP_DISTANCE);
-		glTranslated(camera.x, camera.y, camera.z);
-		glRotated(90.0, 0.0, 0.0, 1.0);  // line band of clouds on skybox up with accretion disk
-
-		glDepthMask(GL_FALSE);
-		g_skybox_display_list.draw();
-		glDepthMask(GL_TRUE);
-	glPopMatrix();
+	return g_view_frustum.isSphereVisible(center, radius) &&
+	       g_view_frustum.getPixelRadius(center, radius) >= MIN_DRAWN_PIXEL_RADIUS;
 }
 
-void drawEntities (bool is_show_debug)
+void drawPathsAndDebug (bool is_show_debug)
 {
 	static const Vector3 PLAYER_COLOUR(1.0, 1.0, 1.0);
 	Vector3 Dcolor0(1.0, 0.5, 0.0);
@@ -832,26 +666,32 @@ void drawEntities (bool is_show_debug)
 	Vector3 Dcolor3(0.0, 0.0, 1.0);
 	Vector3 Dcolor4(0.0, 1.0, 0.0);
 
-	const Vector3& player_position = g_player.getPosition();
-	for(unsigned a = 0; a < gv_asteroids.size(); a++)
+	Spaceship& player = g_world.getPlayer();
+	const BlackHole& black_hole = g_world.getBlackHole();
+	unsigned int chasing = g_world.getChasingCrystal();
+
+	const Vector3& player_position = player.getPosition();
+	for(unsigned a = 0; a < g_world.getAsteroidCount(); a++)
 	{
-		const Asteroid& asteroid = gv_asteroids[a];
-		asteroid.draw();
+		const Asteroid& asteroid = g_world.getAsteroid(a);
 
 		if(is_show_debug)
 		{
-			asteroid.drawAxes(asteroid.getRadius() + 50.0);
-			if (asteroid.getPosition().isDistanceLessThan(player_position, DEBUG_MAX_DISTANCE))
+			if(isVisible(asteroid.getPosition(), asteroid.getRadius() + 50.0))
+				asteroid.drawAxes(asteroid.getRadius() + 50.0);
+			if (asteroid.getPosition().isDistanceLessThan(player_position, DEBUG_MAX_DISTANCE) &&
+			    isVisible(asteroid.getPosition(), asteroid.getRadius()))
 			{
 				asteroid.drawSurfaceEquators();
 			}
 
 			// Draw ast shield if drone is too close to asts
-			for (int k = 0; k < 5; k++)
+			for (unsigned int k = 0; k < World::DRONE_COUNT; k++)
 			{
-				double safedistance = ((drones[k].getVelocity() - gv_asteroids[a].getVelocity()).getNorm() / 25.0) + gv_asteroids[a].getRadius() + drones[k].getRadius() + 50.0;
+				double safedistance = ((g_world.getDrone(k).getVelocity() - asteroid.getVelocity()).getNorm() / 25.0) + asteroid.getRadius() + g_world.getDrone(k).getRadius() + 50.0;
 				double squaredistance = safedistance * safedistance;
-				if ((drones[k].getPosition()).getDistanceSquared(asteroid.getPosition()) < squaredistance)
+				if ((g_world.getDrone(k).getPosition()).getDistanceSquared(asteroid.getPosition()) < squaredistance &&
+				    isVisible(asteroid.getPosition(), safedistance))
 				{
 					glPushMatrix();
 					glColor3ub(150, 20, 255);
@@ -863,58 +703,51 @@ void drawEntities (bool is_show_debug)
 		}
 	}
 
-	for(unsigned c = 0; c < gv_crystals.size(); c++)
-	{
-		const Crystal& crystal = gv_crystals[c];
-		if(!crystal.isGone())
-			crystal.draw();
-	}
-		
-	if(g_player.isAlive())
+	if(player.isAlive())
 	{
-		g_player.draw();
-		g_player.drawPath(g_black_hole, 1000, PLAYER_COLOUR);
+		player.drawPath(black_hole, 1000, PLAYER_COLOUR,
+		                g_world.getSimulationTime(), g_player_path_cache);
 	
 		// Draw drone future position
 		if (is_show_debug)
 		{
-			if (droneStatus[0] == 1 || droneStatus[0] == 3)
+			if (g_world.getDroneStatus(0) == 1 || g_world.getDroneStatus(0) == 3)
 			{
-				g_player.drawFutureD(g_black_hole, drones[0], 0);
+				player.drawFutureD(black_hole, g_world.getDrone(0), 0);
 			}
-			if (droneStatus[1] == 1 || droneStatus[1] == 3)
+			if (g_world.getDroneStatus(1) == 1 || g_world.getDroneStatus(1) == 3)
 			{
-				g_player.drawFutureD(g_black_hole, drones[1], 1);
+				player.drawFutureD(black_hole, g_world.getDrone(1), 1);
 			}
-			if (droneStatus[2] == 1 || droneStatus[2] == 3)
+			if (g_world.getDroneStatus(2) == 1 || g_world.getDroneStatus(2) == 3)
 			{
-				g_player.drawFutureD(g_black_hole, drones[2], 2);
+				player.drawFutureD(black_hole, g_world.getDrone(2), 2);
 			}
-			if (droneStatus[3] == 1 || droneStatus[3] == 3)
+			if (g_world.getDroneStatus(3) == 1 || g_world.getDroneStatus(3) == 3)
 			{
-				g_player.drawFutureD(g_black_hole, drones[3], 3);
+				player.drawFutureD(black_hole, g_world.getDrone(3), 3);
 			}
-			if (droneStatus[4] == 1 || droneStatus[4] == 3)
+			if (g_world.getDroneStatus(4) == 1 || g_world.getDroneStatus(4) == 3)
 			{
-				g_player.drawFutureD(g_black_hole, drones[4], 4);
+				player.drawFutureD(black_hole, g_world.getDrone(4), 4);
 			}
 		}
 		if (is_show_debug)
 		{
-			if (chasing < 1000)
+			if (chasing != World::NO_CRYSTAL)
 			{
 				glPushMatrix();
 				glColor3ub(255, 255, 255);
-				glTranslated(gv_crystals[chasing].getPosition().x, gv_crystals[chasing].getPosition().y, gv_crystals[chasing].getPosition().z);
+				glTranslated(g_world.getCrystal(chasing).getPosition().x, g_world.getCrystal(chasing).getPosition().y, g_world.getCrystal(chasing).getPosition().z);
 				glutWireSphere(16.0, 8, 4);
 				glPopMatrix();
 
 
-				for (int z = 0; z < 5; z++)
+				for (unsigned int z = 0; z < World::DRONE_COUNT; z++)
 				{
-					if (droneStatus[z] == 2)
+					if (g_world.getDroneStatus(z) == 2)
 					{
-						gv_crystals[chasing].drawFutureD(g_black_hole, drones[z], z);
+						g_world.getCrystal(chasing).drawFutureD(black_hole, g_world.getDrone(z), z);
 					}
 				}
 			}
@@ -924,46 +757,44 @@ void drawEntities (bool is_show_debug)
 	// Drawing drone escort position
 	if (is_show_debug)
 	{
-		g_player.drawDronesdead(g_player.getPosition());
+		player.drawDronesdead(player.getPosition());
 	}
 
 	// Drawing drones
-    for (int k = 0; k < 5; k++)
+    for (unsigned int k = 0; k < World::DRONE_COUNT; k++)
 	{
-		if (drones[k].isAlive())
+		if (g_world.getDrone(k).isAlive())
 		{	
 			if (is_show_debug)
 			{
-				g_player.drawDrones(g_player.getPosition(), k);
-				if (chasing < 1000)
+				player.drawDrones(player.getPosition(), k);
+				if (chasing != World::NO_CRYSTAL)
 				{
-					g_player.drawDroneschase(g_player.getPosition(), pursuit);
+					player.drawDroneschase(player.getPosition(), g_world.getPursuitDrone());
 				}
 			}
-			drones[k].draw();
 			if (k == 0)
 			{
-				drones[0].drawPath(g_black_hole, 1000, Dcolor0);
+				g_world.getDrone(0).drawPath(black_hole, 1000, Dcolor0);
 			}
 			if (k == 1)
 			{
-				drones[1].drawPath(g_black_hole, 1000, Dcolor1);
+				g_world.getDrone(1).drawPath(black_hole, 1000, Dcolor1);
 			}
 			if (k == 2)
 			{
-				drones[2].drawPath(g_black_hole, 1000, Dcolor2);
+				g_world.getDrone(2).drawPath(black_hole, 1000, Dcolor2);
 			}
 			if (k == 3)
 			{
-				drones[3].drawPath(g_black_hole, 1000, Dcolor3);
+				g_world.getDrone(3).drawPath(black_hole, 1000, Dcolor3);
 			}
 			if (k == 4)
 			{
-				drones[4].drawPath(g_black_hole, 1000, Dcolor4);
+				g_world.getDrone(4).drawPath(black_hole, 1000, Dcolor4);
 			}
 		}
 	}
-	g_black_hole.draw();  // must be last
 }
 
 void drawOverlays ()
@@ -1005,38 +836,54 @@ void drawOverlays ()
 	// display crystal information
 
 	unsigned int crystal_count = 0;
-	for(unsigned c = 0; c < gv_crystals.size(); c++)
-		if(!gv_crystals[c].isGone())
+	for(unsigned c = 0; c < g_world.getCrystalCount(); c++)
+		if(!g_world.getCrystal(c).isGone())
 			crystal_count++;
 	stringstream crystals_ss;
 	crystals_ss << "Drifting crystals:\t" << crystal_count;
 	font.draw(crystals_ss.str(), 16, 64);
 
 	stringstream collected_ss;
-	collected_ss << "Collected crystals:\t" << g_crystals_collected;
+	collected_ss << "Collected crystals:\t" << g_world.getCrystalsCollected();
 	font.draw(collected_ss.str(), 16, 88);
 
 	// Count the number of live drones
 	stringstream badDrones_ss;
-	badDrones_ss << "Live Bad Drones:\t" << live_drones;
+	badDrones_ss << "Live Bad Drones:\t" << g_world.getLiveDroneCount();
 	font.draw(badDrones_ss.str(), 16, 112);
 
+	// display culling information from the last drawEntities
+
+	stringstream drawn_ss;
+	drawn_ss << "Drawn entities:\t" << g_drawn_entity_count
+	         << " (" << g_culled_entity_count << " culled)";
+	font.draw(drawn_ss.str(), 16, 136);
+
+	stringstream material_ss;
+	material_ss << "Material state changes:\t " << Material::getStateChangeIssuedCount()
+	            << " (" << Material::getStateChangeSkippedCount() << " skipped)";
+	font.draw(material_ss.str(), 16, 160);
+
 	// display control keys
 
 	unsigned char byte_g = key_pressed['g'] ? 0x00 : 0xFF;
+	unsigned char byte_h = key_pressed['h'] ? 0x00 : 0xFF;
 	unsigned char byte_t = g_is_show_debug  ? 0x00 : 0xFF;
 	unsigned char byte_y = key_pressed['y'] ? 0x00 : 0xFF;
 	unsigned char byte_u = key_pressed['u'] ? 0x00 : 0xFF;
 
 	font.draw("[G]:\tAccelerate time",  window_width - 256,  16, byte_g, 0xFF, byte_g);
-	font.draw("[T]:\tToggle debugging", window_width - 256,  48, byte_t, 0xFF, byte_t);
-	font.draw("[Y]:\tSlow display",     window_width - 256,  80, byte_y, 0xFF, byte_y);
-	font.draw("[U]:\tSlow physics",     window_width - 256, 112, byte_u, 0xFF, byte_u);
+	font.draw("[H]:\tTime warp",        window_width - 256,  48, byte_h, 0xFF, byte_h);
+	font.draw("[T]:\tToggle debugging", window_width - 256,  80, byte_t, 0xFF, byte_t);
+	font.draw("[Y]:\tSlow display",     window_width - 256, 112, byte_y, 0xFF, byte_y);
+	font.draw("[U]:\tSlow physics",     window_width - 256, 144, byte_u, 0xFF, byte_u);
 
 	// display "GAME OVER" if appropriate
 
-	if(!g_player.isAlive())
+	if(!g_world.getPlayer().isAlive())
 		font.draw("GAME OVER", window_width / 2.5, window_height / 2);
 
 	SpriteFont::unsetUp2dView();
-}
\ No newline at end of file
+}
+
+#endif